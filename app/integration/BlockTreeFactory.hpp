@@ -14,6 +14,7 @@
 #include "network/extrinsic_observer.hpp"
 #include "crypto/hasher.hpp"
 #include "base/outcome_throw.hpp"
+#include "storage/trie/serialization/trie_pruner.hpp"
 class BlockTreeFactory
 {
 public:
@@ -73,6 +74,15 @@ public:
             sgns::base::raise( maybe_block_tree.error() );
         }
 
+        // the pruner is only registered when state pruning is enabled
+        result = component_factory->GetComponent( "TriePruner", boost::none );
+        if ( result )
+        {
+            auto pruner = std::dynamic_pointer_cast<sgns::storage::trie::TriePruner>( result.value() );
+            maybe_block_tree.value()->setFinalizedEventHandler( [pruner]( const sgns::primitives::BlockHeader &header )
+                                                                { pruner->onFinalized( sgns::base::Buffer{ header.state_root } ); } );
+        }
+
         return maybe_block_tree.value();
     }
 };
@@ -0,0 +1,51 @@
+/**
+ * @file       TriePrunerFactory.hpp
+ * @brief      
+ * @date       2026-10-18
+ */
+#ifndef _TRIE_PRUNER_FACTORY_HPP_
+#define _TRIE_PRUNER_FACTORY_HPP_
+
+#include "base/buffer.hpp"
+#include "base/outcome_throw.hpp"
+#include "blockchain/impl/storage_util.hpp"
+#include "singleton/CComponentFactory.hpp"
+#include "storage/trie/serialization/trie_pruner.hpp"
+
+class TriePrunerFactory
+{
+public:
+    static std::shared_ptr<sgns::storage::trie::TriePruner> create( uint32_t keep_finalized )
+    {
+        auto component_factory = SINGLETONINSTANCE( CComponentFactory );
+
+        auto maybe_buffer_storage = component_factory->GetComponent( "BufferStorage", boost::make_optional( std::string( "rocksdb" ) ) );
+        if ( !maybe_buffer_storage )
+        {
+            throw std::runtime_error( "Initialize BufferStorage first" );
+        }
+        auto buffer_storage = std::dynamic_pointer_cast<sgns::storage::BufferStorage>( maybe_buffer_storage.value() );
+
+        auto maybe_codec = component_factory->GetComponent( "Codec", boost::none );
+        if ( !maybe_codec )
+        {
+            throw std::runtime_error( "Initialize Codec first" );
+        }
+        auto codec = std::dynamic_pointer_cast<sgns::storage::trie::Codec>( maybe_codec.value() );
+
+        using sgns::blockchain::prefix::TRIE_NODE;
+        using sgns::blockchain::prefix::TRIE_PRUNING;
+        auto maybe_pruner = sgns::storage::trie::TriePruner::create( buffer_storage,                         //
+                                                                     sgns::base::Buffer{ TRIE_NODE },        //
+                                                                     sgns::base::Buffer{ TRIE_PRUNING },     //
+                                                                     codec,                                  //
+                                                                     { keep_finalized } );
+        if ( !maybe_pruner )
+        {
+            sgns::base::raise( maybe_pruner.error() );
+        }
+        return maybe_pruner.value();
+    }
+};
+
+#endif
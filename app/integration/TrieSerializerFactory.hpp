@@ -38,7 +38,15 @@ public:
         }
         auto trie_backend = std::dynamic_pointer_cast<sgns::storage::trie::TrieStorageBackend>( maybe_trie_backend.value() );
 
-        return std::make_shared<sgns::storage::trie::TrieSerializerImpl>( sgns_trie_fact, codec, trie_backend );
+        auto serializer = std::make_shared<sgns::storage::trie::TrieSerializerImpl>( sgns_trie_fact, codec, trie_backend );
+
+        // the pruner is only registered when state pruning is enabled
+        auto maybe_pruner = component_factory->GetComponent( "TriePruner", boost::none );
+        if ( maybe_pruner )
+        {
+            serializer->setPruner( std::dynamic_pointer_cast<sgns::storage::trie::TriePruner>( maybe_pruner.value() ) );
+        }
+        return serializer;
     }
 };
 
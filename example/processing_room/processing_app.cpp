@@ -27,7 +27,10 @@ namespace
     class SubTaskResultStorageImpl : public SubTaskResultStorage
     {
     public:
-        void AddSubTaskResult( const SGProcessing::SubTaskResult &subTaskResult ) override {}
+        bool AddSubTaskResult( const SGProcessing::SubTaskResult &subTaskResult ) override
+        {
+            return true;
+        }
 
         void RemoveSubTaskResult( const std::string &subTaskId ) override {}
 
@@ -12,6 +12,7 @@
 #include <rapidjson/writer.h>
 #include "base/sgns_version.hpp"
 #include "base/ScaledInteger.hpp"
+#include "base/tracing.hpp"
 #include "account/TokenAmount.hpp"
 #include "account/GeniusNode.hpp"
 #include "account/MigrationManager.hpp"
@@ -108,6 +109,8 @@ namespace sgns
         SSL_library_init();
         SSL_load_error_strings();
         OpenSSL_add_all_algorithms();
+        // Every node gets its own process id in the traces, so the traces of several nodes can be merged
+        base::Tracer::Instance().SetProcessName( account_->GetAddress() );
         logging_system = std::make_shared<soralog::LoggingSystem>( std::make_shared<soralog::ConfiguratorFromYAML>(
             // Original LibP2P logging config
             std::make_shared<libp2p::log::Configurator>(),
@@ -282,10 +285,15 @@ namespace sgns
         auto generator = std::make_shared<ipfs_lite::ipfs::graphsync::RequestIdGenerator>();
         auto graphsyncnetwork = std::make_shared<ipfs_lite::ipfs::graphsync::Network>( pubsub_->GetHost(), scheduler );
 
+        // The database is shared by the transactions and the sub task results, so the writes are only grouped
+        // when the node is configured to
+        auto crdt_options                           = crdt::CrdtOptions::DefaultOptions();
+        crdt_options->groupCommitWindowMilliseconds = dev_config_.GroupCommitWindowMilliseconds;
+
         auto global_db_ret = crdt::GlobalDB::New( io_,
                                                   write_base_path_ + gnus_network_full_path_,
                                                   pubsub_,
-                                                  crdt::CrdtOptions::DefaultOptions(),
+                                                  crdt_options,
                                                   graphsyncnetwork,
                                                   scheduler,
                                                   generator );
@@ -862,9 +870,11 @@ namespace sgns
                 node_logger->error( "Unable to complete task: {} ", task_id );
                 break;
             }
-            auto pay_result = PayEscrow( maybe_escrow_path.value(),
-                                         taskresult,
-                                         std::move( complete_task_result.value() ) );
+            base::TraceSpan span( "pay_escrow", task_id );
+            auto            pay_result = PayEscrow( maybe_escrow_path.value(),
+                                                    taskresult,
+                                                    std::move( complete_task_result.value() ) );
+            span.End();
             if ( pay_result.has_failure() )
             {
                 node_logger->error( "Invalid results for task: {} ", task_id );
@@ -894,6 +904,16 @@ namespace sgns
         processing_service_->StartProcessing( processing_grid_chanel_topic_ );
     }
 
+    void GeniusNode::SetTracingEnabled( bool enabled )
+    {
+        base::Tracer::Instance().SetEnabled( enabled );
+    }
+
+    outcome::result<void> GeniusNode::WriteTrace( const std::string &path ) const
+    {
+        return base::Tracer::Instance().WriteChromeTrace( path );
+    }
+
     outcome::result<std::map<std::string, double>> GeniusNode::GetCoinprice( const std::vector<std::string> &tokenIds )
     {
         auto                          currentTime = std::chrono::system_clock::now();
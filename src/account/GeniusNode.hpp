@@ -29,6 +29,7 @@ typedef struct DevConfig
     std::string TokenValueInGNUS;
     TokenID     TokenID;
     char        BaseWritePath[1024];
+    long long   GroupCommitWindowMilliseconds = 0; ///< Window merging concurrent database writes, 0 disables it
 } DevConfig_st;
 
 extern DevConfig_st DEV_CONFIG;
@@ -175,6 +176,19 @@ namespace sgns
         void StopProcessing();
         void StartProcessing();
 
+        /**
+         * @brief       Switches the recording of the task processing spans, off by default
+         * @param[in]   enabled Whether spans are recorded
+         */
+        void SetTracingEnabled( bool enabled );
+
+        /**
+         * @brief       Writes the spans recorded so far in the Chrome trace event format
+         * @param[in]   path File to write
+         * @return      Error if the file can't be written
+         */
+        outcome::result<void> WriteTrace( const std::string &path ) const;
+
         outcome::result<std::map<std::string, double>> GetCoinprice( const std::vector<std::string> &tokenIds );
         outcome::result<std::map<std::string, std::map<int64_t, double>>> GetCoinPriceByDate(
             const std::vector<std::string> &tokenIds,
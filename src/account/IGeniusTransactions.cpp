@@ -1,9 +1,9 @@
 #include "IGeniusTransactions.hpp"
+#include "TransactionSignatureVerifier.hpp"
 
 #include <crypto/hasher/hasher_impl.hpp>
 #include <nil/crypto3/algebra/marshalling.hpp>
 #include <nil/crypto3/pubkey/algorithm/sign.hpp>
-#include <nil/crypto3/pubkey/algorithm/verify.hpp>
 
 namespace sgns
 {
@@ -78,49 +78,8 @@ namespace sgns
         return signed_vector;
     }
 
-    bool IGeniusTransactions::CheckDAGStructSignature( SGTransaction::DAGStruct dag_st )
+    bool IGeniusTransactions::CheckDAGStructSignature( const SGTransaction::DAGStruct &dag_st )
     {
-        bool         ret                = false;
-        auto         str_signature      = dag_st.signature();
-        const size_t SIGNATURE_EXP_SIZE = 64;
-        do
-        {
-            if ( str_signature.size() != SIGNATURE_EXP_SIZE )
-            {
-                break;
-            }
-            std::vector<uint8_t> vec_sig( str_signature.cbegin(), str_signature.cend() );
-
-            dag_st.clear_signature();
-            auto                 size = dag_st.ByteSizeLong();
-            std::vector<uint8_t> serialized( size );
-            dag_st.SerializeToArray( serialized.data(), size );
-
-            std::array<uint8_t, 32> hashed = nil::crypto3::hash<nil::crypto3::hashes::sha2<256>>( serialized );
-
-            auto [r_success, r] =
-                nil::marshalling::bincode::field<ecdsa_t::scalar_field_type>::field_element_from_bytes(
-                    vec_sig.cbegin(),
-                    vec_sig.cbegin() + 32 );
-
-            if ( !r_success )
-            {
-                break;
-            }
-            auto [s_success, s] =
-                nil::marshalling::bincode::field<ecdsa_t::scalar_field_type>::field_element_from_bytes(
-                    vec_sig.cbegin() + 32,
-                    vec_sig.cbegin() + 64 );
-
-            if ( !s_success )
-            {
-                break;
-            }
-            ethereum::signature_type sig( r, s );
-            auto eth_pubkey = ethereum::EthereumKeyGenerator::BuildPublicKey( dag_st.source_addr() );
-            ret             = nil::crypto3::verify( hashed, sig, eth_pubkey );
-        } while ( 0 );
-
-        return ret;
+        return TransactionSignatureVerifier::Instance().Verify( dag_st );
     }
 }
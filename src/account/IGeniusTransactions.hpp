@@ -109,7 +109,7 @@ namespace sgns
         void FillHash();
 
         std::vector<uint8_t> MakeSignature( std::shared_ptr<ethereum::EthereumKeyGenerator> eth_key );
-        static bool          CheckDAGStructSignature( SGTransaction::DAGStruct dag_st );
+        static bool          CheckDAGStructSignature( const SGTransaction::DAGStruct &dag_st );
 
         SGTransaction::DAGStruct                                                dag_st;
         static inline std::unordered_map<std::string, TransactionDeserializeFn> deserializers_map;
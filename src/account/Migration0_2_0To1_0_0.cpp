@@ -13,6 +13,7 @@
 #include "account/TransactionManager.hpp"
 #include "account/TransferTransaction.hpp"
 #include "account/EscrowReleaseTransaction.hpp"
+#include "account/TransactionSignatureVerifier.hpp"
 #include "proof/IBasicProof.hpp"
 #include "MigrationManager.hpp"
 
@@ -115,6 +116,11 @@ namespace sgns
         boost::format full_node_topic{ std::string( TransactionManager::GNUS_FULL_NODES_TOPIC ) };
         full_node_topic % TransactionManager::TEST_NET_ID;
 
+        // all fetched first, so their signatures are verified as one batch
+        std::vector<std::pair<std::string, std::shared_ptr<IGeniusTransactions>>> transactions;
+        std::vector<SGTransaction::DAGStruct>                                     dags;
+        transactions.reserve( entries.size() );
+        dags.reserve( entries.size() );
         for ( const auto &entry : entries )
         {
             auto keyOpt = oldDb->KeyToString( entry.first );
@@ -131,10 +137,17 @@ namespace sgns
                 m_logger->error( "Can't fetch transaction for key {}", transaction_key );
                 continue;
             }
-            auto tx = maybe_transaction.value();
             m_logger->trace( "Fetched transaction {}", transaction_key );
+            dags.push_back( maybe_transaction.value()->dag_st );
+            transactions.emplace_back( std::move( transaction_key ), maybe_transaction.value() );
+        }
+        auto valid_signatures = TransactionSignatureVerifier::Instance().VerifyBatch( dags );
+
+        for ( size_t tx_index = 0; tx_index < transactions.size(); ++tx_index )
+        {
+            const auto &[transaction_key, tx] = transactions[tx_index];
 
-            if ( !IGeniusTransactions::CheckDAGStructSignature( tx->dag_st ) )
+            if ( !valid_signatures[tx_index] )
             {
                 m_logger->error( "Could not validate signature of transaction {}", transaction_key );
                 continue;
@@ -178,7 +191,7 @@ namespace sgns
                         maybe_replicated_tx.value() );
                     if ( maybe_deserialized_tx.has_value() )
                     {
-                        auto previous_tx = maybe_transaction.value();
+                        auto previous_tx = tx;
                         if ( previous_tx->dag_st.timestamp() > tx->dag_st.timestamp() )
                         {
                             //need to update, the new one came first
@@ -10,6 +10,7 @@
 
 #include <stdexcept>
 #include <utility>
+#include <charconv>
 #include <algorithm>
 #include <thread>
 
@@ -48,6 +49,9 @@ namespace sgns
 
     {
         m_logger->info( "Initializing values by reading whole blockchain" );
+#ifdef _PROOF_ENABLED
+        proof_generator_m = std::make_shared<ProofGenerator>();
+#endif
 
         boost::format full_node_topic{ std::string( GNUS_FULL_NODES_TOPIC ) };
         full_node_topic % TEST_NET_ID;
@@ -169,10 +173,22 @@ namespace sgns
     TransactionManager::~TransactionManager()
     {
         m_logger->debug( "~TransactionManager CALLED" );
+#ifdef _PROOF_ENABLED
+        proof_generator_m->Stop();
+#endif
+        std::lock_guard<std::mutex> lock( mutex_m );
+        tx_queue_depth_m.Sub( static_cast<int64_t>( tx_queue_m.size() ) );
     }
 
     void TransactionManager::Start()
     {
+        auto load_result = LoadSnapshot();
+        if ( load_result.has_error() )
+        {
+            m_logger->debug( "No usable account snapshot, replaying the whole account history" );
+        }
+        last_snapshot_m = std::chrono::steady_clock::now();
+
         CheckIncoming();
         CheckOutgoing();
 
@@ -191,7 +207,9 @@ namespace sgns
                 } );
         };
 
+        started_m = true;
         ctx_m->post( task_m );
+        ScheduleSend();
     }
 
     void TransactionManager::PrintAccountInfo()
@@ -211,25 +229,30 @@ namespace sgns
                                                                     const std::string &destination,
                                                                     TokenID            token_id )
     {
+        std::lock_guard account_lock( account_mutex_m );
         OUTCOME_TRY(
             auto &&params,
             UTXOTxParameters::create( account_m->utxos, account_m->GetAddress(), amount, destination, token_id ) );
 
         params.SignParameters( account_m->eth_address );
 
-        auto transfer_transaction = std::make_shared<TransferTransaction>(
-            TransferTransaction::New( params.outputs_, params.inputs_, FillDAGStruct(), account_m->eth_address ) );
-
-        std::optional<std::vector<uint8_t>> maybe_proof;
+        // The proof is queued before the nonce is taken, so a full proof queue leaves the account untouched
+        std::vector<ProofFuture> proofs;
 #ifdef _PROOF_ENABLED
-        TransferProof prover( static_cast<uint64_t>( account_m->GetBalance<uint64_t>() ),
-                              static_cast<uint64_t>( amount ) );
-        OUTCOME_TRY( ( auto &&, proof_result ), prover.GenerateFullProof() );
-        maybe_proof = std::move( proof_result );
+        OUTCOME_TRY( ( auto &&, proof ),
+                     SubmitProof( std::make_unique<TransferProof>(
+                         static_cast<uint64_t>( account_m->GetBalance<uint64_t>() ),
+                         static_cast<uint64_t>( amount ) ) ) );
+        proofs.push_back( std::move( proof ) );
 #endif
 
-        account_m->utxos = UTXOTxParameters::UpdateUTXOList( account_m->utxos, params );
-        this->EnqueueTransaction( std::make_pair( transfer_transaction, maybe_proof ) );
+        auto transfer_transaction = std::make_shared<TransferTransaction>(
+            TransferTransaction::New( params.outputs_, params.inputs_, FillDAGStruct(), account_m->eth_address ) );
+
+        auto locked_utxos = LockUTXOs( params );
+        this->EnqueueTransaction( { { TransactionPair{ transfer_transaction, std::nullopt } }, std::nullopt },
+                                  std::move( proofs ),
+                                  std::move( locked_utxos ) );
 
         return transfer_transaction->dag_st.data_hash();
     }
@@ -239,23 +262,26 @@ namespace sgns
                                                                 std::string chainid,
                                                                 TokenID     tokenid )
     {
+        std::lock_guard          account_lock( account_mutex_m );
+        std::vector<ProofFuture> proofs;
+#ifdef _PROOF_ENABLED
+        OUTCOME_TRY( ( auto &&, proof ),
+                     SubmitProof( std::make_unique<TransferProof>(
+                         1000000000000,
+                         static_cast<uint64_t>( amount ) ) ) ); // Mint max 1000000 gnus per transaction
+        proofs.push_back( std::move( proof ) );
+#endif
         auto mint_transaction = std::make_shared<MintTransaction>(
             MintTransaction::New( amount,
                                   std::move( chainid ),
                                   std::move( tokenid ),
                                   FillDAGStruct( std::move( transaction_hash ) ),
                                   account_m->eth_address ) );
-        std::optional<std::vector<uint8_t>> maybe_proof;
-#ifdef _PROOF_ENABLED
-        TransferProof prover( 1000000000000,
-                              static_cast<uint64_t>( amount ) ); // Mint max 1000000 gnus per transaction
-        OUTCOME_TRY( ( auto &&, proof_result ), prover.GenerateFullProof() );
-        maybe_proof = std::move( proof_result );
-#endif
         // Store the transaction ID before moving the transaction
         auto txId = mint_transaction->dag_st.data_hash();
 
-        this->EnqueueTransaction( std::make_pair( std::move( mint_transaction ), maybe_proof ) );
+        this->EnqueueTransaction( { { TransactionPair{ std::move( mint_transaction ), std::nullopt } }, std::nullopt },
+                                  std::move( proofs ) );
 
         return txId;
     }
@@ -267,6 +293,7 @@ namespace sgns
     {
         auto hash_data = hasher_m->blake2b_256( std::vector<uint8_t>{ job_id.begin(), job_id.end() } );
 
+        std::lock_guard account_lock( account_mutex_m );
         OUTCOME_TRY( ( auto &&, params ),
                      UTXOTxParameters::create( account_m->utxos,
                                                account_m->GetAddress(),
@@ -276,22 +303,25 @@ namespace sgns
 
         params.SignParameters( account_m->eth_address );
 
-        account_m->utxos        = UTXOTxParameters::UpdateUTXOList( account_m->utxos, params );
+        std::vector<ProofFuture> proofs;
+#ifdef _PROOF_ENABLED
+        OUTCOME_TRY( ( auto &&, proof ),
+                     SubmitProof( std::make_unique<TransferProof>(
+                         static_cast<uint64_t>( account_m->GetBalance<uint64_t>() ),
+                         static_cast<uint64_t>( amount ) ) ) );
+        proofs.push_back( std::move( proof ) );
+#endif
+
+        auto locked_utxos       = LockUTXOs( params );
         auto escrow_transaction = std::make_shared<EscrowTransaction>(
             EscrowTransaction::New( params, amount, dev_addr, peers_cut, FillDAGStruct(), account_m->eth_address ) );
 
         // Get the transaction ID for tracking
         auto txId = escrow_transaction->dag_st.data_hash();
 
-        std::optional<std::vector<uint8_t>> maybe_proof;
-#ifdef _PROOF_ENABLED
-        TransferProof prover( static_cast<uint64_t>( account_m->GetBalance<uint64_t>() ),
-                              static_cast<uint64_t>( amount ) );
-        OUTCOME_TRY( ( auto &&, proof_result ), prover.GenerateFullProof() );
-        maybe_proof = std::move( proof_result );
-#endif
-
-        this->EnqueueTransaction( std::make_pair( escrow_transaction, maybe_proof ) );
+        this->EnqueueTransaction( { { TransactionPair{ escrow_transaction, std::nullopt } }, std::nullopt },
+                                  std::move( proofs ),
+                                  std::move( locked_utxos ) );
 
         sgns::crdt::GlobalDB::Buffer data_transaction;
         data_transaction.put( escrow_transaction->SerializeByteVector() );
@@ -353,19 +383,23 @@ namespace sgns
         escrow_utxo_input.output_idx_ = 0;
         escrow_utxo_input.signature_  = ""; //TODO - Signature
 
+        std::lock_guard account_lock( account_mutex_m );
+
+        // Both proofs of the batch are generated in parallel
+        std::vector<ProofFuture> proofs;
+#ifdef _PROOF_ENABLED
+        //TODO - Create with the real balance and amount
+        for ( std::size_t i = 0; i < 2; ++i )
+        {
+            OUTCOME_TRY( ( auto &&, proof ), SubmitProof( std::make_unique<TransferProof>( 1, 1 ) ) );
+            proofs.push_back( std::move( proof ) );
+        }
+#endif
         auto transfer_transaction = std::make_shared<TransferTransaction>(
             TransferTransaction::New( payout_peers,
                                       std::vector<InputUTXOInfo>{ escrow_utxo_input },
                                       FillDAGStruct(),
                                       account_m->eth_address ) );
-
-        std::optional<std::vector<uint8_t>> transfer_proof;
-#ifdef _PROOF_ENABLED
-        //TODO - Create with the real balance and amount
-        TransferProof transfer_prover( 1, 1 );
-        OUTCOME_TRY( ( auto &&, transfer_proof_result ), transfer_prover.GenerateFullProof() );
-        transfer_proof = std::move( transfer_proof_result );
-#endif
         auto escrow_release_tx = std::make_shared<EscrowReleaseTransaction>(
             EscrowReleaseTransaction::New( escrow_tx->GetUTXOParameters(),
                                            escrow_tx->GetAmount(),
@@ -375,25 +409,18 @@ namespace sgns
                                            FillDAGStruct(),
                                            account_m->eth_address ) );
 
-        std::optional<std::vector<uint8_t>> escrow_release_proof;
-#ifdef _PROOF_ENABLED
-        //TODO - Create with the real balance and amount
-        TransferProof escrow_release_prover( 1, 1 );
-        OUTCOME_TRY( ( auto &&, escrow_release_proof_result ), escrow_release_prover.GenerateFullProof() );
-        escrow_release_proof = std::move( escrow_release_proof_result );
-#endif
-
         TransactionBatch tx_batch;
 
-        tx_batch.push_back( std::make_pair( transfer_transaction, transfer_proof ) );
-        tx_batch.push_back( std::make_pair( escrow_release_tx, escrow_release_proof ) );
+        tx_batch.push_back( TransactionPair{ transfer_transaction, std::nullopt } );
+        tx_batch.push_back( TransactionPair{ escrow_release_tx, std::nullopt } );
 
-        EnqueueTransaction( std::make_pair( tx_batch, std::move( crdt_transaction ) ) );
+        EnqueueTransaction( std::make_pair( tx_batch, std::move( crdt_transaction ) ), std::move( proofs ) );
         return transfer_transaction->dag_st.data_hash();
     }
 
     uint64_t TransactionManager::GetBalance()
     {
+        std::lock_guard account_lock( account_mutex_m );
         return account_m->GetBalance<uint64_t>();
     }
 
@@ -414,12 +441,149 @@ namespace sgns
         {
             m_logger->error( "Unknown CheckIncoming error in SendTransaction::Update()" );
         }
+        if ( snapshot_dirty_m && ( std::chrono::steady_clock::now() - last_snapshot_m >= SNAPSHOT_INTERVAL ) )
+        {
+            auto snapshot_result = SaveSnapshot();
+            if ( snapshot_result.has_error() )
+            {
+                m_logger->error( "Could not save the account snapshot" );
+            }
+        }
     }
 
     void TransactionManager::EnqueueTransaction( TransactionItem element )
     {
-        std::lock_guard<std::mutex> lock( mutex_m );
-        tx_queue_m.emplace_back( std::move( element ) );
+        EnqueueTransaction( std::move( element ), {} );
+    }
+
+    void TransactionManager::EnqueueTransaction( TransactionItem            element,
+                                                 std::vector<ProofFuture>   proofs,
+                                                 std::vector<InputUTXOInfo> locked_utxos )
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex_m );
+            tx_queue_m.push_back( { std::move( element ), std::move( proofs ), std::move( locked_utxos ) } );
+        }
+        tx_queue_depth_m.Add();
+        ScheduleSend();
+    }
+
+    std::vector<InputUTXOInfo> TransactionManager::LockUTXOs( const UTXOTxParameters &params )
+    {
+        auto updated_utxos = UTXOTxParameters::UpdateUTXOList( account_m->utxos, params );
+
+        // UpdateUTXOList keeps the order of the UTXOs, only the lock flags change
+        std::vector<InputUTXOInfo> locked_utxos;
+        for ( std::size_t i = 0; i < updated_utxos.size(); ++i )
+        {
+            if ( updated_utxos[i].GetLock() && !account_m->utxos[i].GetLock() )
+            {
+                locked_utxos.push_back( { updated_utxos[i].GetTxID(), updated_utxos[i].GetOutputIdx(), "" } );
+            }
+        }
+        account_m->utxos = std::move( updated_utxos );
+        return locked_utxos;
+    }
+
+    void TransactionManager::FailTransactions( std::vector<QueuedTransaction> failed )
+    {
+        {
+            std::lock_guard account_lock( account_mutex_m );
+            {
+                // The queued entries hold the nonces after the failed ones. They are failed too, so the nonces
+                // are given back without a gap the peers would wait on. Entries are only queued with the account
+                // lock held, so none can take a nonce meanwhile.
+                std::lock_guard<std::mutex> lock( mutex_m );
+                while ( !tx_queue_m.empty() )
+                {
+                    failed.push_back( std::move( tx_queue_m.front() ) );
+                    tx_queue_m.pop_front();
+                    tx_queue_depth_m.Sub();
+                }
+            }
+
+            std::optional<uint64_t> min_nonce;
+            for ( const auto &queued : failed )
+            {
+                for ( auto &utxo : account_m->utxos )
+                {
+                    bool was_locked = std::any_of( queued.locked_utxos.begin(),
+                                                   queued.locked_utxos.end(),
+                                                   [&utxo]( const InputUTXOInfo &info )
+                                                   {
+                                                       return info.txid_hash_ == utxo.GetTxID() &&
+                                                              info.output_idx_ == utxo.GetOutputIdx();
+                                                   } );
+                    if ( was_locked )
+                    {
+                        utxo.ToggleLock( false );
+                    }
+                }
+                for ( const auto &transaction_pair : queued.item.first )
+                {
+                    uint64_t nonce = transaction_pair.first->dag_st.nonce();
+                    min_nonce      = min_nonce ? std::min( *min_nonce, nonce ) : nonce;
+                }
+            }
+
+            // Every entry after the first failed one was failed, so the account restarts from its nonce
+            if ( min_nonce && *min_nonce > 0 && *min_nonce <= account_m->nonce )
+            {
+                account_m->nonce = *min_nonce - 1;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> out_lock( outgoing_tx_mutex_m );
+        for ( const auto &queued : failed )
+        {
+            for ( const auto &transaction_pair : queued.item.first )
+            {
+                m_logger->error( "Transaction {} won't be published", transaction_pair.first->dag_st.data_hash() );
+                failed_outgoing_tx_m.insert( transaction_pair.first->dag_st.data_hash() );
+            }
+        }
+    }
+
+#ifdef _PROOF_ENABLED
+    outcome::result<TransactionManager::ProofFuture> TransactionManager::SubmitProof(
+        std::unique_ptr<IBasicProof> prover )
+    {
+        // Called with the account lock held, so a full queue fails the operation instead of blocking it.
+        // The completion runs on a proof worker, so it only posts to the context and never owns the manager.
+        return proof_generator_m->TrySubmit( std::move( prover ),
+                                          [weak_instance = weak_from_this(), ctx = ctx_m]()
+                                          {
+                                              ctx->post(
+                                                  [weak_instance]()
+                                                  {
+                                                      if ( auto instance = weak_instance.lock() )
+                                                      {
+                                                          instance->ScheduleSend();
+                                                      }
+                                                  } );
+                                          } );
+    }
+#endif
+
+    void TransactionManager::ScheduleSend()
+    {
+        // Don't wait for the next Update tick, but keep a single send posted at a time
+        if ( !started_m || send_scheduled_m.exchange( true ) )
+        {
+            return;
+        }
+        ctx_m->post(
+            [weak_instance = weak_from_this()]()
+            {
+                if ( auto instance = weak_instance.lock() )
+                {
+                    instance->send_scheduled_m = false;
+                    if ( instance->SendTransaction().has_error() )
+                    {
+                        instance->m_logger->error( "Unknown SendTranscation error in ScheduleSend" );
+                    }
+                }
+            } );
     }
 
     void TransactionManager::EnqueueTransaction( TransactionPair element )
@@ -446,25 +610,161 @@ namespace sgns
 
     outcome::result<void> TransactionManager::SendTransaction()
     {
+        std::lock_guard  send_lock( send_mutex_m );
         std::unique_lock lock( mutex_m );
-        if ( tx_queue_m.empty() )
+
+        // Only the entries whose proofs are all done leave the queue, so transactions are published in nonce order
+        std::vector<QueuedTransaction> ready_items;
+        std::vector<QueuedTransaction> failed_items;
+        while ( !tx_queue_m.empty() )
         {
+            auto &queued         = tx_queue_m.front();
+            bool  proofs_pending = std::any_of(
+                queued.proofs.begin(),
+                queued.proofs.end(),
+                []( const ProofFuture &proof )
+                { return proof.valid() && proof.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready; } );
+            if ( proofs_pending )
+            {
+                break;
+            }
+
+            bool proofs_valid = true;
+            auto &batch       = queued.item.first;
+            for ( std::size_t i = 0; i < queued.proofs.size() && i < batch.size(); ++i )
+            {
+                if ( !queued.proofs[i].valid() )
+                {
+                    continue;
+                }
+                const auto &proof_result = queued.proofs[i].get();
+                if ( proof_result.has_error() )
+                {
+                    m_logger->error( "Proof generation failed for transaction {}: {}",
+                                     batch[i].first->dag_st.data_hash(),
+                                     proof_result.error().message() );
+                    proofs_valid = false;
+                    break;
+                }
+                batch[i].second = proof_result.value();
+            }
+            if ( proofs_valid )
+            {
+                ready_items.push_back( std::move( queued ) );
+            }
+            else
+            {
+                failed_items.push_back( std::move( queued ) );
+            }
+            tx_queue_m.pop_front();
+            tx_queue_depth_m.Sub();
+            if ( !proofs_valid )
+            {
+                // The entries after it are failed with it, see FailTransactions
+                break;
+            }
+        }
+        lock.unlock();
+
+        if ( ready_items.empty() )
+        {
+            if ( !failed_items.empty() )
+            {
+                FailTransactions( std::move( failed_items ) );
+            }
             return outcome::success();
         }
+        base::ScopedTimer send_timer( tx_send_duration_m );
 
-        auto [transaction_batch, maybe_crdt_transaction] = tx_queue_m.front();
-        tx_queue_m.pop_front();
-        lock.unlock();
-        std::shared_ptr<crdt::AtomicTransaction> crdt_transaction = nullptr;
+        // Batches without an AtomicTransaction of their own are merged into a shared commit. Batches that bring
+        // one are committed on their own, flushing the merged ones first so the queue order is kept.
+        outcome::result<void>            send_result = outcome::success();
+        std::vector<QueuedTransaction *> merged_items;
+        std::size_t                      merged_size = 0;
+
+        // Once a batch fails, the ones after it hold the following nonces and are failed without a commit
+        std::vector<QueuedTransaction> commit_failed_items;
+
+        auto commit_alone = [&]( QueuedTransaction &queued, std::shared_ptr<crdt::AtomicTransaction> crdt_transaction )
+        {
+            if ( !commit_failed_items.empty() )
+            {
+                commit_failed_items.push_back( std::move( queued ) );
+                return;
+            }
+            auto commit_result = CommitTransactionBatch( queued.item.first, std::move( crdt_transaction ) );
+            if ( commit_result.has_error() )
+            {
+                m_logger->error( "Failed to commit a batch of {} transactions: {}",
+                                 queued.item.first.size(),
+                                 commit_result.error().message() );
+                commit_failed_items.push_back( std::move( queued ) );
+                send_result = commit_result;
+            }
+        };
+
+        auto flush_merged = [&]()
+        {
+            if ( merged_items.size() > 1 && commit_failed_items.empty() )
+            {
+                TransactionBatch merged_batch;
+                merged_batch.reserve( merged_size );
+                for ( auto *queued : merged_items )
+                {
+                    merged_batch.insert( merged_batch.end(), queued->item.first.begin(), queued->item.first.end() );
+                }
+                if ( CommitTransactionBatch( merged_batch, globaldb_m->BeginTransaction() ).has_value() )
+                {
+                    merged_items.clear();
+                    merged_size = 0;
+                    return;
+                }
+                // One bad batch must not take the others down with it
+                m_logger->warn( "Failed to commit {} merged transactions, committing their batches one by one",
+                                merged_batch.size() );
+            }
+            for ( auto *queued : merged_items )
+            {
+                commit_alone( *queued, globaldb_m->BeginTransaction() );
+            }
+            merged_items.clear();
+            merged_size = 0;
+        };
+
+        for ( auto &queued : ready_items )
+        {
+            auto &[transaction_batch, maybe_crdt_transaction] = queued.item;
+            if ( maybe_crdt_transaction.has_value() && maybe_crdt_transaction.value() )
+            {
+                flush_merged();
+                commit_alone( queued, std::move( maybe_crdt_transaction.value() ) );
+                continue;
+            }
+            if ( merged_size + transaction_batch.size() > MAX_TRANSACTIONS_PER_COMMIT )
+            {
+                flush_merged();
+            }
+            merged_items.push_back( &queued );
+            merged_size += transaction_batch.size();
+        }
+        flush_merged();
 
-        if ( maybe_crdt_transaction.has_value() && maybe_crdt_transaction.value() )
+        for ( auto &queued : failed_items )
         {
-            crdt_transaction = std::move( maybe_crdt_transaction.value() );
+            commit_failed_items.push_back( std::move( queued ) );
         }
-        else
+        if ( !commit_failed_items.empty() )
         {
-            crdt_transaction = globaldb_m->BeginTransaction();
+            FailTransactions( std::move( commit_failed_items ) );
         }
+
+        return send_result;
+    }
+
+    outcome::result<void> TransactionManager::CommitTransactionBatch(
+        const TransactionBatch                  &transaction_batch,
+        std::shared_ptr<crdt::AtomicTransaction> crdt_transaction )
+    {
         for ( auto &transaction_pair : transaction_batch )
         {
             auto [transaction, maybe_proof] = transaction_pair;
@@ -494,19 +794,78 @@ namespace sgns
             }
         }
 
-        std::set<std::string> topicSet;
-        for ( auto &transaction_pair : transaction_batch )
+        // Parsing gives the topics and the UTXO changes of the batch. They are applied once the batch is published,
+        // so the commit's storage and broadcast I/O runs without the account lock.
+        std::set<std::string>      topicSet;
+        std::vector<GeniusUTXO>    created_utxos;
+        std::vector<InputUTXOInfo> spent_utxos;
         {
-            OUTCOME_TRY( auto &&parsedTopics, ParseTransaction( transaction_pair.first ) );
-            topicSet.insert( parsedTopics.begin(), parsedTopics.end() );
+            std::lock_guard account_lock( account_mutex_m );
+            auto            previous_utxos = account_m->utxos;
+            for ( auto &transaction_pair : transaction_batch )
             {
-                std::unique_lock<std::shared_mutex> out_lock( outgoing_tx_mutex_m );
-                outgoing_tx_processed_m[GetTransactionPath( *transaction_pair.first )] = transaction_pair.first;
+                auto parse_result = ParseTransaction( transaction_pair.first );
+                if ( parse_result.has_error() )
+                {
+                    account_m->utxos = std::move( previous_utxos );
+                    return parse_result.error();
+                }
+                topicSet.insert( parse_result.value().begin(), parse_result.value().end() );
             }
+
+            auto contains = []( const std::vector<GeniusUTXO> &utxos, const GeniusUTXO &utxo )
+            {
+                return std::any_of( utxos.begin(),
+                                    utxos.end(),
+                                    [&utxo]( const GeniusUTXO &other )
+                                    {
+                                        return other.GetTxID() == utxo.GetTxID() &&
+                                               other.GetOutputIdx() == utxo.GetOutputIdx();
+                                    } );
+            };
+            for ( const auto &utxo : account_m->utxos )
+            {
+                if ( !contains( previous_utxos, utxo ) )
+                {
+                    created_utxos.push_back( utxo );
+                }
+            }
+            for ( const auto &utxo : previous_utxos )
+            {
+                if ( !contains( account_m->utxos, utxo ) )
+                {
+                    spent_utxos.push_back( { utxo.GetTxID(), utxo.GetOutputIdx(), "" } );
+                }
+            }
+            // The spent UTXOs stay locked until then, and the created ones aren't spendable yet
+            account_m->utxos = std::move( previous_utxos );
         }
 
         BOOST_OUTCOME_TRYV2( auto &&, crdt_transaction->Commit( topicSet ) );
 
+        {
+            std::lock_guard account_lock( account_mutex_m );
+            account_m->RefreshUTXOs( spent_utxos );
+            for ( const auto &utxo : created_utxos )
+            {
+                account_m->PutUTXO( utxo );
+            }
+            for ( const auto &transaction_pair : transaction_batch )
+            {
+                MarkTransactionProcessed( transaction_pair.first->GetSrcAddress(),
+                                          transaction_pair.first->dag_st.nonce() );
+            }
+        }
+
+        {
+            std::unique_lock<std::shared_mutex> out_lock( outgoing_tx_mutex_m );
+            for ( auto &transaction_pair : transaction_batch )
+            {
+                outgoing_tx_processed_m[GetTransactionPath( *transaction_pair.first )] = transaction_pair.first;
+            }
+        }
+        snapshot_dirty_m = true;
+
         return outcome::success();
     }
 
@@ -706,11 +1065,22 @@ namespace sgns
                 m_logger->debug( "Unable to convert a key to string" );
                 continue;
             }
-            if ( incoming_tx_processed_m.find( transaction_key.value() ) != incoming_tx_processed_m.end() )
+            auto maybe_source = ParseTransactionKey( transaction_key.value() );
+            if ( !maybe_source )
             {
-                m_logger->trace( "Transaction already processed: " + transaction_key.value() );
+                m_logger->debug( "Not a transaction key: " + transaction_key.value() );
                 continue;
             }
+            const auto &[source, nonce] = maybe_source.value();
+            {
+                // Checked on the key, so the transactions covered by the cursors are never fetched again
+                std::lock_guard account_lock( account_mutex_m );
+                if ( IsTransactionProcessed( source, nonce ) )
+                {
+                    m_logger->trace( "Transaction already processed: " + transaction_key.value() );
+                    continue;
+                }
+            }
 
             m_logger->debug( "Finding incoming transaction: {}", transaction_key.value() );
             auto maybe_transaction = FetchTransaction( globaldb_m, transaction_key.value() );
@@ -720,11 +1090,15 @@ namespace sgns
                 continue;
             }
 
-            auto maybe_parsed = ParseTransaction( maybe_transaction.value() );
-            if ( maybe_parsed.has_error() )
             {
-                m_logger->debug( "Can't parse the transaction" );
-                continue;
+                std::lock_guard account_lock( account_mutex_m );
+                auto            maybe_parsed = ParseTransaction( maybe_transaction.value() );
+                if ( maybe_parsed.has_error() )
+                {
+                    m_logger->debug( "Can't parse the transaction" );
+                    continue;
+                }
+                MarkTransactionProcessed( source, nonce );
             }
 
             {
@@ -732,6 +1106,7 @@ namespace sgns
                 std::unique_lock<std::shared_mutex> out_lock( incoming_tx_mutex_m );
                 incoming_tx_processed_m[transaction_key.value()] = maybe_transaction.value();
             }
+            snapshot_dirty_m = true;
         }
         return outcome::success();
     }
@@ -753,11 +1128,21 @@ namespace sgns
                 m_logger->debug( "Unable to convert a key to string" );
                 continue;
             }
-            if ( outgoing_tx_processed_m.find( transaction_key.value() ) != outgoing_tx_processed_m.end() )
+            auto maybe_source = ParseTransactionKey( transaction_key.value() );
+            if ( !maybe_source )
             {
-                m_logger->trace( "Transaction already processed: " + transaction_key.value() );
+                m_logger->debug( "Not a transaction key: " + transaction_key.value() );
                 continue;
             }
+            const auto &[source, nonce] = maybe_source.value();
+            {
+                std::lock_guard account_lock( account_mutex_m );
+                if ( IsTransactionProcessed( source, nonce ) )
+                {
+                    m_logger->trace( "Transaction already processed: " + transaction_key.value() );
+                    continue;
+                }
+            }
 
             auto maybe_transaction = FetchTransaction( globaldb_m, transaction_key.value() );
             if ( !maybe_transaction.has_value() )
@@ -766,24 +1151,231 @@ namespace sgns
                 continue;
             }
             m_logger->debug( "Transaction fetched on " + transaction_key.value() );
-            auto maybe_parsed = ParseTransaction( maybe_transaction.value() );
-            if ( maybe_parsed.has_error() )
             {
-                m_logger->debug( "Can't parse the transaction" );
-                continue;
-            }
-            m_logger->debug( "Transaction parsed " + transaction_key.value() );
+                std::lock_guard account_lock( account_mutex_m );
+                auto            maybe_parsed = ParseTransaction( maybe_transaction.value() );
+                if ( maybe_parsed.has_error() )
+                {
+                    m_logger->debug( "Can't parse the transaction" );
+                    continue;
+                }
+                m_logger->debug( "Transaction parsed " + transaction_key.value() );
 
-            account_m->nonce = std::max( account_m->nonce, maybe_transaction.value()->dag_st.nonce() );
+                account_m->nonce = std::max( account_m->nonce, maybe_transaction.value()->dag_st.nonce() );
+                MarkTransactionProcessed( source, nonce );
+            }
             {
                 m_logger->trace( "Inserting into outgoing {}", transaction_key.value() );
                 std::unique_lock<std::shared_mutex> out_lock( outgoing_tx_mutex_m );
                 outgoing_tx_processed_m[transaction_key.value()] = maybe_transaction.value();
             }
+            snapshot_dirty_m = true;
         }
         return outcome::success();
     }
 
+    std::string TransactionManager::GetSnapshotKey() const
+    {
+        boost::format snapshot_key{ std::string( SNAPSHOT_KEY_FORMAT ) };
+
+        snapshot_key % account_m->GetAddress();
+        return snapshot_key.str();
+    }
+
+    std::optional<std::pair<std::string, uint64_t>> TransactionManager::ParseTransactionKey(
+        const std::string &transaction_key )
+    {
+        auto tx_pos    = transaction_key.find( "/tx/" );
+        auto nonce_pos = transaction_key.rfind( '/' );
+        if ( tx_pos == std::string::npos || tx_pos == 0 || nonce_pos <= tx_pos + 3 )
+        {
+            return std::nullopt;
+        }
+        auto source_pos = transaction_key.rfind( '/', tx_pos - 1 );
+        source_pos      = ( source_pos == std::string::npos ) ? 0 : source_pos + 1;
+
+        uint64_t    nonce     = 0;
+        const char *nonce_end = transaction_key.data() + transaction_key.size();
+        auto [ptr, ec]        = std::from_chars( transaction_key.data() + nonce_pos + 1, nonce_end, nonce );
+        if ( ec != std::errc() || ptr != nonce_end )
+        {
+            return std::nullopt;
+        }
+        return std::make_pair( transaction_key.substr( source_pos, tx_pos - source_pos ), nonce );
+    }
+
+    bool TransactionManager::IsTransactionProcessed( const std::string &source, uint64_t nonce ) const
+    {
+        auto it = tx_cursors_m.find( source );
+        if ( it == tx_cursors_m.end() )
+        {
+            return false;
+        }
+        return nonce <= it->second.nonce || it->second.ahead.count( nonce ) != 0;
+    }
+
+    void TransactionManager::MarkTransactionProcessed( const std::string &source, uint64_t nonce )
+    {
+        auto &cursor = tx_cursors_m[source];
+        if ( nonce <= cursor.nonce )
+        {
+            return;
+        }
+        cursor.ahead.insert( nonce );
+        // Only the nonces after a gap are kept, so the cursors stay small however long the history is
+        while ( !cursor.ahead.empty() && *cursor.ahead.begin() == cursor.nonce + 1 )
+        {
+            cursor.nonce = *cursor.ahead.begin();
+            cursor.ahead.erase( cursor.ahead.begin() );
+        }
+    }
+
+    outcome::result<bool> TransactionManager::SaveSnapshot()
+    {
+        // Outgoing transactions update the UTXOs before they are committed. Holding the send and account locks
+        // and requiring an empty queue makes sure every UTXO change in the snapshot has its transaction in it.
+        std::unique_lock send_lock( send_mutex_m, std::try_to_lock );
+        if ( !send_lock.owns_lock() )
+        {
+            return false;
+        }
+
+        SGTransaction::AccountSnapshot snapshot;
+        {
+            std::lock_guard account_lock( account_mutex_m );
+            {
+                std::lock_guard queue_lock( mutex_m );
+                if ( !tx_queue_m.empty() )
+                {
+                    return false;
+                }
+            }
+            // Cleared before the state is read, so a change made while the snapshot is written marks it again
+            snapshot_dirty_m = false;
+
+            snapshot.set_version( SNAPSHOT_VERSION );
+            snapshot.set_address( account_m->GetAddress() );
+            snapshot.set_nonce( account_m->nonce );
+            for ( const auto &utxo : account_m->utxos )
+            {
+                auto *utxo_entry = snapshot.add_utxos();
+                auto  tx_id      = utxo.GetTxID();
+                auto  token_id   = utxo.GetTokenID();
+                utxo_entry->set_tx_id_hash( tx_id.data(), tx_id.size() );
+                utxo_entry->set_output_index( utxo.GetOutputIdx() );
+                utxo_entry->set_amount( utxo.GetAmount() );
+                utxo_entry->set_locked( utxo.GetLock() );
+                utxo_entry->set_token_id( token_id.bytes().data(), token_id.size() );
+            }
+            // The transactions themselves stay in the CRDT, the cursors only tell the scans where to resume
+            for ( const auto &[source, cursor] : tx_cursors_m )
+            {
+                auto *cursor_entry = snapshot.add_cursors();
+                cursor_entry->set_source( source );
+                cursor_entry->set_nonce( cursor.nonce );
+                for ( auto nonce : cursor.ahead )
+                {
+                    cursor_entry->add_ahead( nonce );
+                }
+            }
+        }
+
+        SGTransaction::AccountSnapshotEnvelope envelope;
+        envelope.set_snapshot( snapshot.SerializeAsString() );
+        auto checksum = hasher_m->sha2_256(
+            gsl::span<const uint8_t>( reinterpret_cast<const uint8_t *>( envelope.snapshot().data() ),
+                                      envelope.snapshot().size() ) );
+        envelope.set_checksum( checksum.data(), checksum.size() );
+
+        crdt::GlobalDB::Buffer snapshot_key;
+        crdt::GlobalDB::Buffer snapshot_buffer;
+        snapshot_key.put( GetSnapshotKey() );
+        snapshot_buffer.put( envelope.SerializeAsString() );
+        auto put_result = globaldb_m->GetDataStore()->put( snapshot_key, std::move( snapshot_buffer ) );
+        if ( put_result.has_error() )
+        {
+            // Retried on the next update
+            snapshot_dirty_m = true;
+            return outcome::failure( put_result.error() );
+        }
+
+        last_snapshot_m = std::chrono::steady_clock::now();
+        m_logger->debug( "Account snapshot saved with {} UTXOs and {} cursors",
+                         snapshot.utxos_size(),
+                         snapshot.cursors_size() );
+        return true;
+    }
+
+    outcome::result<void> TransactionManager::LoadSnapshot()
+    {
+        crdt::GlobalDB::Buffer snapshot_key;
+        snapshot_key.put( GetSnapshotKey() );
+        OUTCOME_TRY( auto &&snapshot_buffer, globaldb_m->GetDataStore()->get( snapshot_key ) );
+
+        SGTransaction::AccountSnapshotEnvelope envelope;
+        if ( !envelope.ParseFromArray( snapshot_buffer.data(), static_cast<int>( snapshot_buffer.size() ) ) )
+        {
+            m_logger->error( "Invalid account snapshot envelope" );
+            return outcome::failure( boost::system::error_code{} );
+        }
+        auto checksum = hasher_m->sha2_256(
+            gsl::span<const uint8_t>( reinterpret_cast<const uint8_t *>( envelope.snapshot().data() ),
+                                      envelope.snapshot().size() ) );
+        if ( envelope.checksum() != std::string( checksum.begin(), checksum.end() ) )
+        {
+            m_logger->error( "Account snapshot checksum mismatch" );
+            return outcome::failure( boost::system::error_code{} );
+        }
+
+        SGTransaction::AccountSnapshot snapshot;
+        if ( !snapshot.ParseFromString( envelope.snapshot() ) )
+        {
+            m_logger->error( "Invalid account snapshot" );
+            return outcome::failure( boost::system::error_code{} );
+        }
+        if ( snapshot.version() != SNAPSHOT_VERSION || snapshot.address() != account_m->GetAddress() )
+        {
+            m_logger->info( "Discarding account snapshot version {}", snapshot.version() );
+            return outcome::failure( boost::system::error_code{} );
+        }
+
+        std::vector<GeniusUTXO> utxos;
+        utxos.reserve( snapshot.utxos_size() );
+        for ( const auto &utxo_entry : snapshot.utxos() )
+        {
+            OUTCOME_TRY( auto &&tx_id,
+                         base::Hash256::fromSpan( gsl::span<const uint8_t>(
+                             reinterpret_cast<const uint8_t *>( utxo_entry.tx_id_hash().data() ),
+                             utxo_entry.tx_id_hash().size() ) ) );
+            GeniusUTXO utxo( tx_id,
+                             utxo_entry.output_index(),
+                             utxo_entry.amount(),
+                             TokenID::FromBytes( utxo_entry.token_id().data(), utxo_entry.token_id().size() ) );
+            utxo.ToggleLock( utxo_entry.locked() );
+            utxos.push_back( std::move( utxo ) );
+        }
+
+        std::map<std::string, NonceCursor> cursors;
+        for ( const auto &cursor_entry : snapshot.cursors() )
+        {
+            auto &cursor = cursors[cursor_entry.source()];
+            cursor.nonce = cursor_entry.nonce();
+            cursor.ahead.insert( cursor_entry.ahead().begin(), cursor_entry.ahead().end() );
+        }
+
+        {
+            std::lock_guard account_lock( account_mutex_m );
+            account_m->utxos = std::move( utxos );
+            account_m->nonce = std::max( account_m->nonce, snapshot.nonce() );
+            tx_cursors_m     = std::move( cursors );
+        }
+
+        m_logger->info( "Account state restored from snapshot with {} UTXOs and {} cursors",
+                        snapshot.utxos_size(),
+                        snapshot.cursors_size() );
+        return outcome::success();
+    }
+
     outcome::result<std::set<std::string>> TransactionManager::ParseTransferTransaction(
         const std::shared_ptr<IGeniusTransactions> &tx )
     {
@@ -985,6 +1577,11 @@ namespace sgns
             // Check in outgoing transactions with the exact path
             {
                 std::shared_lock<std::shared_mutex> out_lock( outgoing_tx_mutex_m );
+                if ( failed_outgoing_tx_m.count( txId ) != 0 )
+                {
+                    m_logger->error( "Outgoing transaction {} failed and won't be published", txId );
+                    return false;
+                }
                 for ( auto tx : outgoing_tx_processed_m )
                 {
                     if ( tx.second->dag_st.data_hash() == txId )
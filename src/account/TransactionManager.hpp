@@ -8,11 +8,15 @@
 #define _TRANSACTION_MANAGER_HPP_
 
 #include <memory>
+#include <atomic>
+#include <chrono>
 #include <deque>
+#include <future>
 #include <cstdint>
 #include <map>
 #include <unordered_map>
 #include <set>
+#include <optional>
 
 #include <boost/format.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
@@ -28,10 +32,12 @@
 #include "account/ProcessingTransaction.hpp"
 #include "account/GeniusAccount.hpp"
 #include "base/logger.hpp"
+#include "base/metrics.hpp"
 #include "base/buffer.hpp"
 #include "crypto/hasher.hpp"
 #ifdef _PROOF_ENABLED
 #include "proof/proto/SGProof.pb.h"
+#include "proof/ProofGenerator.hpp"
 #endif
 #include "processing/proto/SGProcessing.pb.h"
 #include "outcome/outcome.hpp"
@@ -64,6 +70,7 @@ namespace sgns
 
         const GeniusAccount &GetAccount() const;
 
+        /// Transactions processed since startup, the ones covered by a restored snapshot are only kept in the CRDT
         std::vector<std::vector<uint8_t>> GetOutTransactions() const;
         std::vector<std::vector<uint8_t>> GetInTransactions() const;
 
@@ -98,19 +105,77 @@ namespace sgns
 
     protected:
         friend class GeniusNode;
+        friend class TransactionSyncTest;
         void EnqueueTransaction( TransactionPair element );
         void EnqueueTransaction( TransactionItem element );
 
     private:
         static constexpr std::string_view TRANSACTION_BASE_FORMAT = "/bc-%hu/";
 
+        using ProofFuture = std::shared_future<outcome::result<std::vector<uint8_t>>>;
+
+        /// Entry of the outgoing queue, held back until all of its proofs are generated
+        struct QueuedTransaction
+        {
+            TransactionItem            item;
+            std::vector<ProofFuture>   proofs;       ///< Pending proof of each batch entry, invalid when already set
+            std::vector<InputUTXOInfo> locked_utxos; ///< UTXOs locked for the entry, unlocked if it is never published
+        };
+
+        /// Transactions of a source address already applied to the account, tracked by nonce
+        struct NonceCursor
+        {
+            uint64_t           nonce = 0; ///< Every transaction up to this nonce is processed
+            std::set<uint64_t> ahead;     ///< Processed nonces after a gap
+        };
+
         // Parser function pointer alias: returns a set of topic strings or an error
         using TransactionParserFn = outcome::result<std::set<std::string>> ( TransactionManager::* )(
             const std::shared_ptr<IGeniusTransactions> & );
 
+        /// Upper bound of transactions merged into a single CRDT commit
+        static constexpr std::size_t MAX_TRANSACTIONS_PER_COMMIT = 64;
+
+        static constexpr std::uint32_t             SNAPSHOT_VERSION    = 2;
+        static constexpr std::string_view          SNAPSHOT_KEY_FORMAT = "/snapshot/account/%s";
+        static constexpr std::chrono::milliseconds SNAPSHOT_INTERVAL{ 30000 }; ///< Minimum time between snapshots
+
         void                     Update();
         SGTransaction::DAGStruct FillDAGStruct( std::string transaction_hash = "" ) const;
         outcome::result<void>    SendTransaction();
+        /**
+         * @brief       Commits a batch and applies it to the account, the account is left untouched on failure
+         * @param[in]   transaction_batch The transactions with their proofs
+         * @param[in]   crdt_transaction The CRDT transaction the batch is written to
+         * @return      Error if a transaction can't be parsed or the commit fails
+         */
+        outcome::result<void> CommitTransactionBatch( const TransactionBatch                  &transaction_batch,
+                                                      std::shared_ptr<crdt::AtomicTransaction> crdt_transaction );
+        void                     ScheduleSend();
+        void                     EnqueueTransaction( TransactionItem            element,
+                                                     std::vector<ProofFuture>   proofs,
+                                                     std::vector<InputUTXOInfo> locked_utxos = {} );
+        /**
+         * @brief       Locks the UTXOs spent by a transaction, called with the account lock held
+         * @param[in]   params Parameters of the transaction
+         * @return      The UTXOs that were locked by this call
+         */
+        std::vector<InputUTXOInfo> LockUTXOs( const UTXOTxParameters &params );
+        /**
+         * @brief       Undoes the account changes of queued entries that won't be published, along with every
+         *              entry still queued after them, and reports their transactions as failed to
+         *              @ref WaitForTransactionOutgoing
+         * @param[in]   failed The failed entries, taken out of the queue
+         */
+        void FailTransactions( std::vector<QueuedTransaction> failed );
+#ifdef _PROOF_ENABLED
+        /**
+         * @brief       Queues a proof without blocking, called with the account lock held
+         * @param[in]   prover The proof to generate
+         * @return      Future of the proof, or resource_unavailable_try_again if the proof queue is full
+         */
+        outcome::result<ProofFuture> SubmitProof( std::unique_ptr<IBasicProof> prover );
+#endif
 
         static std::string GetTransactionBasePath( const std::string &address );
         static std::string GetBlockChainBase();
@@ -127,6 +192,34 @@ namespace sgns
 
         outcome::result<void> CheckOutgoing();
 
+        /**
+         * @brief       Persists the derived account state and the scan cursors in the local datastore
+         * @return      True if written, false if skipped because outgoing transactions are in flight
+         */
+        outcome::result<bool> SaveSnapshot();
+        /**
+         * @brief       Restores the account state saved by @ref SaveSnapshot
+         * @return      Error if there is no valid snapshot, in which case nothing is changed
+         */
+        outcome::result<void> LoadSnapshot();
+        std::string           GetSnapshotKey() const;
+
+        /**
+         * @brief       Splits a transaction key into its source address and nonce
+         * @param[in]   transaction_key Key of the transaction, <base><address>/tx/<type>/<nonce>
+         * @return      The source address and the nonce, or nothing if the key isn't a transaction key
+         */
+        static std::optional<std::pair<std::string, uint64_t>> ParseTransactionKey(
+            const std::string &transaction_key );
+        /**
+         * @brief       Checks whether a transaction was applied, called with the account lock held
+         */
+        bool IsTransactionProcessed( const std::string &source, uint64_t nonce ) const;
+        /**
+         * @brief       Records an applied transaction, called with the account lock held
+         */
+        void MarkTransactionProcessed( const std::string &source, uint64_t nonce );
+
         std::shared_ptr<crdt::GlobalDB> globaldb_m;
 
         std::shared_ptr<boost::asio::io_context>   ctx_m;
@@ -137,14 +230,32 @@ namespace sgns
         std::string                                full_node_topic_m; ///< formatted full-node topic
 
         // for the SendTransaction thread support
-        mutable std::mutex          mutex_m;
-        std::deque<TransactionItem> tx_queue_m;
+        std::mutex                    account_mutex_m; ///< Guards the account UTXOs and nonce, taken before mutex_m
+        mutable std::mutex            mutex_m;
+        std::deque<QueuedTransaction> tx_queue_m;
+        std::mutex                    send_mutex_m; ///< Keeps the commits in queue order
+
+        base::Gauge &tx_queue_depth_m = base::MetricsRegistry::Instance().GetGauge(
+            "transaction_queue_depth",
+            "Transactions waiting to be committed" );
+        base::Histogram &tx_send_duration_m = base::MetricsRegistry::Instance().GetHistogram(
+            "transaction_send_duration_us",
+            "Time to commit the ready transactions, in microseconds" );
+        std::atomic<bool>             started_m{ false };
+        std::atomic<bool>             send_scheduled_m{ false }; ///< A send is already posted to the context
+#ifdef _PROOF_ENABLED
+        std::shared_ptr<ProofGenerator> proof_generator_m; ///< Generates the proofs off the caller's thread
+#endif
 
         mutable std::shared_mutex                                   outgoing_tx_mutex_m;
         std::map<std::string, std::shared_ptr<IGeniusTransactions>> outgoing_tx_processed_m;
+        std::set<std::string>                                       failed_outgoing_tx_m; ///< Hashes never published
         mutable std::shared_mutex                                   incoming_tx_mutex_m;
         std::map<std::string, std::shared_ptr<IGeniusTransactions>> incoming_tx_processed_m;
+        std::map<std::string, NonceCursor> tx_cursors_m; ///< Processed transactions per source, under account_mutex_m
         std::function<void()>                                       task_m;
+        std::atomic<bool>                     snapshot_dirty_m{ false }; ///< State changed since the last snapshot
+        std::chrono::steady_clock::time_point last_snapshot_m;
 
         outcome::result<std::set<std::string>> ParseTransferTransaction(
             const std::shared_ptr<IGeniusTransactions> &tx );
@@ -0,0 +1,140 @@
+/**
+ * @file       TransactionSignatureVerifier.cpp
+ * @brief      Verification of transaction signatures with a cache of public keys
+ * @date       2026-10-18
+ */
+#include "account/TransactionSignatureVerifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+#include <nil/crypto3/algebra/marshalling.hpp>
+#include <nil/crypto3/pubkey/algorithm/verify.hpp>
+
+namespace sgns
+{
+    TransactionSignatureVerifier::TransactionSignatureVerifier( size_t key_cache_size ) :
+        key_cache_size_( std::max<size_t>( key_cache_size, 1 ) )
+    {
+    }
+
+    TransactionSignatureVerifier &TransactionSignatureVerifier::Instance()
+    {
+        static TransactionSignatureVerifier verifier;
+        return verifier;
+    }
+
+    bool TransactionSignatureVerifier::Verify( const SGTransaction::DAGStruct &dag_st )
+    {
+        const size_t SIGNATURE_EXP_SIZE = 64;
+        const auto  &str_signature      = dag_st.signature();
+        if ( str_signature.size() != SIGNATURE_EXP_SIZE )
+        {
+            return false;
+        }
+        std::vector<uint8_t> vec_sig( str_signature.cbegin(), str_signature.cend() );
+
+        // the signature covers the DAG struct without it
+        SGTransaction::DAGStruct unsigned_dag( dag_st );
+        unsigned_dag.clear_signature();
+        auto                 size = unsigned_dag.ByteSizeLong();
+        std::vector<uint8_t> serialized( size );
+        unsigned_dag.SerializeToArray( serialized.data(), size );
+
+        std::array<uint8_t, 32> hashed = nil::crypto3::hash<nil::crypto3::hashes::sha2<256>>( serialized );
+
+        auto [r_success, r] = nil::marshalling::bincode::field<ecdsa_t::scalar_field_type>::field_element_from_bytes(
+            vec_sig.cbegin(),
+            vec_sig.cbegin() + 32 );
+        if ( !r_success )
+        {
+            return false;
+        }
+        auto [s_success, s] = nil::marshalling::bincode::field<ecdsa_t::scalar_field_type>::field_element_from_bytes(
+            vec_sig.cbegin() + 32,
+            vec_sig.cbegin() + 64 );
+        if ( !s_success )
+        {
+            return false;
+        }
+        ethereum::signature_type sig( r, s );
+        auto                     eth_pubkey = GetPublicKey( dag_st.source_addr() );
+        return nil::crypto3::verify( hashed, sig, *eth_pubkey );
+    }
+
+    std::vector<bool> TransactionSignatureVerifier::VerifyBatch( const std::vector<SGTransaction::DAGStruct> &dags )
+    {
+        std::vector<uint8_t> results( dags.size(), 0 );
+
+        size_t thread_count = std::min<size_t>( std::max( std::thread::hardware_concurrency(), 1u ),
+                                                dags.size() / MIN_BATCH_PER_THREAD );
+        if ( thread_count <= 1 )
+        {
+            for ( size_t i = 0; i < dags.size(); ++i )
+            {
+                results[i] = Verify( dags[i] );
+            }
+        }
+        else
+        {
+            // interleaved, so each thread gets a similar share of the already cached keys
+            std::vector<std::thread> threads;
+            threads.reserve( thread_count );
+            for ( size_t t = 0; t < thread_count; ++t )
+            {
+                threads.emplace_back(
+                    [this, &dags, &results, t, thread_count]()
+                    {
+                        for ( size_t i = t; i < dags.size(); i += thread_count )
+                        {
+                            results[i] = Verify( dags[i] );
+                        }
+                    } );
+            }
+            for ( auto &thread : threads )
+            {
+                thread.join();
+            }
+        }
+        return std::vector<bool>( results.begin(), results.end() );
+    }
+
+    TransactionSignatureVerifier::Stats TransactionSignatureVerifier::GetStats() const
+    {
+        std::lock_guard lock( mutex_ );
+        return stats_;
+    }
+
+    std::shared_ptr<const TransactionSignatureVerifier::PublicKey> TransactionSignatureVerifier::GetPublicKey(
+        const std::string &address )
+    {
+        {
+            std::lock_guard lock( mutex_ );
+            auto            it = key_index_.find( address );
+            if ( it != key_index_.end() )
+            {
+                key_cache_.splice( key_cache_.begin(), key_cache_, it->second );
+                ++stats_.key_cache_hits;
+                return it->second->second;
+            }
+            ++stats_.key_cache_misses;
+        }
+
+        // built outside of the lock, two threads missing the same address just build it twice
+        auto key = std::make_shared<const PublicKey>( ethereum::EthereumKeyGenerator::BuildPublicKey( address ) );
+
+        std::lock_guard lock( mutex_ );
+        if ( key_index_.find( address ) == key_index_.end() )
+        {
+            key_cache_.emplace_front( address, key );
+            key_index_.emplace( address, key_cache_.begin() );
+            if ( key_cache_.size() > key_cache_size_ )
+            {
+                key_index_.erase( key_cache_.back().first );
+                key_cache_.pop_back();
+            }
+        }
+        return key;
+    }
+}
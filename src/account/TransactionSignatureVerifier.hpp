@@ -0,0 +1,86 @@
+/**
+ * @file       TransactionSignatureVerifier.hpp
+ * @brief      Verification of transaction signatures with a cache of public keys
+ * @date       2026-10-18
+ */
+#ifndef _TRANSACTION_SIGNATURE_VERIFIER_HPP_
+#define _TRANSACTION_SIGNATURE_VERIFIER_HPP_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ProofSystem/EthereumKeyGenerator.hpp>
+
+#include "account/proto/SGTransaction.pb.h"
+
+namespace sgns
+{
+    /**
+     * @brief       Verifies the signature of transactions' DAG structs.
+     *              Building the public key of a source address is a large share of a verification,
+     *              and the same addresses sign most of the transactions, so the keys are kept in an LRU cache.
+     */
+    class TransactionSignatureVerifier
+    {
+    public:
+        using PublicKey = decltype( ethereum::EthereumKeyGenerator::BuildPublicKey( std::declval<std::string>() ) );
+
+        static constexpr size_t DEFAULT_KEY_CACHE_SIZE = 4096;
+        static constexpr size_t MIN_BATCH_PER_THREAD   = 8;
+
+        struct Stats
+        {
+            uint64_t key_cache_hits   = 0;
+            uint64_t key_cache_misses = 0;
+        };
+
+        /**
+         * @brief       Construct a new verifier
+         * @param[in]   key_cache_size Number of public keys kept
+         */
+        explicit TransactionSignatureVerifier( size_t key_cache_size = DEFAULT_KEY_CACHE_SIZE );
+
+        /**
+         * @brief       Verifier shared by the whole process
+         */
+        static TransactionSignatureVerifier &Instance();
+
+        /**
+         * @brief       Verifies the signature of a DAG struct against its source address
+         * @param[in]   dag_st The DAG struct, with its signature
+         * @return      true if the signature is valid, false otherwise
+         */
+        bool Verify( const SGTransaction::DAGStruct &dag_st );
+
+        /**
+         * @brief       Verifies several DAG structs, spread over the available cores
+         * @param[in]   dags The DAG structs, with their signatures
+         * @return      The validity of each signature, in the order of @p dags
+         */
+        std::vector<bool> VerifyBatch( const std::vector<SGTransaction::DAGStruct> &dags );
+
+        Stats GetStats() const;
+
+    private:
+        using KeyCacheList = std::list<std::pair<std::string, std::shared_ptr<const PublicKey>>>;
+
+        /**
+         * @brief       Gets the public key of an address from the cache, building it on a miss
+         */
+        std::shared_ptr<const PublicKey> GetPublicKey( const std::string &address );
+
+        const size_t                                            key_cache_size_;
+        mutable std::mutex                                      mutex_;
+        KeyCacheList                                            key_cache_; ///< Most recently used first
+        std::unordered_map<std::string, KeyCacheList::iterator> key_index_;
+        Stats                                                   stats_;
+    };
+}
+
+#endif
@@ -65,6 +65,21 @@ namespace sgns::application
         */
         [[nodiscard]] virtual bool is_only_finalizing() const = 0;
 
+        /**
+        * @return number of finalized states kept in the trie storage, 0 keeps every state.
+        */
+        [[nodiscard]] virtual uint32_t state_pruning() const = 0;
+
+        /**
+        * @return memory budget of the decoded trie node cache in MiB, 0 disables it.
+        */
+        [[nodiscard]] virtual uint32_t trie_node_cache_size() const = 0;
+
+        /**
+        * @return local port serving the metrics in the Prometheus text format, 0 disables it.
+        */
+        [[nodiscard]] virtual uint16_t metrics_port() const = 0;
+
         virtual bool initialize_from_args( LoadScheme scheme, int argc, char **argv ) = 0;
     };
 
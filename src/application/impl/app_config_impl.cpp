@@ -27,6 +27,9 @@ namespace {
   const uint16_t def_p2p_port = 30363;
   const int def_verbosity = 2;
   const bool def_is_only_finalizing = false;
+  const uint32_t def_state_pruning = 0;
+  const uint32_t def_trie_node_cache_size = 32;
+  const uint16_t def_metrics_port = 0;
 }  // namespace
 
 namespace sgns::application {
@@ -39,7 +42,10 @@ namespace sgns::application {
         rpc_ws_port_(def_rpc_ws_port),
         p2p_port_(def_p2p_port),
         verbosity_(static_cast<spdlog::level::level_enum>(def_verbosity)),
-        is_only_finalizing_(def_is_only_finalizing) {}
+        is_only_finalizing_(def_is_only_finalizing),
+        state_pruning_(def_state_pruning),
+        trie_node_cache_size_(def_trie_node_cache_size),
+        metrics_port_(def_metrics_port) {}
 
   AppConfigurationImpl::FilePtr AppConfigurationImpl::open_file(
       const std::string &filepath) {
@@ -85,6 +91,17 @@ namespace sgns::application {
     return false;
   }
 
+  bool AppConfigurationImpl::load_u32(const rapidjson::Value &val,
+                                      char const *name,
+                                      uint32_t &target) {
+    auto m = val.FindMember(name);
+    if (val.MemberEnd() != m && m->value.IsUint()) {
+      target = m->value.GetUint();
+      return true;
+    }
+    return false;
+  }
+
   void AppConfigurationImpl::parse_general_segment(rapidjson::Value &val) {
     uint16_t v{};
     if (load_u16(val, "verbosity", v) && v <= SPDLOG_LEVEL_OFF)
@@ -97,6 +114,8 @@ namespace sgns::application {
 
   void AppConfigurationImpl::parse_storage_segment(rapidjson::Value &val) {
     load_str(val, "rocksdb", rocksdb_path_);
+    load_u32(val, "state_pruning", state_pruning_);
+    load_u32(val, "trie_node_cache_size", trie_node_cache_size_);
   }
 
   void AppConfigurationImpl::parse_authority_segment(rapidjson::Value &val) {
@@ -109,6 +128,7 @@ namespace sgns::application {
     load_u16(val, "rpc_http_port", rpc_http_port_);
     load_str(val, "rpc_ws_host", rpc_ws_host_);
     load_u16(val, "rpc_ws_port", rpc_ws_port_);
+    load_u16(val, "metrics_port", metrics_port_);
   }
 
   void AppConfigurationImpl::parse_additional_segment(rapidjson::Value &val) {
@@ -221,6 +241,8 @@ namespace sgns::application {
     po::options_description storage_desc("Storage options");
     storage_desc.add_options()
         ("rocksdb,l", po::value<std::string>(), "required, rocksdb directory path")
+        ("state_pruning", po::value<uint32_t>(), "number of finalized states kept, 0 (default) keeps every state")
+        ("trie_node_cache_size", po::value<uint32_t>(), "MiB of decoded trie nodes kept in memory, 32 by default, 0 disables the cache")
         ;
 
     po::options_description authority_desc("Authority options");
@@ -235,6 +257,7 @@ namespace sgns::application {
         ("rpc_http_port", po::value<uint16_t>(), "port for RPC over HTTP")
         ("rpc_ws_host", po::value<std::string>(), "address for RPC over Websocket protocol")
         ("rpc_ws_port", po::value<uint16_t>(), "port for RPC over Websocket protocol")
+        ("metrics_port", po::value<uint16_t>(), "local port serving the metrics, 0 (default) disables it")
         ;
 
     po::options_description additional_desc("Additional options");
@@ -290,6 +313,12 @@ namespace sgns::application {
     find_argument<std::string>(
         vm, "rocksdb", [&](std::string const &val) { rocksdb_path_ = val; });
 
+    find_argument<uint32_t>(
+        vm, "state_pruning", [&](uint32_t val) { state_pruning_ = val; });
+
+    find_argument<uint32_t>(
+        vm, "trie_node_cache_size", [&](uint32_t val) { trie_node_cache_size_ = val; });
+
     find_argument<std::string>(
         vm, "keystore", [&](std::string const &val) { keystore_path_ = val; });
 
@@ -319,6 +348,9 @@ namespace sgns::application {
     find_argument<uint16_t>(
         vm, "rpc_ws_port", [&](uint16_t val) { rpc_ws_port_ = val; });
 
+    find_argument<uint16_t>(
+        vm, "metrics_port", [&](uint16_t val) { metrics_port_ = val; });
+
     rpc_http_endpoint_ = get_endpoint_from(rpc_http_host_, rpc_http_port_);
     rpc_ws_endpoint_ = get_endpoint_from(rpc_ws_host_, rpc_ws_port_);
     validate_config(scheme);
@@ -85,6 +85,7 @@ namespace sgns::application {
 
     static bool load_str( const rapidjson::Value &val, char const *name, std::string &target );
     static bool load_u16( const rapidjson::Value &val, char const *name, uint16_t &target );
+    static bool load_u32( const rapidjson::Value &val, char const *name, uint32_t &target );
     static bool load_bool( const rapidjson::Value &val, char const *name, bool &target );
 
     boost::asio::ip::tcp::endpoint get_endpoint_from(const std::string &host,
@@ -114,6 +115,9 @@ public:
     DECLARE_PROPERTY(boost::asio::ip::tcp::endpoint, rpc_ws_endpoint);
     DECLARE_PROPERTY(spdlog::level::level_enum, verbosity);
     DECLARE_PROPERTY(bool, is_only_finalizing);
+    DECLARE_PROPERTY(uint32_t, state_pruning);
+    DECLARE_PROPERTY(uint32_t, trie_node_cache_size);
+    DECLARE_PROPERTY(uint16_t, metrics_port);
   };
 
 }  // namespace sgns::application
@@ -10,6 +10,7 @@
 #include "integration/ProductionLotteryFactory.hpp"
 #include "integration/StorageChangesTrackerFactory.hpp"
 #include "integration/TrieStorageBackendFactory.hpp"
+#include "integration/TriePrunerFactory.hpp"
 #include "integration/TrieSerializerFactory.hpp"
 #include "integration/BlockStorageFactory.hpp"
 #include "integration/TrieStorageFactory.hpp"
@@ -71,6 +72,7 @@ namespace sgns::application
         // genesis launch if database does not exist
         production_execution_strategy_ = boost::filesystem::exists( app_config->rocksdb_path() ) ? Production::ExecutionStrategy::SYNC_FIRST :
                                                                                                    Production::ExecutionStrategy::GENESIS;
+        metrics_port_ = app_config->metrics_port();
 
         auto component_factory = SINGLETONINSTANCE( CComponentFactory );
         component_factory->Register( sgns::RpcContextFactory{}.create(), "RpcContext", boost::none );
@@ -91,6 +93,10 @@ namespace sgns::application
         component_factory->Register( std::make_shared<sgns::storage::trie::SuperGeniusCodec>(), "Codec", boost::none );
         component_factory->Register( StorageChangesTrackerFactory::create(), "ChangesTracker", boost::none );
         component_factory->Register( TrieStorageBackendFactory::create(), "TrieStorageBackend", boost::none );
+        if ( app_config->state_pruning() > 0 )
+        {
+            component_factory->Register( TriePrunerFactory::create( app_config->state_pruning() ), "TriePruner", boost::none );
+        }
         component_factory->Register( TrieSerializerFactory::create(), "TrieSerializer", boost::none );
         component_factory->Register( TrieStorageFactory::create(), "TrieStorage", boost::none );
         component_factory->Register( sgns::BlockStorageFactory{}.create(), "BlockStorage", boost::none );
@@ -245,6 +251,17 @@ namespace sgns::application
                 return true;
             } );
 
+        if ( metrics_port_ != 0 )
+        {
+            app_state_manager_->atLaunch(
+                [this]
+                {
+                    metrics_exporter_ = std::make_unique<base::MetricsExporter>();
+                    return metrics_exporter_->StartHttp( metrics_port_ ).has_value();
+                } );
+            app_state_manager_->atShutdown( [this] { metrics_exporter_.reset(); } );
+        }
+
         app_state_manager_->atShutdown( [ctx{ io_context_ }] { ctx->stop(); } );
 
         app_state_manager_->run();
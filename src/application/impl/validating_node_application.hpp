@@ -8,6 +8,7 @@
 #include "application/app_config.hpp"
 #include "application/configuration_storage.hpp"
 #include "application/impl/local_key_storage.hpp"
+#include "base/metrics_exporter.hpp"
 #include "verification/finality/finality.hpp"
 #include "verification/production.hpp"
 #include "network/router.hpp"
@@ -55,6 +56,9 @@ namespace sgns::application
 
         Production::ExecutionStrategy production_execution_strategy_;
 
+        uint16_t                               metrics_port_;
+        std::unique_ptr<base::MetricsExporter> metrics_exporter_;
+
         base::Logger logger_;
     };
 
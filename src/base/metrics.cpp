@@ -0,0 +1,273 @@
+#include "base/metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace sgns::base
+{
+    namespace
+    {
+        size_t MostSignificantBit( uint64_t value )
+        {
+#if defined( __GNUC__ ) || defined( __clang__ )
+            return 63 - static_cast<size_t>( __builtin_clzll( value ) );
+#else
+            size_t msb = 0;
+            while ( value >>= 1 )
+            {
+                ++msb;
+            }
+            return msb;
+#endif
+        }
+
+        std::string Escape( const std::string &text, bool quotes )
+        {
+            std::string escaped;
+            escaped.reserve( text.size() );
+            for ( char c : text )
+            {
+                if ( c == '\\' || ( quotes && c == '"' ) )
+                {
+                    escaped += '\\';
+                    escaped += c;
+                }
+                else if ( c == '\n' )
+                {
+                    escaped += "\\n";
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+            return escaped;
+        }
+
+        /**
+         * Adds a label to already rendered ones
+         */
+        std::string WithLabel( const std::string &labels, const std::string &label )
+        {
+            if ( labels.empty() )
+            {
+                return "{" + label + "}";
+            }
+            return labels.substr( 0, labels.size() - 1 ) + "," + label + "}";
+        }
+    }
+
+    void Histogram::Observe( uint64_t value )
+    {
+        buckets_[BucketIndex( value )].fetch_add( 1, std::memory_order_relaxed );
+        count_.fetch_add( 1, std::memory_order_relaxed );
+        sum_.fetch_add( value, std::memory_order_relaxed );
+    }
+
+    uint64_t Histogram::Quantile( double q ) const
+    {
+        uint64_t total = 0;
+        for ( const auto &bucket : buckets_ )
+        {
+            total += bucket.load( std::memory_order_relaxed );
+        }
+        if ( total == 0 )
+        {
+            return 0;
+        }
+        auto target = static_cast<uint64_t>( std::ceil( std::clamp( q, 0.0, 1.0 ) * total ) );
+        target      = std::max<uint64_t>( target, 1 );
+
+        uint64_t seen = 0;
+        for ( size_t i = 0; i < BUCKET_COUNT; ++i )
+        {
+            seen += buckets_[i].load( std::memory_order_relaxed );
+            if ( seen >= target )
+            {
+                return BucketUpperBound( i );
+            }
+        }
+        return BucketUpperBound( BUCKET_COUNT - 1 );
+    }
+
+    size_t Histogram::BucketIndex( uint64_t value )
+    {
+        if ( value < SUB_BUCKETS )
+        {
+            return value;
+        }
+        auto shift = MostSignificantBit( value ) - SUB_BUCKET_BITS;
+        return ( shift + 1 ) * SUB_BUCKETS + ( ( value >> shift ) - SUB_BUCKETS );
+    }
+
+    uint64_t Histogram::BucketUpperBound( size_t index )
+    {
+        if ( index < SUB_BUCKETS )
+        {
+            return index;
+        }
+        auto     shift = index / SUB_BUCKETS - 1;
+        uint64_t lower = static_cast<uint64_t>( SUB_BUCKETS + index % SUB_BUCKETS ) << shift;
+        return lower + ( ( uint64_t{ 1 } << shift ) - 1 );
+    }
+
+    MetricsRegistry &MetricsRegistry::Instance()
+    {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    Counter &MetricsRegistry::GetCounter( const std::string &name, const std::string &help, const Labels &labels )
+    {
+        std::lock_guard lock( mutex_ );
+        auto           &series = GetSeries( name, help, labels, Type::COUNTER );
+        if ( !series.counter )
+        {
+            series.counter = std::make_unique<Counter>();
+        }
+        return *series.counter;
+    }
+
+    Gauge &MetricsRegistry::GetGauge( const std::string &name, const std::string &help, const Labels &labels )
+    {
+        std::lock_guard lock( mutex_ );
+        auto           &series = GetSeries( name, help, labels, Type::GAUGE );
+        if ( !series.gauge )
+        {
+            series.gauge = std::make_unique<Gauge>();
+        }
+        return *series.gauge;
+    }
+
+    Histogram &MetricsRegistry::GetHistogram( const std::string &name, const std::string &help, const Labels &labels )
+    {
+        std::lock_guard lock( mutex_ );
+        auto           &series = GetSeries( name, help, labels, Type::SUMMARY );
+        if ( !series.histogram )
+        {
+            series.histogram = std::make_unique<Histogram>();
+        }
+        return *series.histogram;
+    }
+
+    MetricsRegistry::CallbackId MetricsRegistry::AddCallbackGauge( const std::string &name,
+                                                                   const std::string &help,
+                                                                   const Labels      &labels,
+                                                                   Callback           callback )
+    {
+        std::lock_guard lock( mutex_ );
+        auto           &series = GetSeries( name, help, labels, Type::GAUGE );
+        auto            id     = next_callback_id_++;
+        series.callback        = std::move( callback );
+        series.callback_id     = id;
+        callbacks_.emplace( id, std::make_pair( name, RenderLabels( labels ) ) );
+        return id;
+    }
+
+    void MetricsRegistry::RemoveCallbackGauge( CallbackId id )
+    {
+        std::lock_guard lock( mutex_ );
+        auto            it = callbacks_.find( id );
+        if ( it == callbacks_.end() )
+        {
+            return;
+        }
+        auto family = families_.find( it->second.first );
+        if ( family != families_.end() )
+        {
+            auto series = family->second.series.find( it->second.second );
+            // the gauge may have been replaced by a newer callback since
+            if ( series != family->second.series.end() && series->second.callback_id == id )
+            {
+                series->second.callback = nullptr;
+            }
+        }
+        callbacks_.erase( it );
+    }
+
+    std::string MetricsRegistry::Serialize() const
+    {
+        std::ostringstream out;
+        out << std::setprecision( 15 );
+
+        std::lock_guard lock( mutex_ );
+        for ( const auto &[name, family] : families_ )
+        {
+            out << "# HELP " << name << " " << Escape( family.help, false ) << "\n";
+            switch ( family.type )
+            {
+                case Type::COUNTER:
+                    out << "# TYPE " << name << " counter\n";
+                    break;
+                case Type::GAUGE:
+                    out << "# TYPE " << name << " gauge\n";
+                    break;
+                case Type::SUMMARY:
+                    out << "# TYPE " << name << " summary\n";
+                    break;
+            }
+            for ( const auto &[labels, series] : family.series )
+            {
+                if ( series.counter )
+                {
+                    out << name << labels << " " << series.counter->Value() << "\n";
+                }
+                if ( series.gauge )
+                {
+                    out << name << labels << " " << series.gauge->Value() << "\n";
+                }
+                if ( series.callback )
+                {
+                    if ( auto value = series.callback() )
+                    {
+                        out << name << labels << " " << *value << "\n";
+                    }
+                }
+                if ( series.histogram )
+                {
+                    for ( const char *q : { "0.5", "0.9", "0.99" } )
+                    {
+                        out << name << WithLabel( labels, std::string( "quantile=\"" ) + q + "\"" ) << " "
+                            << series.histogram->Quantile( std::stod( q ) ) << "\n";
+                    }
+                    out << name << "_sum" << labels << " " << series.histogram->Sum() << "\n";
+                    out << name << "_count" << labels << " " << series.histogram->Count() << "\n";
+                }
+            }
+        }
+        return out.str();
+    }
+
+    MetricsRegistry::Series &MetricsRegistry::GetSeries( const std::string &name,
+                                                         const std::string &help,
+                                                         const Labels      &labels,
+                                                         Type               type )
+    {
+        auto [it, inserted] = families_.try_emplace( name, Family{ type, help, {} } );
+        if ( !inserted && it->second.type != type )
+        {
+            return mismatched_.emplace_back();
+        }
+        return it->second.series[RenderLabels( labels )];
+    }
+
+    std::string MetricsRegistry::RenderLabels( const Labels &labels )
+    {
+        if ( labels.empty() )
+        {
+            return "";
+        }
+        std::string rendered = "{";
+        for ( const auto &[key, value] : labels )
+        {
+            if ( rendered.size() > 1 )
+            {
+                rendered += ",";
+            }
+            rendered += key + "=\"" + Escape( value, true ) + "\"";
+        }
+        return rendered + "}";
+    }
+} // namespace sgns::base
@@ -0,0 +1,212 @@
+#ifndef SUPERGENIUS_METRICS_HPP
+#define SUPERGENIUS_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sgns::base
+{
+    /**
+     * @brief Monotonic counter, updates are a single relaxed atomic add
+     */
+    class Counter
+    {
+    public:
+        void Increment( uint64_t n = 1 )
+        {
+            value_.fetch_add( n, std::memory_order_relaxed );
+        }
+
+        uint64_t Value() const
+        {
+            return value_.load( std::memory_order_relaxed );
+        }
+
+    private:
+        std::atomic<uint64_t> value_{ 0 };
+    };
+
+    /**
+     * @brief Value that goes up and down, such as a queue depth
+     */
+    class Gauge
+    {
+    public:
+        void Set( int64_t value )
+        {
+            value_.store( value, std::memory_order_relaxed );
+        }
+
+        void Add( int64_t n = 1 )
+        {
+            value_.fetch_add( n, std::memory_order_relaxed );
+        }
+
+        void Sub( int64_t n = 1 )
+        {
+            value_.fetch_sub( n, std::memory_order_relaxed );
+        }
+
+        int64_t Value() const
+        {
+            return value_.load( std::memory_order_relaxed );
+        }
+
+    private:
+        std::atomic<int64_t> value_{ 0 };
+    };
+
+    /**
+     * @brief Histogram of unsigned values with log-linear buckets, as in HDR histograms.
+     * Every power of two range is split in 8 buckets, so a recorded value is known
+     * within 12.5% whatever its magnitude, with a fixed memory footprint and no locking.
+     */
+    class Histogram
+    {
+    public:
+        static constexpr size_t SUB_BUCKET_BITS = 3;
+        static constexpr size_t SUB_BUCKETS     = size_t{ 1 } << SUB_BUCKET_BITS;
+        static constexpr size_t BUCKET_COUNT    = ( 64 - SUB_BUCKET_BITS + 1 ) * SUB_BUCKETS;
+
+        void Observe( uint64_t value );
+
+        uint64_t Count() const
+        {
+            return count_.load( std::memory_order_relaxed );
+        }
+
+        uint64_t Sum() const
+        {
+            return sum_.load( std::memory_order_relaxed );
+        }
+
+        /**
+         * @brief       Estimates a quantile from the buckets
+         * @param[in]   q Quantile between 0 and 1
+         * @return      Upper bound of the bucket holding the quantile, 0 if nothing was recorded
+         */
+        uint64_t Quantile( double q ) const;
+
+        static size_t   BucketIndex( uint64_t value );
+        static uint64_t BucketUpperBound( size_t index );
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+        std::atomic<uint64_t>                           count_{ 0 };
+        std::atomic<uint64_t>                           sum_{ 0 };
+    };
+
+    /**
+     * @brief Records the microseconds elapsed over its lifetime into a histogram
+     */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer( Histogram &histogram ) :
+            histogram_( histogram ), start_( std::chrono::steady_clock::now() )
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            histogram_.Observe( std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::steady_clock::now() - start_ )
+                                    .count() );
+        }
+
+        ScopedTimer( const ScopedTimer & )            = delete;
+        ScopedTimer &operator=( const ScopedTimer & ) = delete;
+
+    private:
+        Histogram                            &histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief Named metrics of the process, rendered in the Prometheus text format.
+     *
+     * Metrics are looked up once, typically when the instrumented object is built, and
+     * then updated through the returned reference without touching the registry.
+     * Metrics are never removed, so the references stay valid for the registry lifetime.
+     */
+    class MetricsRegistry
+    {
+    public:
+        using Labels     = std::map<std::string, std::string>;
+        using Callback   = std::function<std::optional<double>()>;
+        using CallbackId = uint64_t;
+
+        /**
+         * @brief       Registry shared by the whole process
+         */
+        static MetricsRegistry &Instance();
+
+        Counter   &GetCounter( const std::string &name, const std::string &help, const Labels &labels = {} );
+        Gauge     &GetGauge( const std::string &name, const std::string &help, const Labels &labels = {} );
+        Histogram &GetHistogram( const std::string &name, const std::string &help, const Labels &labels = {} );
+
+        /**
+         * @brief       Adds a gauge read when the metrics are rendered, for values owned by
+         *              another component, such as database properties
+         * @param[in]   callback Returns the current value, or std::nullopt to skip it
+         * @return      Id to remove the gauge with
+         */
+        CallbackId AddCallbackGauge( const std::string &name,
+                                     const std::string &help,
+                                     const Labels      &labels,
+                                     Callback           callback );
+
+        void RemoveCallbackGauge( CallbackId id );
+
+        /**
+         * @brief       Renders every metric in the Prometheus text exposition format,
+         *              histograms are rendered as summaries
+         */
+        std::string Serialize() const;
+
+    private:
+        enum class Type
+        {
+            COUNTER,
+            GAUGE,
+            SUMMARY,
+        };
+
+        struct Series
+        {
+            std::unique_ptr<Counter>   counter;
+            std::unique_ptr<Gauge>     gauge;
+            std::unique_ptr<Histogram> histogram;
+            Callback                   callback;
+            CallbackId                 callback_id = 0;
+        };
+
+        struct Family
+        {
+            Type                          type;
+            std::string                   help;
+            std::map<std::string, Series> series; ///< by rendered labels
+        };
+
+        Series &GetSeries( const std::string &name, const std::string &help, const Labels &labels, Type type );
+
+        static std::string RenderLabels( const Labels &labels );
+
+        mutable std::mutex            mutex_;
+        std::map<std::string, Family> families_;
+        std::vector<Series>           mismatched_; ///< metrics registered with another type, never rendered
+        std::map<CallbackId, std::pair<std::string, std::string>> callbacks_; ///< family and series of the gauges
+        CallbackId                                                next_callback_id_ = 0;
+    };
+} // namespace sgns::base
+
+#endif // SUPERGENIUS_METRICS_HPP
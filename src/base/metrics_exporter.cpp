@@ -0,0 +1,180 @@
+#include "base/metrics_exporter.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+namespace sgns::base
+{
+    namespace
+    {
+        constexpr size_t MAX_REQUEST_SIZE = 8192;
+
+        /**
+         * One scrape, the connection is closed after the response
+         */
+        struct Connection : std::enable_shared_from_this<Connection>
+        {
+            Connection( boost::asio::ip::tcp::socket socket, MetricsRegistry &registry ) :
+                socket( std::move( socket ) ), request( MAX_REQUEST_SIZE ), registry( registry )
+            {
+            }
+
+            void Start()
+            {
+                boost::asio::async_read_until( socket,
+                                               request,
+                                               "\r\n\r\n",
+                                               [self( shared_from_this() )]( const boost::system::error_code &ec,
+                                                                             size_t ) { self->Respond( ec ); } );
+            }
+
+            void Respond( const boost::system::error_code &ec )
+            {
+                if ( ec )
+                {
+                    return;
+                }
+                std::istream request_stream( &request );
+                std::string  method;
+                std::string  target;
+                request_stream >> method >> target;
+
+                std::string body;
+                std::string status;
+                if ( method == "GET" && ( target == "/metrics" || target == "/" ) )
+                {
+                    status = "200 OK";
+                    body   = registry.Serialize();
+                }
+                else
+                {
+                    status = "404 Not Found";
+                }
+                response = "HTTP/1.1 " + status +
+                           "\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\nContent-Length: " +
+                           std::to_string( body.size() ) + "\r\n\r\n" + body;
+                boost::asio::async_write( socket,
+                                          boost::asio::buffer( response ),
+                                          [self( shared_from_this() )]( const boost::system::error_code &, size_t )
+                                          {
+                                              boost::system::error_code ignored;
+                                              self->socket.shutdown( boost::asio::ip::tcp::socket::shutdown_both,
+                                                                     ignored );
+                                          } );
+            }
+
+            boost::asio::ip::tcp::socket socket;
+            boost::asio::streambuf       request;
+            std::string                  response;
+            MetricsRegistry             &registry;
+        };
+    }
+
+    MetricsExporter::MetricsExporter( MetricsRegistry &registry ) : registry_( registry )
+    {
+    }
+
+    MetricsExporter::~MetricsExporter()
+    {
+        Stop();
+    }
+
+    outcome::result<void> MetricsExporter::WriteFile( const std::string &path ) const
+    {
+        auto temp_path = path + ".tmp";
+        {
+            std::ofstream file( temp_path, std::ios::out | std::ios::trunc );
+            file << registry_.Serialize();
+            if ( !file )
+            {
+                logger_->error( "Can't write metrics to {}", temp_path );
+                return outcome::failure( boost::system::error_code{ errno, boost::system::generic_category() } );
+            }
+        }
+        if ( std::rename( temp_path.c_str(), path.c_str() ) != 0 )
+        {
+            logger_->error( "Can't move metrics to {}", path );
+            return outcome::failure( boost::system::error_code{ errno, boost::system::generic_category() } );
+        }
+        return outcome::success();
+    }
+
+    outcome::result<void> MetricsExporter::StartHttp( uint16_t port, const std::string &address )
+    {
+        if ( acceptor_ )
+        {
+            return outcome::failure( boost::asio::error::make_error_code( boost::asio::error::already_started ) );
+        }
+        boost::system::error_code ec;
+        auto                      ip = boost::asio::ip::make_address( address, ec );
+        if ( ec )
+        {
+            return outcome::failure( ec );
+        }
+        auto acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>( io_context_ );
+        boost::asio::ip::tcp::endpoint endpoint( ip, port );
+        acceptor->open( endpoint.protocol(), ec );
+        if ( !ec )
+        {
+            acceptor->set_option( boost::asio::socket_base::reuse_address( true ), ec );
+        }
+        if ( !ec )
+        {
+            acceptor->bind( endpoint, ec );
+        }
+        if ( !ec )
+        {
+            acceptor->listen( boost::asio::socket_base::max_listen_connections, ec );
+        }
+        if ( ec )
+        {
+            logger_->error( "Can't listen on {}:{}: {}", address, port, ec.message() );
+            return outcome::failure( ec );
+        }
+        acceptor_ = std::move( acceptor );
+        logger_->info( "Serving metrics on {}:{}", address, GetPort() );
+
+        Accept();
+        thread_ = std::thread( [this]() { io_context_.run(); } );
+        return outcome::success();
+    }
+
+    uint16_t MetricsExporter::GetPort() const
+    {
+        if ( !acceptor_ )
+        {
+            return 0;
+        }
+        boost::system::error_code ec;
+        auto                      endpoint = acceptor_->local_endpoint( ec );
+        return ec ? 0 : endpoint.port();
+    }
+
+    void MetricsExporter::Stop()
+    {
+        io_context_.stop();
+        if ( thread_.joinable() )
+        {
+            thread_.join();
+        }
+        acceptor_.reset();
+    }
+
+    void MetricsExporter::Accept()
+    {
+        acceptor_->async_accept(
+            [this]( const boost::system::error_code &ec, boost::asio::ip::tcp::socket socket )
+            {
+                if ( ec )
+                {
+                    return;
+                }
+                std::make_shared<Connection>( std::move( socket ), registry_ )->Start();
+                Accept();
+            } );
+    }
+} // namespace sgns::base
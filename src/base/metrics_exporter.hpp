@@ -0,0 +1,67 @@
+#ifndef SUPERGENIUS_METRICS_EXPORTER_HPP
+#define SUPERGENIUS_METRICS_EXPORTER_HPP
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include "base/logger.hpp"
+#include "base/metrics.hpp"
+#include "outcome/outcome.hpp"
+
+namespace sgns::base
+{
+    /**
+     * @brief Exposes a metrics registry to scrapers, either as a file or over a local HTTP listener
+     * answering GET /metrics
+     */
+    class MetricsExporter
+    {
+    public:
+        explicit MetricsExporter( MetricsRegistry &registry = MetricsRegistry::Instance() );
+
+        /**
+         * @brief       Stops the listener, see @ref Stop
+         */
+        ~MetricsExporter();
+
+        MetricsExporter( const MetricsExporter & )            = delete;
+        MetricsExporter &operator=( const MetricsExporter & ) = delete;
+
+        /**
+         * @brief       Writes the metrics to a file, for a node exporter textfile collector.
+         *              The file is replaced at once, so it is never read half written
+         * @param[in]   path File to write
+         */
+        outcome::result<void> WriteFile( const std::string &path ) const;
+
+        /**
+         * @brief       Starts serving the metrics on its own thread
+         * @param[in]   port Port to listen on, 0 picks a free one
+         * @param[in]   address Address to listen on, the loopback one by default
+         * @return      already_started if the exporter is already listening, the socket error if it can't listen
+         */
+        outcome::result<void> StartHttp( uint16_t port, const std::string &address = "127.0.0.1" );
+
+        /**
+         * @brief       Port the listener is bound to, 0 if it is not started
+         */
+        uint16_t GetPort() const;
+
+        void Stop();
+
+    private:
+        void Accept();
+
+        MetricsRegistry                               &registry_;
+        boost::asio::io_context                        io_context_;
+        std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor_;
+        std::thread                                    thread_;
+        Logger                                         logger_ = createLogger( "MetricsExporter" );
+    };
+} // namespace sgns::base
+
+#endif // SUPERGENIUS_METRICS_EXPORTER_HPP
@@ -0,0 +1,239 @@
+#include "base/tracing.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <sstream>
+
+namespace sgns::base
+{
+    namespace
+    {
+        std::string EscapeJson( const std::string &text )
+        {
+            std::string escaped;
+            escaped.reserve( text.size() );
+            for ( char c : text )
+            {
+                switch ( c )
+                {
+                    case '"':
+                        escaped += "\\\"";
+                        break;
+                    case '\\':
+                        escaped += "\\\\";
+                        break;
+                    case '\n':
+                        escaped += "\\n";
+                        break;
+                    case '\r':
+                        escaped += "\\r";
+                        break;
+                    case '\t':
+                        escaped += "\\t";
+                        break;
+                    default:
+                        if ( static_cast<unsigned char>( c ) < 0x20 )
+                        {
+                            char code[8];
+                            std::snprintf( code, sizeof( code ), "\\u%04x", static_cast<unsigned>( c ) );
+                            escaped += code;
+                        }
+                        else
+                        {
+                            escaped += c;
+                        }
+                }
+            }
+            return escaped;
+        }
+
+        /**
+         * Flow ids are rendered as strings, 64 bit numbers don't fit in a JSON double
+         */
+        std::string FlowId( uint64_t span_id )
+        {
+            char id[24];
+            std::snprintf( id, sizeof( id ), "0x%016llx", static_cast<unsigned long long>( span_id ) );
+            return id;
+        }
+    }
+
+    Tracer::Tracer()
+    {
+        // random high half so ids from different nodes don't collide
+        std::random_device device;
+        next_span_id_ = ( static_cast<uint64_t>( device() ) << 32 ) | 1;
+    }
+
+    Tracer &Tracer::Instance()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    void Tracer::SetProcessName( const std::string &name )
+    {
+        std::lock_guard lock( mutex_ );
+        process_name_ = name;
+        process_id_   = static_cast<uint32_t>( std::hash<std::string>{}( name ) & 0x7fffffff );
+    }
+
+    void Tracer::SetMaxEvents( size_t max_events )
+    {
+        std::lock_guard lock( mutex_ );
+        max_events_ = max_events;
+    }
+
+    uint64_t Tracer::NewSpanId()
+    {
+        return next_span_id_.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void Tracer::Record( TraceEvent event )
+    {
+        std::lock_guard lock( mutex_ );
+        if ( events_.size() >= max_events_ )
+        {
+            ++dropped_;
+            return;
+        }
+        events_.push_back( std::move( event ) );
+    }
+
+    std::vector<TraceEvent> Tracer::GetEvents() const
+    {
+        std::lock_guard lock( mutex_ );
+        return events_;
+    }
+
+    uint64_t Tracer::GetDroppedCount() const
+    {
+        std::lock_guard lock( mutex_ );
+        return dropped_;
+    }
+
+    void Tracer::Clear()
+    {
+        std::lock_guard lock( mutex_ );
+        events_.clear();
+        dropped_ = 0;
+    }
+
+    std::string Tracer::ExportChromeTrace() const
+    {
+        std::lock_guard    lock( mutex_ );
+        std::ostringstream out;
+        auto               pid = std::to_string( process_id_ );
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":0,\"args\":{\"name\":\""
+            << EscapeJson( process_name_.empty() ? "supergenius" : process_name_ ) << "\"}}";
+        for ( const auto &event : events_ )
+        {
+            auto common = "\"pid\":" + pid + ",\"tid\":" + std::to_string( event.thread_id ) +
+                          ",\"ts\":" + std::to_string( event.start_us );
+            out << ",\n{\"name\":\"" << EscapeJson( event.name ) << "\",\"cat\":\"processing\",\"ph\":\"X\","
+                << common << ",\"dur\":" << event.duration_us << ",\"args\":{\"task_id\":\""
+                << EscapeJson( event.task_id ) << "\"";
+            if ( !event.subtask_id.empty() )
+            {
+                out << ",\"subtask_id\":\"" << EscapeJson( event.subtask_id ) << "\"";
+            }
+            out << ",\"span_id\":\"" << FlowId( event.span_id ) << "\"}}";
+
+            // flow arrows, bound to the enclosing span on both ends
+            if ( event.flow_in != 0 )
+            {
+                out << ",\n{\"name\":\"flow\",\"cat\":\"processing\",\"ph\":\"f\",\"bp\":\"e\",\"id\":\""
+                    << FlowId( event.flow_in ) << "\"," << common << "}";
+            }
+            if ( event.flow_out )
+            {
+                out << ",\n{\"name\":\"flow\",\"cat\":\"processing\",\"ph\":\"s\",\"id\":\""
+                    << FlowId( event.span_id ) << "\"," << common << "}";
+            }
+        }
+        out << "]}\n";
+        return out.str();
+    }
+
+    outcome::result<void> Tracer::WriteChromeTrace( const std::string &path ) const
+    {
+        auto temp_path = path + ".tmp";
+        {
+            std::ofstream file( temp_path, std::ios::out | std::ios::trunc );
+            file << ExportChromeTrace();
+            if ( !file )
+            {
+                return outcome::failure( boost::system::error_code{ errno, boost::system::generic_category() } );
+            }
+        }
+        if ( std::rename( temp_path.c_str(), path.c_str() ) != 0 )
+        {
+            return outcome::failure( boost::system::error_code{ errno, boost::system::generic_category() } );
+        }
+        return outcome::success();
+    }
+
+    int64_t Tracer::Now()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::system_clock::now().time_since_epoch() )
+            .count();
+    }
+
+    uint32_t Tracer::ThreadId()
+    {
+        static std::atomic<uint32_t> next_thread_id{ 1 };
+        thread_local uint32_t        thread_id = next_thread_id.fetch_add( 1, std::memory_order_relaxed );
+        return thread_id;
+    }
+
+    TraceSpan::TraceSpan( std::string_view name, const std::string &task_id, const std::string &subtask_id ) :
+        name_( name )
+    {
+        auto &tracer = Tracer::Instance();
+        if ( !tracer.IsEnabled() )
+        {
+            return;
+        }
+        active_           = true;
+        event_.task_id    = task_id;
+        event_.subtask_id = subtask_id;
+        event_.span_id    = tracer.NewSpanId();
+        event_.thread_id  = Tracer::ThreadId();
+        event_.start_us   = Tracer::Now();
+    }
+
+    TraceSpan::~TraceSpan()
+    {
+        End();
+    }
+
+    uint64_t TraceSpan::FlowOut()
+    {
+        event_.flow_out = active_;
+        return event_.span_id;
+    }
+
+    void TraceSpan::FlowIn( uint64_t span_id )
+    {
+        event_.flow_in = span_id;
+    }
+
+    void TraceSpan::End()
+    {
+        if ( !active_ )
+        {
+            return;
+        }
+        active_            = false;
+        event_.name        = std::string( name_ );
+        event_.duration_us = Tracer::Now() - event_.start_us;
+        Tracer::Instance().Record( std::move( event_ ) );
+    }
+} // namespace sgns::base
@@ -0,0 +1,169 @@
+#ifndef SUPERGENIUS_TRACING_HPP
+#define SUPERGENIUS_TRACING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "outcome/outcome.hpp"
+
+namespace sgns::base
+{
+    /**
+     * @brief Span recorded by the tracer, times are microseconds since the epoch so spans
+     * recorded by different nodes line up on the same timeline
+     */
+    struct TraceEvent
+    {
+        std::string name;
+        std::string task_id;
+        std::string subtask_id;
+        int64_t     start_us    = 0;
+        int64_t     duration_us = 0;
+        uint32_t    thread_id   = 0;
+        uint64_t    span_id     = 0;
+        uint64_t    flow_in     = 0; ///< span of another node this one follows from, 0 if none
+        bool        flow_out    = false; ///< whether spans of other nodes follow from this one
+    };
+
+    /**
+     * @brief Collects the spans of the task processing pipeline and exports them in the
+     * Chrome trace event format, to be opened in chrome://tracing or Perfetto.
+     *
+     * Tracing is off by default and can be switched at any time. When it is off a span
+     * costs a relaxed atomic load. Spans are keyed by task and subtask id, which are the
+     * same on every node, and a span can be linked to a span of another node through its
+     * id, so the traces of several nodes can be merged and followed across the network.
+     */
+    class Tracer
+    {
+    public:
+        static constexpr size_t DEFAULT_MAX_EVENTS = 1 << 20;
+
+        /**
+         * @brief       Tracer shared by the whole process
+         */
+        static Tracer &Instance();
+
+        void SetEnabled( bool enabled )
+        {
+            enabled_.store( enabled, std::memory_order_relaxed );
+        }
+
+        bool IsEnabled() const
+        {
+            return enabled_.load( std::memory_order_relaxed );
+        }
+
+        /**
+         * @brief       Names the process in the exported traces, and derives its process id
+         *              from the name so traces of several nodes can be merged
+         */
+        void SetProcessName( const std::string &name );
+
+        /**
+         * @brief       Sets how many spans are kept, later ones are dropped
+         */
+        void SetMaxEvents( size_t max_events );
+
+        /**
+         * @brief       Returns a span id, unique across nodes with a very high probability
+         */
+        uint64_t NewSpanId();
+
+        void Record( TraceEvent event );
+
+        std::vector<TraceEvent> GetEvents() const;
+
+        /**
+         * @brief       Number of spans dropped because the buffer was full
+         */
+        uint64_t GetDroppedCount() const;
+
+        void Clear();
+
+        /**
+         * @brief       Renders the recorded spans as a Chrome trace event JSON document
+         */
+        std::string ExportChromeTrace() const;
+
+        outcome::result<void> WriteChromeTrace( const std::string &path ) const;
+
+        /**
+         * @brief       Current time in microseconds since the epoch
+         */
+        static int64_t Now();
+
+        /**
+         * @brief       Small id of the calling thread
+         */
+        static uint32_t ThreadId();
+
+    private:
+        Tracer();
+
+        std::atomic<bool>       enabled_{ false };
+        std::atomic<uint64_t>   next_span_id_;
+        mutable std::mutex      mutex_;
+        std::vector<TraceEvent> events_;
+        size_t                  max_events_ = DEFAULT_MAX_EVENTS;
+        uint64_t                dropped_    = 0;
+        std::string             process_name_;
+        uint32_t                process_id_ = 1;
+    };
+
+    /**
+     * @brief Records the time elapsed over its lifetime as a span of the process tracer.
+     * Nothing is recorded, and the ids are not copied, when tracing is off.
+     */
+    class TraceSpan
+    {
+    public:
+        /**
+         * @param[in]   name Name of the span, must outlive it, usually a literal
+         * @param[in]   task_id Task the span belongs to
+         * @param[in]   subtask_id Subtask the span belongs to, empty for task wide spans
+         */
+        TraceSpan( std::string_view name, const std::string &task_id, const std::string &subtask_id = {} );
+
+        ~TraceSpan();
+
+        TraceSpan( const TraceSpan & )            = delete;
+        TraceSpan &operator=( const TraceSpan & ) = delete;
+
+        /**
+         * @brief       Id of the span, to be sent along to other nodes. 0 when tracing is off
+         */
+        uint64_t Id() const
+        {
+            return event_.span_id;
+        }
+
+        /**
+         * @brief       Marks the span as followed by spans of other nodes
+         * @return      Id of the span, 0 when tracing is off
+         */
+        uint64_t FlowOut();
+
+        /**
+         * @brief       Links the span to the span of another node it follows from
+         * @param[in]   span_id Id received from the other node, ignored if 0
+         */
+        void FlowIn( uint64_t span_id );
+
+        /**
+         * @brief       Records the span now instead of on destruction
+         */
+        void End();
+
+    private:
+        std::string_view name_;
+        TraceEvent       event_;
+        bool             active_ = false;
+    };
+} // namespace sgns::base
+
+#endif // SUPERGENIUS_TRACING_HPP
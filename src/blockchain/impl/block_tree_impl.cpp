@@ -225,9 +225,25 @@ namespace sgns::blockchain {
 
     log_->info(
         "Finalized block number {} with hash {}", node->depth, block.toHex());
+
+    if (on_finalized_) {
+      auto header = storage_->getBlockHeader(block);
+      if (header) {
+        on_finalized_(header.value());
+      } else {
+        log_->error("Failed to load finalized block header {}: {}",
+                    block.toHex(),
+                    header.error().message());
+      }
+    }
     return outcome::success();
   }
 
+  void BlockTreeImpl::setFinalizedEventHandler(
+      FinalizedEventHandler handler) {
+    on_finalized_ = std::move(handler);
+  }
+
   outcome::result<primitives::BlockHeader> BlockTreeImpl::getBlockHeader(
       const primitives::BlockId &block) const {
     return storage_->getBlockHeader(block);
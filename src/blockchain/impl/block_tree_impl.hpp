@@ -77,6 +77,12 @@ namespace sgns::blockchain {
       BLOCK_NOT_FOUND
     };
 
+    /**
+     * Called with the header of every newly finalized block
+     */
+    using FinalizedEventHandler =
+        std::function<void(const primitives::BlockHeader &header)>;
+
     /**
      * Create an instance of block tree
      * @param header_repo - block headers repository
@@ -145,6 +151,12 @@ namespace sgns::blockchain {
 
     [[nodiscard]] primitives::BlockInfo getLastFinalized() const override;
 
+    /**
+     * Sets a handler that is notified once a block is finalized, e.g. to
+     * prune the states it makes unreachable
+     */
+    void setFinalizedEventHandler(FinalizedEventHandler handler);
+
     std::string GetName() override
     {
         return "BlockTreeImpl";
@@ -192,6 +204,7 @@ namespace sgns::blockchain {
     std::shared_ptr<network::ExtrinsicObserver> extrinsic_observer_;
 
     std::shared_ptr<crypto::Hasher> hasher_;
+    FinalizedEventHandler on_finalized_;
     base::Logger log_ = base::createLogger("BlockTreeImpl");
   };
 }  // namespace sgns::blockchain
@@ -31,7 +31,10 @@ namespace sgns::blockchain {
       JUSTIFICATION = 6,
 
       // node of a trie db
-      TRIE_NODE = 7
+      TRIE_NODE = 7,
+
+      // reference counts of the trie nodes and journal of the trie states
+      TRIE_PRUNING = 8
     };
   }
 
@@ -9,10 +9,12 @@
 #define _CRDT_DATA_FILTER_HPP_
 #include <unordered_map>
 #include <functional>
+#include <optional>
 #include <string>
 #include <memory>
 #include <regex>
 #include <shared_mutex>
+#include <vector>
 #include "crdt/proto/delta.pb.h"
 
 namespace sgns::crdt
@@ -41,7 +43,7 @@ namespace sgns::crdt
          * @brief       Registers an element filter callback
          * @param[in]   pattern The regex/pattern that the key of the element has to match
          * @param[in]   filter The callback that is executed in case the pattern matches
-         * @return      true if succeeded, false otherwise
+         * @return      true if succeeded, false if the pattern is not a valid regex
          */
         bool RegisterElementFilter( const std::string &pattern, ElementFilterCallback filter );
 
@@ -78,11 +80,37 @@ namespace sgns::crdt
         void FilterTombstonesOnDelta( std::shared_ptr<pb::Delta> &delta );
 
     private:
+        /**
+         * @brief       Patterns of a registry, compiled once on registration.
+         *              Never modified once built, so filtering shares it without copying the registry.
+         */
+        class PatternMatcher
+        {
+        public:
+            /**
+             * @brief       Compiles the patterns of a registry
+             * @param[in]   registry Patterns and their callbacks, every pattern must be a valid regex
+             */
+            explicit PatternMatcher( const FilterCallbackRegistry &registry );
+
+            /**
+             * @brief       Looks for the filter of a key
+             * @param[in]   key The key of the element
+             * @return      The callback of the first pattern matching the key, nullptr if none matches
+             */
+            const ElementFilterCallback *Match( const std::string &key ) const;
+
+        private:
+            std::vector<std::regex>            regexes_; ///< Compiled patterns
+            std::vector<ElementFilterCallback> filters_; ///< Callback of each pattern
+        };
+
         const bool             accept_by_default_;        ///< The default behavior for values not matching any filter
         std::shared_mutex      element_registry_mutex_;   ///< Mutex for the element registry
         std::shared_mutex      tombstone_registry_mutex_; ///< Mutex for the tombstone registry
         FilterCallbackRegistry element_registry_;         ///< Element filter callback registry
         FilterCallbackRegistry tombstone_registry_;       ///< Tombstone filter callback registry
+        std::shared_ptr<const PatternMatcher> element_matcher_; ///< Compiled element registry, nullptr if empty
     };
 
 }
@@ -11,6 +11,7 @@
 
 #include <boost/asio/steady_timer.hpp>
 #include "base/logger.hpp"
+#include "base/metrics.hpp"
 #include <primitives/cid/cid.hpp>
 #include "crdt/crdt_set.hpp"
 #include "crdt/crdt_heads.hpp"
@@ -18,6 +19,7 @@
 #include "crdt/dagsyncer.hpp"
 #include "crdt/crdt_options.hpp"
 #include "crdt/crdt_data_filter.hpp"
+#include "crdt/processed_block_index.hpp"
 #include <storage/rocksdb/rocksdb.hpp>
 #include <ipfs_lite/ipld/ipld_node.hpp>
 #include <shared_mutex>
@@ -73,6 +75,13 @@ namespace sgns::crdt
                                                    std::shared_ptr<Broadcaster>        aBroadcaster,
                                                    const std::shared_ptr<CrdtOptions> &aOptions );
 
+        /**
+         * @brief       Column families for the CRDT keys, to open the database with @ref RocksDB::create
+         * @param[in]   aKey The namespace key the datastore will be created with
+         * @return      Column family layout of the sets and heads namespaces
+         */
+        static RocksDB::ColumnFamilyLayout GetColumnFamilyLayout( const HierarchicalKey &aKey );
+
         /**
          * @brief       Starts the datastore threads
          */
@@ -137,6 +146,25 @@ namespace sgns::crdt
         */
         outcome::result<bool> HasKey( const HierarchicalKey &aKey );
 
+        /** Get hit-rate and memory counters of the cache that serves GetKey and HasKey
+        * @return snapshot of the cache counters
+        */
+        CrdtValueCache::Stats GetValueCacheStats() const;
+
+        /// Counters of the rebroadcast worker
+        struct RebroadcastStats
+        {
+            uint64_t diffBroadcasts = 0; ///< Broadcasts of heads that changed since the previous one
+            uint64_t fullBroadcasts = 0; ///< Periodic broadcasts of the whole head set of a topic
+            uint64_t encodings      = 0; ///< Head sets encoded, full payloads are reused until the heads change
+            uint64_t bytes          = 0; ///< Payload bytes handed to the broadcaster
+        };
+
+        /** Get the counters of the rebroadcast worker
+        * @return snapshot of the counters
+        */
+        RebroadcastStats GetRebroadcastStats() const;
+
         /** Delete removes the value for given `key`.
         * @param aKey HierarchicalKey to delete from set
         * @return outcome::failure on error or success otherwise
@@ -258,9 +286,12 @@ namespace sgns::crdt
     */
         outcome::result<void> PrintDAGRec( const CID &aCID, uint64_t aDepth, std::vector<CID> &aSet );
 
-        /** Regularly send out a list of heads that we have not recently seen
+        /** Send out the heads that changed since the previous call, and the
+    * whole head set of every topic when @p aFullRebroadcast is set
+    * @param aFullRebroadcast whether the unchanged topics are rebroadcast too
+    * @return true if any head changed since the previous call
     */
-        void RebroadcastHeads();
+        bool RebroadcastHeads( bool aFullRebroadcast );
 
         /**
          * @brief Broadcasts a set of CIDs.
@@ -276,6 +307,13 @@ namespace sgns::crdt
     */
         static outcome::result<Buffer> EncodeBroadcast( const std::set<CID> &heads );
 
+        /** Hands an already encoded set of heads to the broadcaster
+    * @param aPayload data returned by EncodeBroadcast
+    * @param topic topic to broadcast to
+    * @return outcome::success on success, or outcome::failure if an error occurs.
+    */
+        outcome::result<void> BroadcastEncoded( const Buffer &aPayload, const std::string &topic );
+
         /** handleBlock takes care of vetting, retrieving and applying
     * CRDT blocks to the Datastore.
     * @return returns outcome::success on success or outcome::failure otherwise
@@ -347,6 +385,8 @@ namespace sgns::crdt
         std::shared_ptr<CrdtSet>   set_   = nullptr;
         std::shared_ptr<CrdtHeads> heads_ = nullptr;
 
+        std::shared_ptr<ProcessedBlockIndex> processedBlocks_ = nullptr;
+
         std::shared_ptr<Broadcaster> broadcaster_ = nullptr;
         std::shared_ptr<DAGSyncer>   dagSyncer_   = nullptr;
         Logger                       logger_      = base::createLogger( "CrdtDatastore" );
@@ -354,6 +394,7 @@ namespace sgns::crdt
         static constexpr std::chrono::milliseconds threadSleepTimeInMilliseconds_ = std::chrono::milliseconds( 100 );
         static constexpr std::string_view          headsNamespace_                = "h";
         static constexpr std::string_view          setsNamespace_                 = "s";
+        static constexpr std::string_view          processedNamespace_            = "p";
 
         PutHookPtr    putHookFunc_       = nullptr;
         DeleteHookPtr deleteHookFunc_    = nullptr;
@@ -375,11 +416,30 @@ namespace sgns::crdt
         std::condition_variable dagWorkerCv_;
         std::queue<DagJob>      dagWorkerJobList;
 
+        base::Gauge &dagJobsQueued_ = base::MetricsRegistry::Instance().GetGauge(
+            "crdt_dag_jobs_queued",
+            "DAG jobs waiting for a worker" );
+        base::Histogram &dagJobBatchDuration_ = base::MetricsRegistry::Instance().GetHistogram(
+            "crdt_dag_job_batch_duration_us",
+            "Time to process the DAG jobs of a root, in microseconds" );
+
         CRDTDataFilter crdt_filter_;
         bool           started_ = false;
 
-        std::mutex              rebroadcastMutex_;
-        std::condition_variable rebroadcastCv_;
+        /// Heads last broadcast on a topic and their encoding, owned by the rebroadcast worker
+        struct TopicBroadcastState
+        {
+            std::set<CID> heads;
+            Buffer        payload; ///< Encoded @ref heads, empty until a full rebroadcast needs it
+        };
+
+        std::mutex                                 rebroadcastMutex_;
+        std::condition_variable                    rebroadcastCv_;
+        std::map<std::string, TopicBroadcastState> rebroadcastState_;
+        std::atomic<uint64_t>                      diffBroadcasts_{ 0 };
+        std::atomic<uint64_t>                      fullBroadcasts_{ 0 };
+        std::atomic<uint64_t>                      broadcastEncodings_{ 0 };
+        std::atomic<uint64_t>                      broadcastBytes_{ 0 };
         std::set<std::string>   topicNames_;
         bool                    isFullNode = false;
     };
@@ -3,6 +3,7 @@
 
 #include <mutex>
 #include <storage/rocksdb/rocksdb.hpp>
+#include <storage/rocksdb/rocksdb_batch.hpp>
 #include "base/logger.hpp"
 #include "crdt/hierarchical_key.hpp"
 #include <primitives/cid/cid.hpp>
@@ -116,18 +117,26 @@ namespace sgns::crdt
     * @param aHeight height of CID head
     * @return outcome::failure on error
     */
-        outcome::result<void> Write( const std::unique_ptr<storage::BufferBatch> &aDataStore,
-                                     const CID                                   &aCid,
-                                     uint64_t                                     aHeight,
-                                     const std::string                           &topic );
+        outcome::result<void> Write( const std::unique_ptr<DataStore::Batch> &aDataStore,
+                                     const CID                               &aCid,
+                                     uint64_t                                 aHeight,
+                                     const std::string                       &topic );
 
         /** Delete data from datastore in batch mode
         * @param aDataStore Pointer to datastore batch
         * @param aCid Content identifier to remove
         */
-        outcome::result<void> Delete( const std::unique_ptr<storage::BufferBatch> &aDataStore,
-                                      const CID                                   &aCid,
-                                      const std::string                           &topic );
+        outcome::result<void> Delete( const std::unique_ptr<DataStore::Batch> &aDataStore,
+                                      const CID                               &aCid,
+                                      const std::string                       &topic );
+
+        /** Builds the full path to a CID key in place
+         *   /<namespace>/<topic>/<cid>
+         * @param topic Topic of the head
+         * @param aCid Content identifier
+         * @return builder holding the key or outcome::failure on error
+         */
+        outcome::result<HierarchicalKeyBuilder> GetKeyBuilder( std::string_view topic, const CID &aCid ) const;
 
     private:
         CrdtHeads() = default;
@@ -3,6 +3,8 @@
 
 #include "base/buffer.hpp"
 #include "base/logger.hpp"
+#include "crdt/crdt_value_cache.hpp"
+#include "crdt/group_commit_queue.hpp"
 #include "crdt/hierarchical_key.hpp"
 #include <functional>
 
@@ -23,6 +25,13 @@ namespace sgns::crdt
     /** RebroadcastInterval specifies interval to rebroadcast data */
     long long rebroadcastIntervalMilliseconds = 0;
 
+    /** RebroadcastMaxInterval bounds the backoff of the full rebroadcast while
+    * the heads don't change. The interval doubles from RebroadcastInterval on
+    * every idle round, and goes back to it as soon as a head changes.
+    * Values below RebroadcastInterval keep the interval fixed.
+    */
+    long long rebroadcastMaxIntervalMilliseconds = 0;
+
     /** DAGSyncerTimeout specifies how long to wait for a DAGSyncer.
     * Set to 0 to disable.
     */
@@ -31,6 +40,22 @@ namespace sgns::crdt
     /** NumWorkers specifies the number of workers ready to walk DAGs */
     int numWorkers = 0;
 
+    /** ValueCacheBytes bounds the memory of the cache of resolved keys
+    * served by GetKey and HasKey. Set to 0 to disable.
+    */
+    std::size_t valueCacheBytes = CrdtValueCache::DEFAULT_CAPACITY_BYTES;
+
+    /** GroupCommitWindow lets GlobalDB group the PutAsync and RemoveAsync
+    * writes made within the window into a single delta.
+    * Set to 0 to commit each write on its own.
+    */
+    long long groupCommitWindowMilliseconds = 0;
+
+    /** GroupCommitMaxOperations commits a group before its window ends
+    * once it holds that many writes
+    */
+    std::size_t groupCommitMaxOperations = GroupCommitQueue::DEFAULT_MAX_OPERATIONS;
+
     /** The PutHook function is triggered whenever an element
     * is successfully added to the datastore (either by a local
     * or remote update), and only when that addition is considered the
@@ -62,6 +87,7 @@ namespace sgns::crdt
       auto options = std::make_shared<CrdtOptions>();
       options->logger = base::createLogger("CrdtDatastore");
       options->rebroadcastIntervalMilliseconds = 10000; // 10s
+      options->rebroadcastMaxIntervalMilliseconds = 160000; // 2min 40s
       options->dagSyncerTimeoutSec = 300; // 5 mins
       options->numWorkers = 1;
       return options;
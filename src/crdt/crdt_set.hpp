@@ -3,6 +3,8 @@
 
 #include <mutex>
 #include <storage/rocksdb/rocksdb.hpp>
+#include <storage/rocksdb/rocksdb_batch.hpp>
+#include "crdt/crdt_value_cache.hpp"
 #include "crdt/hierarchical_key.hpp"
 #include "crdt/proto/delta.pb.h"
 
@@ -22,6 +24,7 @@ namespace sgns::crdt
         using Element     = pb::Element;
         using Buffer      = base::Buffer;
         using DataStore   = storage::rocksdb;
+        using Batch       = DataStore::Batch;
         using QueryResult = DataStore::QueryResult;
 
         enum class QuerySuffix
@@ -47,13 +50,15 @@ namespace sgns::crdt
         * @param aNamespace Namespce key (e.g "/namespace")
         * @param aPutHookPtr Function pointer to nofify when key added to datastore, default nullptr
         * @param aDeleteHookPtr Function pointer to nofify when key deleted from datastore, default nullptr
+        * @param aValueCacheBytes Memory budget of the resolved value cache, 0 disables it
         */
         CrdtSet( std::shared_ptr<DataStore> aDatastore,
                  const HierarchicalKey     &aNamespace,
-                 PutHookPtr                 aPutHookPtr    = nullptr,
-                 DeleteHookPtr              aDeleteHookPtr = nullptr );
+                 PutHookPtr                 aPutHookPtr     = nullptr,
+                 DeleteHookPtr              aDeleteHookPtr  = nullptr,
+                 std::size_t                aValueCacheBytes = CrdtValueCache::DEFAULT_CAPACITY_BYTES );
 
-        /** Copy constructor
+        /** Copy constructor, the copy shares the value cache of @param aSet
         */
         CrdtSet( const CrdtSet & );
 
@@ -89,6 +94,13 @@ namespace sgns::crdt
             return std::string( valueSuffix_ );
         }
 
+        /** Column families for the namespaces of a set, to open its datastore with. Values and
+        * priorities are split by suffix, elements and tombstones by namespace.
+        * @param aNamespace Namespce key of the set (e.g "/namespace/s")
+        * @return column family layout, see storage::rocksdb::ColumnFamilySpec
+        */
+        static DataStore::ColumnFamilyLayout GetColumnFamilyLayout( const HierarchicalKey &aNamespace );
+
         /** Get value from datastore for HierarchicalKey defined
         * @param aKey HierarchicalKey to get value from datastore
         * @return buffer value as string or outcome::failure on error
@@ -107,13 +119,13 @@ namespace sgns::crdt
         * @param aKey delta key to remove from datastore
         * @return pointer to delta or outcome::failure on error
         */
-        outcome::result<std::shared_ptr<Delta>> CreateDeltaToRemove( const std::string &aKey );
+        outcome::result<std::shared_ptr<Delta>> CreateDeltaToRemove( std::string_view aKey );
 
         /** Get the value of an element from the CRDT set /namespace/k/<key>/v
         * @param aKey Key name
         * @return buffer value or outcome::failure on error
         */
-        outcome::result<Buffer> GetElement( const std::string &aKey );
+        outcome::result<Buffer> GetElement( std::string_view aKey );
 
         /** Query datastore key-value pairs by prefix, if prefix empty return all elements /namespace/k/<prefix>
         * @param aPrefix prefix to search, if empty string, return all
@@ -145,69 +157,69 @@ namespace sgns::crdt
         * @param aKey key name
         * @return true if the key belongs to one of the elements and is not tombstoned or outcome::failure on error
         */
-        outcome::result<bool> IsValueInSet( const std::string &aKey );
+        outcome::result<bool> IsValueInSet( std::string_view aKey );
 
         /** Returns in we have a key/block combinations in the
         * elements set that has not been tombstoned.
         * @param aKey key name
         * @return true if the key has not been tombstoned, false otherwise or outcome::failure on error
         */
-        outcome::result<bool> InElemsNotTombstoned( const std::string &aKey );
+        outcome::result<bool> InElemsNotTombstoned( std::string_view aKey );
 
         /** Get full path prefix in namespace for a key
         * /namespace/<key>
         * @param aKey key string
         * @return HierarchicalKey with key prefix
         */
-        HierarchicalKey KeyPrefix( const std::string &aKey );
+        HierarchicalKey KeyPrefix( std::string_view aKey );
 
         /** Get elems full path prefix in namespace for a key
         * /namespace/s/<key>
         * @param aKey key string
         * @return HierarchicalKey with elems prefix
         */
-        HierarchicalKey ElemsPrefix( const std::string &aKey );
+        HierarchicalKey ElemsPrefix( std::string_view aKey );
 
         /** Get tombs full path prefix in namespace for a key
         * /namespace/t/<key>
         * @param aKey key string
         * @return HierarchicalKey with tombs prefix
         */
-        HierarchicalKey TombsPrefix( const std::string &aKey );
+        HierarchicalKey TombsPrefix( std::string_view aKey );
 
         /** Get keys full path prefix in namespace for a key
         * /namespace/k/<key>
         * @param aKey key string
         * @return HierarchicalKey with key prefix
         */
-        HierarchicalKey KeysKey( const std::string &aKey );
+        HierarchicalKey KeysKey( std::string_view aKey );
 
         /** Get value full path prefix in namespace for a key
         * /namespace/k/<key>/v
         * @param aKey key string
         * @return HierarchicalKey with value prefix
         */
-        HierarchicalKey ValueKey( const std::string &aKey );
+        HierarchicalKey ValueKey( std::string_view aKey );
 
         /** Get priority full path prefix in namespace for a key
         * /namespace/k/<key>/p
         * @param aKey key string
         * @return HierarchicalKey with priority prefix
         */
-        HierarchicalKey PriorityKey( const std::string &aKey );
+        HierarchicalKey PriorityKey( std::string_view aKey );
 
         /** Get priority for a key from datastore
         * @param aKey key string
         * @return priority of the key or outcome::failure on error
         */
-        outcome::result<uint64_t> GetPriority( const std::string &aKey );
+        outcome::result<uint64_t> GetPriority( std::string_view aKey );
 
         /** Set priority for a key and put into datastore
         * @param aKey key string
         * @param aPriority priority to save
         * @return priority of the key or outcome::failure on error
         */
-        outcome::result<void> SetPriority( const std::string &aKey, uint64_t aPriority );
+        outcome::result<void> SetPriority( std::string_view aKey, uint64_t aPriority );
 
         /** Sets a value to datastore if priority is higher. When equal, it sets if the
         * value is lexicographically higher than the current value.
@@ -217,25 +229,10 @@ namespace sgns::crdt
         * @param aPriority priority to save
         * @return priority of the key or outcome::failure on error
         */
-        outcome::result<void> SetValue( const std::string &aKey,
-                                        const std::string &aID,
-                                        const Buffer      &aValue,
-                                        uint64_t           aPriority );
-
-        /** Sets a value to datastore in batch mode if priority is higher. When equal, it sets if the
-        * value is lexicographically higher than the current value.
-        * @param aDataStore datastore batch
-        * @param aKey key string
-        * @param aID tomb key ID
-        * @param aValue buffer value to set
-        * @param aPriority priority to save
-        * @return priority of the key or outcome::failure on error
-        */
-        outcome::result<void> SetValue( const std::unique_ptr<storage::BufferBatch> &aDataStore,
-                                        const std::string                           &aKey,
-                                        const std::string                           &aID,
-                                        const Buffer                                &aValue,
-                                        uint64_t                                     aPriority );
+        outcome::result<void> SetValue( std::string_view aKey,
+                                        std::string_view aID,
+                                        const Buffer    &aValue,
+                                        uint64_t         aPriority );
 
         /** putElems adds items to the "elems" set. It will also set current
         * values and priorities for each element. This needs to run in a lock,
@@ -253,7 +250,8 @@ namespace sgns::crdt
         */
         outcome::result<void> PutElems( std::vector<Element> &aElems, const std::string &aID, uint64_t aPriority );
 
-        /** PutTombs adds items to the "tombs" set (marked as deleted)
+        /** PutTombs adds items to the "tombs" set (marked as deleted). Runs under the
+        * same lock as PutElems, so the value cache is updated in commit order.
         * @param aElems list of elems to to into datastore
         * @return outcome::success on success or outcome::failure otherwise
         */
@@ -271,7 +269,7 @@ namespace sgns::crdt
         * @param aID tomb key ID
         * @return true if key with ID is tombstoned, false otherwise or outcome::failure on error
         */
-        outcome::result<bool> InTombsKeyID( const std::string &aKey, const std::string &aID );
+        outcome::result<bool> InTombsKeyID( std::string_view aKey, std::string_view aID );
 
         /** The PutHook function is triggered whenever an element
         * is successfully added to the datastore (either by a local
@@ -301,9 +299,49 @@ namespace sgns::crdt
 
         void PrintDataStore();
 
+        /** Get hit-rate and memory counters of the resolved value cache
+        * @return snapshot of the cache counters
+        */
+        CrdtValueCache::Stats GetValueCacheStats() const;
+
     private:
         CrdtSet() = default;
 
+        /** Builds /namespace/<aNamespace>/<aKey> in place, without heap allocations for typical keys
+        * @param aNamespace one of the set namespaces (s, t, k)
+        * @param aKey key string
+        * @return builder holding the key, which can be extended further
+        */
+        HierarchicalKeyBuilder NamespaceKeyBuilder( std::string_view aNamespace, std::string_view aKey ) const;
+
+        /** Gets the value stored under a raw key view
+        * @param aKey key view, e.g. from a HierarchicalKeyBuilder
+        * @return buffer value as string or outcome::failure on error
+        */
+        outcome::result<std::string> GetRawValue( std::string_view aKey );
+
+        /** Sets a value to datastore in batch mode if priority is higher. When equal, it sets if the
+        * value is lexicographically higher than the current value. The caller updates the value
+        * cache once the batch is committed.
+        * @param aDataStore datastore batch
+        * @param aKey key string
+        * @param aID tomb key ID
+        * @param aValue buffer value to set
+        * @param aPriority priority to save
+        * @return true if the value was stored, false if the current one prevails, or outcome::failure on error
+        */
+        outcome::result<bool> StoreValue( const std::unique_ptr<Batch> &aDataStore,
+                                          std::string_view              aKey,
+                                          std::string_view              aID,
+                                          const Buffer                 &aValue,
+                                          uint64_t                      aPriority );
+
+        /** Resolves the value and tombstone state of a key, from the value cache when possible
+        * @param aKey key name
+        * @return resolved state or outcome::failure on datastore errors
+        */
+        outcome::result<CrdtValueCache::Entry> ResolveElement( std::string_view aKey );
+
         static void PrintTombs( const std::vector<Element> &aTombs );
         static void PrintElements( const std::vector<Element> &aElems );
 
@@ -313,6 +351,8 @@ namespace sgns::crdt
         PutHookPtr                 putHookFunc_    = nullptr;
         DeleteHookPtr              deleteHookFunc_ = nullptr;
 
+        std::shared_ptr<CrdtValueCache> valueCache_ = std::make_shared<CrdtValueCache>( 0 );
+
         static constexpr std::string_view elemsNamespace_ = "s"; // "s" -> elements namespace /set/s/<key>/<block>
         static constexpr std::string_view tombsNamespace_ = "t"; // "t" -> tombstones namespace /set/t/<key>/<block>
         static constexpr std::string_view keysNamespace_  = "k"; // "k" -> keys namespace /set/k/<key>/{v,p}
@@ -0,0 +1,161 @@
+#ifndef SUPERGENIUS_CRDT_VALUE_CACHE_HPP
+#define SUPERGENIUS_CRDT_VALUE_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace sgns::crdt
+{
+    /** @brief Bounded, sharded cache of the resolved state of CRDT set keys.
+    * Resolving a key in the set takes a value lookup plus a prefix scan of the
+    * elements and a tombstone lookup per element. The cache keeps the outcome of
+    * that resolution for recently used keys, and is updated by the set writers
+    * after each batch is committed.
+    *
+    * Readers that miss take a ticket with @ref BeginLoad before reading the
+    * datastore and hand it to @ref Fill. Any write to the same shard in between
+    * invalidates the ticket, so a stale read is never cached.
+    */
+    class CrdtValueCache
+    {
+    public:
+        /// Resolved state of a key in the set
+        struct Entry
+        {
+            std::optional<std::string> value;      ///< Current value, empty if the key was never added
+            std::optional<uint64_t>    priority;   ///< Priority of the value, empty if not loaded
+            bool                       tombstoned = false; ///< All the elements of the key are tombstoned
+        };
+
+        /// Cache counters, aggregated over all shards
+        struct Stats
+        {
+            uint64_t    hits          = 0;
+            uint64_t    misses        = 0;
+            uint64_t    insertions    = 0;
+            uint64_t    evictions     = 0;
+            uint64_t    invalidations = 0;
+            std::size_t entries       = 0;
+            std::size_t bytes         = 0;
+            std::size_t capacityBytes = 0;
+
+            /** Ratio of lookups served from the cache
+            * @return hit rate between 0 and 1
+            */
+            double HitRate() const
+            {
+                const auto lookups = hits + misses;
+                return lookups == 0 ? 0.0 : static_cast<double>( hits ) / static_cast<double>( lookups );
+            }
+        };
+
+        using Ticket = uint64_t;
+
+        static constexpr std::size_t DEFAULT_CAPACITY_BYTES = 16 * 1024 * 1024;
+        static constexpr std::size_t DEFAULT_SHARD_COUNT    = 16;
+
+        /** Constructor
+        * @param aCapacityBytes Memory budget of the cache, 0 disables it
+        * @param aShardCount Number of independently locked shards
+        */
+        explicit CrdtValueCache( std::size_t aCapacityBytes = DEFAULT_CAPACITY_BYTES,
+                                 std::size_t aShardCount    = DEFAULT_SHARD_COUNT );
+
+        CrdtValueCache( const CrdtValueCache & )            = delete;
+        CrdtValueCache &operator=( const CrdtValueCache & ) = delete;
+
+        /** Checks if the cache holds anything at all
+        * @return false when built with a zero budget
+        */
+        bool IsEnabled() const
+        {
+            return capacityBytes_ != 0;
+        }
+
+        /** Looks up the resolved state of a key, marking it as recently used
+        * @param aKey key name
+        * @return cached entry or std::nullopt on miss
+        */
+        std::optional<Entry> Get( std::string_view aKey );
+
+        /** Takes a ticket before reading the state of a key from the datastore
+        * @param aKey key name
+        * @return ticket to be passed to @ref Fill
+        */
+        Ticket BeginLoad( std::string_view aKey ) const;
+
+        /** Caches state read from the datastore, unless a write hit the key's shard since the ticket was taken
+        * @param aKey key name
+        * @param aEntry resolved state
+        * @param aTicket ticket returned by @ref BeginLoad
+        * @return true if the entry was cached
+        */
+        bool Fill( std::string_view aKey, Entry aEntry, Ticket aTicket );
+
+        /** Stores state written by the set, replacing any cached entry
+        * @param aKey key name
+        * @param aEntry resolved state
+        */
+        void Put( std::string_view aKey, Entry aEntry );
+
+        /** Drops the cached state of a key
+        * @param aKey key name
+        */
+        void Invalidate( std::string_view aKey );
+
+        /** Drops every cached entry
+        */
+        void Clear();
+
+        /** Get the cache counters
+        * @return snapshot of the counters
+        */
+        Stats GetStats() const;
+
+    private:
+        struct Node
+        {
+            std::string key;
+            Entry       entry;
+            std::size_t bytes = 0;
+        };
+
+        using LruList = std::list<Node>;
+
+        struct Shard
+        {
+            mutable std::mutex                                      mutex;
+            LruList                                                 lru;   ///< Most recently used first
+            std::unordered_map<std::string_view, LruList::iterator> index; ///< Views point into the list nodes
+            std::size_t                                             bytes = 0;
+            std::atomic<uint64_t>                                   generation{ 0 };
+        };
+
+        Shard &GetShard( std::string_view aKey ) const;
+        void   Store( Shard &aShard, std::string_view aKey, Entry aEntry );
+        bool   Erase( Shard &aShard, std::string_view aKey );
+
+        static std::size_t EntryBytes( std::string_view aKey, const Entry &aEntry );
+
+        const std::size_t        capacityBytes_;
+        const std::size_t        shardCount_;
+        const std::size_t        shardCapacityBytes_;
+        std::unique_ptr<Shard[]> shards_;
+
+        std::atomic<uint64_t> hits_{ 0 };
+        std::atomic<uint64_t> misses_{ 0 };
+        std::atomic<uint64_t> insertions_{ 0 };
+        std::atomic<uint64_t> evictions_{ 0 };
+        std::atomic<uint64_t> invalidations_{ 0 };
+    };
+} // namespace sgns::crdt
+
+#endif //SUPERGENIUS_CRDT_VALUE_CACHE_HPP
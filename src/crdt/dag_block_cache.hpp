@@ -0,0 +1,236 @@
+#ifndef SUPERGENIUS_DAG_BLOCK_CACHE_HPP
+#define SUPERGENIUS_DAG_BLOCK_CACHE_HPP
+
+#include <primitives/cid/cid.hpp>
+#include <ipfs_lite/ipld/ipld_node.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sgns::crdt
+{
+    /** @brief Memory budgeted cache of decoded DAG nodes shared by the DAG syncer lookups.
+    *
+    * The cache has two independent tiers:
+    * - The clean tier holds nodes that are already persisted in the block store. It is
+    *   split in shards, each one with its own lock and a segmented LRU: new nodes enter a
+    *   probation segment and move to a protected segment when hit again. A TinyLFU
+    *   frequency sketch decides whether a new node is worth evicting the current victim
+    *   for, so a traversal over many cold blocks can't flush the hot ones. Evicted nodes
+    *   are simply dropped, the block store being the next tier.
+    * - The pending tier holds blocks that were requested or received but not processed
+    *   yet. These must never reach the block store on their own, since having a block
+    *   there means that it was processed, so the tier is bounded by its own budget and
+    *   evicts in LRU order.
+    */
+    class DAGBlockCache
+    {
+    public:
+        using IPLDNode = ipfs_lite::ipld::IPLDNode;
+
+        /// Cache counters, aggregated over all shards
+        struct Stats
+        {
+            uint64_t    hits             = 0; ///< Lookups served by the clean tier
+            uint64_t    misses           = 0; ///< Lookups that went to the block store
+            uint64_t    admissions       = 0; ///< Nodes inserted in the clean tier
+            uint64_t    rejections       = 0; ///< Nodes refused by the admission policy
+            uint64_t    evictions        = 0; ///< Nodes evicted from the clean tier
+            uint64_t    pendingEvictions = 0; ///< Entries evicted from the pending tier
+            std::size_t entries          = 0; ///< Nodes resident in the clean tier
+            std::size_t bytes            = 0; ///< Estimated bytes resident in the clean tier
+            std::size_t protectedBytes   = 0; ///< Part of @ref bytes in the protected segment
+            std::size_t capacityBytes    = 0; ///< Budget of the clean tier
+            std::size_t pendingEntries   = 0; ///< Entries in the pending tier, with or without content
+            std::size_t pendingBytes     = 0; ///< Estimated bytes held by the pending tier
+
+            /** Ratio of lookups served from the clean tier
+            * @return hit rate between 0 and 1
+            */
+            double HitRate() const
+            {
+                const auto lookups = hits + misses;
+                return lookups == 0 ? 0.0 : static_cast<double>( hits ) / static_cast<double>( lookups );
+            }
+        };
+
+        static constexpr std::size_t DEFAULT_CAPACITY_BYTES         = 64 * 1024 * 1024;
+        static constexpr std::size_t DEFAULT_PENDING_CAPACITY_BYTES = 32 * 1024 * 1024;
+        static constexpr std::size_t DEFAULT_PENDING_MAX_ENTRIES    = 250;
+        static constexpr std::size_t DEFAULT_SHARD_COUNT            = 16;
+
+        /** Constructor
+        * @param aCapacityBytes Memory budget of the clean tier, 0 disables it
+        * @param aPendingCapacityBytes Memory budget of the pending tier
+        * @param aPendingMaxEntries Maximum number of entries in the pending tier
+        * @param aShardCount Number of independently locked shards of the clean tier
+        */
+        explicit DAGBlockCache( std::size_t aCapacityBytes        = DEFAULT_CAPACITY_BYTES,
+                                std::size_t aPendingCapacityBytes = DEFAULT_PENDING_CAPACITY_BYTES,
+                                std::size_t aPendingMaxEntries    = DEFAULT_PENDING_MAX_ENTRIES,
+                                std::size_t aShardCount           = DEFAULT_SHARD_COUNT );
+
+        DAGBlockCache( const DAGBlockCache & )            = delete;
+        DAGBlockCache &operator=( const DAGBlockCache & ) = delete;
+
+        /** Looks up a persisted node in the clean tier
+        * @param aCid Content identifier of the node
+        * @return cached node or nullptr on miss
+        */
+        std::shared_ptr<IPLDNode> Get( const CID &aCid );
+
+        /** Offers a node read from the block store to the clean tier
+        * @param aCid Content identifier of the node
+        * @param aNode Decoded node
+        * @return true if the node is resident after the call
+        */
+        bool Insert( const CID &aCid, std::shared_ptr<IPLDNode> aNode );
+
+        /** Drops a node removed from the block store
+        * @param aCid Content identifier of the node
+        */
+        void Erase( const CID &aCid );
+
+        /** Marks a CID as requested, without content
+        * @param aCid Content identifier of the node
+        */
+        void MarkPending( const CID &aCid );
+
+        /** Stores a received block that wasn't processed yet
+        * @param aCid Content identifier of the node
+        * @param aNode Decoded node
+        * @return true if a new pending entry was created, false if an existing one was updated
+        */
+        bool AddPending( const CID &aCid, std::shared_ptr<IPLDNode> aNode );
+
+        /** Looks up the content of a pending block
+        * @param aCid Content identifier of the node
+        * @return pending node or nullptr if there is no entry or it has no content yet
+        */
+        std::shared_ptr<IPLDNode> GetPending( const CID &aCid );
+
+        /** Checks if a CID has a pending entry, with or without content
+        * @param aCid Content identifier of the node
+        * @return true if the CID is pending
+        */
+        bool IsPending( const CID &aCid ) const;
+
+        /** Drops a pending entry
+        * @param aCid Content identifier of the node
+        * @return true if there was an entry
+        */
+        bool RemovePending( const CID &aCid );
+
+        /** Drops everything in both tiers
+        */
+        void Clear();
+
+        /** Get the cache counters
+        * @return snapshot of the counters
+        */
+        Stats GetStats() const;
+
+        /** Estimates the memory held by a decoded node
+        * @param aNode Decoded node
+        * @return estimated size in bytes
+        */
+        static std::size_t NodeBytes( const IPLDNode &aNode );
+
+    private:
+        /// Count-min sketch of counters saturating at 15, halved periodically, as used by TinyLFU
+        class FrequencySketch
+        {
+        public:
+            explicit FrequencySketch( std::size_t aExpectedEntries );
+
+            void     Increment( uint64_t aHash );
+            uint32_t Estimate( uint64_t aHash ) const;
+
+        private:
+            static constexpr std::size_t DEPTH       = 4;
+            static constexpr uint8_t     MAX_COUNTER = 15;
+
+            std::size_t Index( uint64_t aHash, std::size_t aRow ) const;
+            void        Age();
+
+            std::vector<uint8_t> table_;
+            std::size_t          widthMask_;
+            std::size_t          sampleSize_;
+            std::size_t          additions_ = 0;
+        };
+
+        enum class Segment
+        {
+            PROBATION,
+            PROTECTED,
+        };
+
+        struct CleanEntry
+        {
+            std::shared_ptr<IPLDNode> node;
+            std::size_t               bytes = 0;
+            Segment                   segment;
+            std::list<CID>::iterator  position;
+        };
+
+        struct Shard
+        {
+            explicit Shard( std::size_t aExpectedEntries ) : sketch( aExpectedEntries )
+            {
+            }
+
+            mutable std::mutex         mutex;
+            std::map<CID, CleanEntry>  entries;
+            std::list<CID>             probation;       ///< Most recently used first
+            std::list<CID>             protectedList;   ///< Most recently used first
+            std::size_t                probationBytes = 0;
+            std::size_t                protectedBytes = 0;
+            FrequencySketch            sketch;
+        };
+
+        struct PendingEntry
+        {
+            std::shared_ptr<IPLDNode> node;
+            std::size_t               bytes = 0;
+            std::list<CID>::iterator  position;
+        };
+
+        static uint64_t HashCid( const CID &aCid );
+
+        Shard &GetShard( uint64_t aHash ) const;
+        void   Touch( Shard &aShard, CleanEntry &aEntry );
+        void   Admit( Shard &aShard, const CID &aCid, std::shared_ptr<IPLDNode> aNode, std::size_t aBytes );
+        void   EraseClean( Shard &aShard, std::map<CID, CleanEntry>::iterator aIt );
+        void   RebalanceProtected( Shard &aShard );
+        void   EvictPending();
+        void   ErasePending( std::map<CID, PendingEntry>::iterator aIt );
+
+        const std::size_t                   capacityBytes_;
+        const std::size_t                   shardCount_;
+        const std::size_t                   shardCapacityBytes_;
+        const std::size_t                   protectedCapacityBytes_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+
+        const std::size_t           pendingCapacityBytes_;
+        const std::size_t           pendingMaxEntries_;
+        mutable std::mutex          pendingMutex_;
+        std::map<CID, PendingEntry> pending_;
+        std::list<CID>              pendingLru_; ///< Most recently used first
+        std::size_t                 pendingBytes_ = 0;
+
+        std::atomic<uint64_t> hits_{ 0 };
+        std::atomic<uint64_t> misses_{ 0 };
+        std::atomic<uint64_t> admissions_{ 0 };
+        std::atomic<uint64_t> rejections_{ 0 };
+        std::atomic<uint64_t> evictions_{ 0 };
+        std::atomic<uint64_t> pendingEvictions_{ 0 };
+    };
+} // namespace sgns::crdt
+
+#endif //SUPERGENIUS_DAG_BLOCK_CACHE_HPP
@@ -19,6 +19,7 @@
 #include <libp2p/injector/kademlia_injector.hpp>
 #include <boost/di/extension/scopes/shared.hpp>
 #include <boost/format.hpp>
+#include <algorithm>
 
 #if defined( _WIN32 )
 #include <winsock2.h>
@@ -50,6 +51,8 @@ OUTCOME_CPP_DEFINE_CATEGORY_3( sgns::crdt, GlobalDB::Error, e )
             return "Invalid parameters provided";
         case ProofError::GLOBALDB_NOT_STARTED:
             return "Start method wasn't called";
+        case ProofError::INCOMPATIBLE_DATASTORE:
+            return "Datastore column families don't match the CRDT ones";
     }
     return "Unknown error";
 }
@@ -67,6 +70,24 @@ namespace sgns::crdt
     using GraphsyncImpl      = ipfs_lite::ipfs::graphsync::GraphsyncImpl;
     using GossipPubSubTopic  = ipfs_pubsub::GossipPubSubTopic;
 
+    namespace
+    {
+        /// Same families holding the same keys, their tuning may differ
+        bool SameKeyLayout( const storage::rocksdb::ColumnFamilyLayout &lhs,
+                            const storage::rocksdb::ColumnFamilyLayout &rhs )
+        {
+            return std::equal( lhs.begin(),
+                               lhs.end(),
+                               rhs.begin(),
+                               rhs.end(),
+                               []( const auto &lhsSpec, const auto &rhsSpec )
+                               {
+                                   return lhsSpec.name == rhsSpec.name && lhsSpec.keyPrefix == rhsSpec.keyPrefix &&
+                                          lhsSpec.keySuffix == rhsSpec.keySuffix;
+                               } );
+        }
+    }
+
     outcome::result<std::shared_ptr<GlobalDB>> GlobalDB::New(
         std::shared_ptr<boost::asio::io_context>                              context,
         std::string                                                           databasePath,
@@ -106,6 +127,8 @@ namespace sgns::crdt
     GlobalDB::~GlobalDB()
     {
         m_logger->debug( "~GlobalDB CALLED" );
+        // Publishes the grouped writes still pending
+        m_groupCommit.reset();
         m_broadcaster->Stop();
         m_crdtDatastore->Close();
     }
@@ -117,7 +140,16 @@ namespace sgns::crdt
         std::shared_ptr<sgns::ipfs_lite::ipfs::graphsync::RequestIdGenerator> generator,
         std::shared_ptr<RocksDB>                                              datastore )
     {
+        const HierarchicalKey crdtNamespace( "crdt" );
+        const auto            layout = CrdtDatastore::GetColumnFamilyLayout( crdtNamespace );
+
         std::shared_ptr<RocksDB> dataStore = std::move( datastore );
+        if ( dataStore != nullptr && !SameKeyLayout( dataStore->GetColumnFamilyLayout(), layout ) )
+        {
+            // Its CRDT keys would go to other families than the ones of the nodes opening the database themselves
+            m_logger->error( "The datastore wasn't opened with the CRDT column families" );
+            return Error::INCOMPATIBLE_DATASTORE;
+        }
         if ( dataStore == nullptr )
         {
             auto databasePathAbsolute = boost::filesystem::absolute( m_databasePath ).string();
@@ -134,7 +166,7 @@ namespace sgns::crdt
             options.level_compaction_dynamic_level_bytes = false;
             try
             {
-                if ( auto dataStoreResult = RocksDB::create( databasePathAbsolute, options );
+                if ( auto dataStoreResult = RocksDB::create( databasePathAbsolute, options, layout );
                      dataStoreResult.has_value() )
                 {
                     dataStore = dataStoreResult.value();
@@ -193,7 +225,7 @@ namespace sgns::crdt
             return Error::PUBSUB_BROADCASTER_NOT_CREATED;
         }
         m_crdtDatastore = CrdtDatastore::New( m_datastore,
-                                              HierarchicalKey( "crdt" ),
+                                              crdtNamespace,
                                               dagSyncer,
                                               m_broadcaster,
                                               crdtOptions );
@@ -202,6 +234,17 @@ namespace sgns::crdt
             m_logger->error( "Unable to create CRDT datastore" );
             return Error::CRDT_DATASTORE_NOT_CREATED;
         }
+        if ( crdtOptions->groupCommitWindowMilliseconds > 0 )
+        {
+            EnableGroupCommit( std::chrono::milliseconds( crdtOptions->groupCommitWindowMilliseconds ),
+                               crdtOptions->groupCommitMaxOperations );
+        }
+
+        // The set layout is fixed for the datastore lifetime, so resolve it once for KeyToString
+        BOOST_OUTCOME_TRY( auto &&keysPrefix, m_crdtDatastore->GetKeysPrefix() );
+        BOOST_OUTCOME_TRY( auto &&valueSuffix, m_crdtDatastore->GetValueSuffix() );
+        m_keysPrefix  = std::move( keysPrefix );
+        m_valueSuffix = std::move( valueSuffix );
 
         return outcome::success();
     }
@@ -260,6 +303,67 @@ namespace sgns::crdt
         return m_crdtDatastore->DeleteKey( key, topics );
     }
 
+    void GlobalDB::EnableGroupCommit( std::chrono::milliseconds window, size_t max_operations )
+    {
+        m_groupCommit = std::make_unique<GroupCommitQueue>(
+            [datastore = m_crdtDatastore]( const std::vector<GroupCommitQueue::Operation> &operations,
+                                           const std::set<std::string>                    &topics ) -> outcome::result<void>
+            {
+                AtomicTransaction batch( datastore );
+                for ( const auto &operation : operations )
+                {
+                    if ( operation.type == GroupCommitQueue::Operation::Type::PUT )
+                    {
+                        BOOST_OUTCOME_TRYV2( auto &&, batch.Put( operation.key, operation.value ) );
+                    }
+                    else
+                    {
+                        BOOST_OUTCOME_TRYV2( auto &&, batch.Remove( operation.key ) );
+                    }
+                }
+                return batch.Commit( topics );
+            },
+            window,
+            max_operations );
+        m_logger->info( "Group commit enabled, window {} ms, up to {} writes per delta",
+                        window.count(),
+                        max_operations );
+    }
+
+    std::future<outcome::result<void>> GlobalDB::PutAsync( const HierarchicalKey &key,
+                                                           const Buffer          &value,
+                                                           std::set<std::string>  topics )
+    {
+        if ( !m_groupCommit || !started_ )
+        {
+            std::promise<outcome::result<void>> promise;
+            promise.set_value( Put( key, value, std::move( topics ) ) );
+            return promise.get_future();
+        }
+        return m_groupCommit->Enqueue( { GroupCommitQueue::Operation::Type::PUT, key, value }, std::move( topics ) );
+    }
+
+    std::future<outcome::result<void>> GlobalDB::RemoveAsync( const HierarchicalKey &key, std::set<std::string> topics )
+    {
+        if ( !m_groupCommit || !started_ )
+        {
+            std::promise<outcome::result<void>> promise;
+            promise.set_value( Remove( key, topics ) );
+            return promise.get_future();
+        }
+        return m_groupCommit->Enqueue( { GroupCommitQueue::Operation::Type::REMOVE, key, Buffer() },
+                                       std::move( topics ) );
+    }
+
+    std::optional<GroupCommitQueue::Stats> GlobalDB::GetGroupCommitStats() const
+    {
+        if ( !m_groupCommit )
+        {
+            return std::nullopt;
+        }
+        return m_groupCommit->GetStats();
+    }
+
     outcome::result<GlobalDB::QueryResult> GlobalDB::QueryKeyValues( const std::string &keyPrefix )
     {
         return m_crdtDatastore->QueryKeyValues( keyPrefix );
@@ -280,35 +384,25 @@ namespace sgns::crdt
 
     outcome::result<std::string> GlobalDB::KeyToString( const Buffer &key ) const
     {
-        // @todo cache the prefix and suffix
-        auto keysPrefix = m_crdtDatastore->GetKeysPrefix();
-        if ( !keysPrefix.has_value() )
-        {
-            return outcome::failure( boost::system::error_code{} );
-        }
-        auto valueSuffix = m_crdtDatastore->GetValueSuffix();
-        if ( !valueSuffix.has_value() )
-        {
-            return outcome::failure( boost::system::error_code{} );
-        }
+        const std::string_view keysPrefix  = m_keysPrefix;
+        const std::string_view valueSuffix = m_valueSuffix;
 
-        auto sKey = std::string( key.toString() );
+        auto sKey = key.toString();
 
-        size_t prefixPos = ( !keysPrefix.value().empty() ) ? sKey.find( keysPrefix.value(), 0 ) : 0;
+        size_t prefixPos = ( !keysPrefix.empty() ) ? sKey.find( keysPrefix, 0 ) : 0;
         if ( prefixPos != 0 )
         {
             return outcome::failure( boost::system::error_code{} );
         }
 
-        size_t keyPos    = keysPrefix.value().size();
-        auto   suffixPos = ( !valueSuffix.value().empty() ) ? sKey.rfind( valueSuffix.value(), std::string::npos )
-                                                            : sKey.size();
-        if ( ( suffixPos == std::string::npos ) || ( suffixPos < keyPos ) )
+        size_t keyPos    = keysPrefix.size();
+        auto   suffixPos = ( !valueSuffix.empty() ) ? sKey.rfind( valueSuffix, std::string_view::npos ) : sKey.size();
+        if ( ( suffixPos == std::string_view::npos ) || ( suffixPos < keyPos ) )
         {
             return outcome::failure( boost::system::error_code{} );
         }
 
-        return sKey.substr( keyPos, suffixPos - keyPos );
+        return std::string( sKey.substr( keyPos, suffixPos - keyPos ) );
     }
 
     void GlobalDB::PrintDataStore()
@@ -9,6 +9,7 @@
 #include "crdt/crdt_options.hpp"
 #include "crdt/crdt_datastore.hpp"
 #include "crdt/atomic_transaction.hpp"
+#include "crdt/group_commit_queue.hpp"
 #include <libp2p/protocol/identify/identify.hpp>
 #include <libp2p/protocol/autonat/autonat.hpp>
 #include <libp2p/protocol/holepunch/holepunch_server.hpp>
@@ -34,7 +35,8 @@ namespace sgns::crdt
          * @param[in]   graphsyncnetwork The graphsync networks used
          * @param[in]   scheduler libp2p scheduler
          * @param[in]   generator The request ID generator from graphsync
-         * @param[in]   datastore datastore to be used. If not defined, created using databasePath
+         * @param[in]   datastore datastore to be used. If not defined, created using databasePath. It has to be opened
+         *              with CrdtDatastore::GetColumnFamilyLayout of the "crdt" namespace
          * @return      Instance of the GlobalDB initialized or Error
          */
         static outcome::result<std::shared_ptr<GlobalDB>> New(
@@ -70,6 +72,7 @@ namespace sgns::crdt
             PUBSUB_BROADCASTER_NOT_CREATED, ///< CRDT DataStore not created
             INVALID_PARAMETERS,             ///< Invalid parameters
             GLOBALDB_NOT_STARTED,           ///< Start wasn't called
+            INCOMPATIBLE_DATASTORE,         ///< Datastore not opened with the CRDT column families
         };
 
         /**
@@ -99,6 +102,40 @@ namespace sgns::crdt
         */
         outcome::result<void> Remove( const HierarchicalKey &key, const std::set<std::string> &topics );
 
+        /**
+         * @brief       Groups the writes of PutAsync and RemoveAsync into shared deltas, instead of one delta each
+         * @param[in]   window How long the first write of a group waits for others to the same topics
+         * @param[in]   max_operations Number of writes that commits a group before its window ends
+         * @note        Call it before the first PutAsync or RemoveAsync. Grouped writes are only visible to Get
+         *              once their group is committed.
+         */
+        void EnableGroupCommit( std::chrono::milliseconds window         = GroupCommitQueue::DEFAULT_WINDOW,
+                                size_t                    max_operations = GroupCommitQueue::DEFAULT_MAX_OPERATIONS );
+
+        /**
+         * @brief       Puts a key-value pair like Put, grouped with other writes if group commit is enabled
+         * @param[in]   key The hierarchical key where the value should be stored.
+         * @param[in]   value The value to store.
+         * @param[in]   topics Topics the write is broadcast on
+         * @return      Future holding the outcome of the write once it is published
+         */
+        std::future<outcome::result<void>> PutAsync( const HierarchicalKey &key,
+                                                     const Buffer          &value,
+                                                     std::set<std::string>  topics );
+
+        /**
+         * @brief       Removes a key like Remove, grouped with other writes if group commit is enabled
+         * @param[in]   key The key to remove
+         * @param[in]   topics Topics the write is broadcast on
+         * @return      Future holding the outcome of the write once it is published
+         */
+        std::future<outcome::result<void>> RemoveAsync( const HierarchicalKey &key, std::set<std::string> topics );
+
+        /**
+         * @brief       Number of writes grouped so far and of the deltas they made, empty if group commit is disabled
+         */
+        std::optional<GroupCommitQueue::Stats> GetGroupCommitStats() const;
+
         /** Queries CRDT key-value pairs by prefix. If the prefix is empty returns all elements that were not tombstoned
         * @param prefix - keys prefix to match. An empty prefix matches any key.
         * @return list of key-value pairs matches prefix
@@ -178,7 +215,10 @@ namespace sgns::crdt
 
         int obsAddrRetries = 0;
 
-        std::shared_ptr<CrdtDatastore> m_crdtDatastore;
+        std::shared_ptr<CrdtDatastore>    m_crdtDatastore;
+        std::unique_ptr<GroupCommitQueue> m_groupCommit; ///< Only set if group commit is enabled
+        std::string                       m_keysPrefix;  ///< Cached CRDT set keys prefix, e.g. /crdt/s/k/
+        std::string                       m_valueSuffix; ///< Cached CRDT set value suffix, e.g. /v
 
         //Default Bootstrap Servers
         std::vector<std::string> bootstrapAddresses_ = {
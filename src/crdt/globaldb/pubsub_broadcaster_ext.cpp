@@ -89,6 +89,8 @@ namespace sgns::crdt
     PubSubBroadcasterExt ::~PubSubBroadcasterExt()
     {
         m_logger->debug( "~PubSubBroadcasterExt CALLED" );
+        std::lock_guard<std::mutex> lock( queueMutex_ );
+        messagesQueued_.Sub( static_cast<int64_t>( messageQueue_.size() ) );
     }
 
     void PubSubBroadcasterExt::Start()
@@ -214,6 +216,7 @@ namespace sgns::crdt
             if ( new_content )
             {
                 messageQueue_.emplace( std::move( peerId ), bmsg.data() );
+                messagesQueued_.Add();
             }
             else
             {
@@ -306,6 +309,7 @@ namespace sgns::crdt
 
         std::string strBuffer = std::get<1>( messageQueue_.front() );
         messageQueue_.pop();
+        messagesQueued_.Sub();
 
         base::Buffer buffer;
         buffer.put( strBuffer );
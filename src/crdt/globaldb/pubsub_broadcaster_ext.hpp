@@ -4,6 +4,7 @@
 #include "crdt/broadcaster.hpp"
 #include "crdt/graphsync_dagsyncer.hpp"
 #include "base/logger.hpp"
+#include "base/metrics.hpp"
 #include <ipfs_pubsub/gossip_pubsub_topic.hpp>
 #include <queue>
 #include <tuple>
@@ -108,6 +109,10 @@ namespace sgns::crdt
         std::mutex       subscriptionMutex_;    ///< protects subscriptionFutures_
         std::atomic_bool started_;
 
+        base::Gauge &messagesQueued_ = base::MetricsRegistry::Instance().GetGauge(
+            "pubsub_broadcast_messages_queued",
+            "Received broadcasts waiting to be merged" );
+
         sgns::base::Logger m_logger = sgns::base::createLogger( "PubSubBroadcasterExt" );
         std::vector<std::future<libp2p::protocol::Subscription>> subscriptionFutures_;
     };
@@ -2,7 +2,9 @@
 #define SUPERGENIUS_GRAPHSYNC_DAGSYNCER_HPP
 
 #include "crdt/dagsyncer.hpp"
+#include "crdt/dag_block_cache.hpp"
 #include "base/logger.hpp"
+#include "base/metrics.hpp"
 
 #include <ipfs_lite/ipfs/graphsync/impl/merkledag_bridge_impl.hpp>
 #include <ipfs_lite/ipfs/merkledag/impl/merkledag_service_impl.hpp>
@@ -125,6 +127,11 @@ namespace sgns::crdt
 
         void Stop() override;
 
+        /** Get the counters of the block cache shared by the node lookups
+        * @return snapshot of the counters
+        */
+        DAGBlockCache::Stats GetBlockCacheStats() const;
+
     protected:
         static constexpr uint64_t TIMEOUT_SECONDS = 1200;
         static constexpr uint64_t MAX_FAILURES    = 3;
@@ -134,6 +141,14 @@ namespace sgns::crdt
             boost::optional<std::vector<Multiaddress>> address,
             const CID                                 &root_cid ) const;
 
+        /** Waits for a requested node to be received
+        * @param cid - requested node
+        * @param peerID - peer the node was requested from, blacklisted if the request fails
+        * @return the node or outcome::failure if the request failed
+        */
+        outcome::result<std::shared_ptr<ipfs_lite::ipld::IPLDNode>> WaitForRequestedNode( const CID    &cid,
+                                                                                            const PeerId &peerID ) const;
+
         void RequestProgressCallback( ResponseStatusCode code, const std::vector<Extension> &extensions ) const;
         void BlockReceivedCallback( const CID &cid, sgns::common::Buffer buffer );
 
@@ -150,6 +165,13 @@ namespace sgns::crdt
 
         Logger logger_ = base::createLogger( "GraphsyncDAGSyncer" );
 
+        base::Histogram &fetch_latency_ = base::MetricsRegistry::Instance().GetHistogram(
+            "graphsync_fetch_latency_us",
+            "Time from a node request to its reception, in microseconds" );
+        base::Counter &fetch_failures_ = base::MetricsRegistry::Instance().GetCounter(
+            "graphsync_fetch_failures_total",
+            "Node requests that failed" );
+
         // keeping subscriptions alive, otherwise they cancel themselves
         // class Subscription have non-copyable constructor and operator, so it can not be used in std::vector
         // std::vector<Subscription> requests_;
@@ -167,10 +189,9 @@ namespace sgns::crdt
         mutable RouteMapType routing_;
         mutable std::mutex   routing_mutex_;
 
-        mutable std::map<Multihash, BlacklistEntry>                       blacklist_;
-        mutable std::mutex                                                blacklist_mutex_;
-        mutable std::mutex                                                mutex_;
-        mutable std::map<CID, std::shared_ptr<ipfs_lite::ipld::IPLDNode>> received_blocks_;
+        mutable std::map<Multihash, BlacklistEntry> blacklist_;
+        mutable std::mutex                          blacklist_mutex_;
+        mutable std::mutex                          mutex_;
 
         // Helper methods for the peer registry
         PeerKey                    RegisterPeer( const PeerId &peer, const std::vector<Multiaddress> &address ) const;
@@ -203,34 +224,9 @@ namespace sgns::crdt
         void RecordSuccessfulConnection( const PeerId &peer ) const;
 
     private:
-        struct LRUCIDCache
-        {
-            // Maximum number of blocks to store in the cache
-            static constexpr size_t MAX_CACHE_SIZE = 250;
-
-            // Main storage: CID -> (Node, list iterator)
-            std::map<CID, std::pair<std::shared_ptr<ipfs_lite::ipld::IPLDNode>, std::list<CID>::iterator>> cache_map_;
-
-            // LRU list: most recently used at front, least recently used at back
-            std::list<CID> lru_list_;
-
-            void init( const CID &cid );
-            bool add( const CID &cid, std::shared_ptr<ipfs_lite::ipld::IPLDNode> node );
-            std::shared_ptr<ipfs_lite::ipld::IPLDNode> get( const CID &cid );
-            bool                                       remove( const CID &cid );
-            bool                                       contains( const CID &cid ) const;
-
-            bool hasContent( const CID &cid ) const;
-
-            size_t size() const
-            {
-                return cache_map_.size();
-            }
-        };
-
-        mutable LRUCIDCache lru_cid_cache_;
-        mutable std::mutex  cache_mutex_;
-        std::atomic<bool>   is_stopped_{ false };
+        /// Persisted nodes plus the blocks requested or received but not processed yet
+        mutable DAGBlockCache blockCache_;
+        std::atomic<bool>     is_stopped_{ false };
     };
 
 }
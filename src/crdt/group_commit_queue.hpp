@@ -0,0 +1,152 @@
+/**
+ * @file       group_commit_queue.hpp
+ * @brief      Coalescing of single key CRDT writes into shared deltas
+ * @date       2026-10-18
+ */
+
+#ifndef SUPERGENIUS_CRDT_GROUP_COMMIT_QUEUE_HPP
+#define SUPERGENIUS_CRDT_GROUP_COMMIT_QUEUE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "base/buffer.hpp"
+#include "crdt/hierarchical_key.hpp"
+#include "outcome/outcome.hpp"
+
+namespace sgns::crdt
+{
+    /**
+     * @brief       Collects the single key writes of concurrent callers and commits them together.
+     *              Every write committed on its own becomes an IPLD node, a head replacement and a broadcast,
+     *              so writes to the same topic set are grouped for a short window, or until the group is full,
+     *              and committed as one delta. Each caller gets a future completed once its group is published.
+     */
+    class GroupCommitQueue
+    {
+    public:
+        using Buffer = base::Buffer;
+
+        static constexpr std::chrono::milliseconds DEFAULT_WINDOW{ 20 };
+        static constexpr size_t                    DEFAULT_MAX_OPERATIONS = 256;
+
+        /**
+         * @brief       A write waiting for its group to be committed
+         */
+        struct Operation
+        {
+            enum class Type
+            {
+                PUT,
+                REMOVE
+            };
+
+            Type            type;
+            HierarchicalKey key;
+            Buffer          value; ///< Empty for REMOVE
+        };
+
+        /**
+         * @brief       Commits a group of operations as a single delta on the given topics
+         */
+        using CommitFunction =
+            std::function<outcome::result<void>( const std::vector<Operation> &, const std::set<std::string> & )>;
+
+        /**
+         * @brief       Counters of the writes and of the deltas they were grouped into
+         */
+        struct Stats
+        {
+            uint64_t operations = 0; ///< Writes committed
+            uint64_t deltas     = 0; ///< Groups committed, one DAG node each
+            uint64_t bytes      = 0; ///< Key and value bytes of the writes committed
+            uint64_t failures   = 0; ///< Groups whose commit failed
+
+            double OperationsPerDelta() const
+            {
+                return deltas == 0 ? 0.0 : static_cast<double>( operations ) / static_cast<double>( deltas );
+            }
+
+            double BytesPerOperation() const
+            {
+                return operations == 0 ? 0.0 : static_cast<double>( bytes ) / static_cast<double>( operations );
+            }
+        };
+
+        /**
+         * @brief       Starts the thread committing the groups
+         * @param[in]   commit Commits a group, called from the queue's thread only
+         * @param[in]   window How long the first write of a group waits for others
+         * @param[in]   max_operations Number of writes that closes a group before its window ends
+         */
+        GroupCommitQueue( CommitFunction            commit,
+                          std::chrono::milliseconds window         = DEFAULT_WINDOW,
+                          size_t                    max_operations = DEFAULT_MAX_OPERATIONS );
+
+        /**
+         * @brief       Commits the pending groups and stops the thread
+         */
+        ~GroupCommitQueue();
+
+        GroupCommitQueue( const GroupCommitQueue & )            = delete;
+        GroupCommitQueue &operator=( const GroupCommitQueue & ) = delete;
+
+        /**
+         * @brief       Queues a write
+         * @param[in]   operation The write
+         * @param[in]   topics Topics the write is broadcast on, only writes to the same topics are grouped
+         * @return      Future holding the outcome of the commit of the write's group
+         */
+        std::future<outcome::result<void>> Enqueue( Operation operation, std::set<std::string> topics );
+
+        /**
+         * @brief       Commits every pending group without waiting for the windows to end
+         */
+        void Flush();
+
+        Stats GetStats() const;
+
+    private:
+        struct Group
+        {
+            std::set<std::string>                            topics;
+            std::vector<Operation>                           operations;
+            std::vector<std::promise<outcome::result<void>>> promises;
+            std::unordered_set<std::string>                  keys; ///< A key written twice starts a new group
+            std::chrono::steady_clock::time_point            deadline;
+            bool                                             closed = false;
+        };
+
+        void Run();
+
+        /**
+         * @brief       Commits a group and completes the futures of its writes
+         */
+        void Commit( Group &group );
+
+        CommitFunction                  commit_;
+        const std::chrono::milliseconds window_;
+        const size_t                    max_operations_;
+
+        mutable std::mutex      mutex_;
+        std::condition_variable cv_;      ///< Wakes the queue's thread
+        std::condition_variable idle_cv_; ///< Wakes the callers of Flush
+        std::deque<Group>       groups_;  ///< In the order they were opened, which is the order they are committed
+        bool                    committing_ = false;
+        bool                    stopping_   = false;
+        Stats                   stats_;
+        std::thread             thread_;
+    };
+}
+
+#endif
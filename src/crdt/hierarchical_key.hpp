@@ -1,8 +1,11 @@
 #ifndef SUPERGENIUS_HIERARCHICAL_KEY_HPP
 #define SUPERGENIUS_HIERARCHICAL_KEY_HPP
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <boost/container/small_vector.hpp>
 
 namespace sgns::crdt
 {
@@ -19,36 +22,74 @@ namespace sgns::crdt
   *     Key("/Comedy/MontyPython/Actor:JohnCleese")
   *     Key("/Comedy/MontyPython/Sketch:CheeseShop")
   *    Key("/Comedy/MontyPython/Sketch:CheeseShop/Character:Mousebender")
+  *
+  * Keys up to @ref INLINE_KEY_SIZE characters are kept inline in the object,
+  * so building and copying typical CRDT keys does not touch the heap.
   */
   class HierarchicalKey
   {
   public:
+    /// Number of characters stored inline before the key spills to the heap
+    static constexpr std::size_t INLINE_KEY_SIZE = 96;
+
+    using Storage = boost::container::small_vector<char, INLINE_KEY_SIZE>;
 
     HierarchicalKey() = default;
 
-    /** Constructs a key from {@param s}.
+    /** Constructs a key from {@param key}.
+    */
+    HierarchicalKey( std::string_view key );
+
+    /** Constructs a key from {@param key}.
     */
-    HierarchicalKey( std::string key );
+    HierarchicalKey( const std::string &key ) : HierarchicalKey( std::string_view( key ) )
+    {
+    }
+
+    /** Constructs a key from {@param key}.
+    */
+    HierarchicalKey( const char *key ) : HierarchicalKey( std::string_view( key ) )
+    {
+    }
 
     /** Copy constructor
     */
     HierarchicalKey( const HierarchicalKey & ) = default;
 
+    HierarchicalKey( HierarchicalKey && ) noexcept = default;
+
     virtual ~HierarchicalKey() = default;
 
-    HierarchicalKey& operator=(const HierarchicalKey&) = default;
+    HierarchicalKey &operator=( const HierarchicalKey & ) = default;
 
-    void SetKey(const std::string& aKey ) { key_ = aKey; };
+    HierarchicalKey &operator=( HierarchicalKey && ) noexcept = default;
 
-    std::string GetKey() const { return key_; };
+    void SetKey( std::string_view aKey )
+    {
+      key_.assign( aKey.begin(), aKey.end() );
+    };
+
+    /** Returns a copy of the key as a string. Prefer @ref GetView on hot paths.
+    */
+    std::string GetKey() const
+    {
+      return std::string( GetView() );
+    };
+
+    /** Returns a view of the key, valid as long as this key is not modified.
+    */
+    std::string_view GetView() const noexcept
+    {
+      return { key_.data(), key_.size() };
+    }
 
     /** @brief Appends `s` to the key.
      * @param s String to be appended
-     * 
+     *
      * NewKey("/Comedy/MontyPython").ChildString("Actor:JohnCleese")
      * NewKey("/Comedy/MontyPython/Actor:JohnCleese")
     */
-    HierarchicalKey ChildString(const std::string& s) const;
+    HierarchicalKey ChildString( std::string_view s ) const;
 
     /** List returns the `list` representation of this Key.
     *   NewKey("/Comedy/MontyPython/Actor:JohnCleese").List()
@@ -58,9 +99,14 @@ namespace sgns::crdt
 
     bool IsTopLevel() const;
 
+    /** Checks if the raw key @param key would be a top level key once normalized,
+    * without building a HierarchicalKey
+    */
+    static bool IsTopLevel( std::string_view key );
+
     bool operator==( const HierarchicalKey &rhs ) const
     {
-      return key_ == rhs.key_;
+      return GetView() == rhs.GetView();
     }
 
     bool operator!=( const HierarchicalKey &rhs ) const
@@ -69,8 +115,55 @@ namespace sgns::crdt
     }
 
   private:
+    friend class HierarchicalKeyBuilder;
+
+    Storage key_;
+  };
 
-    std::string key_;
+  /** @brief Assembles a hierarchical key in place, applying the same normalization as
+  * HierarchicalKey::ChildString. The resulting view can be handed to the datastore
+  * directly, so the per-element lookups of the CRDT set don't allocate.
+  *
+  *   HierarchicalKeyBuilder( HierarchicalKey( "/ns" ) ).Child( "s" ).Child( "key" ).GetView()
+  *   "/ns/s/key"
+  */
+  class HierarchicalKeyBuilder
+  {
+  public:
+    /** Starts a key from @param base
+    */
+    explicit HierarchicalKeyBuilder( const HierarchicalKey &base ) : key_( base.key_ )
+    {
+    }
+
+    /** Appends a child namespace, adding the separator if missing
+    * @param segment Namespace to append
+    * @return this builder, suitable for chaining
+    */
+    HierarchicalKeyBuilder &Child( std::string_view segment );
+
+    /** Drops everything after the first @param size characters, so a common
+    * prefix can be reused for several keys
+    * @return this builder, suitable for chaining
+    */
+    HierarchicalKeyBuilder &Truncate( std::size_t size );
+
+    std::size_t Size() const noexcept
+    {
+      return key_.size();
+    }
+
+    std::string_view GetView() const noexcept
+    {
+      return { key_.data(), key_.size() };
+    }
+
+    /** Creates a HierarchicalKey from the current contents
+    */
+    HierarchicalKey Build() const;
+
+  private:
+    HierarchicalKey::Storage key_;
   };
 } // namespace sgns::crdt
 
@@ -72,7 +72,7 @@ namespace sgns::crdt
         auto new_end = std::remove_if( operations_.begin(),
                                        operations_.end(),
                                        [&key]( const PendingOperation &op )
-                                       { return op.key.GetKey() == key.GetKey(); } );
+                                       { return op.key == key; } );
 
         // If we removed any operations, erase them and remove from the set
         if ( new_end != operations_.end() )
@@ -151,7 +151,7 @@ namespace sgns::crdt
         // Search from the end (most recent operations first)
         for ( auto it = operations_.rbegin(); it != operations_.rend(); ++it )
         {
-            if ( it->key.GetKey() == key.GetKey() )
+            if ( it->key == key )
             {
                 return *it;
             }
@@ -10,15 +10,63 @@ namespace sgns::crdt
 {
     CRDTDataFilter::CRDTDataFilter( bool accept_by_default ) : accept_by_default_( std::move( accept_by_default ) ) {}
 
+    namespace
+    {
+        bool IsValidPattern( const std::string &pattern )
+        {
+            try
+            {
+                std::regex regex( pattern );
+            }
+            catch ( const std::regex_error & )
+            {
+                return false;
+            }
+            return true;
+        }
+    }
+
+    CRDTDataFilter::PatternMatcher::PatternMatcher( const FilterCallbackRegistry &registry )
+    {
+        regexes_.reserve( registry.size() );
+        filters_.reserve( registry.size() );
+        for ( const auto &[pattern, filter] : registry )
+        {
+            regexes_.emplace_back( pattern, std::regex::optimize );
+            filters_.push_back( filter );
+        }
+    }
+
+    const CRDTDataFilter::ElementFilterCallback *CRDTDataFilter::PatternMatcher::Match( const std::string &key ) const
+    {
+        for ( size_t i = 0; i < regexes_.size(); ++i )
+        {
+            if ( std::regex_match( key, regexes_[i] ) )
+            {
+                return &filters_[i];
+            }
+        }
+        return nullptr;
+    }
+
     bool CRDTDataFilter::RegisterElementFilter( const std::string &pattern, ElementFilterCallback filter )
     {
+        if ( !IsValidPattern( pattern ) )
+        {
+            return false;
+        }
         std::lock_guard lock( element_registry_mutex_ );
         element_registry_[pattern] = std::move( filter );
+        element_matcher_           = std::make_shared<const PatternMatcher>( element_registry_ );
         return true;
     }
 
     bool CRDTDataFilter::RegisterTombstoneFilter( const std::string &pattern, ElementFilterCallback filter )
     {
+        if ( !IsValidPattern( pattern ) )
+        {
+            return false;
+        }
         std::lock_guard lock( tombstone_registry_mutex_ );
         tombstone_registry_[pattern] = std::move( filter );
         return true;
@@ -27,7 +75,11 @@ namespace sgns::crdt
     void CRDTDataFilter::UnregisterElementFilter( const std::string &pattern )
     {
         std::lock_guard lock( element_registry_mutex_ );
-        element_registry_.erase( pattern );
+        if ( element_registry_.erase( pattern ) != 0 )
+        {
+            element_matcher_ = element_registry_.empty() ? nullptr
+                                                         : std::make_shared<const PatternMatcher>( element_registry_ );
+        }
     }
 
     void CRDTDataFilter::UnregisterTombstoneFilter( const std::string &pattern )
@@ -38,33 +90,30 @@ namespace sgns::crdt
 
     void CRDTDataFilter::FilterElementsOnDelta( std::shared_ptr<pb::Delta> &delta )
     {
-        std::vector<pb::Element>                               new_tombstones;
-        std::unordered_map<std::string, ElementFilterCallback> registry_copy;
+        std::shared_ptr<const PatternMatcher> matcher;
         {
             std::shared_lock lock( element_registry_mutex_ );
-            registry_copy = element_registry_;
+            matcher = element_matcher_;
+        }
+        if ( !matcher && accept_by_default_ )
+        {
+            return;
         }
 
+        std::vector<pb::Element> new_tombstones;
         for ( int i = 0; i < delta->elements_size(); ++i )
         {
-            const auto &element        = delta->elements( i );
-            bool        filter_matched = false;
-
-            for ( const auto &[pattern, filter] : registry_copy )
+            const auto &element = delta->elements( i );
+            const auto *filter  = matcher ? matcher->Match( element.key() ) : nullptr;
+            if ( filter != nullptr )
             {
-                std::regex regex( pattern );
-                if ( std::regex_match( element.key(), regex ) )
+                auto tombstones = ( *filter )( element );
+                if ( tombstones )
                 {
-                    auto tombstones = filter( element );
-                    if ( tombstones )
-                    {
-                        new_tombstones.insert( new_tombstones.end(), tombstones->begin(), tombstones->end() );
-                    }
-                    filter_matched = true;
-                    break;
+                    new_tombstones.insert( new_tombstones.end(), tombstones->begin(), tombstones->end() );
                 }
             }
-            if ( ( filter_matched == false ) && ( accept_by_default_ == false ) )
+            else if ( accept_by_default_ == false )
             {
                 //at least tombstone the current element
                 new_tombstones.push_back( element );
@@ -5,6 +5,8 @@
 #include "crdt/proto/bcast.pb.h"
 #include <google/protobuf/unknown_field_set.h>
 #include <ipfs_lite/ipld/impl/ipld_node_impl.hpp>
+#include <algorithm>
+#include <iterator>
 #include <thread>
 #include <utility>
 
@@ -53,6 +55,23 @@ namespace sgns::crdt
         return crdtInstance;
     }
 
+    CrdtDatastore::RocksDB::ColumnFamilyLayout CrdtDatastore::GetColumnFamilyLayout( const HierarchicalKey &aKey )
+    {
+        auto layout = CrdtSet::GetColumnFamilyLayout( aKey.ChildString( setsNamespace_ ) );
+
+        // Heads are few and always read by scanning a topic, no filters needed
+        auto headsKey = aKey.ChildString( headsNamespace_ );
+        layout.push_back( { std::string( headsKey.GetView() ) + ":heads",
+                            std::string( headsKey.GetView() ) + "/",
+                            "",
+                            0,
+                            false,
+                            0,
+                            1024 * 1024 } );
+        layout.push_back( ProcessedBlockIndex::GetColumnFamilySpec( aKey.ChildString( processedNamespace_ ) ) );
+        return layout;
+    }
+
     void CrdtDatastore::Start()
     {
         if ( started_ == true )
@@ -100,14 +119,33 @@ namespace sgns::crdt
                     return;
                 }
 
-                const auto interval = std::chrono::milliseconds(
+                const auto baseInterval = std::chrono::milliseconds(
                     self->options_ ? self->options_->rebroadcastIntervalMilliseconds : 100 );
+                const auto maxInterval = std::max(
+                    baseInterval,
+                    std::chrono::milliseconds( self->options_ ? self->options_->rebroadcastMaxIntervalMilliseconds
+                                                              : 0 ) );
+                auto                         interval = baseInterval;
+                auto                         nextFull = std::chrono::steady_clock::now();
                 std::unique_lock<std::mutex> lock( self->rebroadcastMutex_ );
 
                 while ( self->rebroadcastThreadRunning_ )
                 {
-                    self->RebroadcastHeads();
-                    self->rebroadcastCv_.wait_for( lock, interval );
+                    // Changed heads go out as soon as the worker is notified. The whole head set is only
+                    // repeated on the timer, which backs off while nothing changes.
+                    const auto now  = std::chrono::steady_clock::now();
+                    const bool full = now >= nextFull;
+                    if ( self->RebroadcastHeads( full ) )
+                    {
+                        interval = baseInterval;
+                        nextFull = now + interval;
+                    }
+                    else if ( full )
+                    {
+                        interval = std::min( interval * 2, maxInterval );
+                        nextFull = now + interval;
+                    }
+                    self->rebroadcastCv_.wait_until( lock, nextFull );
                 }
             } );
 
@@ -178,8 +216,16 @@ namespace sgns::crdt
             numberOfDagWorkers = options_->numWorkers;
         }
 
-        set_   = std::make_shared<CrdtSet>( dataStore_, fullSetNs, putHookFunc_, deleteHookFunc_ );
+        set_   = std::make_shared<CrdtSet>( dataStore_,
+                                          fullSetNs,
+                                          putHookFunc_,
+                                          deleteHookFunc_,
+                                          options_ ? options_->valueCacheBytes
+                                                   : CrdtValueCache::DEFAULT_CAPACITY_BYTES );
         heads_ = std::make_shared<CrdtHeads>( dataStore_, fullHeadsNs );
+        // <namespace>/p
+        processedBlocks_ = std::make_shared<ProcessedBlockIndex>( dataStore_,
+                                                                  aKey.ChildString( processedNamespace_ ) );
 
         int      numberOfHeads = 0;
         uint64_t maxHeight     = 0;
@@ -201,6 +247,8 @@ namespace sgns::crdt
     {
         logger_->debug( "~CrdtDatastore CALLED at {} ", std::this_thread::get_id() );
         Close();
+        std::unique_lock lock( dagWorkerMutex_ );
+        dagJobsQueued_.Sub( static_cast<int64_t>( dagWorkerJobList.size() ) );
     }
 
     std::shared_ptr<CrdtDatastore::Delta> CrdtDatastore::DeltaMerge( const std::shared_ptr<Delta> &aDelta1,
@@ -307,6 +355,12 @@ namespace sgns::crdt
 
         for ( const auto &bCastHeadCID : decodeResult.value() )
         {
+            if ( processedBlocks_->GetState( bCastHeadCID ) == ProcessedBlockIndex::State::COMPLETE )
+            {
+                // Merged along with its whole subgraph, on this run or an earlier one
+                logger_->trace( "HandleBlock: Already merged block {}", bCastHeadCID.toString().value() );
+                continue;
+            }
             auto dagSyncerResult = dagSyncer_->HasBlock( bCastHeadCID );
             if ( dagSyncerResult.has_failure() )
             {
@@ -389,6 +443,8 @@ namespace sgns::crdt
             // Put back the jobs with different rootCid
             dagWorkerJobList = std::move( temp_queue );
         }
+        dagJobsQueued_.Sub( static_cast<int64_t>( jobs_to_process.size() ) );
+        base::ScopedTimer batchTimer( dagJobBatchDuration_ );
 
         logger_->info( "SendJobWorker processing {} jobs for rootCid={}",
                        jobs_to_process.size(),
@@ -451,6 +507,11 @@ namespace sgns::crdt
                 {
                     logger_->error( "DAGSyncer: error writing ROOT block {}", current_root_cid.toString().value() );
                 }
+                else if ( processedBlocks_->SetState( current_root_cid, ProcessedBlockIndex::State::COMPLETE )
+                              .has_failure() )
+                {
+                    logger_->error( "DAGSyncer: error recording ROOT block {}", current_root_cid.toString().value() );
+                }
             }
             else
             {
@@ -539,32 +600,89 @@ namespace sgns::crdt
         return outputBuffer;
     }
 
-    void CrdtDatastore::RebroadcastHeads()
+    bool CrdtDatastore::RebroadcastHeads( bool aFullRebroadcast )
     {
         auto getListResult = heads_->GetList();
         if ( getListResult.has_failure() )
         {
             logger_->error( "RebroadcastHeads: Failed to get list of heads (error code {})", getListResult.error() );
-            return;
+            return false;
         }
         auto [head_map, maxHeight] = getListResult.value();
 
-        for ( const auto &[topic_name, cid_set] : head_map ) // Changed from cid_map to head_map
+        bool changed = false;
+        for ( auto it = rebroadcastState_.begin(); it != rebroadcastState_.end(); )
         {
-            auto broadcastResult = Broadcast( cid_set, topic_name );
-            if ( broadcastResult.has_failure() )
+            // Topics without heads anymore are forgotten
+            it = head_map.count( it->first ) ? std::next( it ) : rebroadcastState_.erase( it );
+        }
+
+        for ( auto &[topic_name, cid_set] : head_map )
+        {
+            auto &state = rebroadcastState_[topic_name];
+            if ( cid_set != state.heads )
             {
-                logger_->error( "RebroadcastHeads: Broadcast failed" );
+                std::set<CID> newHeads;
+                std::set_difference( cid_set.begin(),
+                                     cid_set.end(),
+                                     state.heads.begin(),
+                                     state.heads.end(),
+                                     std::inserter( newHeads, newHeads.end() ) );
+                state.heads = std::move( cid_set );
+                state.payload.clear();
+                changed = true;
+
+                if ( newHeads.empty() )
+                {
+                    // Heads were only removed, there is nothing new to announce
+                    continue;
+                }
+                auto broadcastResult = Broadcast( newHeads, topic_name );
+                if ( broadcastResult.has_failure() )
+                {
+                    logger_->error( "RebroadcastHeads: Broadcast failed" );
+                    continue;
+                }
+                ++diffBroadcasts_;
+                logger_->trace( "RebroadcastHeads: Broadcasted {} new CIDs to topic {} ", newHeads.size(), topic_name );
+                for ( const auto &cid : newHeads )
+                {
+                    logger_->trace( "RebroadcastHeads: CID {} ", cid.toString().value() );
+                }
             }
-            else
+            else if ( aFullRebroadcast && !state.heads.empty() )
             {
-                logger_->trace( "RebroadcastHeads: Broadcasted CIDs to topic {} ", topic_name );
-                for ( const auto &cid : cid_set )
+                if ( state.payload.empty() )
                 {
-                    logger_->trace( "RebroadcastHeads: CID {} ", cid.toString().value() );
+                    auto encodedBufferResult = EncodeBroadcast( state.heads );
+                    if ( encodedBufferResult.has_failure() )
+                    {
+                        logger_->error( "RebroadcastHeads: Encoding failed for topic {}", topic_name );
+                        continue;
+                    }
+                    ++broadcastEncodings_;
+                    state.payload = std::move( encodedBufferResult.value() );
                 }
+                if ( BroadcastEncoded( state.payload, topic_name ).has_failure() )
+                {
+                    logger_->error( "RebroadcastHeads: Broadcast failed" );
+                    continue;
+                }
+                ++fullBroadcasts_;
+                logger_->trace( "RebroadcastHeads: Rebroadcasted {} CIDs to topic {} ", state.heads.size(), topic_name );
             }
         }
+        return changed;
+    }
+
+    CrdtDatastore::RebroadcastStats CrdtDatastore::GetRebroadcastStats() const
+    {
+        RebroadcastStats stats;
+        stats.diffBroadcasts = diffBroadcasts_.load();
+        stats.fullBroadcasts = fullBroadcasts_.load();
+        stats.encodings      = broadcastEncodings_.load();
+        stats.bytes          = broadcastBytes_.load();
+        return stats;
     }
 
     outcome::result<void> CrdtDatastore::HandleBlock( const CID &aCid )
@@ -664,6 +782,7 @@ namespace sgns::crdt
                 std::unique_lock lock( dagWorkerMutex_ );
                 dagWorkerJobList.push( dagJob );
             }
+            dagJobsQueued_.Add();
             dagWorkerCv_.notify_one();
         }
         return outcome::success();
@@ -671,7 +790,7 @@ namespace sgns::crdt
 
     outcome::result<CrdtDatastore::Buffer> CrdtDatastore::GetKey( const HierarchicalKey &aKey )
     {
-        return set_->GetElement( aKey.GetKey() );
+        return set_->GetElement( aKey.GetView() );
     }
 
     outcome::result<std::string> CrdtDatastore::GetKeysPrefix()
@@ -705,7 +824,12 @@ namespace sgns::crdt
 
     outcome::result<bool> CrdtDatastore::HasKey( const HierarchicalKey &aKey )
     {
-        return set_->IsValueInSet( aKey.GetKey() );
+        return set_->IsValueInSet( aKey.GetView() );
+    }
+
+    CrdtValueCache::Stats CrdtDatastore::GetValueCacheStats() const
+    {
+        return set_->GetValueCacheStats();
     }
 
     outcome::result<void> CrdtDatastore::PutKey( const HierarchicalKey &aKey,
@@ -776,13 +900,25 @@ namespace sgns::crdt
 
             return outcome::failure( encodedBufferResult.error() );
         }
+        ++broadcastEncodings_;
 
-        auto bcastResult = broadcaster_->Broadcast( encodedBufferResult.value(), topic );
+        return BroadcastEncoded( encodedBufferResult.value(), topic );
+    }
+
+    outcome::result<void> CrdtDatastore::BroadcastEncoded( const Buffer &aPayload, const std::string &topic )
+    {
+        if ( !broadcaster_ )
+        {
+            logger_->error( "Broadcast: No broadcaster, Failed to broadcast" );
+            return outcome::failure( boost::system::error_code{} );
+        }
+        auto bcastResult = broadcaster_->Broadcast( aPayload, topic );
         if ( bcastResult.has_failure() )
         {
             logger_->error( "Broadcast: Broadcaster failed to broadcast" );
             return outcome::failure( bcastResult.error() );
         }
+        broadcastBytes_ += aPayload.size();
         return outcome::success();
     }
 
@@ -850,7 +986,14 @@ namespace sgns::crdt
             return outcome::failure( strCidResult.error() );
         }
         HierarchicalKey hKey( strCidResult.value() );
-        if ( filter_crdt )
+        // Blocks merged before a restart, or before the sync of their subgraph was interrupted,
+        // only need their links walked again
+        const bool already_merged = processedBlocks_->GetState( current ) != ProcessedBlockIndex::State::UNKNOWN;
+        if ( already_merged )
+        {
+            logger_->debug( "ProcessNode: Skipping merge of already merged node {}", strCidResult.value() );
+        }
+        else if ( filter_crdt )
         {
             crdt_filter_.FilterElementsOnDelta( aDelta );
             //crdt_filter_.FilterTombstonesOnDelta( aDelta );
@@ -863,9 +1006,13 @@ namespace sgns::crdt
             logger_->error( "ProcessNode: Processing OUTGOING root {} node {}",
                             aRoot.toString().value(),
                             aNode->getCID().toString().value() );
+        }
+        if ( !filter_crdt )
+        {
             skip_if_visited = true;
         }
 
+        if ( !already_merged )
         {
             std::unique_lock lock( dagSetMutex_ );
             auto             mergeResult = set_->Merge( aDelta, hKey.GetKey() );
@@ -874,6 +1021,11 @@ namespace sgns::crdt
                 logger_->error( "ProcessNode: error merging delta from {}", hKey.GetKey() );
                 return outcome::failure( mergeResult.error() );
             }
+            lock.unlock();
+            if ( processedBlocks_->SetState( current, ProcessedBlockIndex::State::MERGED ).has_failure() )
+            {
+                logger_->error( "ProcessNode: error recording merged node {}", hKey.GetKey() );
+            }
         }
 
         auto priority = aDelta->priority();
@@ -938,10 +1090,16 @@ namespace sgns::crdt
                 }
                 for ( const auto &[cid, link_name] : links_to_fetch )
                 {
-                    if ( topicNames_.find( link_name ) != topicNames_.end() )
+                    if ( topicNames_.find( link_name ) == topicNames_.end() )
                     {
-                        children.emplace( cid );
+                        continue;
                     }
+                    if ( processedBlocks_->GetState( cid ) == ProcessedBlockIndex::State::COMPLETE )
+                    {
+                        // Merged along with its subgraph, even if the block itself is gone from the DAG
+                        continue;
+                    }
+                    children.emplace( cid );
                 }
             }
         }
@@ -1010,6 +1168,10 @@ namespace sgns::crdt
                 return outcome::failure( dagSyncerResult.error() );
             }
             dagSyncer_->DeleteCIDBlock( node->getCID() );
+            if ( processedBlocks_->SetState( node->getCID(), ProcessedBlockIndex::State::COMPLETE ).has_failure() )
+            {
+                logger_->error( "AddDAGNode: error recording new block {}", node->getCID().toString().value() );
+            }
         }
 
         return node->getCID();
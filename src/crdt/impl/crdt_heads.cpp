@@ -51,24 +51,30 @@ namespace sgns::crdt
 
     outcome::result<HierarchicalKey> CrdtHeads::GetKey( const std::string &topic, const CID &aCid )
     {
-        // /<namespace>/<topic>/<cid>
-        auto topicNs = namespaceKey_.ChildString( std::string( topic ) );
+        OUTCOME_TRY( auto &&builder, GetKeyBuilder( topic, aCid ) );
+        return builder.Build();
+    }
 
+    outcome::result<HierarchicalKeyBuilder> CrdtHeads::GetKeyBuilder( std::string_view topic, const CID &aCid ) const
+    {
         auto cidStr = aCid.toString();
         if ( cidStr.has_failure() )
         {
             return outcome::failure( cidStr.error() );
         }
 
-        return topicNs.ChildString( cidStr.value() );
+        // /<namespace>/<topic>/<cid>
+        HierarchicalKeyBuilder builder( namespaceKey_ );
+        builder.Child( topic ).Child( cidStr.value() );
+        return builder;
     }
 
-    outcome::result<void> CrdtHeads::Write( const std::unique_ptr<storage::BufferBatch> &aDataStore,
-                                            const CID                                   &aCid,
-                                            uint64_t                                     aHeight,
-                                            const std::string                           &topic )
+    outcome::result<void> CrdtHeads::Write( const std::unique_ptr<DataStore::Batch> &aDataStore,
+                                            const CID                               &aCid,
+                                            uint64_t                                 aHeight,
+                                            const std::string                       &topic )
     {
-        auto getKeyResult = GetKey( topic, aCid );
+        auto getKeyResult = GetKeyBuilder( topic, aCid );
         if ( getKeyResult.has_failure() )
         {
             return outcome::failure( getKeyResult.error() );
@@ -76,34 +82,25 @@ namespace sgns::crdt
 
         auto strHeight = std::to_string( aHeight );
 
-        Buffer keyBuffer;
-        keyBuffer.put( getKeyResult.value().GetKey() );
-
-        Buffer valueBuffer;
-        valueBuffer.put( strHeight );
-
-        return aDataStore->put( keyBuffer, valueBuffer );
+        return aDataStore->put( getKeyResult.value().GetView(), strHeight );
     }
 
-    outcome::result<void> CrdtHeads::Delete( const std::unique_ptr<storage::BufferBatch> &aDataStore,
-                                             const CID                                   &aCid,
-                                             const std::string                           &topic )
+    outcome::result<void> CrdtHeads::Delete( const std::unique_ptr<DataStore::Batch> &aDataStore,
+                                             const CID                               &aCid,
+                                             const std::string                       &topic )
     {
         if ( aDataStore == nullptr )
         {
             return outcome::failure( boost::system::error_code{} );
         }
 
-        auto getKeyResult = this->GetKey( topic, aCid );
+        auto getKeyResult = this->GetKeyBuilder( topic, aCid );
         if ( getKeyResult.has_failure() )
         {
             return outcome::failure( getKeyResult.error() );
         }
 
-        Buffer keyBuffer;
-        keyBuffer.put( getKeyResult.value().GetKey() );
-
-        return aDataStore->remove( keyBuffer );
+        return aDataStore->remove( getKeyResult.value().GetView() );
     }
 
     bool CrdtHeads::IsHead( const CID &cid, const std::string &topic )
@@ -183,7 +180,7 @@ namespace sgns::crdt
             return outcome::failure( boost::system::error_code{} );
         }
 
-        auto batchDatastore = this->dataStore_->batch();
+        auto batchDatastore = this->dataStore_->CreateBatch();
         auto writeResult    = this->Write( batchDatastore, aCid, aHeight, topic );
         if ( writeResult.has_failure() )
         {
@@ -215,7 +212,7 @@ namespace sgns::crdt
             return outcome::failure( boost::system::error_code{} );
         }
 
-        auto batchDatastore = this->dataStore_->batch();
+        auto batchDatastore = this->dataStore_->CreateBatch();
         auto writeResult    = this->Write( batchDatastore, aNewHeadCid, aHeight, topic );
         if ( writeResult.has_failure() )
         {
@@ -277,13 +274,10 @@ namespace sgns::crdt
     outcome::result<void> CrdtHeads::PrimeCache()
     {
         // builds the heads cache based on what's in storage
-        const auto strNamespace = this->namespaceKey_.GetKey();
+        const auto strNamespace = this->namespaceKey_.GetView();
         logger_->debug( "PrimeCache: starting for namespace '{}'", strNamespace );
 
-        Buffer keyPrefixBuffer;
-        keyPrefixBuffer.put( strNamespace );
-
-        auto queryResult = this->dataStore_->query( keyPrefixBuffer );
+        auto queryResult = this->dataStore_->query( strNamespace );
         if ( queryResult.has_failure() )
         {
             logger_->error( "PrimeCache: query failed: {}", queryResult.error().message() );
@@ -295,8 +289,7 @@ namespace sgns::crdt
         for ( const auto &bufferKeyAndValue : queryResult.value() )
         {
             // full key is "/<namespace>/<topic>/<cid>"
-            auto        keyView = bufferKeyAndValue.first.toString();
-            std::string full( keyView.data(), keyView.size() );
+            auto full = bufferKeyAndValue.first.toString();
 
             if ( full.size() <= strNamespace.size() + 1 )
             {
@@ -304,17 +297,17 @@ namespace sgns::crdt
                 continue;
             }
 
-            std::string rel = full.substr( strNamespace.size() + 1 );
+            auto rel = full.substr( strNamespace.size() + 1 );
 
             auto sepPos = rel.find( '/' );
-            if ( sepPos == std::string::npos )
+            if ( sepPos == std::string_view::npos )
             {
                 logger_->warn( "PrimeCache: malformed key '{}'", rel );
                 continue;
             }
 
-            std::string topic  = rel.substr( 0, sepPos );
-            std::string strCid = rel.substr( sepPos + 1 );
+            std::string      topic( rel.substr( 0, sepPos ) );
+            std::string_view strCid = rel.substr( sepPos + 1 );
 
             if ( topic.empty() || strCid.empty() )
             {
@@ -322,7 +315,7 @@ namespace sgns::crdt
                 continue;
             }
 
-            auto cidResult = CID::fromString( strCid );
+            auto cidResult = CID::fromString( std::string( strCid ) );
             if ( cidResult.has_failure() )
             {
                 logger_->warn( "PrimeCache: invalid CID '{}' in key '{}'", strCid, full );
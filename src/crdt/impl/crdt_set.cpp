@@ -8,15 +8,27 @@
 
 namespace sgns::crdt
 {
+    namespace
+    {
+        /// Checks for "/<suffix>" at the end of a key without building the suffix string
+        bool HasSuffix( std::string_view aKey, std::string_view aSuffix )
+        {
+            return aKey.size() > aSuffix.size() &&
+                   aKey.compare( aKey.size() - aSuffix.size(), aSuffix.size(), aSuffix ) == 0 &&
+                   aKey[aKey.size() - aSuffix.size() - 1] == '/';
+        }
+    }
 
     CrdtSet::CrdtSet( std::shared_ptr<DataStore> aDatastore,
                       const HierarchicalKey     &aNamespace,
                       PutHookPtr                 aPutHookPtr,
-                      DeleteHookPtr              aDeleteHookPtr ) :
+                      DeleteHookPtr              aDeleteHookPtr,
+                      std::size_t                aValueCacheBytes ) :
         dataStore_( std::move( aDatastore ) ),
         namespaceKey_( aNamespace ),
         putHookFunc_( std::move( aPutHookPtr ) ),
-        deleteHookFunc_( std::move( aDeleteHookPtr ) )
+        deleteHookFunc_( std::move( aDeleteHookPtr ) ),
+        valueCache_( std::make_shared<CrdtValueCache>( aValueCacheBytes ) )
     {
     }
 
@@ -33,6 +45,7 @@ namespace sgns::crdt
             this->namespaceKey_   = aSet.namespaceKey_;
             this->putHookFunc_    = aSet.putHookFunc_;
             this->deleteHookFunc_ = aSet.deleteHookFunc_;
+            this->valueCache_     = aSet.valueCache_;
         }
         return *this;
     }
@@ -50,17 +63,62 @@ namespace sgns::crdt
         return !( *this == aSet );
     }
 
+    CrdtSet::DataStore::ColumnFamilyLayout CrdtSet::GetColumnFamilyLayout( const HierarchicalKey &aNamespace )
+    {
+        // Characters of the set key covered by the prefix bloom filters of the scanned families
+        constexpr std::size_t KEY_FILTER_LENGTH = 8;
+
+        auto familyPrefix = [&aNamespace]( std::string_view aSubNamespace )
+        {
+            HierarchicalKeyBuilder builder( aNamespace );
+            builder.Child( aSubNamespace );
+            return std::string( builder.GetView() ) + "/";
+        };
+        auto familyName = [&aNamespace]( std::string_view aName )
+        { return std::string( aNamespace.GetView() ) + ":" + std::string( aName ); };
+
+        const auto keysPrefix  = familyPrefix( keysNamespace_ );
+        const auto elemsPrefix = familyPrefix( elemsNamespace_ );
+        const auto tombsPrefix = familyPrefix( tombsNamespace_ );
+
+        DataStore::ColumnFamilyLayout layout;
+        // Point reads on GetElement and prefix scans on QueryElements
+        layout.push_back( { familyName( "values" ),
+                            keysPrefix,
+                            "/" + std::string( valueSuffix_ ),
+                            10,
+                            true,
+                            keysPrefix.size() + KEY_FILTER_LENGTH,
+                            32 * 1024 * 1024 } );
+        // Point reads while merging deltas only
+        layout.push_back(
+            { familyName( "priorities" ), keysPrefix, "/" + std::string( prioritySuffix_ ), 10, true, 0, 4 * 1024 * 1024 } );
+        // Only scanned by key prefix, so the filters are built on prefixes
+        layout.push_back( { familyName( "elements" ),
+                            elemsPrefix,
+                            "",
+                            10,
+                            false,
+                            elemsPrefix.size() + KEY_FILTER_LENGTH,
+                            16 * 1024 * 1024 } );
+        // Point reads of key/id pairs
+        layout.push_back( { familyName( "tombstones" ), tombsPrefix, "", 10, true, 0, 8 * 1024 * 1024 } );
+        return layout;
+    }
+
     outcome::result<std::string> CrdtSet::GetValueFromDatastore( const HierarchicalKey &aKey )
+    {
+        return GetRawValue( aKey.GetView() );
+    }
+
+    outcome::result<std::string> CrdtSet::GetRawValue( std::string_view aKey )
     {
         if ( this->dataStore_ == nullptr )
         {
             return outcome::failure( boost::system::error_code{} );
         }
 
-        Buffer bufferKey;
-        bufferKey.put( aKey.GetKey() );
-
-        auto bufferValueResult = dataStore_->get( bufferKey );
+        auto bufferValueResult = dataStore_->get( aKey );
         if ( bufferValueResult.has_failure() )
         {
             return outcome::failure( bufferValueResult.error() );
@@ -81,16 +139,13 @@ namespace sgns::crdt
         return delta;
     }
 
-    outcome::result<std::shared_ptr<CrdtSet::Delta>> CrdtSet::CreateDeltaToRemove( const std::string &aKey )
+    outcome::result<std::shared_ptr<CrdtSet::Delta>> CrdtSet::CreateDeltaToRemove( std::string_view aKey )
     {
         auto delta = std::make_shared<CrdtSet::Delta>();
         // /namespace/s/<key>
-        auto prefix         = this->ElemsPrefix( aKey );
-        auto strElemsPrefix = prefix.GetKey();
+        auto elemsPrefix = this->NamespaceKeyBuilder( elemsNamespace_, aKey );
 
-        Buffer keyPrefixBuffer;
-        keyPrefixBuffer.put( strElemsPrefix );
-        auto queryResult = this->dataStore_->query( keyPrefixBuffer );
+        auto queryResult = this->dataStore_->query( elemsPrefix.GetView() );
         if ( queryResult.has_failure() )
         {
             return outcome::failure( queryResult.error() );
@@ -98,32 +153,69 @@ namespace sgns::crdt
 
         for ( const auto &bufferKeyAndValue : queryResult.value() )
         {
-            std::string keyWithPrefix = std::string( bufferKeyAndValue.first.toString() );
-            std::string id            = keyWithPrefix.erase( 0, strElemsPrefix.size() );
+            auto id = bufferKeyAndValue.first.toString().substr( elemsPrefix.Size() );
 
-            auto hId = HierarchicalKey( id );
-
-            if ( !hId.IsTopLevel() )
+            if ( !HierarchicalKey::IsTopLevel( id ) )
             {
                 continue;
             }
 
             // check if its already tombed, which case don't add it to the
             // Remove delta set.
-            auto isDeletedResult = this->InTombsKeyID( aKey, hId.GetKey() );
+            auto isDeletedResult = this->InTombsKeyID( aKey, id );
             if ( isDeletedResult.has_value() && !isDeletedResult.value() )
             {
                 auto tombstone = delta->add_tombstones();
-                tombstone->set_key( aKey );
-                tombstone->set_id( hId.GetKey() );
+                tombstone->set_key( aKey.data(), aKey.size() );
+                tombstone->set_id( HierarchicalKey( id ).GetKey() );
             }
         }
 
         return delta;
     }
 
-    outcome::result<CrdtSet::Buffer> CrdtSet::GetElement( const std::string &aKey )
+    outcome::result<CrdtSet::Buffer> CrdtSet::GetElement( std::string_view aKey )
+    {
+        auto entryResult = this->ResolveElement( aKey );
+        if ( entryResult.has_failure() )
+        {
+            return outcome::failure( entryResult.error() );
+        }
+
+        const auto &entry = entryResult.value();
+        if ( !entry.value )
+        {
+            // not found is fine, we just return it
+            return outcome::failure( storage::DatabaseError::NOT_FOUND );
+        }
+
+        if ( entry.tombstoned )
+        {
+            return outcome::failure( boost::system::error_code{} );
+        }
+
+        // otherwise return the value
+        Buffer bufferValue;
+        bufferValue.put( *entry.value );
+
+        return bufferValue;
+    }
+
+    outcome::result<CrdtValueCache::Entry> CrdtSet::ResolveElement( std::string_view aKey )
     {
+        if ( this->dataStore_ == nullptr )
+        {
+            return outcome::failure( boost::system::error_code{} );
+        }
+
+        if ( auto cached = this->valueCache_->Get( aKey ) )
+        {
+            return std::move( *cached );
+        }
+
+        // Taken before reading, so a write racing with this load keeps it out of the cache
+        auto ticket = this->valueCache_->BeginLoad( aKey );
+
         // We can only GET an element if it's part of the Set (in
         // "elements" and not in "tombstones").
 
@@ -134,14 +226,20 @@ namespace sgns::crdt
         // * If the key does not have a value in the store:
         //   -> It was either never added
 
-        auto valueK      = this->ValueKey( aKey );
-        auto valueResult = this->GetValueFromDatastore( valueK );
+        CrdtValueCache::Entry entry;
 
+        auto valueK      = this->NamespaceKeyBuilder( keysNamespace_, aKey ).Child( valueSuffix_ );
+        auto valueResult = this->GetRawValue( valueK.GetView() );
         if ( valueResult.has_failure() )
         {
-            // not found is fine, we just return it
-            return outcome::failure( valueResult.error() );
+            if ( valueResult.error() != storage::DatabaseError::NOT_FOUND )
+            {
+                return outcome::failure( valueResult.error() );
+            }
+            this->valueCache_->Fill( aKey, entry, ticket );
+            return entry;
         }
+        entry.value = std::move( valueResult.value() );
 
         // We have an existing element. Check if tombstoned.
         auto inSetResult = this->InElemsNotTombstoned( aKey );
@@ -149,20 +247,10 @@ namespace sgns::crdt
         {
             return outcome::failure( inSetResult.error() );
         }
+        entry.tombstoned = !inSetResult.value();
 
-        if ( !inSetResult.value() )
-        {
-            // attempt to remove so next time we do not have to do this lookup.
-            // In concurrency, this may delete a key that was just written
-            // and should not be deleted.
-            return outcome::failure( boost::system::error_code{} );
-        }
-
-        // otherwise return the value
-        Buffer bufferValue;
-        bufferValue.put( valueResult.value() );
-
-        return bufferValue;
+        this->valueCache_->Fill( aKey, entry, ticket );
+        return entry;
     }
 
     outcome::result<CrdtSet::QueryResult> CrdtSet::QueryElements(
@@ -185,11 +273,9 @@ namespace sgns::crdt
         //   -> It was either never added
 
         // /namespace/k/<prefix>
-        auto prefixKeysKey = this->KeysKey( aPrefix );
+        auto prefixKeysKey = this->NamespaceKeyBuilder( keysNamespace_, aPrefix );
 
-        Buffer keyPrefixBuffer;
-        keyPrefixBuffer.put( prefixKeysKey.GetKey() );
-        auto queryResult = this->dataStore_->query( keyPrefixBuffer );
+        auto queryResult = this->dataStore_->query( prefixKeysKey.GetView() );
         if ( queryResult.has_failure() )
         {
             return outcome::failure( queryResult.error() );
@@ -199,26 +285,26 @@ namespace sgns::crdt
         // Check if elements tombstoned.
         for ( const auto &element : queryResult.value() )
         {
-            auto inSetResult = this->InElemsNotTombstoned( std::string( element.first.toString() ) );
+            auto inSetResult = this->InElemsNotTombstoned( element.first.toString() );
             if ( inSetResult.has_failure() || !inSetResult.value() )
             {
                 continue;
             }
 
-            std::string key = std::string( element.first.toString() );
+            auto key = element.first.toString();
             switch ( aSuffix )
             {
                 case QuerySuffix::QUERY_ALL:
                     elements.insert( element );
                     break;
                 case QuerySuffix::QUERY_PRIORITYSUFFIX:
-                    if ( boost::algorithm::ends_with( key, "/" + GetPrioritySuffix() ) )
+                    if ( HasSuffix( key, prioritySuffix_ ) )
                     {
                         elements.insert( element );
                     }
                     break;
                 case QuerySuffix::QUERY_VALUESUFFIX:
-                    if ( boost::algorithm::ends_with( key, "/" + GetValueSuffix() ) )
+                    if ( HasSuffix( key, valueSuffix_ ) )
                     {
                         elements.insert( element );
                     }
@@ -265,26 +351,26 @@ namespace sgns::crdt
         // Check if elements tombstoned.
         for ( const auto &element : queryResult.value() )
         {
-            auto inSetResult = this->InElemsNotTombstoned( std::string( element.first.toString() ) );
+            auto inSetResult = this->InElemsNotTombstoned( element.first.toString() );
             if ( inSetResult.has_failure() || !inSetResult.value() )
             {
                 continue;
             }
 
-            std::string key = std::string( element.first.toString() );
+            auto key = element.first.toString();
             switch ( aSuffix )
             {
                 case QuerySuffix::QUERY_ALL:
                     elements.insert( element );
                     break;
                 case QuerySuffix::QUERY_PRIORITYSUFFIX:
-                    if ( boost::algorithm::ends_with( key, "/" + GetPrioritySuffix() ) )
+                    if ( HasSuffix( key, prioritySuffix_ ) )
                     {
                         elements.insert( element );
                     }
                     break;
                 case QuerySuffix::QUERY_VALUESUFFIX:
-                    if ( boost::algorithm::ends_with( key, "/" + GetValueSuffix() ) )
+                    if ( HasSuffix( key, valueSuffix_ ) )
                     {
                         elements.insert( element );
                     }
@@ -297,44 +383,25 @@ namespace sgns::crdt
         return elements;
     }
 
-    outcome::result<bool> CrdtSet::IsValueInSet( const std::string &aKey )
+    outcome::result<bool> CrdtSet::IsValueInSet( std::string_view aKey )
     {
-        if ( this->dataStore_ == nullptr )
-        {
-            return outcome::failure( boost::system::error_code{} );
-        }
-
         // Optimization: if we do not have a value
         // this key was never added.
-        auto valueK = this->ValueKey( aKey );
-
-        Buffer bufferKey;
-        bufferKey.put( valueK.GetKey() );
-
-        if ( !this->dataStore_->contains( bufferKey ) )
-        {
-            return false;
-        }
-
-        // Otherwise, do the long check.
-        auto inElemsNotTombstonedResult = this->InElemsNotTombstoned( aKey );
-        if ( inElemsNotTombstonedResult.has_error() )
+        auto entryResult = this->ResolveElement( aKey );
+        if ( entryResult.has_error() )
         {
-            return outcome::failure( inElemsNotTombstonedResult.error() );
+            return outcome::failure( entryResult.error() );
         }
 
-        return inElemsNotTombstonedResult.value();
+        return entryResult.value().value.has_value() && !entryResult.value().tombstoned;
     }
 
-    outcome::result<bool> CrdtSet::InElemsNotTombstoned( const std::string &aKey )
+    outcome::result<bool> CrdtSet::InElemsNotTombstoned( std::string_view aKey )
     {
         // /namespace/elems/<key>
-        auto prefix         = this->ElemsPrefix( aKey );
-        auto strElemsPrefix = prefix.GetKey();
+        auto elemsPrefix = this->NamespaceKeyBuilder( elemsNamespace_, aKey );
 
-        Buffer keyPrefixBuffer;
-        keyPrefixBuffer.put( strElemsPrefix );
-        auto queryResult = this->dataStore_->query( keyPrefixBuffer );
+        auto queryResult = this->dataStore_->query( elemsPrefix.GetView() );
         if ( queryResult.has_failure() )
         {
             return outcome::failure( queryResult.error() );
@@ -347,10 +414,8 @@ namespace sgns::crdt
 
         for ( const auto &bufferKeyAndValue : queryResult.value() )
         {
-            std::string keyWithPrefix = std::string( bufferKeyAndValue.first.toString() );
-            std::string id            = keyWithPrefix.erase( 0, strElemsPrefix.size() );
-            auto        hId           = HierarchicalKey( id );
-            if ( !hId.IsTopLevel() )
+            auto id = bufferKeyAndValue.first.toString().substr( elemsPrefix.Size() );
+            if ( !HierarchicalKey::IsTopLevel( id ) )
             {
                 // our prefix matches blocks from other keys i.e. our
                 // prefix is "hello" and we have a different key like
@@ -360,7 +425,7 @@ namespace sgns::crdt
                 continue;
             }
             // if not tombstoned, we have it
-            auto inTombResult = this->InTombsKeyID( aKey, hId.GetKey() );
+            auto inTombResult = this->InTombsKeyID( aKey, id );
             if ( inTombResult.has_value() && !inTombResult.value() )
             {
                 return true;
@@ -370,47 +435,59 @@ namespace sgns::crdt
         return false;
     }
 
-    HierarchicalKey CrdtSet::KeyPrefix( const std::string &aKey )
+    HierarchicalKeyBuilder CrdtSet::NamespaceKeyBuilder( std::string_view aNamespace, std::string_view aKey ) const
+    {
+        HierarchicalKeyBuilder builder( this->namespaceKey_ );
+        builder.Child( aNamespace ).Child( aKey );
+        return builder;
+    }
+
+    HierarchicalKey CrdtSet::KeyPrefix( std::string_view aKey )
     {
         // /namespace/<key>
         return this->namespaceKey_.ChildString( aKey );
     }
 
-    HierarchicalKey CrdtSet::ElemsPrefix( const std::string &aKey )
+    HierarchicalKey CrdtSet::ElemsPrefix( std::string_view aKey )
     {
         // /namespace/s/<key>
-        return this->KeyPrefix( std::string( elemsNamespace_ ) ).ChildString( aKey );
+        return this->NamespaceKeyBuilder( elemsNamespace_, aKey ).Build();
     }
 
-    HierarchicalKey CrdtSet::TombsPrefix( const std::string &aKey )
+    HierarchicalKey CrdtSet::TombsPrefix( std::string_view aKey )
     {
         // /namespace/t/<key>
-        return this->KeyPrefix( std::string( tombsNamespace_ ) ).ChildString( aKey );
+        return this->NamespaceKeyBuilder( tombsNamespace_, aKey ).Build();
     }
 
-    HierarchicalKey CrdtSet::KeysKey( const std::string &aKey )
+    HierarchicalKey CrdtSet::KeysKey( std::string_view aKey )
     {
         // /namespace/k/<key>
-        return this->KeyPrefix( std::string( keysNamespace_ ) ).ChildString( aKey );
+        return this->NamespaceKeyBuilder( keysNamespace_, aKey ).Build();
     }
 
-    HierarchicalKey CrdtSet::ValueKey( const std::string &aKey )
+    HierarchicalKey CrdtSet::ValueKey( std::string_view aKey )
     {
         // /namespace/k/<key>/v
-        return this->KeysKey( aKey ).ChildString( GetValueSuffix() );
+        return this->NamespaceKeyBuilder( keysNamespace_, aKey ).Child( valueSuffix_ ).Build();
     }
 
-    HierarchicalKey CrdtSet::PriorityKey( const std::string &aKey )
+    HierarchicalKey CrdtSet::PriorityKey( std::string_view aKey )
     {
         // /namespace/k/<key>/p
-        return this->KeysKey( aKey ).ChildString( GetPrioritySuffix() );
+        return this->NamespaceKeyBuilder( keysNamespace_, aKey ).Child( prioritySuffix_ ).Build();
     }
 
-    outcome::result<uint64_t> CrdtSet::GetPriority( const std::string &aKey )
+    outcome::result<uint64_t> CrdtSet::GetPriority( std::string_view aKey )
     {
+        if ( auto cached = this->valueCache_->Get( aKey ); cached && cached->priority )
+        {
+            return *cached->priority;
+        }
+
         uint64_t priority    = 0;
-        auto     prioK       = this->PriorityKey( aKey );
-        auto     valueResult = this->GetValueFromDatastore( prioK );
+        auto     prioK       = this->NamespaceKeyBuilder( keysNamespace_, aKey ).Child( prioritySuffix_ );
+        auto     valueResult = this->GetRawValue( prioK.GetView() );
         if ( !valueResult.has_failure() )
         {
             try
@@ -430,41 +507,40 @@ namespace sgns::crdt
         return priority;
     }
 
-    outcome::result<void> CrdtSet::SetPriority( const std::string &aKey, uint64_t aPriority )
+    outcome::result<void> CrdtSet::SetPriority( std::string_view aKey, uint64_t aPriority )
     {
         if ( this->dataStore_ == nullptr )
         {
             return outcome::failure( boost::system::error_code{} );
         }
 
-        auto prioK = this->PriorityKey( aKey );
+        auto prioK = this->NamespaceKeyBuilder( keysNamespace_, aKey ).Child( prioritySuffix_ );
 
         std::string strPriority = std::to_string( aPriority + 1 );
 
-        Buffer keyBuffer;
-        keyBuffer.put( prioK.GetKey() );
-
-        Buffer valueBuffer;
-        valueBuffer.put( strPriority );
-
-        return this->dataStore_->put( keyBuffer, valueBuffer );
+        auto putResult = this->dataStore_->put( prioK.GetView(), strPriority );
+        // Written outside of any batch, so the cached priority is stale from now on
+        this->valueCache_->Invalidate( aKey );
+        return putResult;
     }
 
-    outcome::result<void> CrdtSet::SetValue( const std::string &aKey,
-                                             const std::string &aID,
-                                             const Buffer      &aValue,
-                                             uint64_t           aPriority )
+    outcome::result<void> CrdtSet::SetValue( std::string_view aKey,
+                                             std::string_view aID,
+                                             const Buffer    &aValue,
+                                             uint64_t         aPriority )
     {
         if ( this->dataStore_ == nullptr )
         {
             return outcome::failure( boost::system::error_code{} );
         }
 
-        auto batchDatastore = this->dataStore_->batch();
-        auto setValueResult = this->SetValue( batchDatastore, aKey, aID, aValue, aPriority );
-        if ( setValueResult.has_failure() )
+        std::lock_guard lg( this->mutex_ );
+
+        auto batchDatastore = this->dataStore_->CreateBatch();
+        auto storeResult    = this->StoreValue( batchDatastore, aKey, aID, aValue, aPriority );
+        if ( storeResult.has_failure() )
         {
-            return outcome::failure( setValueResult.error() );
+            return outcome::failure( storeResult.error() );
         }
 
         auto commitResult = batchDatastore->commit();
@@ -473,14 +549,23 @@ namespace sgns::crdt
             return outcome::failure( commitResult.error() );
         }
 
+        if ( storeResult.value() )
+        {
+            this->valueCache_->Put( aKey, { std::string( aValue.toString() ), aPriority, false } );
+        }
+        else
+        {
+            this->valueCache_->Invalidate( aKey );
+        }
+
         return outcome::success();
     }
 
-    outcome::result<void> CrdtSet::SetValue( const std::unique_ptr<storage::BufferBatch> &aDataStore,
-                                             const std::string                           &aKey,
-                                             const std::string                           &aID,
-                                             const Buffer                                &aValue,
-                                             uint64_t                                     aPriority )
+    outcome::result<bool> CrdtSet::StoreValue( const std::unique_ptr<Batch> &aDataStore,
+                                               std::string_view              aKey,
+                                               std::string_view              aID,
+                                               const Buffer                 &aValue,
+                                               uint64_t                      aPriority )
     {
         if ( aDataStore == nullptr )
         {
@@ -496,7 +581,7 @@ namespace sgns::crdt
         if ( isDeletedResult.value() )
         {
             //if it's tombstone we just don't add it
-            return outcome::success();
+            return false;
         }
 
         auto priorityResult = this->GetPriority( aKey );
@@ -507,14 +592,14 @@ namespace sgns::crdt
 
         if ( aPriority < priorityResult.value() )
         {
-            return outcome::success();
+            return false;
         }
 
-        auto valueK = this->ValueKey( aKey );
+        auto valueK = this->NamespaceKeyBuilder( keysNamespace_, aKey ).Child( valueSuffix_ );
 
         if ( aPriority == priorityResult.value() )
         {
-            auto valueResult = this->GetValueFromDatastore( valueK );
+            auto valueResult = this->GetRawValue( valueK.GetView() );
             if ( valueResult.has_failure() )
             {
                 return outcome::failure( valueResult.error() );
@@ -522,18 +607,14 @@ namespace sgns::crdt
 
             // if bytes.Compare(valueResult.value(), aValue) >= 0 {
             // comparing two data lexicographically,  valueResult >= aValue, no need to store value
-            if ( !boost::lexicographical_compare<std::string, std::string>( valueResult.value(),
-                                                                            std::string( aValue.toString() ) ) )
+            if ( !boost::lexicographical_compare( valueResult.value(), aValue.toString() ) )
             {
-                return outcome::success();
+                return false;
             }
         }
 
         // store value
-        Buffer valueKeyBuffer;
-        valueKeyBuffer.put( valueK.GetKey() );
-
-        auto putResult = aDataStore->put( valueKeyBuffer, aValue );
+        auto putResult = aDataStore->put( valueK.GetView(), aValue.toString() );
         if ( putResult.has_failure() )
         {
             return outcome::failure( putResult.error() );
@@ -549,10 +630,10 @@ namespace sgns::crdt
         // trigger add hook
         if ( this->putHookFunc_ != nullptr )
         {
-            putHookFunc_( aKey, aValue );
+            putHookFunc_( std::string( aKey ), aValue );
         }
 
-        return outcome::success();
+        return true;
     }
 
     outcome::result<void> CrdtSet::PutElems( std::vector<Element> &aElems, const std::string &aID, uint64_t aPriority )
@@ -569,21 +650,22 @@ namespace sgns::crdt
 
         std::lock_guard lg( this->mutex_ );
 
-        auto batchDatastore = this->dataStore_->batch();
+        auto batchDatastore = this->dataStore_->CreateBatch();
+
+        // Index of each element whose value was stored, to write it through to the cache after the commit
+        std::vector<bool> storedElems( aElems.size(), false );
 
-        for ( auto &elem : aElems )
+        for ( std::size_t i = 0; i < aElems.size(); ++i )
         {
+            auto &elem = aElems[i];
             // overwrite the identifier as it would come unset
             elem.set_id( aID );
-            auto key = elem.key();
+            const auto &key = elem.key();
 
             // /namespace/s/<key>/<id>
-            auto kNamespace = this->ElemsPrefix( key ).ChildString( aID );
-
-            Buffer keyBuffer;
-            keyBuffer.put( kNamespace.GetKey() );
+            auto kNamespace = this->NamespaceKeyBuilder( elemsNamespace_, key ).Child( aID );
 
-            auto putResult = batchDatastore->put( std::move( keyBuffer ), Buffer() );
+            auto putResult = batchDatastore->put( kNamespace.GetView(), std::string_view() );
             if ( putResult.has_error() )
             {
                 return outcome::failure( putResult.error() );
@@ -593,11 +675,12 @@ namespace sgns::crdt
             // * not tombstoned before.
             Buffer valueBuffer;
             valueBuffer.put( elem.value() );
-            auto setValueResult = this->SetValue( batchDatastore, key, aID, std::move( valueBuffer ), aPriority );
-            if ( setValueResult.has_failure() )
+            auto storeResult = this->StoreValue( batchDatastore, key, aID, valueBuffer, aPriority );
+            if ( storeResult.has_failure() )
             {
-                return outcome::failure( setValueResult.error() );
+                return outcome::failure( storeResult.error() );
             }
+            storedElems[i] = storeResult.value();
         }
         auto commitResult = batchDatastore->commit();
         if ( commitResult.has_failure() )
@@ -605,6 +688,20 @@ namespace sgns::crdt
             return outcome::failure( commitResult.error() );
         }
 
+        for ( std::size_t i = 0; i < aElems.size(); ++i )
+        {
+            const auto &elem = aElems[i];
+            if ( storedElems[i] )
+            {
+                this->valueCache_->Put( elem.key(), { elem.value(), aPriority, false } );
+            }
+            else
+            {
+                // The value did not change, but the new element may have revived a tombstoned key
+                this->valueCache_->Invalidate( elem.key() );
+            }
+        }
+
         return outcome::success();
     }
 
@@ -620,7 +717,9 @@ namespace sgns::crdt
             return outcome::failure( boost::system::error_code{} );
         }
 
-        auto batchDatastore = this->dataStore_->batch();
+        std::unique_lock lock( this->mutex_ );
+
+        auto batchDatastore = this->dataStore_->CreateBatch();
 
         std::vector<std::string> deletedKeys;
         for ( auto tomb : aTombs )
@@ -631,12 +730,9 @@ namespace sgns::crdt
                 tomb.set_id( aID );
             }
             const auto &key        = tomb.key();
-            auto        kNamespace = this->TombsPrefix( key ).ChildString( tomb.id() );
-
-            Buffer keyBuffer;
-            keyBuffer.put( kNamespace.GetKey() );
+            auto        kNamespace = this->NamespaceKeyBuilder( tombsNamespace_, key ).Child( tomb.id() );
 
-            auto putResult = batchDatastore->put( std::move( keyBuffer ), Buffer() );
+            auto putResult = batchDatastore->put( kNamespace.GetView(), std::string_view() );
             if ( putResult.has_error() )
             {
                 return outcome::failure( putResult.error() );
@@ -654,6 +750,12 @@ namespace sgns::crdt
             return outcome::failure( commitResult.error() );
         }
 
+        for ( const auto &key : deletedKeys )
+        {
+            this->valueCache_->Invalidate( key );
+        }
+        lock.unlock();
+
         if ( deleteHookFunc_ )
         {
             for ( const auto &key : deletedKeys )
@@ -683,17 +785,16 @@ namespace sgns::crdt
         return this->PutElems( elements, aID, aDelta->priority() );
     }
 
-    outcome::result<bool> CrdtSet::InTombsKeyID( const std::string &aKey, const std::string &aID )
+    outcome::result<bool> CrdtSet::InTombsKeyID( std::string_view aKey, std::string_view aID )
     {
         if ( this->dataStore_ == nullptr )
         {
             return outcome::failure( boost::system::error_code{} );
         }
 
-        auto   kNamespace = this->TombsPrefix( aKey ).ChildString( aID );
-        Buffer keyBuffer;
-        keyBuffer.put( kNamespace.GetKey() );
-        return this->dataStore_->contains( keyBuffer );
+        // /namespace/t/<key>/<id>
+        auto kNamespace = this->NamespaceKeyBuilder( tombsNamespace_, aKey ).Child( aID );
+        return this->dataStore_->contains( kNamespace.GetView() );
     }
 
     void CrdtSet::SetPutHook( const PutHookPtr &putHookPtr )
@@ -726,6 +827,11 @@ namespace sgns::crdt
         return SetValue( aKey, aID, aValue, aPriority.value() );
     }
 
+    CrdtValueCache::Stats CrdtSet::GetValueCacheStats() const
+    {
+        return this->valueCache_->GetStats();
+    }
+
     void CrdtSet::PrintTombs( const std::vector<Element> &aTombs )
     {
         std::cout << "Tombs" << std::endl;
@@ -0,0 +1,184 @@
+#include "crdt/crdt_value_cache.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace sgns::crdt
+{
+    CrdtValueCache::CrdtValueCache( std::size_t aCapacityBytes, std::size_t aShardCount ) :
+        capacityBytes_( aCapacityBytes ),
+        shardCount_( std::max<std::size_t>( aShardCount, 1 ) ),
+        shardCapacityBytes_( aCapacityBytes / shardCount_ ),
+        shards_( std::make_unique<Shard[]>( shardCount_ ) )
+    {
+    }
+
+    std::optional<CrdtValueCache::Entry> CrdtValueCache::Get( std::string_view aKey )
+    {
+        if ( !IsEnabled() )
+        {
+            return std::nullopt;
+        }
+
+        auto            &shard = GetShard( aKey );
+        std::lock_guard  lock( shard.mutex );
+
+        auto it = shard.index.find( aKey );
+        if ( it == shard.index.end() )
+        {
+            misses_.fetch_add( 1, std::memory_order_relaxed );
+            return std::nullopt;
+        }
+
+        shard.lru.splice( shard.lru.begin(), shard.lru, it->second );
+        hits_.fetch_add( 1, std::memory_order_relaxed );
+        return it->second->entry;
+    }
+
+    CrdtValueCache::Ticket CrdtValueCache::BeginLoad( std::string_view aKey ) const
+    {
+        if ( !IsEnabled() )
+        {
+            return 0;
+        }
+        return GetShard( aKey ).generation.load( std::memory_order_acquire );
+    }
+
+    bool CrdtValueCache::Fill( std::string_view aKey, Entry aEntry, Ticket aTicket )
+    {
+        if ( !IsEnabled() )
+        {
+            return false;
+        }
+
+        auto            &shard = GetShard( aKey );
+        std::lock_guard  lock( shard.mutex );
+
+        if ( shard.generation.load( std::memory_order_relaxed ) != aTicket )
+        {
+            // A writer touched this shard while the entry was being loaded
+            return false;
+        }
+
+        Store( shard, aKey, std::move( aEntry ) );
+        return true;
+    }
+
+    void CrdtValueCache::Put( std::string_view aKey, Entry aEntry )
+    {
+        if ( !IsEnabled() )
+        {
+            return;
+        }
+
+        auto            &shard = GetShard( aKey );
+        std::lock_guard  lock( shard.mutex );
+
+        shard.generation.fetch_add( 1, std::memory_order_acq_rel );
+        Store( shard, aKey, std::move( aEntry ) );
+    }
+
+    void CrdtValueCache::Invalidate( std::string_view aKey )
+    {
+        if ( !IsEnabled() )
+        {
+            return;
+        }
+
+        auto            &shard = GetShard( aKey );
+        std::lock_guard  lock( shard.mutex );
+
+        shard.generation.fetch_add( 1, std::memory_order_acq_rel );
+        if ( Erase( shard, aKey ) )
+        {
+            invalidations_.fetch_add( 1, std::memory_order_relaxed );
+        }
+    }
+
+    void CrdtValueCache::Clear()
+    {
+        for ( std::size_t i = 0; i < shardCount_; ++i )
+        {
+            auto           &shard = shards_[i];
+            std::lock_guard lock( shard.mutex );
+
+            shard.generation.fetch_add( 1, std::memory_order_acq_rel );
+            shard.index.clear();
+            shard.lru.clear();
+            shard.bytes = 0;
+        }
+    }
+
+    CrdtValueCache::Stats CrdtValueCache::GetStats() const
+    {
+        Stats stats;
+        stats.hits          = hits_.load( std::memory_order_relaxed );
+        stats.misses        = misses_.load( std::memory_order_relaxed );
+        stats.insertions    = insertions_.load( std::memory_order_relaxed );
+        stats.evictions     = evictions_.load( std::memory_order_relaxed );
+        stats.invalidations = invalidations_.load( std::memory_order_relaxed );
+        stats.capacityBytes = capacityBytes_;
+
+        for ( std::size_t i = 0; i < shardCount_; ++i )
+        {
+            const auto     &shard = shards_[i];
+            std::lock_guard lock( shard.mutex );
+
+            stats.entries += shard.index.size();
+            stats.bytes   += shard.bytes;
+        }
+        return stats;
+    }
+
+    CrdtValueCache::Shard &CrdtValueCache::GetShard( std::string_view aKey ) const
+    {
+        return shards_[std::hash<std::string_view>{}( aKey ) % shardCount_];
+    }
+
+    void CrdtValueCache::Store( Shard &aShard, std::string_view aKey, Entry aEntry )
+    {
+        Erase( aShard, aKey );
+
+        const auto bytes = EntryBytes( aKey, aEntry );
+        if ( bytes > shardCapacityBytes_ )
+        {
+            return;
+        }
+
+        while ( aShard.bytes + bytes > shardCapacityBytes_ && !aShard.lru.empty() )
+        {
+            auto &victim = aShard.lru.back();
+            aShard.bytes -= victim.bytes;
+            aShard.index.erase( victim.key );
+            aShard.lru.pop_back();
+            evictions_.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        aShard.lru.push_front( Node{ std::string( aKey ), std::move( aEntry ), bytes } );
+        aShard.index.emplace( aShard.lru.front().key, aShard.lru.begin() );
+        aShard.bytes += bytes;
+        insertions_.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    bool CrdtValueCache::Erase( Shard &aShard, std::string_view aKey )
+    {
+        auto it = aShard.index.find( aKey );
+        if ( it == aShard.index.end() )
+        {
+            return false;
+        }
+
+        auto node     = it->second;
+        aShard.bytes -= node->bytes;
+        aShard.index.erase( it );
+        aShard.lru.erase( node );
+        return true;
+    }
+
+    std::size_t CrdtValueCache::EntryBytes( std::string_view aKey, const Entry &aEntry )
+    {
+        // Key and value payloads, plus the list node and the index slot that reference them
+        constexpr std::size_t NODE_OVERHEAD = sizeof( Node ) + 2 * sizeof( void * ) + sizeof( std::string_view ) +
+                                              sizeof( LruList::iterator ) + sizeof( void * );
+        return aKey.size() + ( aEntry.value ? aEntry.value->size() : 0 ) + NODE_OVERHEAD;
+    }
+} // namespace sgns::crdt
@@ -0,0 +1,401 @@
+#include "crdt/dag_block_cache.hpp"
+#include <algorithm>
+
+namespace sgns::crdt
+{
+    namespace
+    {
+        /// Fixed cost of a cache entry: map node, list node and shared_ptr control block
+        constexpr std::size_t ENTRY_OVERHEAD_BYTES = 192;
+        /// Estimated cost of a decoded link: CID, name and size
+        constexpr std::size_t LINK_OVERHEAD_BYTES = 96;
+
+        uint64_t Mix( uint64_t x )
+        {
+            // splitmix64 finalizer
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+    }
+
+    DAGBlockCache::FrequencySketch::FrequencySketch( std::size_t aExpectedEntries )
+    {
+        std::size_t width = 64;
+        while ( width < aExpectedEntries )
+        {
+            width <<= 1;
+        }
+        table_.assign( DEPTH * width, 0 );
+        widthMask_  = width - 1;
+        sampleSize_ = 10 * width;
+    }
+
+    std::size_t DAGBlockCache::FrequencySketch::Index( uint64_t aHash, std::size_t aRow ) const
+    {
+        static constexpr uint64_t SEEDS[DEPTH] = { 0xc3a5c85c97cb3127ULL,
+                                                   0xb492b66fbe98f273ULL,
+                                                   0x9ae16a3b2f90404fULL,
+                                                   0xcbf29ce484222325ULL };
+        return aRow * ( widthMask_ + 1 ) + ( Mix( aHash + SEEDS[aRow] ) & widthMask_ );
+    }
+
+    void DAGBlockCache::FrequencySketch::Increment( uint64_t aHash )
+    {
+        bool added = false;
+        for ( std::size_t row = 0; row < DEPTH; ++row )
+        {
+            auto &counter = table_[Index( aHash, row )];
+            if ( counter < MAX_COUNTER )
+            {
+                ++counter;
+                added = true;
+            }
+        }
+        if ( added && ++additions_ >= sampleSize_ )
+        {
+            Age();
+        }
+    }
+
+    uint32_t DAGBlockCache::FrequencySketch::Estimate( uint64_t aHash ) const
+    {
+        uint32_t estimate = MAX_COUNTER;
+        for ( std::size_t row = 0; row < DEPTH; ++row )
+        {
+            estimate = std::min<uint32_t>( estimate, table_[Index( aHash, row )] );
+        }
+        return estimate;
+    }
+
+    void DAGBlockCache::FrequencySketch::Age()
+    {
+        // Halving every counter lets the sketch forget blocks that stopped being popular
+        for ( auto &counter : table_ )
+        {
+            counter >>= 1;
+        }
+        additions_ /= 2;
+    }
+
+    DAGBlockCache::DAGBlockCache( std::size_t aCapacityBytes,
+                                  std::size_t aPendingCapacityBytes,
+                                  std::size_t aPendingMaxEntries,
+                                  std::size_t aShardCount ) :
+        capacityBytes_( aCapacityBytes ),
+        shardCount_( std::max<std::size_t>( aShardCount, 1 ) ),
+        shardCapacityBytes_( aCapacityBytes / shardCount_ ),
+        protectedCapacityBytes_( shardCapacityBytes_ / 5 * 4 ),
+        pendingCapacityBytes_( aPendingCapacityBytes ),
+        pendingMaxEntries_( std::max<std::size_t>( aPendingMaxEntries, 1 ) )
+    {
+        // Size the sketch for blocks of a few KiB, which is what CRDT deltas usually take
+        const std::size_t expectedEntries = shardCapacityBytes_ / 4096;
+        shards_.reserve( shardCount_ );
+        for ( std::size_t i = 0; i < shardCount_; ++i )
+        {
+            shards_.push_back( std::make_unique<Shard>( expectedEntries ) );
+        }
+    }
+
+    std::shared_ptr<DAGBlockCache::IPLDNode> DAGBlockCache::Get( const CID &aCid )
+    {
+        if ( capacityBytes_ == 0 )
+        {
+            return nullptr;
+        }
+
+        const auto       hash  = HashCid( aCid );
+        auto            &shard = GetShard( hash );
+        std::lock_guard  lock( shard.mutex );
+
+        shard.sketch.Increment( hash );
+
+        auto it = shard.entries.find( aCid );
+        if ( it == shard.entries.end() )
+        {
+            misses_.fetch_add( 1, std::memory_order_relaxed );
+            return nullptr;
+        }
+
+        Touch( shard, it->second );
+        hits_.fetch_add( 1, std::memory_order_relaxed );
+        return it->second.node;
+    }
+
+    bool DAGBlockCache::Insert( const CID &aCid, std::shared_ptr<IPLDNode> aNode )
+    {
+        if ( !aNode )
+        {
+            return false;
+        }
+
+        const auto bytes = NodeBytes( *aNode );
+        if ( capacityBytes_ == 0 || bytes > shardCapacityBytes_ )
+        {
+            return false;
+        }
+
+        const auto       hash  = HashCid( aCid );
+        auto            &shard = GetShard( hash );
+        std::lock_guard  lock( shard.mutex );
+
+        auto it = shard.entries.find( aCid );
+        if ( it != shard.entries.end() )
+        {
+            EraseClean( shard, it );
+        }
+        else if ( shard.probationBytes + shard.protectedBytes + bytes > shardCapacityBytes_ )
+        {
+            // TinyLFU admission: only displace the victim if the candidate is requested more often
+            const auto &victims = shard.probation.empty() ? shard.protectedList : shard.probation;
+            if ( !victims.empty() &&
+                 shard.sketch.Estimate( hash ) <= shard.sketch.Estimate( HashCid( victims.back() ) ) )
+            {
+                rejections_.fetch_add( 1, std::memory_order_relaxed );
+                return false;
+            }
+        }
+
+        Admit( shard, aCid, std::move( aNode ), bytes );
+        return true;
+    }
+
+    void DAGBlockCache::Erase( const CID &aCid )
+    {
+        if ( capacityBytes_ == 0 )
+        {
+            return;
+        }
+
+        auto            &shard = GetShard( HashCid( aCid ) );
+        std::lock_guard  lock( shard.mutex );
+
+        auto it = shard.entries.find( aCid );
+        if ( it != shard.entries.end() )
+        {
+            EraseClean( shard, it );
+        }
+    }
+
+    void DAGBlockCache::MarkPending( const CID &aCid )
+    {
+        std::lock_guard lock( pendingMutex_ );
+
+        auto it = pending_.find( aCid );
+        if ( it != pending_.end() )
+        {
+            pendingLru_.splice( pendingLru_.begin(), pendingLru_, it->second.position );
+            return;
+        }
+
+        pendingLru_.push_front( aCid );
+        pending_.emplace( aCid, PendingEntry{ nullptr, 0, pendingLru_.begin() } );
+        EvictPending();
+    }
+
+    bool DAGBlockCache::AddPending( const CID &aCid, std::shared_ptr<IPLDNode> aNode )
+    {
+        const auto bytes = aNode ? NodeBytes( *aNode ) : 0;
+
+        std::lock_guard lock( pendingMutex_ );
+
+        bool created = false;
+        auto it      = pending_.find( aCid );
+        if ( it != pending_.end() )
+        {
+            pendingBytes_ -= it->second.bytes;
+            it->second.node  = std::move( aNode );
+            it->second.bytes = bytes;
+            pendingLru_.splice( pendingLru_.begin(), pendingLru_, it->second.position );
+        }
+        else
+        {
+            pendingLru_.push_front( aCid );
+            pending_.emplace( aCid, PendingEntry{ std::move( aNode ), bytes, pendingLru_.begin() } );
+            created = true;
+        }
+        pendingBytes_ += bytes;
+        EvictPending();
+        return created;
+    }
+
+    std::shared_ptr<DAGBlockCache::IPLDNode> DAGBlockCache::GetPending( const CID &aCid )
+    {
+        std::lock_guard lock( pendingMutex_ );
+
+        auto it = pending_.find( aCid );
+        if ( it == pending_.end() || !it->second.node )
+        {
+            return nullptr;
+        }
+        pendingLru_.splice( pendingLru_.begin(), pendingLru_, it->second.position );
+        return it->second.node;
+    }
+
+    bool DAGBlockCache::IsPending( const CID &aCid ) const
+    {
+        std::lock_guard lock( pendingMutex_ );
+        return pending_.find( aCid ) != pending_.end();
+    }
+
+    bool DAGBlockCache::RemovePending( const CID &aCid )
+    {
+        std::lock_guard lock( pendingMutex_ );
+
+        auto it = pending_.find( aCid );
+        if ( it == pending_.end() )
+        {
+            return false;
+        }
+        ErasePending( it );
+        return true;
+    }
+
+    void DAGBlockCache::Clear()
+    {
+        for ( auto &shard : shards_ )
+        {
+            std::lock_guard lock( shard->mutex );
+            shard->entries.clear();
+            shard->probation.clear();
+            shard->protectedList.clear();
+            shard->probationBytes = 0;
+            shard->protectedBytes = 0;
+        }
+
+        std::lock_guard lock( pendingMutex_ );
+        pending_.clear();
+        pendingLru_.clear();
+        pendingBytes_ = 0;
+    }
+
+    DAGBlockCache::Stats DAGBlockCache::GetStats() const
+    {
+        Stats stats;
+        stats.hits             = hits_.load( std::memory_order_relaxed );
+        stats.misses           = misses_.load( std::memory_order_relaxed );
+        stats.admissions       = admissions_.load( std::memory_order_relaxed );
+        stats.rejections       = rejections_.load( std::memory_order_relaxed );
+        stats.evictions        = evictions_.load( std::memory_order_relaxed );
+        stats.pendingEvictions = pendingEvictions_.load( std::memory_order_relaxed );
+        stats.capacityBytes    = capacityBytes_;
+
+        for ( const auto &shard : shards_ )
+        {
+            std::lock_guard lock( shard->mutex );
+            stats.entries        += shard->entries.size();
+            stats.bytes          += shard->probationBytes + shard->protectedBytes;
+            stats.protectedBytes += shard->protectedBytes;
+        }
+
+        std::lock_guard lock( pendingMutex_ );
+        stats.pendingEntries = pending_.size();
+        stats.pendingBytes   = pendingBytes_;
+        return stats;
+    }
+
+    std::size_t DAGBlockCache::NodeBytes( const IPLDNode &aNode )
+    {
+        return ENTRY_OVERHEAD_BYTES + aNode.getRawBytes().size() + aNode.content().size() +
+               aNode.getLinks().size() * LINK_OVERHEAD_BYTES;
+    }
+
+    uint64_t DAGBlockCache::HashCid( const CID &aCid )
+    {
+        // FNV-1a over the multihash digest, which is already uniformly distributed
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for ( auto byte : aCid.content_address.getHash() )
+        {
+            hash ^= byte;
+            hash *= 0x100000001b3ULL;
+        }
+        return Mix( hash );
+    }
+
+    DAGBlockCache::Shard &DAGBlockCache::GetShard( uint64_t aHash ) const
+    {
+        return *shards_[( aHash >> 32 ) % shardCount_];
+    }
+
+    void DAGBlockCache::Touch( Shard &aShard, CleanEntry &aEntry )
+    {
+        if ( aEntry.segment == Segment::PROTECTED )
+        {
+            aShard.protectedList.splice( aShard.protectedList.begin(), aShard.protectedList, aEntry.position );
+            return;
+        }
+
+        // A second hit promotes the node out of probation
+        aShard.protectedList.splice( aShard.protectedList.begin(), aShard.probation, aEntry.position );
+        aShard.probationBytes -= aEntry.bytes;
+        aShard.protectedBytes += aEntry.bytes;
+        aEntry.segment         = Segment::PROTECTED;
+        RebalanceProtected( aShard );
+    }
+
+    void DAGBlockCache::Admit( Shard &aShard, const CID &aCid, std::shared_ptr<IPLDNode> aNode, std::size_t aBytes )
+    {
+        while ( aShard.probationBytes + aShard.protectedBytes + aBytes > shardCapacityBytes_ )
+        {
+            const auto &victims = aShard.probation.empty() ? aShard.protectedList : aShard.probation;
+            EraseClean( aShard, aShard.entries.find( victims.back() ) );
+            evictions_.fetch_add( 1, std::memory_order_relaxed );
+        }
+
+        aShard.probation.push_front( aCid );
+        aShard.entries.emplace( aCid,
+                                CleanEntry{ std::move( aNode ), aBytes, Segment::PROBATION, aShard.probation.begin() } );
+        aShard.probationBytes += aBytes;
+        admissions_.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void DAGBlockCache::EraseClean( Shard &aShard, std::map<CID, CleanEntry>::iterator aIt )
+    {
+        if ( aIt->second.segment == Segment::PROTECTED )
+        {
+            aShard.protectedList.erase( aIt->second.position );
+            aShard.protectedBytes -= aIt->second.bytes;
+        }
+        else
+        {
+            aShard.probation.erase( aIt->second.position );
+            aShard.probationBytes -= aIt->second.bytes;
+        }
+        aShard.entries.erase( aIt );
+    }
+
+    void DAGBlockCache::RebalanceProtected( Shard &aShard )
+    {
+        // Overflow of the protected segment goes back to the head of probation
+        while ( aShard.protectedBytes > protectedCapacityBytes_ && aShard.protectedList.size() > 1 )
+        {
+            auto &entry = aShard.entries.find( aShard.protectedList.back() )->second;
+            aShard.probation.splice( aShard.probation.begin(), aShard.protectedList, entry.position );
+            aShard.protectedBytes -= entry.bytes;
+            aShard.probationBytes += entry.bytes;
+            entry.segment          = Segment::PROBATION;
+        }
+    }
+
+    void DAGBlockCache::EvictPending()
+    {
+        // The most recent entry is always kept, even if it exceeds the budget on its own
+        while ( pendingLru_.size() > 1 &&
+                ( pending_.size() > pendingMaxEntries_ || pendingBytes_ > pendingCapacityBytes_ ) )
+        {
+            ErasePending( pending_.find( pendingLru_.back() ) );
+            pendingEvictions_.fetch_add( 1, std::memory_order_relaxed );
+        }
+    }
+
+    void DAGBlockCache::ErasePending( std::map<CID, PendingEntry>::iterator aIt )
+    {
+        pendingBytes_ -= aIt->second.bytes;
+        pendingLru_.erase( aIt->second.position );
+        pending_.erase( aIt );
+    }
+}
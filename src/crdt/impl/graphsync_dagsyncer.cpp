@@ -197,8 +197,27 @@ namespace sgns::crdt
         auto &peerID  = peerEntry.first;
         auto &address = peerEntry.second;
 
+        auto fetch_start = std::chrono::steady_clock::now();
         OUTCOME_TRY( ( auto &&, subscription ), RequestNode( peerID, address, cid ) );
 
+        auto fetched     = WaitForRequestedNode( cid, peerID );
+        if ( fetched )
+        {
+            fetch_latency_.Observe( std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now() - fetch_start )
+                                        .count() );
+        }
+        else
+        {
+            fetch_failures_.Increment();
+        }
+        return fetched;
+    }
+
+    outcome::result<std::shared_ptr<ipfs_lite::ipld::IPLDNode>> GraphsyncDAGSyncer::WaitForRequestedNode(
+        const CID    &cid,
+        const PeerId &peerID ) const
+    {
         while ( true )
         {
             if ( is_stopped_ )
@@ -311,10 +330,11 @@ namespace sgns::crdt
 
     outcome::result<bool> GraphsyncDAGSyncer::HasBlock( const CID &cid ) const
     {
-        auto getNodeResult       = GetNodeFromMerkleDAG( cid );
-        auto getCachedNodeResult = GrabCIDBlock( cid );
-
-        return getNodeResult.has_value() || getCachedNodeResult.has_value();
+        if ( GetNodeFromMerkleDAG( cid ).has_value() )
+        {
+            return true;
+        }
+        return GrabCIDBlock( cid ).has_value();
     }
 
     outcome::result<std::shared_ptr<ipfs_lite::ipld::IPLDNode>> GraphsyncDAGSyncer::GetNodeWithoutRequest(
@@ -583,27 +603,21 @@ namespace sgns::crdt
 
     void GraphsyncDAGSyncer::InitCIDBlock( const CID &cid )
     {
-        std::lock_guard<std::mutex> lock( cache_mutex_ );
-        lru_cid_cache_.init( cid );
-        logger_->debug( "Block initialized without content to LRU cache: CID {}, cache size: {}",
-                        cid.toString().value(),
-                        lru_cid_cache_.size() );
+        blockCache_.MarkPending( cid );
+        logger_->debug( "Block initialized without content to pending cache: CID {}", cid.toString().value() );
     }
 
     bool GraphsyncDAGSyncer::AddCIDBlock( const CID &cid, const std::shared_ptr<ipfs_lite::ipld::IPLDNode> &block )
     {
-        std::lock_guard<std::mutex> lock( cache_mutex_ );
-        bool                        was_created = lru_cid_cache_.add( cid, block );
+        bool was_created = blockCache_.AddPending( cid, block );
 
         if ( was_created )
         {
-            logger_->debug( "New block added to LRU cache: CID {}, cache size: {}",
-                            cid.toString().value(),
-                            lru_cid_cache_.size() );
+            logger_->debug( "New block added to pending cache: CID {}", cid.toString().value() );
         }
         else
         {
-            logger_->debug( "Existing block updated in LRU cache: CID {}", cid.toString().value() );
+            logger_->debug( "Existing block updated in pending cache: CID {}", cid.toString().value() );
         }
 
         return was_created;
@@ -611,36 +625,34 @@ namespace sgns::crdt
 
     bool GraphsyncDAGSyncer::IsCIDInCache( const CID &cid ) const
     {
-        std::lock_guard<std::mutex> lock( cache_mutex_ );
-        return lru_cid_cache_.contains( cid );
+        return blockCache_.IsPending( cid );
     }
 
     outcome::result<std::shared_ptr<ipfs_lite::ipld::IPLDNode>> GraphsyncDAGSyncer::GrabCIDBlock( const CID &cid ) const
     {
-        std::lock_guard<std::mutex> lock( cache_mutex_ );
-        if ( lru_cid_cache_.hasContent( cid ) )
+        if ( auto node = blockCache_.GetPending( cid ) )
         {
-            auto node = lru_cid_cache_.get( cid );
-            if ( node )
-            {
-                logger_->trace( "Block retrieved from LRU cache: CID {}", cid.toString().value() );
-                return node;
-            }
+            logger_->trace( "Block retrieved from pending cache: CID {}", cid.toString().value() );
+            return node;
         }
         return outcome::failure( Error::CID_NOT_FOUND );
     }
 
     outcome::result<void> GraphsyncDAGSyncer::DeleteCIDBlock( const CID &cid )
     {
-        std::lock_guard<std::mutex> lock( cache_mutex_ );
-        if ( lru_cid_cache_.remove( cid ) )
+        if ( blockCache_.RemovePending( cid ) )
         {
-            logger_->debug( "Block removed from LRU cache: CID {}", cid.toString().value() );
+            logger_->debug( "Block removed from pending cache: CID {}", cid.toString().value() );
             return outcome::success();
         }
         return outcome::failure( Error::CID_NOT_FOUND );
     }
 
+    DAGBlockCache::Stats GraphsyncDAGSyncer::GetBlockCacheStats() const
+    {
+        return blockCache_.GetStats();
+    }
+
     void GraphsyncDAGSyncer::AddToBlackList( const PeerId &peer ) const
     {
         std::lock_guard<std::mutex> lock( blacklist_mutex_ );
@@ -771,8 +783,16 @@ namespace sgns::crdt
     outcome::result<std::shared_ptr<ipfs_lite::ipld::IPLDNode>> GraphsyncDAGSyncer::GetNodeFromMerkleDAG(
         const CID &cid ) const
     {
+        if ( auto node = blockCache_.Get( cid ) )
+        {
+            return node;
+        }
+
+        // Filled under the DAG lock so a concurrent removal can't leave a stale node cached
         std::lock_guard<std::mutex> lock( mutex_ );
-        return dagService_.getNode( cid );
+        OUTCOME_TRY( auto node, dagService_.getNode( cid ) );
+        blockCache_.Insert( cid, node );
+        return node;
     }
 
     outcome::result<void> GraphsyncDAGSyncer::AddNodeToMerkleDAG(
@@ -785,6 +805,7 @@ namespace sgns::crdt
     outcome::result<void> GraphsyncDAGSyncer::RemoveNodeFromMerkleDAG( const CID &cid )
     {
         std::lock_guard<std::mutex> lock( mutex_ );
+        blockCache_.Erase( cid );
         return dagService_.removeNode( cid );
     }
 
@@ -869,117 +890,6 @@ namespace sgns::crdt
                 .count() );
     }
 
-    void GraphsyncDAGSyncer::LRUCIDCache::init( const CID &cid )
-    {
-        // Check if the item already exists
-        auto it = cache_map_.find( cid );
-        if ( it != cache_map_.end() )
-        {
-            // Already exists, just update its position in LRU list
-            lru_list_.erase( it->second.second );
-            lru_list_.push_front( cid );
-            it->second.second = lru_list_.begin();
-            return;
-        }
-
-        // If cache is full, remove the least recently used item
-        if ( cache_map_.size() >= MAX_CACHE_SIZE )
-        {
-            // Get the least recently used CID
-            const CID &lru_cid = lru_list_.back();
-            // Remove it from the cache
-            cache_map_.erase( lru_cid );
-            // Remove it from the LRU list
-            lru_list_.pop_back();
-        }
-
-        // Add the new item to the front of the LRU list
-        lru_list_.push_front( cid );
-        // Add to the cache map with nullptr and reference to its position in the LRU list
-        cache_map_[cid] = std::make_pair( nullptr, lru_list_.begin() );
-    }
-
-    bool GraphsyncDAGSyncer::LRUCIDCache::add( const CID &cid, std::shared_ptr<ipfs_lite::ipld::IPLDNode> node )
-    {
-        // Check if the item already exists
-        auto it = cache_map_.find( cid );
-        if ( it != cache_map_.end() )
-        {
-            // Existing entry - update it
-            // Move the CID to the front of the LRU list
-            lru_list_.erase( it->second.second );
-            lru_list_.push_front( cid );
-            // Update the cache item with new node and new iterator
-            it->second = std::make_pair( node, lru_list_.begin() );
-            return false; // Entry was updated, not created
-        }
-
-        // If cache is full, remove the least recently used item
-        if ( cache_map_.size() >= MAX_CACHE_SIZE )
-        {
-            // Get the least recently used CID
-            const CID &lru_cid = lru_list_.back();
-            // Remove it from the cache
-            cache_map_.erase( lru_cid );
-            // Remove it from the LRU list
-            lru_list_.pop_back();
-        }
-
-        // Add the new item to the front of the LRU list
-        lru_list_.push_front( cid );
-        // Add to the cache map with a reference to its position in the LRU list
-        cache_map_[cid] = std::make_pair( std::move( node ), lru_list_.begin() );
-        return true; // New entry was created
-    }
-
-    std::shared_ptr<ipfs_lite::ipld::IPLDNode> GraphsyncDAGSyncer::LRUCIDCache::get( const CID &cid )
-    {
-        auto it = cache_map_.find( cid );
-        if ( it == cache_map_.end() )
-        {
-            return nullptr;
-        }
-
-        // Move this item to the front of the LRU list
-        lru_list_.erase( it->second.second );
-        lru_list_.push_front( cid );
-
-        // Update the iterator in the cache map
-        it->second.second = lru_list_.begin();
-
-        // Return the node
-        return it->second.first;
-    }
-
-    bool GraphsyncDAGSyncer::LRUCIDCache::remove( const CID &cid )
-    {
-        auto it = cache_map_.find( cid );
-        if ( it == cache_map_.end() )
-        {
-            return false;
-        }
-
-        // Remove from LRU list
-        lru_list_.erase( it->second.second );
-
-        // Remove from cache map
-        cache_map_.erase( it );
-
-        return true;
-    }
-
-    bool GraphsyncDAGSyncer::LRUCIDCache::contains( const CID &cid ) const
-    {
-        return cache_map_.find( cid ) != cache_map_.end();
-    }
-
-    // Check if CID exists and has content
-    bool GraphsyncDAGSyncer::LRUCIDCache::hasContent( const CID &cid ) const
-    {
-        auto it = cache_map_.find( cid );
-        return it != cache_map_.end() && it->second.first != nullptr;
-    }
-
     void GraphsyncDAGSyncer::Stop()
     {
         logger_->debug( "Stopping Dagsyncer" );
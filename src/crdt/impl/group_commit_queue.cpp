@@ -0,0 +1,155 @@
+#include "crdt/group_commit_queue.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace sgns::crdt
+{
+    GroupCommitQueue::GroupCommitQueue( CommitFunction            commit,
+                                        std::chrono::milliseconds window,
+                                        size_t                    max_operations ) :
+        commit_( std::move( commit ) ),
+        window_( window ),
+        max_operations_( std::max<size_t>( max_operations, 1 ) ),
+        thread_( [this]() { Run(); } )
+    {
+    }
+
+    GroupCommitQueue::~GroupCommitQueue()
+    {
+        {
+            std::lock_guard lock( mutex_ );
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    std::future<outcome::result<void>> GroupCommitQueue::Enqueue( Operation operation, std::set<std::string> topics )
+    {
+        std::promise<outcome::result<void>> promise;
+        auto                                future = promise.get_future();
+        auto                                key    = operation.key.GetKey();
+
+        std::lock_guard lock( mutex_ );
+        // The newest group of the topics takes the write, unless the key is already in it or in a group opened
+        // after it, as a key written twice in a delta has no defined winner and groups are committed in order
+        Group *group = nullptr;
+        for ( auto it = groups_.rbegin(); it != groups_.rend(); ++it )
+        {
+            if ( it->topics == topics )
+            {
+                if ( !it->closed && it->keys.count( key ) == 0 )
+                {
+                    group = &*it;
+                }
+                break;
+            }
+            if ( it->keys.count( key ) != 0 )
+            {
+                break;
+            }
+        }
+        bool wake = false;
+        if ( group == nullptr )
+        {
+            group           = &groups_.emplace_back();
+            group->topics   = std::move( topics );
+            group->deadline = std::chrono::steady_clock::now() + window_;
+            wake            = groups_.size() == 1;
+        }
+        group->operations.push_back( std::move( operation ) );
+        group->promises.push_back( std::move( promise ) );
+        group->keys.insert( std::move( key ) );
+        if ( group->operations.size() >= max_operations_ )
+        {
+            group->closed = true;
+            wake          = true;
+        }
+        if ( wake )
+        {
+            cv_.notify_one();
+        }
+        return future;
+    }
+
+    void GroupCommitQueue::Flush()
+    {
+        std::unique_lock lock( mutex_ );
+        for ( auto &group : groups_ )
+        {
+            group.closed = true;
+        }
+        cv_.notify_one();
+        idle_cv_.wait( lock, [this]() { return groups_.empty() && !committing_; } );
+    }
+
+    GroupCommitQueue::Stats GroupCommitQueue::GetStats() const
+    {
+        std::lock_guard lock( mutex_ );
+        return stats_;
+    }
+
+    void GroupCommitQueue::Run()
+    {
+        std::unique_lock lock( mutex_ );
+        while ( true )
+        {
+            if ( groups_.empty() )
+            {
+                idle_cv_.notify_all();
+                if ( stopping_ )
+                {
+                    break;
+                }
+                cv_.wait( lock, [this]() { return stopping_ || !groups_.empty(); } );
+                continue;
+            }
+
+            // The oldest group has the earliest deadline. A closed group behind it is committed right away,
+            // along with every group opened before it.
+            const auto &oldest = groups_.front();
+            if ( !stopping_ && std::chrono::steady_clock::now() < oldest.deadline &&
+                 std::none_of( groups_.begin(), groups_.end(), []( const Group &group ) { return group.closed; } ) )
+            {
+                cv_.wait_until( lock, oldest.deadline );
+                continue;
+            }
+
+            Group group = std::move( groups_.front() );
+            groups_.pop_front();
+            committing_ = true;
+            lock.unlock();
+            Commit( group );
+            lock.lock();
+            committing_ = false;
+        }
+    }
+
+    void GroupCommitQueue::Commit( Group &group )
+    {
+        auto result = commit_( group.operations, group.topics );
+
+        {
+            std::lock_guard lock( mutex_ );
+            if ( result.has_failure() )
+            {
+                ++stats_.failures;
+            }
+            else
+            {
+                ++stats_.deltas;
+                stats_.operations += group.operations.size();
+                for ( const auto &operation : group.operations )
+                {
+                    stats_.bytes += operation.key.GetView().size() + operation.value.size();
+                }
+            }
+        }
+
+        for ( auto &promise : group.promises )
+        {
+            promise.set_value( result );
+        }
+    }
+}
@@ -3,37 +3,48 @@
 namespace sgns::crdt
 {
 
-    HierarchicalKey::HierarchicalKey( std::string key )
+    HierarchicalKey::HierarchicalKey( std::string_view key )
     {
+        key_.reserve( key.size() + 1 );
+
         // Add slash to beginning if missing
         if ( key.empty() || key[0] != '/' )
         {
-            key.insert( key.begin(), '/' );
+            key_.push_back( '/' );
         }
+        key_.insert( key_.end(), key.begin(), key.end() );
 
         // Remove trailing slash
-        if ( key.size() > 1 && key[key.size() - 1] == '/' )
+        if ( key_.size() > 1 && key_.back() == '/' )
         {
-            key.erase( key.begin() + key.size() - 1 );
+            key_.pop_back();
         }
-
-        this->key_ = key;
     }
 
-  HierarchicalKey HierarchicalKey::ChildString(const std::string& s) const
+  HierarchicalKey HierarchicalKey::ChildString( std::string_view s ) const
   {
-    std::string childString = s;
-    if ( !childString.empty() && childString[0] != '/' )
-    {
-      childString.insert(childString.begin(), '/');
-    }
-
-    return {this->key_ + childString};
+    HierarchicalKeyBuilder builder( *this );
+    builder.Child( s );
+    return builder.Build();
   }
 
   bool HierarchicalKey::IsTopLevel() const
   {
-    return GetList().size() == 1;
+    return !key_.empty() && IsTopLevel( GetView() );
+  }
+
+  bool HierarchicalKey::IsTopLevel( std::string_view key )
+  {
+    // Mirrors the normalization of the constructor: leading slash added, trailing one removed
+    if ( !key.empty() && key.front() == '/' )
+    {
+      key.remove_prefix( 1 );
+    }
+    if ( !key.empty() && key.back() == '/' )
+    {
+      key.remove_suffix( 1 );
+    }
+    return key.find( '/' ) == std::string_view::npos;
   }
 
   std::vector<std::string> HierarchicalKey::GetList() const
@@ -41,9 +52,50 @@ namespace sgns::crdt
     std::vector<std::string> listOfNames;
     if (!this->key_.empty())
     {
-      boost::split(listOfNames, this->key_, boost::is_any_of("/"));
+      boost::split(listOfNames, GetView(), boost::is_any_of("/"));
       listOfNames.erase(listOfNames.begin());
     }
     return listOfNames;
   }
+
+  HierarchicalKeyBuilder &HierarchicalKeyBuilder::Child( std::string_view segment )
+  {
+    if ( segment.empty() )
+    {
+      return *this;
+    }
+
+    if ( segment[0] != '/' )
+    {
+      key_.push_back( '/' );
+    }
+    key_.insert( key_.end(), segment.begin(), segment.end() );
+
+    // Remove trailing slash
+    if ( key_.size() > 1 && key_.back() == '/' )
+    {
+      key_.pop_back();
+    }
+    return *this;
+  }
+
+  HierarchicalKeyBuilder &HierarchicalKeyBuilder::Truncate( std::size_t size )
+  {
+    if ( size < key_.size() )
+    {
+      key_.resize( size );
+    }
+    return *this;
+  }
+
+  HierarchicalKey HierarchicalKeyBuilder::Build() const
+  {
+    if ( key_.empty() )
+    {
+      return HierarchicalKey( std::string_view() );
+    }
+    HierarchicalKey key;
+    key.key_ = key_;
+    return key;
+  }
 }
@@ -0,0 +1,138 @@
+#include "crdt/processed_block_index.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+namespace sgns::crdt
+{
+    ProcessedBlockIndex::ProcessedBlockIndex( std::shared_ptr<DataStore> aDatastore,
+                                              const HierarchicalKey     &aNamespace,
+                                              size_t                     aBloomBits ) :
+        dataStore_( std::move( aDatastore ) ),
+        namespaceKey_( aNamespace ),
+        bloom_( std::max<size_t>( ( aBloomBits + 63 ) / 64, 1 ) )
+    {
+        auto loadResult = LoadBloom();
+        if ( loadResult.has_failure() )
+        {
+            // Every lookup goes to the datastore until the blocks are recorded again
+            logger_->error( "Unable to load the processed blocks: {}", loadResult.error().message() );
+            for ( auto &word : bloom_ )
+            {
+                word.store( ~uint64_t{ 0 }, std::memory_order_relaxed );
+            }
+            return;
+        }
+        logger_->info( "Loaded {} processed blocks", size_.load() );
+    }
+
+    ProcessedBlockIndex::DataStore::ColumnFamilySpec ProcessedBlockIndex::GetColumnFamilySpec(
+        const HierarchicalKey &aNamespace )
+    {
+        return { std::string( aNamespace.GetView() ) + ":processed",
+                 std::string( aNamespace.GetView() ) + "/",
+                 "",
+                 10,
+                 true,
+                 0,
+                 4 * 1024 * 1024 };
+    }
+
+    ProcessedBlockIndex::State ProcessedBlockIndex::GetState( const CID &aCid ) const
+    {
+        auto keyResult = GetKey( aCid );
+        if ( keyResult.has_failure() || !MayContain( keyResult.value() ) )
+        {
+            return State::UNKNOWN;
+        }
+        auto getResult = dataStore_->get( std::string_view( keyResult.value() ) );
+        if ( getResult.has_failure() || getResult.value().empty() )
+        {
+            return State::UNKNOWN;
+        }
+        return getResult.value()[0] == static_cast<uint8_t>( State::COMPLETE ) ? State::COMPLETE : State::MERGED;
+    }
+
+    outcome::result<void> ProcessedBlockIndex::SetState( const CID &aCid, State aState )
+    {
+        if ( aState == State::UNKNOWN )
+        {
+            return outcome::failure( boost::system::error_code{} );
+        }
+        OUTCOME_TRY( auto &&key, GetKey( aCid ) );
+
+        std::lock_guard lock( mutex_ );
+        auto            current = GetState( aCid );
+        if ( current >= aState )
+        {
+            return outcome::success();
+        }
+        const char value = static_cast<char>( aState );
+        OUTCOME_TRY( dataStore_->put( std::string_view( key ), std::string_view( &value, 1 ) ) );
+        if ( current == State::UNKNOWN )
+        {
+            AddToBloom( key );
+            size_.fetch_add( 1, std::memory_order_relaxed );
+        }
+        return outcome::success();
+    }
+
+    outcome::result<std::string> ProcessedBlockIndex::GetKey( const CID &aCid ) const
+    {
+        OUTCOME_TRY( auto &&cidString, aCid.toString() );
+
+        // /<namespace>/<cid>
+        HierarchicalKeyBuilder builder( namespaceKey_ );
+        builder.Child( cidString );
+        return std::string( builder.GetView() );
+    }
+
+    std::pair<uint64_t, uint64_t> ProcessedBlockIndex::BloomHashes( std::string_view aKey ) const
+    {
+        uint64_t first = std::hash<std::string_view>{}( aKey );
+        // splitmix64 finalizer, the second hash only has to be independent enough and odd
+        uint64_t second = first + 0x9e3779b97f4a7c15ULL;
+        second          = ( second ^ ( second >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+        second          = ( second ^ ( second >> 27 ) ) * 0x94d049bb133111ebULL;
+        second          = second ^ ( second >> 31 );
+        return { first, second | 1 };
+    }
+
+    bool ProcessedBlockIndex::MayContain( std::string_view aKey ) const
+    {
+        auto [first, second] = BloomHashes( aKey );
+        const uint64_t bits  = bloom_.size() * 64;
+        for ( size_t i = 0; i < BLOOM_HASH_FUNCTIONS; ++i )
+        {
+            uint64_t bit = ( first + i * second ) % bits;
+            if ( ( bloom_[bit / 64].load( std::memory_order_relaxed ) & ( uint64_t{ 1 } << ( bit % 64 ) ) ) == 0 )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ProcessedBlockIndex::AddToBloom( std::string_view aKey )
+    {
+        auto [first, second] = BloomHashes( aKey );
+        const uint64_t bits  = bloom_.size() * 64;
+        for ( size_t i = 0; i < BLOOM_HASH_FUNCTIONS; ++i )
+        {
+            uint64_t bit = ( first + i * second ) % bits;
+            bloom_[bit / 64].fetch_or( uint64_t{ 1 } << ( bit % 64 ), std::memory_order_relaxed );
+        }
+    }
+
+    outcome::result<void> ProcessedBlockIndex::LoadBloom()
+    {
+        OUTCOME_TRY( auto &&entries, dataStore_->query( std::string( namespaceKey_.GetView() ) + "/" ) );
+        for ( const auto &[key, value] : entries )
+        {
+            AddToBloom( key.toString() );
+        }
+        size_.store( entries.size(), std::memory_order_relaxed );
+        return outcome::success();
+    }
+}
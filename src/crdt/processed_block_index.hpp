@@ -0,0 +1,107 @@
+/**
+ * @file       processed_block_index.hpp
+ * @brief      Durable index of the CRDT blocks already merged into the set
+ * @date       2026-10-18
+ */
+
+#ifndef SUPERGENIUS_CRDT_PROCESSED_BLOCK_INDEX_HPP
+#define SUPERGENIUS_CRDT_PROCESSED_BLOCK_INDEX_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <storage/rocksdb/rocksdb.hpp>
+#include <primitives/cid/cid.hpp>
+#include "base/logger.hpp"
+#include "crdt/hierarchical_key.hpp"
+
+namespace sgns::crdt
+{
+    /**
+     * @brief       Records which blocks were merged, so restarts don't merge them and their subgraphs again.
+     *              Entries live in the CRDT datastore under their own namespace, and an in memory bloom filter
+     *              loaded on construction answers most lookups of unknown blocks without reading the datastore.
+     */
+    class ProcessedBlockIndex
+    {
+    public:
+        using DataStore = storage::rocksdb;
+
+        /**
+         * @brief       How far the processing of a block went
+         */
+        enum class State : uint8_t
+        {
+            UNKNOWN  = 0, ///< Never merged
+            MERGED   = 1, ///< Delta merged, some blocks it links to may still be missing
+            COMPLETE = 2, ///< Delta merged along with every block it links to
+        };
+
+        static constexpr size_t DEFAULT_BLOOM_BITS   = size_t{ 1 } << 23;
+        static constexpr size_t BLOOM_HASH_FUNCTIONS = 7;
+
+        /**
+         * @brief       Creates the index and loads the bloom filter from the blocks already recorded
+         * @param[in]   aDatastore CRDT datastore
+         * @param[in]   aNamespace Namespace of the index entries
+         * @param[in]   aBloomBits Size of the bloom filter, about 10 bits per recorded block keep false positives at 1%
+         */
+        ProcessedBlockIndex( std::shared_ptr<DataStore> aDatastore,
+                             const HierarchicalKey     &aNamespace,
+                             size_t                     aBloomBits = DEFAULT_BLOOM_BITS );
+
+        /**
+         * @brief       Column family of the index entries, point reads only
+         */
+        static DataStore::ColumnFamilySpec GetColumnFamilySpec( const HierarchicalKey &aNamespace );
+
+        /**
+         * @brief       Returns how far the processing of a block went
+         * @param[in]   aCid CID of the block
+         */
+        State GetState( const CID &aCid ) const;
+
+        /**
+         * @brief       Records that a block reached a state. A block never goes back to an earlier state
+         * @param[in]   aCid CID of the block
+         * @param[in]   aState MERGED or COMPLETE
+         * @return      outcome::success or the datastore error
+         */
+        outcome::result<void> SetState( const CID &aCid, State aState );
+
+        /**
+         * @brief       Number of blocks recorded when the index was created, plus the ones recorded since
+         */
+        uint64_t GetSize() const
+        {
+            return size_.load( std::memory_order_relaxed );
+        }
+
+    private:
+        outcome::result<std::string> GetKey( const CID &aCid ) const;
+
+        /**
+         * @brief       Derives the bloom filter hashes of a key, by double hashing
+         */
+        std::pair<uint64_t, uint64_t> BloomHashes( std::string_view aKey ) const;
+
+        bool MayContain( std::string_view aKey ) const;
+
+        void AddToBloom( std::string_view aKey );
+
+        outcome::result<void> LoadBloom();
+
+        std::shared_ptr<DataStore>         dataStore_;
+        HierarchicalKey                    namespaceKey_;
+        std::vector<std::atomic<uint64_t>> bloom_;
+        std::atomic<uint64_t>              size_{ 0 };
+        std::mutex                         mutex_; ///< Keeps the states from going back
+        base::Logger                       logger_ = base::createLogger( "ProcessedBlockIndex" );
+    };
+}
+
+#endif
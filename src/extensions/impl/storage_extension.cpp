@@ -1,6 +1,7 @@
 
 #include "extensions/impl/storage_extension.hpp"
 
+#include <algorithm>
 #include <forward_list>
 
 #include "primitives/block_id.hpp"
@@ -36,6 +37,7 @@ namespace sgns::extensions {
     auto batch = storage_provider_->getCurrentBatch();
     auto prefix = memory_->loadN(prefix_data, prefix_length);
     auto res = batch->clearPrefix(prefix);
+    forgetPrefix(prefix);
     if (! res) {
       logger_->error("ext_clear_prefix failed: {}", res.error().message());
     }
@@ -46,7 +48,11 @@ namespace sgns::extensions {
     auto batch = storage_provider_->getCurrentBatch();
     auto key = memory_->loadN(key_data, key_length);
     auto del_result = batch->remove(key);
-    if (! del_result) {
+    callCache().cursor.reset();
+    if (del_result) {
+      cacheValue(key, boost::none);
+    } else {
+      callCache().values.erase(key);
       logger_->warn(
           "ext_clear_storage did not delete key {} from trie db with reason: "
           "{}",
@@ -57,18 +63,25 @@ namespace sgns::extensions {
 
   runtime::WasmSize StorageExtension::ext_exists_storage(
       runtime::WasmPointer key_data, runtime::WasmSize key_length) const {
-    auto batch = storage_provider_->getCurrentBatch();
     auto key = memory_->loadN(key_data, key_length);
-    return batch->contains(key) ? 1 : 0;
+    auto &cache = callCache();
+    if (auto it = cache.values.find(key); it != cache.values.end()) {
+      return it->second.has_value() ? 1 : 0;
+    }
+    auto batch = storage_provider_->getCurrentBatch();
+    auto exists = batch->contains(key);
+    if (! exists) {
+      cacheValue(key, boost::none);
+    }
+    return exists ? 1 : 0;
   }
 
   runtime::WasmPointer StorageExtension::ext_get_allocated_storage(
       runtime::WasmPointer key_data,
       runtime::WasmSize key_length,
       runtime::WasmPointer len_ptr) {
-    auto batch = storage_provider_->getCurrentBatch();
     auto key = memory_->loadN(key_data, key_length);
-    auto data = batch->get(key);
+    auto data = get(key);
     const auto length = data.has_value() ? data.value().size()
                                          : runtime::WasmMemory::kMaxMemorySize;
     memory_->store32(len_ptr, length);
@@ -158,7 +171,11 @@ namespace sgns::extensions {
 
     auto batch = storage_provider_->getCurrentBatch();
     auto put_result = batch->put(key, value);
-    if (! put_result) {
+    callCache().cursor.reset();
+    if (put_result) {
+      cacheValue(key, std::move(value));
+    } else {
+      callCache().values.erase(key);
       logger_->error(
           "ext_set_storage failed, due to fail in trie db with reason: {}",
           put_result.error().message());
@@ -236,8 +253,7 @@ namespace sgns::extensions {
       const base::Buffer &key,
       runtime::WasmSize offset,
       runtime::WasmSize max_length) const {
-    auto batch = storage_provider_->getCurrentBatch();
-    OUTCOME_TRY((auto &&, data), batch->get(key));
+    OUTCOME_TRY((auto &&, data), get(key));
 
     const auto data_length =
         std::min<runtime::WasmSize>(max_length, data.size() - offset);
@@ -248,21 +264,88 @@ namespace sgns::extensions {
 
   outcome::result<base::Buffer> StorageExtension::get(
       const base::Buffer &key) const {
+    auto &cache = callCache();
+    if (auto it = cache.values.find(key); it != cache.values.end()) {
+      if (! it->second.has_value()) {
+        return storage::trie::TrieError::NO_VALUE;
+      }
+      return it->second.value();
+    }
+
     auto batch = storage_provider_->getCurrentBatch();
-    return batch->get(key);
+    auto data = batch->get(key);
+    if (data.has_value()) {
+      cacheValue(key, data.value());
+    } else if (data.error() == storage::trie::TrieError::NO_VALUE) {
+      cacheValue(key, boost::none);
+    }
+    return data;
   }
 
   outcome::result<boost::optional<Buffer>> StorageExtension::getStorageNextKey(
       const base::Buffer &key) const {
-    auto batch = storage_provider_->getCurrentBatch();
-    auto cursor = batch->cursor();
-    BOOST_OUTCOME_TRYV2(auto &&, cursor->seek(key));
-    BOOST_OUTCOME_TRYV2(auto &&, cursor->next());
-    if (cursor->isValid()) {
-      OUTCOME_TRY((auto &&, next_key), cursor->key());
-      return boost::make_optional(next_key);
-    }
-    return boost::none;
+    auto &cache = callCache();
+    // iterating a map asks for the key after the one returned last, the
+    // cursor is already there
+    if (cache.cursor == nullptr || cache.cursor_key != key) {
+      auto batch = storage_provider_->getCurrentBatch();
+      cache.cursor = batch->cursor();
+      cache.cursor_key = key;
+      if (auto res = cache.cursor->seek(key); res.has_error()) {
+        cache.cursor.reset();
+        return res.error();
+      }
+    }
+    if (auto res = cache.cursor->next(); res.has_error()) {
+      cache.cursor.reset();
+      return res.error();
+    }
+    if (! cache.cursor->isValid()) {
+      cache.cursor.reset();
+      return boost::none;
+    }
+    auto next_key = cache.cursor->key();
+    if (next_key.has_error()) {
+      cache.cursor.reset();
+      return next_key.error();
+    }
+    cache.cursor_key = next_key.value();
+
+    // the value of the key is usually read next, the cursor is on its node
+    if (auto value = cache.cursor->value(); value.has_value()) {
+      cacheValue(next_key.value(), std::move(value.value()));
+    }
+    return boost::make_optional(next_key.value());
+  }
+
+  StorageExtension::CallCache &StorageExtension::callCache() const {
+    const auto generation = storage_provider_->getBatchGeneration();
+    if (cache_.batch_generation != generation) {
+      cache_.batch_generation = generation;
+      cache_.values.clear();
+      cache_.cursor.reset();
+    }
+    return cache_;
+  }
+
+  void StorageExtension::cacheValue(const base::Buffer &key,
+                                    CachedValue value) const {
+    auto &cache = callCache();
+    if (cache.values.size() >= kMaxCachedValues
+        && cache.values.count(key) == 0) {
+      cache.values.clear();
+    }
+    cache.values.insert_or_assign(key, std::move(value));
+  }
+
+  void StorageExtension::forgetPrefix(const base::Buffer &prefix) const {
+    auto &cache = callCache();
+    cache.cursor.reset();
+    auto it = cache.values.lower_bound(prefix);
+    while (it != cache.values.end() && it->first.size() >= prefix.size()
+           && std::equal(prefix.begin(), prefix.end(), it->first.begin())) {
+      it = cache.values.erase(it);
+    }
   }
 
   void StorageExtension::ext_storage_set_version_1(runtime::WasmSpan key,
@@ -3,6 +3,8 @@
 #define SUPERGENIUS_SRC_EXTENSIONS_STORAGE_EXTENSION_HPP
 
 #include <cstdint>
+#include <map>
+#include <memory>
 
 #include "base/logger.hpp"
 #include "runtime/trie_storage_provider.hpp"
@@ -12,6 +14,10 @@
 namespace sgns::extensions {
   /**
    * Implements extension functions related to storage
+   *
+   * Values read and written during a runtime call, including the absence of a
+   * key, are cached until the next call, and ext_storage_next_key continues
+   * from the cursor of the previous key instead of walking the trie again
    */
   class StorageExtension {
    public:
@@ -151,7 +157,38 @@ namespace sgns::extensions {
     runtime::WasmPointer ext_trie_blake2_256_ordered_root_version_1(
         runtime::WasmSpan values_data);
 
+    /// Values kept in the cache of a call before it is emptied
+    static constexpr size_t kMaxCachedValues = 1u << 16u;
+
    private:
+    /// value of a key, none if the key is absent
+    using CachedValue = boost::optional<base::Buffer>;
+
+    /**
+     * Storage accessed during the current call
+     */
+    struct CallCache {
+      uint64_t batch_generation = 0;
+      std::map<base::Buffer, CachedValue> values;
+      // cursor of the last key returned by ext_storage_next_key
+      std::unique_ptr<storage::BufferMapCursor> cursor;
+      base::Buffer cursor_key;
+    };
+
+    /**
+     * @return the cache of the current call, emptied if the storage provider
+     * has set a new batch since it was filled
+     */
+    CallCache &callCache() const;
+
+    void cacheValue(const base::Buffer &key, CachedValue value) const;
+
+    /**
+     * Drops what is cached of the keys starting with \arg prefix, along with
+     * the cursor, which may point to nodes the trie doesn't have anymore
+     */
+    void forgetPrefix(const base::Buffer &prefix) const;
+
     /**
      * Find the value by given key and the return the part of it starting from
      * given offset
@@ -178,6 +215,7 @@ namespace sgns::extensions {
     std::shared_ptr<runtime::WasmMemory> memory_;
     std::shared_ptr<storage::changes_trie::ChangesTracker> changes_tracker_;
     base::Logger logger_;
+    mutable CallCache cache_;
 
     constexpr static auto kDefaultLoggerTag = "WASM Runtime [StorageExtension]";
   };
@@ -82,6 +82,7 @@
 #include "runtime/binaryen/runtime_api/offchain_worker_impl.hpp"
 #include "runtime/binaryen/runtime_api/parachain_host_impl.hpp"
 #include "runtime/binaryen/runtime_api/tagged_transaction_queue_impl.hpp"
+#include "runtime/binaryen/runtime_manager.hpp"
 #include "runtime/common/storage_wasm_provider.hpp"
 #include "runtime/common/trie_storage_provider_impl.hpp"
 
@@ -92,6 +93,7 @@
 #include "storage/trie/impl/trie_storage_impl.hpp"
 #include "storage/trie/supergenius_trie/supergenius_trie_factory_impl.hpp"
 #include "storage/trie/serialization/supergenius_codec.hpp"
+#include "storage/trie/serialization/trie_pruner.hpp"
 #include "storage/trie/serialization/trie_serializer_impl.hpp"
 #include "transaction_pool/impl/pool_moderator_impl.hpp"
 #include "transaction_pool/impl/transaction_pool_impl.hpp"
@@ -295,6 +297,51 @@ namespace sgns::injector {
     return initialized.value();
   }
 
+  // trie pruner getter, nullptr when pruning is disabled
+  template <typename Injector>
+  sptr<storage::trie::TriePruner> get_trie_pruner(const Injector &injector) {
+    static auto initialized =
+        boost::optional<sptr<storage::trie::TriePruner>>(boost::none);
+    if (initialized) {
+      return initialized.value();
+    }
+    auto config = injector.template create<storage::trie::TriePruner::Config>();
+    if (config.keep_finalized == 0) {
+      initialized = nullptr;
+      return nullptr;
+    }
+    auto storage = injector.template create<sptr<storage::BufferStorage>>();
+    auto codec = injector.template create<sptr<storage::trie::Codec>>();
+    using blockchain::prefix::TRIE_NODE;
+    using blockchain::prefix::TRIE_PRUNING;
+    auto pruner = storage::trie::TriePruner::create(storage,
+                                                   base::Buffer{TRIE_NODE},
+                                                   base::Buffer{TRIE_PRUNING},
+                                                   codec,
+                                                   config);
+    if (!pruner) {
+      base::raise(pruner.error());
+    }
+    initialized = pruner.value();
+    return initialized.value();
+  }
+
+  // trie serializer getter, pruning the states when the pruner is on
+  template <typename Injector>
+  sptr<storage::trie::TrieSerializer> get_trie_serializer(
+      const Injector &injector) {
+    static auto initialized =
+        boost::optional<sptr<storage::trie::TrieSerializer>>(boost::none);
+    if (initialized) {
+      return initialized.value();
+    }
+    auto serializer =
+        injector.template create<sptr<storage::trie::TrieSerializerImpl>>();
+    serializer->setPruner(get_trie_pruner(injector));
+    initialized = serializer;
+    return serializer;
+  }
+
   // block tree getter
   template <typename Injector>
   sptr<blockchain::BlockTree> get_block_tree(const Injector &injector) {
@@ -330,6 +377,12 @@ namespace sgns::injector {
     if (!tree) {
       base::raise(tree.error());
     }
+    if (auto pruner = get_trie_pruner(injector)) {
+      tree.value()->setFinalizedEventHandler(
+          [pruner](const primitives::BlockHeader &header) {
+            pruner->onFinalized(base::Buffer{header.state_root});
+          });
+    }
     initialized = tree.value();
     return initialized.value();
   }
@@ -373,6 +426,40 @@ namespace sgns::injector {
     return initialized.value();
   }
 
+  // runtime manager getter, parsing the runtime code ahead of the first call
+  template <typename Injector>
+  sptr<runtime::binaryen::RuntimeManager> get_runtime_manager(
+      const Injector &injector) {
+    static auto initialized =
+        boost::optional<sptr<runtime::binaryen::RuntimeManager>>(boost::none);
+    if (initialized) {
+      return initialized.value();
+    }
+    auto runtime_manager = std::make_shared<runtime::binaryen::RuntimeManager>(
+        injector.template create<sptr<extensions::ExtensionFactory>>(),
+        injector.template create<sptr<runtime::binaryen::WasmModuleFactory>>(),
+        injector.template create<sptr<runtime::TrieStorageProvider>>(),
+        injector.template create<sptr<crypto::Hasher>>());
+
+    auto wasm_provider = injector.template create<sptr<runtime::WasmProvider>>();
+    if (auto storage_wasm_provider =
+            std::dynamic_pointer_cast<runtime::StorageWasmProvider>(
+                wasm_provider)) {
+      // a runtime upgrade is parsed as soon as its code is loaded
+      storage_wasm_provider->setCodeChangeHandler(
+          [weak_manager = std::weak_ptr(runtime_manager)](
+              const runtime::WasmProvider::StateCode &state_code) {
+            if (auto manager = weak_manager.lock()) {
+              manager->prepareModule(state_code);
+            }
+          });
+    }
+    runtime_manager->prepareModule(wasm_provider->getStateCode());
+
+    initialized = runtime_manager;
+    return runtime_manager;
+  }
+
   template <typename Injector>
   sptr<storage::trie::TrieStorageBackendImpl> get_trie_storage_backend(
       const Injector &injector) {
@@ -384,9 +471,11 @@ namespace sgns::injector {
       return initialized.value();
     }
     auto storage = injector.template create<sptr<storage::BufferStorage>>();
+    auto config = injector.template create<
+        storage::trie::TrieStorageBackendImpl::Config>();
     using blockchain::prefix::TRIE_NODE;
     auto backend = std::make_shared<storage::trie::TrieStorageBackendImpl>(
-        storage, base::Buffer{TRIE_NODE});
+        storage, base::Buffer{TRIE_NODE}, config.node_cache_bytes);
     initialized = backend;
     return backend;
   }
@@ -714,6 +803,8 @@ namespace sgns::injector {
         di::bind<runtime::ProductionApi>.template to<runtime::binaryen::ProductionApiImpl>(),
         di::bind<runtime::BlockBuilder>.template to<runtime::binaryen::BlockBuilderImpl>(),
         di::bind<runtime::TrieStorageProvider>.template to<runtime::TrieStorageProviderImpl>(),
+        di::bind<runtime::binaryen::RuntimeManager>.to(
+            [](auto const &inj) { return get_runtime_manager(inj); }),
         di::bind<transaction_pool::TransactionPool>.template to<transaction_pool::TransactionPoolImpl>(),
         di::bind<transaction_pool::PoolModerator>.template to<transaction_pool::PoolModeratorImpl>(),
         di::bind<storage::changes_trie::ChangesTracker>.template to<storage::changes_trie::StorageChangesTrackerImpl>(),
@@ -725,7 +816,8 @@ namespace sgns::injector {
             [](auto const &inj) { return get_trie_storage(inj); }),
         di::bind<storage::trie::SuperGeniusTrieFactory>.template to<storage::trie::SuperGeniusTrieFactoryImpl>(),
         di::bind<storage::trie::Codec>.template to<storage::trie::SuperGeniusCodec>(),
-        di::bind<storage::trie::TrieSerializer>.template to<storage::trie::TrieSerializerImpl>(),
+        di::bind<storage::trie::TrieSerializer>.to(
+            [](auto const &inj) { return get_trie_serializer(inj); }),
         di::bind<runtime::WasmProvider>.template to<runtime::StorageWasmProvider>(),
         di::bind<application::ConfigurationStorage>.to(
             [genesis_path](const auto &injector) {
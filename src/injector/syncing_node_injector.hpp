@@ -57,6 +57,10 @@ namespace sgns::injector {
                                 app_config->rocksdb_path(),
                                 app_config->rpc_http_endpoint(),
                                 app_config->rpc_ws_endpoint()),
+        injector::useConfig(storage::trie::TriePruner::Config{
+            app_config->state_pruning()}),
+        injector::useConfig(storage::trie::TrieStorageBackendImpl::Config{
+            size_t{app_config->trie_node_cache_size()} * 1024 * 1024}),
 
         // peer info
         di::bind<network::OwnPeerInfo>.to(
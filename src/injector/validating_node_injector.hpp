@@ -150,6 +150,10 @@ namespace sgns::injector {
                                 app_config->rocksdb_path(),
                                 app_config->rpc_http_endpoint(),
                                 app_config->rpc_ws_endpoint()),
+        injector::useConfig(storage::trie::TriePruner::Config{
+            app_config->state_pruning()}),
+        injector::useConfig(storage::trie::TrieStorageBackendImpl::Config{
+            size_t{app_config->trie_node_cache_size()} * 1024 * 1024}),
         // bind sr25519 keypair
         di::bind<crypto::SR25519Keypair>.to(
             [](auto const &inj) { return get_sr25519_keypair(inj); }),
@@ -2,9 +2,15 @@
 
 #include "network/impl/gossiper_broadcast.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+#include <libp2p/multi/uvarint.hpp>
+
 #include "network/common.hpp"
-#include "network/helpers/scale_message_read_writer.hpp"
 #include "network/impl/loopback_stream.hpp"
+#include "scale/scale.hpp"
 
 namespace sgns::network {
 
@@ -63,39 +69,56 @@ namespace sgns::network {
   }
 
   void GossiperBroadcast::broadcast(GossipMessage &&msg) {
-    auto msg_send_lambda = [msg, this](auto stream) {
-      auto read_writer =
-          std::make_shared<ScaleMessageReadWriter>(std::move(stream));
-      read_writer->write(msg, [this](auto &&res) {
-        if (! res) {
-          logger_->error("Could not broadcast, reason: {}",
-                         res.error().message());
-        }
-      });
-    };
+    auto encoded_msg_res = scale::encode(msg);
+    if (!encoded_msg_res) {
+      logger_->error("Could not broadcast, reason: {}",
+                     encoded_msg_res.error().message());
+      return;
+    }
+    // the same varint-prefixed frame a ScaleMessageReadWriter would write,
+    // built once for all the streams
+    const auto &encoded_msg = encoded_msg_res.value();
+    libp2p::multi::UVarint varint_len{encoded_msg.size()};
+    auto frame = std::make_shared<std::vector<uint8_t>>();
+    frame->reserve(varint_len.size() + encoded_msg.size());
+    frame->insert(
+        frame->end(), varint_len.toBytes().begin(), varint_len.toBytes().end());
+    frame->insert(frame->end(), encoded_msg.begin(), encoded_msg.end());
+    SharedMessage message = std::move(frame);
+
+    forgetSeen();
+    if (wasSeen(message)) {
+      logger_->debug("Gossip message was already broadcast, skipping it");
+      return;
+    }
 
     // iterate over the existing streams and send them the msg. If stream is
     // closed it is removed
+    bool sent = false;
     auto stream_it = syncing_streams_.begin();
     while (stream_it != syncing_streams_.end()) {
       auto stream = *stream_it;
       if (stream && !stream->isClosed()) {
-        msg_send_lambda(stream);
+        send(stream, message);
+        sent = true;
         stream_it++;
       } else {
         // remove this stream
+        dropQueue(stream);
         stream_it = syncing_streams_.erase(stream_it);
       }
     }
     for (const auto &[info, stream] : streams_) {
       if (stream && !stream->isClosed()) {
-        msg_send_lambda(stream);
+        send(stream, message);
+        sent = true;
         continue;
       }
+      dropQueue(stream);
       // if stream does not exist or expired, open a new one
       host_.newStream(info,
                       kGossipProtocol,
-                      [self{shared_from_this()}, info = info, msg_send_lambda](
+                      [self{shared_from_this()}, info = info, message](
                           auto &&stream_res) mutable {
                         if (!stream_res) {
                           // we will try to open the stream again, when
@@ -108,10 +131,113 @@ namespace sgns::network {
                         }
 
                         // save the stream and send the message
-                        self->streams_[info] = stream_res.value();
-                        msg_send_lambda(std::move(stream_res.value()));
+                        auto &stream = self->streams_[info];
+                        self->dropQueue(stream);
+                        stream = stream_res.value();
+                        self->send(stream, message);
+                        self->markSeen(message);
                       });
     }
+    // a message no peer was reached with may be broadcast again
+    if (sent) {
+      markSeen(message);
+    }
+  }
+
+  void GossiperBroadcast::send(
+      const std::shared_ptr<libp2p::connection::Stream> &stream,
+      const SharedMessage &message) {
+    auto &queue = write_queues_[stream.get()];
+    if (queue == nullptr) {
+      queue = std::make_shared<WriteQueue>();
+      queue->stream = stream;
+    }
+    if (queue->pending.size() >= kMaxQueuedMessages) {
+      // the peer doesn't keep up, its oldest gossip is the least useful
+      logger_->warn("Gossip queue of a stream is full, dropping a message");
+      queue->pending.pop_front();
+    }
+    queue->pending.push_back(message);
+    if (!queue->writing) {
+      writeNext(queue);
+    }
+  }
+
+  void GossiperBroadcast::writeNext(const std::shared_ptr<WriteQueue> &queue) {
+    if (queue->stream->isClosed()) {
+      dropQueue(queue->stream);
+      return;
+    }
+    if (queue->pending.empty()) {
+      queue->writing = false;
+      return;
+    }
+    queue->writing = true;
+    auto message = std::move(queue->pending.front());
+    queue->pending.pop_front();
+
+    // the buffer is kept alive by the callback until the write is done
+    queue->stream->write(
+        *message,
+        message->size(),
+        [self{shared_from_this()}, queue, message](auto &&res) {
+          if (!res) {
+            self->logger_->error("Could not broadcast, reason: {}",
+                                 res.error().message());
+            // the stream is reopened or dropped by the next broadcast
+            self->dropQueue(queue->stream);
+            return;
+          }
+          self->writeNext(queue);
+        });
+  }
+
+  void GossiperBroadcast::dropQueue(
+      const std::shared_ptr<libp2p::connection::Stream> &stream) {
+    write_queues_.erase(stream.get());
+  }
+
+  bool GossiperBroadcast::wasSeen(const SharedMessage &message) const {
+    auto [begin, end] = seen_messages_.equal_range(hashOf(message));
+    return std::any_of(begin, end, [&message](const auto &seen) {
+      return *seen.second == *message;
+    });
+  }
+
+  void GossiperBroadcast::markSeen(const SharedMessage &message) {
+    if (wasSeen(message)) {
+      return;
+    }
+
+    const auto hash = hashOf(message);
+    seen_messages_.emplace(hash, message);
+    seen_order_.push_back(SeenMessage{
+        hash, message, std::chrono::steady_clock::now() + kSeenMessagesTtl});
+    forgetSeen();
+  }
+
+  void GossiperBroadcast::forgetSeen() {
+    const auto now = std::chrono::steady_clock::now();
+    // every entry lives as long, so the oldest one expires first
+    while (!seen_order_.empty()
+           && (seen_order_.size() > kSeenMessagesLimit
+               || seen_order_.front().expiry <= now)) {
+      const auto &oldest = seen_order_.front();
+      auto [first, last] = seen_messages_.equal_range(oldest.hash);
+      for (auto it = first; it != last; ++it) {
+        if (it->second == oldest.message) {
+          seen_messages_.erase(it);
+          break;
+        }
+      }
+      seen_order_.pop_front();
+    }
+  }
+
+  size_t GossiperBroadcast::hashOf(const SharedMessage &message) {
+    return std::hash<std::string_view>{}(std::string_view(
+        reinterpret_cast<const char *>(message->data()),  // NOLINT
+        message->size()));
   }
 
 }  // namespace sgns::network
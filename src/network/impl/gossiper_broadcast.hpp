@@ -3,8 +3,11 @@
 #ifndef SUPERGENIUS_GOSSIPER_BROADCAST_HPP
 #define SUPERGENIUS_GOSSIPER_BROADCAST_HPP
 
+#include <chrono>
+#include <deque>
 #include <gsl/span>
 #include <unordered_map>
+#include <vector>
 
 #include <libp2p/connection/stream.hpp>
 #include <libp2p/host/host.hpp>
@@ -16,6 +19,11 @@
 namespace sgns::network {
   /**
    * Sends gossip messages using broadcast strategy
+   *
+   * A message is encoded once, and every stream writes from the same buffer.
+   * Each stream has its own queue with a single write in flight, so a slow
+   * peer holds only a bounded number of messages, and a message broadcast
+   * within the last kSeenMessagesTtl is not sent again
    */
   class GossiperBroadcast
       : public Gossiper,
@@ -25,6 +33,16 @@ namespace sgns::network {
     using PrimaryPropose = verification::finality::PrimaryPropose;
 
    public:
+    /// Messages waiting for a stream, the oldest is dropped beyond that
+    static constexpr size_t kMaxQueuedMessages = 64;
+
+    /// Recently broadcast messages remembered to filter out duplicates
+    static constexpr size_t kSeenMessagesLimit = 4096;
+
+    /// How long a broadcast message is filtered out. Short enough for a
+    /// retransmitted vote or status of this node to go out again
+    static constexpr std::chrono::milliseconds kSeenMessagesTtl{1000};
+
     GossiperBroadcast(libp2p::Host &host);
 
     ~GossiperBroadcast() override = default;
@@ -49,13 +67,66 @@ namespace sgns::network {
     }
 
    private:
+    using SharedMessage = std::shared_ptr<const std::vector<uint8_t>>;
+
+    /**
+     * Messages to write to a stream, one after another
+     */
+    struct WriteQueue {
+      std::shared_ptr<libp2p::connection::Stream> stream;
+      std::deque<SharedMessage> pending;
+      bool writing = false;
+    };
+
+    struct SeenMessage {
+      size_t hash;
+      SharedMessage message;
+      std::chrono::steady_clock::time_point expiry;
+    };
+
     void broadcast(GossipMessage &&msg);
 
+    /**
+     * Queues an encoded message for the stream, starting the write if none is
+     * in flight
+     */
+    void send(const std::shared_ptr<libp2p::connection::Stream> &stream,
+              const SharedMessage &message);
+
+    void writeNext(const std::shared_ptr<WriteQueue> &queue);
+
+    /**
+     * Forgets the queue of a stream which is closed, failed or replaced
+     */
+    void dropQueue(const std::shared_ptr<libp2p::connection::Stream> &stream);
+
+    /**
+     * @return true if the encoded message was broadcast recently
+     */
+    bool wasSeen(const SharedMessage &message) const;
+
+    /**
+     * Records the encoded message as broadcast, once it reached a peer
+     */
+    void markSeen(const SharedMessage &message);
+
+    /**
+     * Forgets the messages past their expiry, and the oldest ones beyond
+     * kSeenMessagesLimit
+     */
+    void forgetSeen();
+
+    static size_t hashOf(const SharedMessage &message);
+
     libp2p::Host &host_;
     std::unordered_map<libp2p::peer::PeerInfo,
                        std::shared_ptr<libp2p::connection::Stream>>
         streams_;
     std::vector<std::shared_ptr<libp2p::connection::Stream>> syncing_streams_;
+    std::unordered_map<libp2p::connection::Stream *, std::shared_ptr<WriteQueue>>
+        write_queues_;
+    std::unordered_multimap<size_t, SharedMessage> seen_messages_;
+    std::deque<SeenMessage> seen_order_;  // oldest first
     base::Logger logger_;
   };
 }  // namespace sgns::network
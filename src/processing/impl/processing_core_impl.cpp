@@ -3,6 +3,7 @@
 #include <rapidjson/document.h>
 
 #include "FileManager.hpp"
+#include "base/tracing.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY_3( sgns::processing, ProcessingCoreImpl::Error, e )
 {
@@ -48,7 +49,9 @@ namespace sgns::processing
         task.ParseFromArray( queryTasks.value().data(), queryTasks.value().size() );
         if ( cidData_.find( subTask.subtaskid() ) == cidData_.end() )
         {
-            auto buffers = GetCidForProc( subTask.json_data(), task.json_data() );
+            base::TraceSpan fetchSpan( "fetch_inputs", subTask.ipfsblock(), subTask.subtaskid() );
+            auto            buffers = GetCidForProc( subTask.json_data(), task.json_data() );
+            fetchSpan.End();
             if ( buffers == nullptr )
             {
                 return outcome::failure( Error::NO_BUFFER_FROM_JOB_DATA );
@@ -61,11 +64,13 @@ namespace sgns::processing
             //this->cidData_.insert( { subTask.subtaskid(), buffers } );
             //this->ProcessSubTask2(subTask, result, initialHashCode, buffers->second.at(0));
             //this->m_processor->SetData(buffers);
+            base::TraceSpan inferenceSpan( "inference", subTask.ipfsblock(), subTask.subtaskid() );
             auto        tempresult = this->m_processor->StartProcessing( result,
                                                                   task,
                                                                   subTask,
                                                                   *buffers->second,
                                                                   *buffers->first );
+            inferenceSpan.End();
             std::string hashString( tempresult.begin(), tempresult.end() );
             result.set_result_hash( hashString );
             result.set_token_id( m_tokenId.bytes().data(), m_tokenId.size() );
@@ -85,11 +90,13 @@ namespace sgns::processing
 
             // Set data and process
             //this->m_processor->SetData(buffers);
+            base::TraceSpan inferenceSpan( "inference", subTask.ipfsblock(), subTask.subtaskid() );
             auto        tempresult = this->m_processor->StartProcessing( result,
                                                                   task,
                                                                   subTask,
                                                                   *buffers->second,
                                                                   *buffers->first );
+            inferenceSpan.End();
             std::string hashString( tempresult.begin(), tempresult.end() );
             result.set_result_hash( hashString );
             result.set_token_id( m_tokenId.bytes().data(), m_tokenId.size() );
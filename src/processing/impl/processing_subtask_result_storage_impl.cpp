@@ -12,21 +12,37 @@ namespace sgns::processing
 
     SubTaskResultStorageImpl::~SubTaskResultStorageImpl() {}
 
-    void SubTaskResultStorageImpl::AddSubTaskResult( const SGProcessing::SubTaskResult &result )
+    bool SubTaskResultStorageImpl::AddSubTaskResult( const SGProcessing::SubTaskResult &result )
     {
         sgns::crdt::GlobalDB::Buffer data;
         data.put( result.SerializeAsString() );
 
-        auto taskId = m_db->Put(
-            sgns::crdt::HierarchicalKey( ( boost::format( "results/%s" ) % result.subtaskid() ).str() ),
-            data,
-            { m_processing_topic } );
+        // Results are written at a high rate, with group commit enabled concurrent ones share deltas
+        auto written = m_db->PutAsync( sgns::crdt::HierarchicalKey(
+                                           ( boost::format( "results/%s" ) % result.subtaskid() ).str() ),
+                                       data,
+                                       { m_processing_topic } );
+        if ( auto result_written = written.get(); result_written.has_failure() )
+        {
+            m_logger->error( "Could not store the result of subtask {}: {}",
+                             result.subtaskid(),
+                             result_written.error().message() );
+            return false;
+        }
+        return true;
     }
 
     void SubTaskResultStorageImpl::RemoveSubTaskResult( const std::string &subTaskId )
     {
-        m_db->Remove( sgns::crdt::HierarchicalKey( ( boost::format( "results/%s" ) % subTaskId ).str() ),
-                      { m_processing_topic } );
+        auto removed = m_db->RemoveAsync(
+            sgns::crdt::HierarchicalKey( ( boost::format( "results/%s" ) % subTaskId ).str() ),
+            { m_processing_topic } );
+        if ( auto result_removed = removed.get(); result_removed.has_failure() )
+        {
+            m_logger->error( "Could not remove the result of subtask {}: {}",
+                             subTaskId,
+                             result_removed.error().message() );
+        }
     }
 
     std::vector<SGProcessing::SubTaskResult> SubTaskResultStorageImpl::GetSubTaskResults(
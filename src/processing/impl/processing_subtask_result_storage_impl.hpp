@@ -18,10 +18,11 @@ namespace sgns::processing
 
         ~SubTaskResultStorageImpl();
 
-        /** Add a subtask result
+        /** Add a subtask result, waiting for its write to be published
         * @param result - Result to add
+        * @return true once the result is stored
         */
-        void AddSubTaskResult( const SGProcessing::SubTaskResult &result ) override;
+        bool AddSubTaskResult( const SGProcessing::SubTaskResult &result ) override;
 
         /** Remove a subtask result
         * @param subTaskId - Result ID to remove
@@ -37,6 +38,7 @@ namespace sgns::processing
     private:
         std::shared_ptr<sgns::crdt::GlobalDB> m_db;
         std::string                           m_processing_topic;
+        sgns::base::Logger                    m_logger = sgns::base::createLogger( "SubTaskResultStorageImpl" );
     };
 }
 
@@ -1,5 +1,7 @@
 #include "processing_engine.hpp"
 
+#include "base/tracing.hpp"
+
 #include <thread>
 #include <memory>
 #include <utility>
@@ -75,9 +77,13 @@ namespace sgns::processing
             [subTask( std::move( subTask ) ), _this( shared_from_this() )]()
             {
                 // @todo set initial hash code that depends on node id
-                auto maybe_result = _this->m_processingCore->ProcessSubTask(
-                    subTask,
-                    std::hash<std::string>{}( _this->m_nodeId ) );
+                auto maybe_result = [&]()
+                {
+                    base::ScopedTimer timer( _this->m_subTaskDuration );
+                    base::TraceSpan   span( "process_subtask", subTask.ipfsblock(), subTask.subtaskid() );
+                    return _this->m_processingCore->ProcessSubTask( subTask,
+                                                                    std::hash<std::string>{}( _this->m_nodeId ) );
+                }();
                 if ( maybe_result.has_value() )
                 {
                     SGProcessing::SubTaskResult result = maybe_result.value();
@@ -105,6 +111,7 @@ namespace sgns::processing
                 }
                 else
                 {
+                    _this->m_subTaskFailures.Increment();
                     _this->m_processingErrorSink( maybe_result.error().message() );
                 }
             } );
@@ -9,6 +9,7 @@
 #include "processing/processing_core.hpp"
 #include "processing/processing_subtask_queue_accessor.hpp"
 #include "base/logger.hpp"
+#include "base/metrics.hpp"
 
 namespace sgns::processing
 {
@@ -50,6 +51,13 @@ namespace sgns::processing
 
         mutable std::mutex m_mutexSubTaskQueue;
 
+        base::Histogram &m_subTaskDuration = base::MetricsRegistry::Instance().GetHistogram(
+            "processing_subtask_duration_us",
+            "Time to process a subtask, in microseconds" );
+        base::Counter &m_subTaskFailures = base::MetricsRegistry::Instance().GetCounter(
+            "processing_subtask_failures_total",
+            "Subtasks the processing core failed on" );
+
         base::Logger m_logger = base::createLogger( "ProcessingEngine" );
     };
 }
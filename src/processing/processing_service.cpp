@@ -1,5 +1,7 @@
 #include "processing_service.hpp"
 
+#include "base/tracing.hpp"
+
 #include <utility>
 #include <thread>
 
@@ -249,6 +251,7 @@ namespace sgns::processing
         }
 
         m_logger->debug( "[{}] AcceptProcessingChannel for queue {}", node_address_, processingQueuelId );
+        base::TraceSpan span( "accept_channel", processingQueuelId );
 
         // Check if we're currently in the process of creating any node
         {
@@ -486,6 +489,7 @@ namespace sgns::processing
             std::lock_guard<std::mutex> lockCreation( m_mutexPendingCreation );
             m_competingPeers.insert( node_address_ );
             m_pendingCreationTimestamp = std::chrono::steady_clock::now();
+            m_negotiationStartUs       = base::Tracer::Instance().IsEnabled() ? base::Tracer::Now() : 0;
         }
 
         m_gridChannel->Publish( gridMessage.SerializeAsString() );
@@ -558,6 +562,7 @@ namespace sgns::processing
                              m_pendingSubTaskQueueId,
                              reason );
 
+            RecordNegotiationSpan();
             m_pendingSubTaskQueueId.clear();
             m_pendingSubTasks.clear();
             m_pendingTask.reset();
@@ -565,6 +570,23 @@ namespace sgns::processing
         }
     }
 
+    void ProcessingServiceImpl::RecordNegotiationSpan()
+    {
+        if ( m_negotiationStartUs == 0 )
+        {
+            return;
+        }
+        base::TraceEvent event;
+        event.name        = "channel_negotiation";
+        event.task_id     = m_pendingSubTaskQueueId;
+        event.start_us    = m_negotiationStartUs;
+        event.duration_us = base::Tracer::Now() - m_negotiationStartUs;
+        event.thread_id   = base::Tracer::ThreadId();
+        event.span_id     = base::Tracer::Instance().NewSpanId();
+        base::Tracer::Instance().Record( std::move( event ) );
+        m_negotiationStartUs = 0;
+    }
+
     bool ProcessingServiceImpl::HasLowestAddress() const
     {
         if ( m_competingPeers.empty() )
@@ -595,6 +617,7 @@ namespace sgns::processing
             subTaskQueueId = m_pendingSubTaskQueueId;
             subTasks       = m_pendingSubTasks;
             task           = m_pendingTask;
+            RecordNegotiationSpan();
 
             // Check if we still have the lowest address
             if ( !HasLowestAddress() )
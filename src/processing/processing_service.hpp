@@ -69,6 +69,10 @@ namespace sgns::processing
         bool HasLowestAddress() const;
         bool IsPendingCreationStale() const;
         void CancelPendingCreation( const std::string &reason );
+        /**
+         * Records the node creation negotiation as a trace span, called with m_mutexPendingCreation held
+         */
+        void RecordNegotiationSpan();
 
         std::shared_ptr<sgns::ipfs_pubsub::GossipPubSub>       m_gossipPubSub;
         std::shared_ptr<boost::asio::io_context>               m_context;
@@ -94,6 +98,7 @@ namespace sgns::processing
         std::set<std::string>                 m_competingPeers;
         std::chrono::steady_clock::time_point m_pendingCreationTimestamp;
         std::chrono::seconds                  m_pendingCreationTimeout{ 10 };
+        int64_t                               m_negotiationStartUs = 0; ///< 0 when not traced
 
         boost::asio::deadline_timer         m_nodeCreationTimer;
         boost::posix_time::time_duration    m_nodeCreationTimeout;
@@ -1,5 +1,6 @@
 #include <fmt/std.h>
 #include "processing_subtask_queue_accessor_impl.hpp"
+#include "base/tracing.hpp"
 #include <thread>
 #include <utility>
 
@@ -39,6 +40,7 @@ namespace sgns::processing
         {
             m_resultChannel = std::make_shared<ipfs_pubsub::GossipPubSubTopic>( m_gossipPubSub,
                                                                                 "RESULT_CHANNEL_ID_" + task_id );
+            m_taskId = task_id;
             m_logger->debug( "Results channel created with \"RESULT_CHANNEL_ID_{}\"", task_id );
             ret = true;
         }
@@ -166,14 +168,30 @@ namespace sgns::processing
     void SubTaskQueueAccessorImpl::CompleteSubTask( const std::string                 &subTaskId,
                                                     const SGProcessing::SubTaskResult &subTaskResult )
     {
-        m_subTaskResultStorage->AddSubTaskResult( subTaskResult );
+        // The subtask is only marked processed once its result is published, so peers never see it without one
+        if ( !m_subTaskResultStorage->AddSubTaskResult( subTaskResult ) )
+        {
+            m_logger->error( "SubTask {} result not stored, leaving it unprocessed", subTaskId );
+            return;
+        }
         m_subTaskStateStorage->ChangeSubTaskState( subTaskId, SGProcessing::SubTaskState::PROCESSED );
         // tell local queue manager we completed this task as well.
         m_subTaskQueueManager->ChangeSubTaskProcessingStates( { subTaskId }, true );
 
         if ( m_resultChannel )
         {
-            m_resultChannel->Publish( subTaskResult.SerializeAsString() );
+            base::TraceSpan span( "publish_result", m_taskId, subTaskId );
+            if ( auto spanId = span.FlowOut(); spanId != 0 )
+            {
+                // receivers link their spans to this one
+                auto tracedResult = subTaskResult;
+                tracedResult.set_trace_span_id( spanId );
+                m_resultChannel->Publish( tracedResult.SerializeAsString() );
+            }
+            else
+            {
+                m_resultChannel->Publish( subTaskResult.SerializeAsString() );
+            }
 
             m_logger->debug( "Published SubTask results to Results Channel" );
         }
@@ -297,6 +315,8 @@ namespace sgns::processing
             {
                 _this->m_logger->debug( "[RESULT_RECEIVED]. ({}).", result.subtaskid() );
 
+                base::TraceSpan span( "receive_result", _this->m_taskId, result.subtaskid() );
+                span.FlowIn( result.trace_span_id() );
                 rebroadcast_results = _this->OnResultReceived( std::move( result ) );
 
                 if ( rebroadcast_results )
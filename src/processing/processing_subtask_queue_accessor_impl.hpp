@@ -77,6 +77,7 @@ namespace sgns::processing
         std::function<void( const std::string & )>              m_processingErrorSink;
 
         std::shared_ptr<sgns::ipfs_pubsub::GossipPubSubTopic> m_resultChannel;
+        std::string                                           m_taskId;
 
         mutable std::mutex                                 m_mutexResults;
         std::map<std::string, SGProcessing::SubTaskResult> m_results;
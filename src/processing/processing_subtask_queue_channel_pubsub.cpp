@@ -1,14 +1,75 @@
 #include "processing_subtask_queue_channel_pubsub.hpp"
 #include <thread>
+#include <random>
+#include <unordered_set>
 #include <base/util.hpp>
 
 
 namespace sgns::processing
 {
+    namespace
+    {
+        uint64_t GenerateSenderId()
+        {
+            std::random_device                      rd;
+            std::mt19937_64                         generator( ( static_cast<uint64_t>( rd() ) << 32 ) | rd() );
+            std::uniform_int_distribution<uint64_t> distribution( 1 );
+            return distribution( generator );
+        }
+
+        bool SameSubTasks( const SGProcessing::SubTaskCollection &lhs, const SGProcessing::SubTaskCollection &rhs )
+        {
+            // Subtasks are never modified once the queue is created, so the ids identify them
+            if ( lhs.items_size() != rhs.items_size() )
+            {
+                return false;
+            }
+            for ( int i = 0; i < lhs.items_size(); ++i )
+            {
+                if ( lhs.items( i ).subtaskid() != rhs.items( i ).subtaskid() )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool SameItem( const SGProcessing::ProcessingQueueItem &lhs, const SGProcessing::ProcessingQueueItem &rhs )
+        {
+            return lhs.lock_timestamp() == rhs.lock_timestamp() && lhs.lock_node_id() == rhs.lock_node_id() &&
+                   lhs.lock_expiration_timestamp() == rhs.lock_expiration_timestamp();
+        }
+
+        bool ApplyDelta( SGProcessing::SubTaskQueue &queue, const SGProcessing::SubTaskQueueDelta &delta )
+        {
+            auto processingQueue = queue.mutable_processing_queue();
+            for ( const auto &update : delta.items() )
+            {
+                if ( update.index() >= static_cast<uint32_t>( processingQueue->items_size() ) )
+                {
+                    return false;
+                }
+            }
+            for ( const auto &update : delta.items() )
+            {
+                *processingQueue->mutable_items( static_cast<int>( update.index() ) ) = update.item();
+            }
+            processingQueue->set_last_update_timestamp( delta.last_update_timestamp() );
+            processingQueue->set_processing_timeout_length( delta.processing_timeout_length() );
+            processingQueue->set_owner_node_id( delta.owner_node_id() );
+            *processingQueue->mutable_ownership_requests() = delta.ownership_requests();
+            for ( const auto &subTaskId : delta.added_processed_subtask_ids() )
+            {
+                processingQueue->add_processed_subtask_ids( subTaskId );
+            }
+            return true;
+        }
+    }
+
     ProcessingSubTaskQueueChannelPubSub::ProcessingSubTaskQueueChannelPubSub(
         std::shared_ptr<sgns::ipfs_pubsub::GossipPubSub> gossipPubSub,
         const std::string                               &processingQueueChannelId ) :
-        m_gossipPubSub( std::move( gossipPubSub ) )
+        m_gossipPubSub( std::move( gossipPubSub ) ), m_senderId( GenerateSenderId() )
     {
         using GossipPubSubTopic  = sgns::ipfs_pubsub::GossipPubSubTopic;
         m_processingQueueChannel = std::make_shared<GossipPubSubTopic>( m_gossipPubSub, processingQueueChannelId );
@@ -70,10 +131,114 @@ namespace sgns::processing
 
     void ProcessingSubTaskQueueChannelPubSub::PublishQueue( std::shared_ptr<SGProcessing::SubTaskQueue> queue )
     {
+        if ( !queue )
+        {
+            return;
+        }
+
+        std::string payload;
+        {
+            std::lock_guard guard( m_publishMutex );
+
+            SGProcessing::ProcessingChannelMessage message;
+            auto                                   update = message.mutable_subtask_queue_update();
+            update->set_sender_id( m_senderId );
+
+            const auto &processingQueue = queue->processing_queue();
+            // Late joiners that missed the snapshot request catch up on the periodic snapshots
+            if ( m_version % SNAPSHOT_INTERVAL != 0 && CanEncodeDelta( *queue ) )
+            {
+                auto delta = update->mutable_delta();
+                delta->set_base_version( m_version );
+                for ( int i = 0; i < processingQueue.items_size(); ++i )
+                {
+                    if ( !SameItem( processingQueue.items( i ), m_lastProcessingQueue.items( i ) ) )
+                    {
+                        auto itemUpdate = delta->add_items();
+                        itemUpdate->set_index( static_cast<uint32_t>( i ) );
+                        *itemUpdate->mutable_item() = processingQueue.items( i );
+                    }
+                }
+                delta->set_last_update_timestamp( processingQueue.last_update_timestamp() );
+                delta->set_processing_timeout_length( processingQueue.processing_timeout_length() );
+                delta->set_owner_node_id( processingQueue.owner_node_id() );
+                *delta->mutable_ownership_requests() = processingQueue.ownership_requests();
+
+                std::unordered_set<std::string> publishedIds( m_lastProcessingQueue.processed_subtask_ids().begin(),
+                                                              m_lastProcessingQueue.processed_subtask_ids().end() );
+                for ( const auto &subTaskId : processingQueue.processed_subtask_ids() )
+                {
+                    if ( publishedIds.find( subTaskId ) == publishedIds.end() )
+                    {
+                        delta->add_added_processed_subtask_ids( subTaskId );
+                    }
+                }
+
+                update->set_version( ++m_version );
+                payload = message.SerializeAsString();
+                ++m_publishStats.deltas;
+                m_publishStats.deltaBytes += payload.size();
+            }
+            else
+            {
+                if ( !m_lastSubTasks || !SameSubTasks( *m_lastSubTasks, queue->subtasks() ) )
+                {
+                    m_lastSubTasks = std::make_shared<const SGProcessing::SubTaskCollection>( queue->subtasks() );
+                }
+
+                update->set_version( ++m_version );
+                update->set_allocated_snapshot( queue.get() );
+                payload = message.SerializeAsString();
+                update->release_snapshot();
+                ++m_publishStats.snapshots;
+                m_publishStats.snapshotBytes += payload.size();
+            }
+            m_lastProcessingQueue.CopyFrom( processingQueue );
+        }
+        m_processingQueueChannel->Publish( payload );
+    }
+
+    bool ProcessingSubTaskQueueChannelPubSub::CanEncodeDelta( const SGProcessing::SubTaskQueue &queue ) const
+    {
+        if ( !m_lastSubTasks || !SameSubTasks( *m_lastSubTasks, queue.subtasks() ) )
+        {
+            return false;
+        }
+
+        const auto &processingQueue = queue.processing_queue();
+        if ( processingQueue.items_size() != m_lastProcessingQueue.items_size() )
+        {
+            return false;
+        }
+
+        // Deltas can only add processed subtasks
+        std::unordered_set<std::string> processedIds( processingQueue.processed_subtask_ids().begin(),
+                                                      processingQueue.processed_subtask_ids().end() );
+        for ( const auto &subTaskId : m_lastProcessingQueue.processed_subtask_ids() )
+        {
+            if ( processedIds.find( subTaskId ) == processedIds.end() )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string ProcessingSubTaskQueueChannelPubSub::SerializeLastSnapshot() const
+    {
+        if ( m_version == 0 || !m_lastSubTasks )
+        {
+            return {};
+        }
+
         SGProcessing::ProcessingChannelMessage message;
-        message.set_allocated_subtask_queue( queue.get() );
-        m_processingQueueChannel->Publish( message.SerializeAsString() );
-        message.release_subtask_queue();
+        auto                                   update = message.mutable_subtask_queue_update();
+        update->set_sender_id( m_senderId );
+        update->set_version( m_version );
+        auto snapshot                        = update->mutable_snapshot();
+        *snapshot->mutable_processing_queue() = m_lastProcessingQueue;
+        *snapshot->mutable_subtasks()         = *m_lastSubTasks;
+        return message.SerializeAsString();
     }
 
     void ProcessingSubTaskQueueChannelPubSub::SetQueueRequestSink( QueueRequestSink queueRequestSink )
@@ -98,6 +263,14 @@ namespace sgns::processing
                 {
                     HandleSubTaskQueueRequest( channelMesssage );
                 }
+                else if ( channelMesssage.has_subtask_queue_update() )
+                {
+                    HandleSubTaskQueueUpdate( channelMesssage );
+                }
+                else if ( channelMesssage.has_subtask_queue_snapshot_request() )
+                {
+                    HandleSubTaskQueueSnapshotRequest( channelMesssage );
+                }
                 else if ( channelMesssage.has_subtask_queue() )
                 {
                     HandleSubTaskQueue( channelMesssage );
@@ -133,6 +306,97 @@ namespace sgns::processing
         }
     }
 
+    void ProcessingSubTaskQueueChannelPubSub::HandleSubTaskQueueUpdate(
+        SGProcessing::ProcessingChannelMessage &channelMesssage )
+    {
+        auto                                        update = channelMesssage.mutable_subtask_queue_update();
+        std::unique_ptr<SGProcessing::SubTaskQueue> queue;
+        bool                                        requestSnapshot = false;
+        {
+            std::lock_guard guard( m_sendersMutex );
+            auto           &sender = m_senders[update->sender_id()];
+            if ( sender.queue && update->version() <= sender.version )
+            {
+                // Duplicate or reordered update
+                return;
+            }
+
+            if ( update->has_snapshot() )
+            {
+                sender.queue.reset( update->release_snapshot() );
+                sender.version           = update->version();
+                sender.snapshotRequested = false;
+            }
+            else if ( update->has_delta() )
+            {
+                if ( !sender.queue || update->delta().base_version() != sender.version ||
+                     !ApplyDelta( *sender.queue, update->delta() ) )
+                {
+                    m_logger->debug( "Queue update gap from sender {}: have version {}, got {} based on {}",
+                                     update->sender_id(),
+                                     sender.version,
+                                     update->version(),
+                                     update->delta().base_version() );
+                    // A failed delta may have been partially applied, so the state is only reliable again
+                    // after the next snapshot
+                    sender.queue.reset();
+                    requestSnapshot          = !sender.snapshotRequested;
+                    sender.snapshotRequested = true;
+                }
+                else
+                {
+                    sender.version = update->version();
+                }
+            }
+
+            if ( sender.queue && m_queueUpdateSink )
+            {
+                queue = std::make_unique<SGProcessing::SubTaskQueue>( *sender.queue );
+            }
+        }
+
+        if ( requestSnapshot )
+        {
+            SGProcessing::ProcessingChannelMessage message;
+            message.mutable_subtask_queue_snapshot_request()->set_sender_id( update->sender_id() );
+            m_processingQueueChannel->Publish( message.SerializeAsString() );
+        }
+
+        if ( queue )
+        {
+            auto queueChanged = m_queueUpdateSink( queue.release() );
+            m_logger->debug( "Queue changed = {} on update version {}", queueChanged, update->version() );
+        }
+    }
+
+    void ProcessingSubTaskQueueChannelPubSub::HandleSubTaskQueueSnapshotRequest(
+        SGProcessing::ProcessingChannelMessage &channelMesssage )
+    {
+        if ( channelMesssage.subtask_queue_snapshot_request().sender_id() != m_senderId )
+        {
+            return;
+        }
+
+        std::string payload;
+        {
+            std::lock_guard guard( m_publishMutex );
+            payload = SerializeLastSnapshot();
+            if ( payload.empty() )
+            {
+                return;
+            }
+            ++m_publishStats.snapshots;
+            m_publishStats.snapshotBytes += payload.size();
+        }
+        m_processingQueueChannel->Publish( payload );
+    }
+
+    ProcessingSubTaskQueueChannelPubSub::PublishStats ProcessingSubTaskQueueChannelPubSub::GetPublishStats() const
+    {
+        std::lock_guard guard( m_publishMutex );
+        return m_publishStats;
+    }
+
     size_t ProcessingSubTaskQueueChannelPubSub::GetActiveNodesCount() const
     {
         // include ourselves
@@ -7,6 +7,8 @@
 #define SUPERGENIUS_PROCESSING_SUBTASK_QUEUE_CHANNEL_PUBSUB_HPP
 
 #include <future>
+#include <map>
+#include <mutex>
 #include "outcome/outcome.hpp"
 
 #include "processing/processing_subtask_queue_channel.hpp"
@@ -27,6 +29,19 @@ namespace sgns::processing
         using QueueRequestSink = std::function<bool( const SGProcessing::SubTaskQueueRequest & )>;
         using QueueUpdateSink  = std::function<bool( SGProcessing::SubTaskQueue * )>;
 
+        /** Counters of the queue publications sent by this channel
+        */
+        struct PublishStats
+        {
+            uint64_t snapshots     = 0; ///< Full queue snapshots published
+            uint64_t deltas        = 0; ///< Delta updates published
+            uint64_t snapshotBytes = 0; ///< Serialized size of the published snapshots
+            uint64_t deltaBytes    = 0; ///< Serialized size of the published deltas
+        };
+
+        /// Number of publications after which a full snapshot is sent even if a delta would do
+        static constexpr uint64_t SNAPSHOT_INTERVAL = 32;
+
         /** Constructs subtask queue channel object
     * @param gossipPubSub - ipfs pubsub
     * @param processingQueueChannelId - a unique id of queue data channel
@@ -69,6 +84,10 @@ namespace sgns::processing
          */
         std::vector<libp2p::peer::PeerId> GetActiveNodes() const override;
 
+        /** Returns the publication counters of this channel
+        * @return copy of the counters
+        */
+        PublishStats GetPublishStats() const;
 
     private:
         std::shared_ptr<sgns::ipfs_pubsub::GossipPubSubTopic> m_processingQueueChannel;
@@ -77,6 +96,27 @@ namespace sgns::processing
 
         void HandleSubTaskQueueRequest( SGProcessing::ProcessingChannelMessage &channelMesssage );
         void HandleSubTaskQueue( SGProcessing::ProcessingChannelMessage &channelMesssage );
+        void HandleSubTaskQueueUpdate( SGProcessing::ProcessingChannelMessage &channelMesssage );
+        void HandleSubTaskQueueSnapshotRequest( SGProcessing::ProcessingChannelMessage &channelMesssage );
+
+        /** Checks if a queue can be encoded as a delta of the last published one
+        * @param queue - queue to publish
+        * @return false if the subtasks, the number of items or the processed ids were changed otherwise
+        */
+        bool CanEncodeDelta( const SGProcessing::SubTaskQueue &queue ) const;
+        /** Builds the snapshot message of the last published queue
+        * @return serialized channel message
+        */
+        std::string SerializeLastSnapshot() const;
+
+        /** Queue state last received from a sender
+        */
+        struct SenderState
+        {
+            uint64_t                                    version = 0;
+            std::unique_ptr<SGProcessing::SubTaskQueue> queue;
+            bool                                        snapshotRequested = false;
+        };
 
         std::shared_ptr<sgns::ipfs_pubsub::GossipPubSub> m_gossipPubSub;
         std::shared_ptr<boost::asio::io_context>         m_context;
@@ -84,6 +124,16 @@ namespace sgns::processing
         std::function<bool( const SGProcessing::SubTaskQueueRequest & )> m_queueRequestSink;
         std::function<bool( SGProcessing::SubTaskQueue * )>              m_queueUpdateSink;
 
+        const uint64_t                                         m_senderId;
+        mutable std::mutex                                     m_publishMutex;
+        uint64_t                                               m_version = 0;
+        SGProcessing::ProcessingQueue                          m_lastProcessingQueue; ///< Last published processing state
+        std::shared_ptr<const SGProcessing::SubTaskCollection> m_lastSubTasks;        ///< Last published subtasks
+        PublishStats                                           m_publishStats;
+
+        std::mutex                      m_sendersMutex;
+        std::map<uint64_t, SenderState> m_senders;
+
         base::Logger m_logger = base::createLogger( "ProcessingSubTaskQueueChannelPubSub" );
 
 
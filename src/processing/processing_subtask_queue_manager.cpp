@@ -1,5 +1,7 @@
 #include "processing_subtask_queue_manager.hpp"
 
+#include "base/tracing.hpp"
+
 #include <utility>
 #include <thread>
 
@@ -172,6 +174,11 @@ namespace sgns::processing
     {
         m_dltGrabSubTaskTimeout.expires_at( boost::posix_time::pos_infin );
 
+        if ( auto waitStartUs = m_ownershipWaitStartUs.exchange( 0 ); waitStartUs != 0 )
+        {
+            RecordOwnershipWait( waitStartUs );
+        }
+
         m_logger->trace("QUEUE_PROCESS_PENDING: for node {} at {}ms.", m_localNodeId, m_queue_timestamp_);
 
         // Update queue timestamp based on current ownership duration
@@ -331,10 +338,34 @@ namespace sgns::processing
         {
             // Since we're not the owner, we must use the pubsub channel
             // to request ownership from the current owner
+            if ( base::Tracer::Instance().IsEnabled() )
+            {
+                int64_t notWaiting = 0;
+                m_ownershipWaitStartUs.compare_exchange_strong( notWaiting, base::Tracer::Now() );
+            }
             m_queueChannel->RequestQueueOwnership( m_localNodeId );
         }
     }
 
+    void ProcessingSubTaskQueueManager::RecordOwnershipWait( int64_t waitStartUs ) const
+    {
+        base::TraceEvent event;
+        event.name        = "ownership_wait";
+        event.start_us    = waitStartUs;
+        event.duration_us = base::Tracer::Now() - waitStartUs;
+        event.thread_id   = base::Tracer::ThreadId();
+        event.span_id     = base::Tracer::Instance().NewSpanId();
+        {
+            std::lock_guard guard( m_queueMutex );
+            // the subtasks of a queue all belong to the same task
+            if ( m_queue && m_queue->subtasks().items_size() > 0 )
+            {
+                event.task_id = m_queue->subtasks().items( 0 ).ipfsblock();
+            }
+        }
+        base::Tracer::Instance().Record( std::move( event ) );
+    }
+
     bool ProcessingSubTaskQueueManager::MoveOwnershipTo( const std::string &nodeId )
     {
         std::lock_guard guard( m_queueMutex );
@@ -13,6 +13,7 @@
 
 #include <boost/asio.hpp>
 #include <boost/optional.hpp>
+#include <atomic>
 #include <list>
 #include <queue>
 
@@ -166,6 +167,12 @@ namespace sgns::processing
         bool UpdateUnprocessedSubTaskIndices(const SGProcessing::SubTaskQueue* queue,
                                               std::vector<int>& unprocessedSubTaskIndices) const;
 
+        /**
+         * Records the time spent waiting for the queue ownership as a trace span
+         * @param waitStartUs - when the ownership was requested, in microseconds since the epoch
+         */
+        void RecordOwnershipWait( int64_t waitStartUs ) const;
+
         std::shared_ptr<ProcessingSubTaskQueueChannel> m_queueChannel;
         std::shared_ptr<boost::asio::io_context>       m_context;
         std::string                                    m_localNodeId;
@@ -208,6 +215,7 @@ namespace sgns::processing
         std::chrono::steady_clock::time_point m_lastActiveCountCheck = std::chrono::steady_clock::now();
         uint64_t m_waitTimeBeforeReset = 3000; // Initial wait time of 3000ms
         bool m_initialDelayPassed = false;    // Track if initial delay has passed
+        std::atomic<int64_t> m_ownershipWaitStartUs{ 0 }; // When ownership was requested while tracing, 0 if not waiting
     };
 }
 
@@ -19,8 +19,9 @@ namespace sgns::processing
 
         /** Adds a result to the storage
         * @param subTaskResult - processing result
+        * @return true once the result is stored, false if it could not be written
         */
-        virtual void AddSubTaskResult( const SGProcessing::SubTaskResult &subTaskResult ) = 0;
+        virtual bool AddSubTaskResult( const SGProcessing::SubTaskResult &subTaskResult ) = 0;
 
         /** Removes result from the storage
         * @param subTaskId subtask id that the result was generated for
@@ -0,0 +1,138 @@
+/**
+ * @file       ProofGenerator.cpp
+ * @brief      Worker pool that generates proofs off the caller's thread
+ * @date       2026-10-18
+ */
+#include "ProofGenerator.hpp"
+#include <algorithm>
+#include <system_error>
+
+namespace sgns
+{
+    ProofGenerator::ProofGenerator( std::size_t worker_count, std::size_t max_queued ) :
+        max_queued_( std::max<std::size_t>( max_queued, 1 ) )
+    {
+        if ( worker_count == 0 )
+        {
+            worker_count = std::max<std::size_t>( std::thread::hardware_concurrency() / 2, 1 );
+        }
+        workers_.reserve( worker_count );
+        for ( std::size_t i = 0; i < worker_count; ++i )
+        {
+            workers_.emplace_back( [this]() { WorkerLoop(); } );
+        }
+    }
+
+    ProofGenerator::~ProofGenerator()
+    {
+        Stop();
+    }
+
+    ProofGenerator::ProofFuture ProofGenerator::Submit( std::unique_ptr<IBasicProof> proof, CompletionCallback on_done )
+    {
+        std::unique_lock lock( mutex_ );
+        space_cv_.wait( lock, [this]() { return stopped_ || jobs_.size() < max_queued_; } );
+        return Push( std::move( proof ), std::move( on_done ), lock );
+    }
+
+    outcome::result<ProofGenerator::ProofFuture> ProofGenerator::TrySubmit( std::unique_ptr<IBasicProof> proof,
+                                                                            CompletionCallback           on_done )
+    {
+        std::unique_lock lock( mutex_ );
+        if ( !stopped_ && jobs_.size() >= max_queued_ )
+        {
+            return std::errc::resource_unavailable_try_again;
+        }
+        return Push( std::move( proof ), std::move( on_done ), lock );
+    }
+
+    ProofGenerator::ProofFuture ProofGenerator::Push( std::unique_ptr<IBasicProof> proof,
+                                                      CompletionCallback           on_done,
+                                                      std::unique_lock<std::mutex> &lock )
+    {
+        Job job{ std::move( proof ), std::promise<ProofResult>(), std::move( on_done ) };
+        auto future = job.promise.get_future().share();
+
+        if ( stopped_ || !job.proof )
+        {
+            lock.unlock();
+            job.promise.set_value( outcome::failure( boost::system::error_code{} ) );
+            if ( job.on_done )
+            {
+                job.on_done();
+            }
+            return future;
+        }
+        jobs_.push_back( std::move( job ) );
+        lock.unlock();
+        job_cv_.notify_one();
+        return future;
+    }
+
+    void ProofGenerator::Stop()
+    {
+        std::deque<Job> abandoned;
+        {
+            std::lock_guard lock( mutex_ );
+            if ( stopped_ )
+            {
+                return;
+            }
+            stopped_ = true;
+            abandoned.swap( jobs_ );
+        }
+        job_cv_.notify_all();
+        space_cv_.notify_all();
+
+        for ( auto &job : abandoned )
+        {
+            job.promise.set_value( outcome::failure( boost::system::error_code{} ) );
+            if ( job.on_done )
+            {
+                job.on_done();
+            }
+        }
+        for ( auto &worker : workers_ )
+        {
+            if ( worker.joinable() )
+            {
+                worker.join();
+            }
+        }
+    }
+
+    std::size_t ProofGenerator::GetPendingCount() const
+    {
+        std::lock_guard lock( mutex_ );
+        return jobs_.size() + running_;
+    }
+
+    void ProofGenerator::WorkerLoop()
+    {
+        while ( true )
+        {
+            Job job;
+            {
+                std::unique_lock lock( mutex_ );
+                job_cv_.wait( lock, [this]() { return stopped_ || !jobs_.empty(); } );
+                if ( jobs_.empty() )
+                {
+                    return;
+                }
+                job = std::move( jobs_.front() );
+                jobs_.pop_front();
+                ++running_;
+            }
+            space_cv_.notify_one();
+
+            job.promise.set_value( job.proof->GenerateFullProof() );
+            if ( job.on_done )
+            {
+                job.on_done();
+            }
+
+            std::lock_guard lock( mutex_ );
+            --running_;
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * @file       ProofGenerator.hpp
+ * @brief      Worker pool that generates proofs off the caller's thread
+ * @date       2026-10-18
+ */
+
+#ifndef _PROOF_GENERATOR_HPP_
+#define _PROOF_GENERATOR_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "IBasicProof.hpp"
+#include "outcome/outcome.hpp"
+
+namespace sgns
+{
+    /**
+     * @class ProofGenerator
+     * @brief Bounded pool of workers running @ref IBasicProof::GenerateFullProof
+     *
+     * Proofs are submitted and handed back as futures, so independent proofs are
+     * generated in parallel and the caller only waits when it needs the result.
+     */
+    class ProofGenerator
+    {
+    public:
+        using ProofResult        = outcome::result<std::vector<uint8_t>>;
+        using ProofFuture        = std::shared_future<ProofResult>;
+        using CompletionCallback = std::function<void()>;
+
+        static constexpr std::size_t DEFAULT_MAX_QUEUED = 64; ///< Default number of proofs waiting for a worker
+
+        /**
+         * @brief       Starts the worker threads
+         * @param[in]   worker_count Number of workers, 0 picks half of the hardware threads
+         * @param[in]   max_queued Number of proofs that may wait for a worker before @ref Submit blocks and @ref TrySubmit fails
+         */
+        explicit ProofGenerator( std::size_t worker_count = 0, std::size_t max_queued = DEFAULT_MAX_QUEUED );
+
+        /**
+         * @brief       Stops the workers, see @ref Stop
+         */
+        ~ProofGenerator();
+
+        ProofGenerator( const ProofGenerator & )            = delete;
+        ProofGenerator &operator=( const ProofGenerator & ) = delete;
+
+        /**
+         * @brief       Queues a proof for generation, blocking while the queue is full
+         * @param[in]   proof The proof to generate, owned by the generator until it's done
+         * @param[in]   on_done Optional callback invoked from the worker once the future is ready
+         * @return      Future holding the serialized proof or the generation error
+         */
+        ProofFuture Submit( std::unique_ptr<IBasicProof> proof, CompletionCallback on_done = nullptr );
+
+        /**
+         * @brief       Queues a proof for generation without blocking
+         * @param[in]   proof The proof to generate, owned by the generator until it's done
+         * @param[in]   on_done Optional callback invoked from the worker once the future is ready
+         * @return      Future holding the serialized proof or the generation error,
+         *              or resource_unavailable_try_again if the queue is full
+         */
+        outcome::result<ProofFuture> TrySubmit( std::unique_ptr<IBasicProof> proof,
+                                                CompletionCallback           on_done = nullptr );
+
+        /**
+         * @brief       Stops accepting proofs, fails the queued ones and joins the workers
+         */
+        void Stop();
+
+        /**
+         * @brief       Number of proofs queued or being generated
+         */
+        std::size_t GetPendingCount() const;
+
+    private:
+        struct Job
+        {
+            std::unique_ptr<IBasicProof> proof;
+            std::promise<ProofResult>    promise;
+            CompletionCallback           on_done;
+        };
+
+        /**
+         * @brief       Queues a job, called with the lock held and room in the queue or the generator stopped
+         */
+        ProofFuture Push( std::unique_ptr<IBasicProof> proof,
+                          CompletionCallback           on_done,
+                          std::unique_lock<std::mutex> &lock );
+        void        WorkerLoop();
+
+        const std::size_t        max_queued_;
+        mutable std::mutex       mutex_;
+        std::condition_variable  job_cv_;   ///< Signals workers that a job or stop is available
+        std::condition_variable  space_cv_; ///< Signals submitters that the queue has room
+        std::deque<Job>          jobs_;
+        std::size_t              running_ = 0;
+        bool                     stopped_ = false;
+        std::vector<std::thread> workers_;
+    };
+}
+
+#endif
@@ -21,6 +21,14 @@ namespace sgns::runtime::binaryen {
      */
     virtual wasm::Literal callExport(
         wasm::Name name, const std::vector<wasm::Literal> &arguments) = 0;
+
+    /**
+     * Keeps the current globals and memory size, so restoreState() can bring
+     * the instance back to them before it is reused for another call
+     */
+    virtual void saveState() = 0;
+
+    virtual void restoreState() = 0;
   };
 }  // namespace sgns::runtime::binaryen
 
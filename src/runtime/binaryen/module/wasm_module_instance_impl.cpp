@@ -17,4 +17,17 @@ namespace sgns::runtime::binaryen {
       wasm::Name name, const wasm::LiteralList &arguments) {
     return module_instance_->callExport(name, arguments);
   }
+
+  void WasmModuleInstanceImpl::saveState() {
+    saved_state_ = std::make_unique<State>(
+        State{module_instance_->globals, module_instance_->memorySize});
+  }
+
+  void WasmModuleInstanceImpl::restoreState() {
+    if (!saved_state_) {
+      return;
+    }
+    module_instance_->globals = saved_state_->globals;
+    module_instance_->memorySize = saved_state_->memory_size;
+  }
 }  // namespace sgns::runtime::binaryen
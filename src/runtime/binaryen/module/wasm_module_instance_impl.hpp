@@ -22,8 +22,18 @@ namespace sgns::runtime::binaryen {
     wasm::Literal callExport(
         wasm::Name name, const std::vector<wasm::Literal> &arguments) override;
 
+    void saveState() override;
+
+    void restoreState() override;
+
    private:
     std::unique_ptr<wasm::ModuleInstance> module_instance_;
+
+    struct State {
+      decltype(wasm::ModuleInstance::globals) globals;
+      decltype(wasm::ModuleInstance::memorySize) memory_size;
+    };
+    std::unique_ptr<State> saved_state_;
   };
 
 }  // namespace sgns::runtime::binaryen
@@ -52,12 +52,12 @@ namespace sgns::runtime::binaryen {
           case CallPersistency::PERSISTENT:
             return runtime_manager_
                 ->createPersistentRuntimeEnvironmentAt(
-                    wasm_provider_->getStateCode(), state_root_opt.value())
+                    *wasm_provider_, state_root_opt.value())
                 .value();
           case CallPersistency::EPHEMERAL:
             return runtime_manager_
                 ->createEphemeralRuntimeEnvironmentAt(
-                    wasm_provider_->getStateCode(), state_root_opt.value())
+                    *wasm_provider_, state_root_opt.value())
                 .value();
         }
       } else {
@@ -65,12 +65,12 @@ namespace sgns::runtime::binaryen {
           case CallPersistency::PERSISTENT:
             return runtime_manager_
                 ->createPersistentRuntimeEnvironment(
-                    wasm_provider_->getStateCode())
+                    *wasm_provider_)
                 .value();
           case CallPersistency::EPHEMERAL:
             return runtime_manager_
                 ->createEphemeralRuntimeEnvironment(
-                    wasm_provider_->getStateCode())
+                    *wasm_provider_)
                 .value();
         }
       }
@@ -135,7 +135,7 @@ namespace sgns::runtime::binaryen {
       }
 
       auto environment = createRuntimeEnvironment(persistency, state_root);
-      auto &&[module, memory, opt_batch] = environment;
+      auto &&[instance, module, memory, opt_batch] = environment;
 
       runtime::WasmPointer ptr = 0u;
       runtime::WasmSize len = 0u;
@@ -13,7 +13,7 @@ namespace sgns::runtime::binaryen {
       const base::Buffer &state_code) {
 
     return RuntimeEnvironment{
-        module->instantiate(rei), rei->memory(), boost::none};
+        nullptr, module->instantiate(rei), rei->memory(), boost::none};
   }
 
 }  // namespace sgns::runtime::binaryen
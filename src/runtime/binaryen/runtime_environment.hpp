@@ -23,12 +23,14 @@ namespace sgns::runtime {
 
 namespace sgns::runtime::binaryen {
   class RuntimeExternalInterface;
+  struct RuntimeInstance;
   class WasmModuleInstance;
   class WasmModule;
 
   /**
    * Runtime environment is a structure that contains data necessary to operate
-   * with Runtime: memory, WASM module, storage batch
+   * with Runtime: memory, WASM module, storage batch, and the pooled instance
+   * they belong to
    */
   class RuntimeEnvironment {
    public:
@@ -45,6 +47,8 @@ namespace sgns::runtime::binaryen {
 
     ~RuntimeEnvironment() = default;
 
+    // declared first so the instance goes back to the pool last
+    std::shared_ptr<RuntimeInstance> instance;  // null unless pooled
     std::shared_ptr<WasmModuleInstance> module_instance;
     std::shared_ptr<WasmMemory> memory;
     boost::optional<std::shared_ptr<storage::trie::TopperTrieBatch>>
@@ -84,10 +84,36 @@ namespace sgns::runtime::binaryen {
                      "extension factory is nullptr");
     BOOST_ASSERT_MSG(storage_provider != nullptr,
                      "storage provider is nullptr");
-    auto memory_impl =
+    memory_impl_ =
         std::make_shared<WasmMemoryImpl>(&(ShellExternalInterface::memory));
     extension_ = extension_factory->createExtension(
-        memory_impl, std::move(storage_provider));
+        memory_impl_, std::move(storage_provider));
+  }
+
+  void RuntimeExternalInterface::store8(wasm::Address addr, int8_t value) {
+    memory_impl_->markDirty(addr, sizeof(value));
+    ShellExternalInterface::store8(addr, value);
+  }
+
+  void RuntimeExternalInterface::store16(wasm::Address addr, int16_t value) {
+    memory_impl_->markDirty(addr, sizeof(value));
+    ShellExternalInterface::store16(addr, value);
+  }
+
+  void RuntimeExternalInterface::store32(wasm::Address addr, int32_t value) {
+    memory_impl_->markDirty(addr, sizeof(value));
+    ShellExternalInterface::store32(addr, value);
+  }
+
+  void RuntimeExternalInterface::store64(wasm::Address addr, int64_t value) {
+    memory_impl_->markDirty(addr, sizeof(value));
+    ShellExternalInterface::store64(addr, value);
+  }
+
+  void RuntimeExternalInterface::store128(
+      wasm::Address addr, const std::array<uint8_t, 16> &value) {
+    memory_impl_->markDirty(addr, value.size());
+    ShellExternalInterface::store128(addr, value);
   }
 
   wasm::Literal RuntimeExternalInterface::callImport(
@@ -11,6 +11,8 @@
 
 namespace sgns::runtime::binaryen {
 
+  class WasmMemoryImpl;
+
   class RuntimeExternalInterface : public wasm::ShellExternalInterface {
    public:
     explicit RuntimeExternalInterface(
@@ -20,10 +22,22 @@ namespace sgns::runtime::binaryen {
     wasm::Literal callImport(wasm::Function *import,
                              wasm::LiteralList &arguments) override;
 
+    // stores of the module, reported to the memory so it can be restored
+    void store8(wasm::Address addr, int8_t value) override;
+    void store16(wasm::Address addr, int16_t value) override;
+    void store32(wasm::Address addr, int32_t value) override;
+    void store64(wasm::Address addr, int64_t value) override;
+    void store128(wasm::Address addr,
+                  const std::array<uint8_t, 16> &value) override;
+
     inline std::shared_ptr<WasmMemory> memory() const {
       return extension_->memory();
     }
 
+    inline const std::shared_ptr<WasmMemoryImpl> &memoryImpl() const {
+      return memory_impl_;
+    }
+
    private:
     /**
      * Checks that the number of arguments is as expected and terminates the
@@ -33,6 +47,7 @@ namespace sgns::runtime::binaryen {
                         size_t expected,
                         size_t actual);
 
+    std::shared_ptr<WasmMemoryImpl> memory_impl_;
     std::unique_ptr<extensions::Extension> extension_;
     base::Logger logger_ = base::createLogger(kDefaultLoggerTag);
 
@@ -1,9 +1,12 @@
 #include "runtime/binaryen/runtime_manager.hpp"
 
+#include <thread>
+
 #include <gsl/gsl>
 
 #include "crypto/hasher/hasher_impl.hpp"
 #include "runtime/binaryen/runtime_external_interface.hpp"
+#include "runtime/binaryen/wasm_memory_impl.hpp"
 
 OUTCOME_CPP_DEFINE_CATEGORY_3(sgns::runtime::binaryen,
                             RuntimeManager::Error,
@@ -38,9 +41,10 @@ namespace sgns::runtime::binaryen {
 
   outcome::result<RuntimeEnvironment>
   RuntimeManager::createPersistentRuntimeEnvironmentAt(
-      const base::Buffer &state_code, const base::Hash256 &state_root) {
+      const WasmProvider &wasm_provider, const base::Hash256 &state_root) {
     BOOST_OUTCOME_TRYV2(auto &&, storage_provider_->setToPersistentAt(state_root));
-    auto env = createRuntimeEnvironment(state_code);
+    auto env =
+        createRuntimeEnvironment(wasm_provider, sharedExternalInterface());
     if (env.has_value()) {
       env.value().batch =
           storage_provider_->tryGetPersistentBatch().value()->batchOnTop();
@@ -50,16 +54,16 @@ namespace sgns::runtime::binaryen {
 
   outcome::result<RuntimeEnvironment>
   RuntimeManager::createEphemeralRuntimeEnvironmentAt(
-      const base::Buffer &state_code, const base::Hash256 &state_root) {
-    BOOST_OUTCOME_TRYV2(auto &&, storage_provider_->setToEphemeralAt(state_root));
-    return createRuntimeEnvironment(state_code);
+      const WasmProvider &wasm_provider, const base::Hash256 &state_root) {
+    return createPooledRuntimeEnvironment(wasm_provider, state_root);
   }
 
   outcome::result<RuntimeEnvironment>
   RuntimeManager::createPersistentRuntimeEnvironment(
-      const base::Buffer &state_code) {
+      const WasmProvider &wasm_provider) {
     BOOST_OUTCOME_TRYV2(auto &&, storage_provider_->setToPersistent());
-    auto env = createRuntimeEnvironment(state_code);
+    auto env =
+        createRuntimeEnvironment(wasm_provider, sharedExternalInterface());
     if (env.has_value()) {
       env.value().batch =
           storage_provider_->tryGetPersistentBatch().value()->batchOnTop();
@@ -69,49 +73,228 @@ namespace sgns::runtime::binaryen {
 
   outcome::result<RuntimeEnvironment>
   RuntimeManager::createEphemeralRuntimeEnvironment(
-      const base::Buffer &state_code) {
-    BOOST_OUTCOME_TRYV2(auto &&, storage_provider_->setToEphemeral());
-    return createRuntimeEnvironment(state_code);
+      const WasmProvider &wasm_provider) {
+    return createPooledRuntimeEnvironment(wasm_provider, boost::none);
   }
 
-  outcome::result<RuntimeEnvironment> RuntimeManager::createRuntimeEnvironment(
-      const base::Buffer &state_code) {
-    if (state_code.empty()) {
-      return Error::EMPTY_STATE_CODE;
+  outcome::result<RuntimeEnvironment>
+  RuntimeManager::createPooledRuntimeEnvironment(
+      const WasmProvider &wasm_provider,
+      const boost::optional<base::Hash256> &state_root) {
+    auto instance = acquireInstance();
+    if (instance == nullptr) {
+      // no separate storage, run on the shared one as persistent calls do
+      if (state_root.has_value()) {
+        BOOST_OUTCOME_TRYV2(auto &&, storage_provider_->setToEphemeralAt(state_root.value()));
+      } else {
+        BOOST_OUTCOME_TRYV2(auto &&, storage_provider_->setToEphemeral());
+      }
+      return createRuntimeEnvironment(wasm_provider, sharedExternalInterface());
     }
 
-    auto hash = hasher_->twox_256(state_code);
+    if (state_root.has_value()) {
+      BOOST_OUTCOME_TRYV2(auto &&, instance->storage_provider->setToEphemeralAt(state_root.value()));
+    } else {
+      BOOST_OUTCOME_TRYV2(auto &&, instance->storage_provider->setToEphemeral());
+    }
+    OUTCOME_TRY((auto &&, module),
+                getModule(wasm_provider.getStateCode(),
+                          instance->external_interface));
+    if (instance->module != module) {
+      // the state right after instantiation is the one every later call on
+      // this code starts from
+      instance->module_instance =
+          module->instantiate(instance->external_interface);
+      instance->module = std::move(module);
+      instance->module_instance->saveState();
+      instance->external_interface->memoryImpl()->takeImage();
+    }
+
+    auto module_instance = instance->module_instance;
+    auto memory = instance->external_interface->memory();
+    return RuntimeEnvironment{std::move(instance),
+                              std::move(module_instance),
+                              std::move(memory),
+                              boost::none};
+  }
+
+  void RuntimeManager::prepareModule(
+      const WasmProvider::StateCode &state_code) {
+    if (state_code.code == nullptr || state_code.code->empty()) {
+      return;
+    }
+    auto hash = getCodeHash(*state_code.code, state_code.version);
+
+    auto promise = std::make_shared<std::promise<std::shared_ptr<WasmModule>>>();
+    {
+      std::lock_guard lockGuard(modules_->mutex);
+      if (modules_->ready.count(hash) != 0
+          || modules_->preparing.count(hash) != 0) {
+        return;
+      }
+      modules_->preparing.emplace(hash, promise->get_future().share());
+    }
 
-    std::shared_ptr<WasmModule> module;
+    // the thread only holds what it uses, the manager may go away before it
+    // is done
+    std::thread([modules = modules_,
+                 module_factory = module_factory_,
+                 external_interface = sharedExternalInterface(),
+                 code = state_code.code,
+                 hash,
+                 promise,
+                 logger = logger_] {
+      std::shared_ptr<WasmModule> module;
+      auto module_res = module_factory->createModule(*code, external_interface);
+      if (module_res.has_value()) {
+        module = std::move(module_res.value());
+      } else {
+        logger->error("Preparing runtime module {} failed: {}",
+                      hash.toHex(),
+                      module_res.error().message());
+      }
+
+      {
+        std::lock_guard lockGuard(modules->mutex);
+        if (module) {
+          modules->ready.emplace(hash, module);
+        }
+        modules->preparing.erase(hash);
+      }
+      promise->set_value(std::move(module));
+    }).detach();
+  }
+
+  outcome::result<std::shared_ptr<WasmModule>> RuntimeManager::getModule(
+      const base::Buffer &state_code,
+      const base::Hash256 &hash,
+      const std::shared_ptr<RuntimeExternalInterface> &external_interface) {
+    std::shared_future<std::shared_ptr<WasmModule>> preparing;
 
     // Trying retrieve pre-prepared module
     {
-      std::lock_guard lockGuard(modules_mutex_);
-      auto it = modules_.find(hash);
-      if (it != modules_.end()) {
-        module = it->second;
+      std::lock_guard lockGuard(modules_->mutex);
+      auto it = modules_->ready.find(hash);
+      if (it != modules_->ready.end()) {
+        return it->second;
+      }
+      auto preparing_it = modules_->preparing.find(hash);
+      if (preparing_it != modules_->preparing.end()) {
+        preparing = preparing_it->second;
+      }
+    }
+
+    if (preparing.valid()) {
+      logger_->debug("Waiting for the runtime module being prepared");
+      if (auto module = preparing.get(); module != nullptr) {
+        return module;
       }
+      // the preparation failed, parsing again reports the error
     }
 
+    // Prepare new module
+    OUTCOME_TRY((auto &&, new_module),
+                module_factory_->createModule(state_code, external_interface));
+
+    // Trying to safe emplace new module, and use existed one
+    //  if it already emplaced in another thread
+    std::lock_guard lockGuard(modules_->mutex);
+    return modules_->ready.emplace(hash, std::move(new_module)).first->second;
+  }
+
+  std::shared_ptr<RuntimeInstance> RuntimeManager::acquireInstance() {
+    std::unique_ptr<RuntimeInstance> instance;
+    {
+      std::lock_guard lockGuard(instances_->mutex);
+      if (!instances_->idle.empty()) {
+        instance = std::move(instances_->idle.back());
+        instances_->idle.pop_back();
+      }
+    }
+
+    if (!instance) {
+      auto storage_provider = storage_provider_->createEphemeralProvider();
+      if (storage_provider == nullptr) {
+        return nullptr;
+      }
+      auto external_interface = std::make_shared<RuntimeExternalInterface>(
+          extension_factory_, storage_provider);
+      instance = std::make_unique<RuntimeInstance>(RuntimeInstance{
+          std::move(storage_provider), std::move(external_interface)});
+    }
+
+    // the pool may be gone by the time the environment is released
+    return std::shared_ptr<RuntimeInstance>(
+        instance.release(),
+        [pool = std::weak_ptr<InstancePool>(instances_)](
+            RuntimeInstance *released) {
+          std::unique_ptr<RuntimeInstance> owned(released);
+          auto instances = pool.lock();
+          if (!instances) {
+            return;
+          }
+          // only the pages the call wrote are copied back, and a failed call
+          // doesn't leave its allocations behind
+          owned->external_interface->memoryImpl()->restoreImage();
+          if (owned->module_instance) {
+            owned->module_instance->restoreState();
+          }
+          std::lock_guard lockGuard(instances->mutex);
+          if (instances->idle.size() < kMaxIdleInstances) {
+            instances->idle.push_back(std::move(owned));
+          }
+        });
+  }
+
+  std::shared_ptr<RuntimeExternalInterface>
+  RuntimeManager::sharedExternalInterface() {
     if (external_interface_ == nullptr) {
       external_interface_ = std::make_shared<RuntimeExternalInterface>(
           extension_factory_, storage_provider_);
     }
+    return external_interface_;
+  }
 
-    if (!module) {
-      // Prepare new module
-      OUTCOME_TRY((auto &&,
-          new_module),
-          module_factory_->createModule(state_code, external_interface_));
+  base::Hash256 RuntimeManager::getCodeHash(const base::Buffer &state_code,
+                                            uint64_t version) {
+    if (version != 0) {
+      std::lock_guard lockGuard(code_hash_mutex_);
+      if (code_hash_version_ == version) {
+        return code_hash_;
+      }
+    }
+
+    auto hash = hasher_->twox_256(state_code);
+
+    if (version != 0) {
+      std::lock_guard lockGuard(code_hash_mutex_);
+      code_hash_version_ = version;
+      code_hash_ = hash;
+    }
+    return hash;
+  }
 
-      // Trying to safe emplace new module, and use existed one
-      //  if it already emplaced in another thread
-      std::lock_guard lockGuard(modules_mutex_);
-      module = modules_.emplace(hash, std::move(new_module)).first->second;
+  outcome::result<std::shared_ptr<WasmModule>> RuntimeManager::getModule(
+      const WasmProvider::StateCode &state_code,
+      const std::shared_ptr<RuntimeExternalInterface> &external_interface) {
+    if (state_code.code == nullptr || state_code.code->empty()) {
+      return Error::EMPTY_STATE_CODE;
     }
 
+    auto hash = getCodeHash(*state_code.code, state_code.version);
+
+    return getModule(*state_code.code, hash, external_interface);
+  }
+
+  outcome::result<RuntimeEnvironment> RuntimeManager::createRuntimeEnvironment(
+      const WasmProvider &wasm_provider,
+      const std::shared_ptr<RuntimeExternalInterface> &external_interface) {
+    // read once, so the environment is made of the code the module is of
+    auto state_code = wasm_provider.getStateCode();
+    OUTCOME_TRY((auto &&, module), getModule(state_code, external_interface));
+
     return RuntimeEnvironment::create(
-        external_interface_, module, state_code);
+        external_interface, module, *state_code.code);
   }
 
 }  // namespace sgns::runtime::binaryen
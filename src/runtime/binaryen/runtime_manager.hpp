@@ -2,6 +2,13 @@
 #ifndef SUPERGENIUS_SRC_RUNTIME_BINARYEN_RUNTIME_API_RUNTIME_MANAGER
 #define SUPERGENIUS_SRC_RUNTIME_BINARYEN_RUNTIME_API_RUNTIME_MANAGER
 
+#include <future>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <boost/optional.hpp>
+
 #include "base/blob.hpp"
 #include "base/logger.hpp"
 #include "crypto/hasher.hpp"
@@ -17,15 +24,37 @@
 
 namespace sgns::runtime::binaryen {
 
+  /**
+   * @brief Storage and external interface, with its memory, of an ephemeral
+   * runtime call. Each call in flight has its own, so they can run in parallel.
+   * The module instance is kept between calls on the same code, its memory and
+   * globals going back to their state after instantiation when the instance
+   * returns to the pool
+   */
+  struct RuntimeInstance {
+    std::shared_ptr<TrieStorageProvider> storage_provider;
+    std::shared_ptr<RuntimeExternalInterface> external_interface;
+    std::shared_ptr<WasmModule> module;  // the module_instance is made of
+    std::shared_ptr<WasmModuleInstance> module_instance;
+  };
+
   /**
    * @brief RuntimeManager is a mechanism to prepare environment for launching
    * execute() function of runtime APIs. It supports in-memory cache to reuse
    * existing environments, avoid hi-load operations.
+   *
+   * Persistent calls share the storage provider given on construction and
+   * must not overlap. Ephemeral calls, such as transaction validation or
+   * metadata queries, take an instance from a pool and can run concurrently
+   * with them and with each other.
    */
   class RuntimeManager {
    public:
     enum class Error { EMPTY_STATE_CODE = 1 };
 
+    /// Instances kept for later calls once returned to the pool
+    static constexpr size_t kMaxIdleInstances = 16;
+
     RuntimeManager(
         std::shared_ptr<extensions::ExtensionFactory> extension_factory,
         std::shared_ptr<WasmModuleFactory> module_factory,
@@ -33,24 +62,91 @@ namespace sgns::runtime::binaryen {
         std::shared_ptr<crypto::Hasher> hasher);
 
     outcome::result<RuntimeEnvironment> createPersistentRuntimeEnvironment(
-        const base::Buffer &state_code);
+        const WasmProvider &wasm_provider);
 
     outcome::result<RuntimeEnvironment> createEphemeralRuntimeEnvironment(
-        const base::Buffer &state_code);
+        const WasmProvider &wasm_provider);
 
     /**
      * @warning calling this with an \arg state_root older than the current root
      * will reset the storage to an older state once changes are committed
      */
     outcome::result<RuntimeEnvironment> createPersistentRuntimeEnvironmentAt(
-        const base::Buffer &state_code, const base::Hash256 &state_root);
+        const WasmProvider &wasm_provider, const base::Hash256 &state_root);
 
     outcome::result<RuntimeEnvironment> createEphemeralRuntimeEnvironmentAt(
-        const base::Buffer &state_code, const base::Hash256 &state_root);
+        const WasmProvider &wasm_provider, const base::Hash256 &state_root);
+
+    /**
+     * Parses the module of \arg state_code on a background thread, unless it
+     * is ready or being prepared already. Calls needing the module meanwhile
+     * wait for it instead of parsing it again. Meant to be called on startup
+     * and as soon as a runtime upgrade is seen, so block import doesn't stall
+     * on the parsing
+     */
+    void prepareModule(const WasmProvider::StateCode &state_code);
 
    private:
+    struct InstancePool {
+      std::mutex mutex;
+      std::vector<std::unique_ptr<RuntimeInstance>> idle;
+    };
+
+    /**
+     * Modules by code hash, shared with the threads preparing them
+     */
+    struct ModuleStore {
+      std::mutex mutex;
+      std::map<base::Hash256, std::shared_ptr<WasmModule>> ready;
+      std::map<base::Hash256, std::shared_future<std::shared_ptr<WasmModule>>>
+          preparing;
+    };
+
+    /**
+     * @return the module of the code, waiting for its preparation if it is
+     * being prepared, parsing it otherwise
+     */
+    outcome::result<std::shared_ptr<WasmModule>> getModule(
+        const base::Buffer &state_code,
+        const base::Hash256 &hash,
+        const std::shared_ptr<RuntimeExternalInterface> &external_interface);
+
+    /**
+     * @return the module of \arg state_code
+     */
+    outcome::result<std::shared_ptr<WasmModule>> getModule(
+        const WasmProvider::StateCode &state_code,
+        const std::shared_ptr<RuntimeExternalInterface> &external_interface);
+
     outcome::result<RuntimeEnvironment> createRuntimeEnvironment(
-        const base::Buffer &state_code);
+        const WasmProvider &wasm_provider,
+        const std::shared_ptr<RuntimeExternalInterface> &external_interface);
+
+    /**
+     * Ephemeral environment on an instance of the pool, with its own storage
+     * batch. The module instance of the previous call is reused if it was on
+     * the same code
+     */
+    outcome::result<RuntimeEnvironment> createPooledRuntimeEnvironment(
+        const WasmProvider &wasm_provider,
+        const boost::optional<base::Hash256> &state_root);
+
+    /**
+     * @return an idle instance, or a new one, which goes back to the pool once
+     * released. Null if the storage provider can't make ephemeral providers
+     */
+    std::shared_ptr<RuntimeInstance> acquireInstance();
+
+    /**
+     * @return hash of the code, computed once per version of the code
+     */
+    base::Hash256 getCodeHash(const base::Buffer &state_code,
+                              uint64_t version);
+
+    /**
+     * External interface of the calling thread on the shared storage provider
+     */
+    std::shared_ptr<RuntimeExternalInterface> sharedExternalInterface();
 
     base::Logger logger_ = base::createLogger("Runtime manager");
 
@@ -59,8 +155,13 @@ namespace sgns::runtime::binaryen {
     std::shared_ptr<WasmModuleFactory> module_factory_;
     std::shared_ptr<crypto::Hasher> hasher_;
 
-    std::mutex modules_mutex_;
-    std::map<base::Hash256, std::shared_ptr<WasmModule>> modules_;
+    std::shared_ptr<ModuleStore> modules_ = std::make_shared<ModuleStore>();
+
+    std::mutex code_hash_mutex_;
+    uint64_t code_hash_version_ = 0;
+    base::Hash256 code_hash_;
+
+    std::shared_ptr<InstancePool> instances_ = std::make_shared<InstancePool>();
 
     static thread_local std::shared_ptr<RuntimeExternalInterface>
         external_interface_;
@@ -1,6 +1,8 @@
 #include "runtime/binaryen/wasm_memory_impl.hpp"
 #include <runtime/wasm_result.hpp>
 
+#include <algorithm>
+
 namespace sgns::runtime::binaryen {
   WasmMemoryImpl::WasmMemoryImpl(wasm::ShellExternalInterface::Memory *memory,
                                  WasmSize size)
@@ -19,6 +21,54 @@ namespace sgns::runtime::binaryen {
     deallocated_.clear();
   }
 
+  void WasmMemoryImpl::takeImage() {
+    image_ = memory_->memory;
+    image_size_ = size_;
+    dirty_pages_.assign(
+        (image_.size() + kDirtyPageSize - 1) / kDirtyPageSize, false);
+  }
+
+  void WasmMemoryImpl::restoreImage() {
+    if (image_.empty()) {
+      reset();
+      return;
+    }
+    // pages past the image are dropped, and zeroed if the memory grows again
+    memory_->resize(image_.size());
+    size_ = image_size_;
+
+    const auto pages = std::min(
+        dirty_pages_.size(),
+        (image_.size() + kDirtyPageSize - 1) / kDirtyPageSize);
+    for (size_t page = 0; page < pages; ++page) {
+      if (!dirty_pages_[page]) {
+        continue;
+      }
+      const auto offset = page * kDirtyPageSize;
+      const auto length =
+          std::min<size_t>(kDirtyPageSize, image_.size() - offset);
+      std::memcpy(&memory_->memory[offset], &image_[offset], length);
+    }
+    std::fill(dirty_pages_.begin(), dirty_pages_.end(), false);
+
+    reset();
+  }
+
+  void WasmMemoryImpl::markDirty(WasmPointer addr, WasmSize size) {
+    if (image_.empty() || size == 0) {
+      return;
+    }
+    const size_t first = addr / kDirtyPageSize;
+    const size_t last =
+        (static_cast<size_t>(addr) + size - 1) / kDirtyPageSize;
+    if (last >= dirty_pages_.size()) {
+      dirty_pages_.resize(last + 1, false);
+    }
+    for (auto page = first; page <= last; ++page) {
+      dirty_pages_[page] = true;
+    }
+  }
+
   WasmSize WasmMemoryImpl::size() const {
     return size_;
   }
@@ -155,25 +205,31 @@ namespace sgns::runtime::binaryen {
   }
 
   void WasmMemoryImpl::store8(WasmPointer addr, int8_t value) {
+    markDirty(addr, sizeof(value));
     memory_->set<int8_t>(addr, value);
   }
   void WasmMemoryImpl::store16(WasmPointer addr, int16_t value) {
+    markDirty(addr, sizeof(value));
     memory_->set<int16_t>(addr, value);
   }
   void WasmMemoryImpl::store32(WasmPointer addr, int32_t value) {
+    markDirty(addr, sizeof(value));
     memory_->set<int32_t>(addr, value);
   }
   void WasmMemoryImpl::store64(WasmPointer addr, int64_t value) {
+    markDirty(addr, sizeof(value));
     memory_->set<int64_t>(addr, value);
   }
   void WasmMemoryImpl::store128(WasmPointer addr,
                                 const std::array<uint8_t, 16> &value) {
+    markDirty(addr, value.size());
     memory_->set<std::array<uint8_t, 16>>(addr, value);
   }
   void WasmMemoryImpl::storeBuffer(sgns::runtime::WasmPointer addr,
                                    gsl::span<const uint8_t> value) {
     // TODO (kamilsa) PRE-98: check if we do not go outside of memory
     // boundaries, 04.04.2019
+    markDirty(addr, value.size());
     for (size_t i = addr, j = 0; i < addr + static_cast<size_t>(value.size());
          i++, j++) {
       memory_->set(i, value[j]);
@@ -7,6 +7,7 @@
 #include <cstring>  // for std::memset in gcc
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/optional.hpp>
 
@@ -35,6 +36,27 @@ namespace sgns::runtime::binaryen {
 
     void reset() override;
 
+    /**
+     * Keeps the current contents as the image restoreImage() goes back to,
+     * and starts tracking the pages written from now on
+     */
+    void takeImage();
+
+    /**
+     * Brings the memory back to its image and resets the allocator. Only the
+     * pages written since the image was taken are copied, so a call touching a
+     * few pages costs a few page copies instead of a new instantiation.
+     * Without an image only the allocator is reset
+     */
+    void restoreImage();
+
+    /**
+     * Records a write of \arg size bytes at \arg addr, for restoreImage().
+     * Writes of the module go through the external interface, which reports
+     * them here
+     */
+    void markDirty(WasmPointer addr, WasmSize size);
+
     WasmSize size() const override;
     void resize(WasmSize newSize) override;
 
@@ -66,10 +88,20 @@ namespace sgns::runtime::binaryen {
 
     WasmSpan storeBuffer(gsl::span<const uint8_t> value) override;
 
+    /// Granularity of the dirty pages tracking
+    static constexpr WasmSize kDirtyPageSize = 4096;
+
    private:
     wasm::ShellExternalInterface::Memory *memory_;
     WasmSize size_;
 
+    // contents restoreImage() brings the memory back to, empty if no image
+    std::vector<char> image_;
+    WasmSize image_size_ = 0;
+
+    // pages written since the image was taken
+    std::vector<bool> dirty_pages_;
+
     // Offset on the tail of the last allocated MemoryImpl chunk
     WasmPointer offset_;
 
@@ -4,9 +4,10 @@
 namespace sgns::runtime {
 
   ConstWasmProvider::ConstWasmProvider(base::Buffer code)
-      : code_{std::move(code)} {}
+      : code_{std::make_shared<const base::Buffer>(std::move(code)),
+              nextStateCodeVersion()} {}
 
-  const base::Buffer &ConstWasmProvider::getStateCode() const {
+  WasmProvider::StateCode ConstWasmProvider::getStateCode() const {
     return code_;
   }
 
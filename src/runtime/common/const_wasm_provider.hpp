@@ -11,10 +11,10 @@ namespace sgns::runtime {
    public:
     explicit ConstWasmProvider(base::Buffer code);
 
-    const base::Buffer &getStateCode() const override;
+    StateCode getStateCode() const override;
 
    private:
-    base::Buffer code_;
+    StateCode code_;
   };
 
 }  // namespace sgns::runtime
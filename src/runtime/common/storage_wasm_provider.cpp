@@ -16,13 +16,36 @@ namespace sgns::runtime {
     // for debug
 	BOOST_ASSERT_MSG(state_code_res.has_value(),
                      "Runtime code does not exist in the storage");
-	state_code_ = state_code_res.value();
+	state_code_ = {std::make_shared<const base::Buffer>(state_code_res.value()),
+                   nextStateCodeVersion()};
   }
 
-  const base::Buffer &StorageWasmProvider::getStateCode() const {
+  WasmProvider::StateCode StorageWasmProvider::getStateCode() const {
+    StateCode state_code;
+    CodeChangeHandler on_code_change;
+    {
+      std::lock_guard lock(mutex_);
+      if (updateStateCode()) {
+        on_code_change = on_code_change_;
+      }
+      // a copy, the holders keep the code alive once it is replaced
+      state_code = state_code_;
+    }
+    if (on_code_change) {
+      on_code_change(state_code);
+    }
+    return state_code;
+  }
+
+  void StorageWasmProvider::setCodeChangeHandler(CodeChangeHandler handler) {
+    std::lock_guard lock(mutex_);
+    on_code_change_ = std::move(handler);
+  }
+
+  bool StorageWasmProvider::updateStateCode() const {
     auto current_state_root = storage_->getRootHash();
     if (last_state_root_ == current_state_root) {
-      return state_code_;
+      return false;
     }
     last_state_root_ = current_state_root;
 
@@ -32,8 +55,13 @@ namespace sgns::runtime {
     auto state_code_res = batch.value()->get(kRuntimeKey);
     BOOST_ASSERT_MSG(state_code_res.has_value(),
                      "Runtime code does not exist in the storage");
-    state_code_ = state_code_res.value();
-    return state_code_;
+    // most blocks don't touch the code, keep the buffer and its version then
+    if (state_code_res.value() == *state_code_.code) {
+      return false;
+    }
+    state_code_ = {std::make_shared<const base::Buffer>(state_code_res.value()),
+                   nextStateCodeVersion()};
+    return true;
   }
 
 }  // namespace sgns::runtime
@@ -1,6 +1,9 @@
 #ifndef SUPERGENIUS_SRC_RUNTIME_STORAGE_WASM_PROVIDER_HPP
 #define SUPERGENIUS_SRC_RUNTIME_STORAGE_WASM_PROVIDER_HPP
 
+#include <functional>
+#include <mutex>
+
 #include "runtime/wasm_provider.hpp"
 
 #include "storage/trie/trie_storage.hpp"
@@ -13,17 +16,38 @@ namespace sgns::runtime {
 
   class StorageWasmProvider : public WasmProvider {
    public:
+    /// called with the new code, outside of the provider lock
+    using CodeChangeHandler = std::function<void(const StateCode &)>;
+
     ~StorageWasmProvider() override = default;
 
     explicit StorageWasmProvider(
         std::shared_ptr<const storage::trie::TrieStorage> storage);
 
-    const base::Buffer &getStateCode() const override;
+    /**
+     * @return code of the current state root. Its version only changes when a
+     * new state root holds a different code
+     */
+    StateCode getStateCode() const override;
+
+    /**
+     * Sets the handler called once the code of a new state root is loaded and
+     * differs from the previous one, such as on a runtime upgrade
+     */
+    void setCodeChangeHandler(CodeChangeHandler handler);
 
    private:
+    /**
+     * Reloads the code if the state root changed since the last call
+     * @return true if the code changed
+     */
+    bool updateStateCode() const;
+
     std::shared_ptr<const storage::trie::TrieStorage> storage_;
-    mutable base::Buffer state_code_;
+    mutable std::mutex mutex_;
+    mutable StateCode state_code_;
     mutable base::Buffer last_state_root_;
+    CodeChangeHandler on_code_change_;
   };
 
 }  // namespace sgns::runtime
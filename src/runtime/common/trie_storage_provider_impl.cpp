@@ -11,6 +11,7 @@ namespace sgns::runtime {
   outcome::result<void> TrieStorageProviderImpl::setToEphemeral() {
     OUTCOME_TRY((auto &&, batch), trie_storage_->getEphemeralBatch());
     current_batch_ = std::move(batch);
+    ++batch_generation_;
     return outcome::success();
   }
 
@@ -18,6 +19,7 @@ namespace sgns::runtime {
       const base::Hash256 &state_root) {
     OUTCOME_TRY((auto &&, batch), trie_storage_->getEphemeralBatchAt(state_root));
     current_batch_ = std::move(batch);
+    ++batch_generation_;
     return outcome::success();
   }
 
@@ -27,6 +29,7 @@ namespace sgns::runtime {
       persistent_batch_ = std::move(batch);
     }
     current_batch_ = persistent_batch_;
+    ++batch_generation_;
     return outcome::success();
   }
 
@@ -35,6 +38,7 @@ namespace sgns::runtime {
     OUTCOME_TRY((auto &&, batch), trie_storage_->getPersistentBatchAt(state_root));
     persistent_batch_ = std::move(batch);
     current_batch_ = persistent_batch_;
+    ++batch_generation_;
     return outcome::success();
   }
 
@@ -43,6 +47,10 @@ namespace sgns::runtime {
     return current_batch_;
   }
 
+  uint64_t TrieStorageProviderImpl::getBatchGeneration() const {
+    return batch_generation_;
+  }
+
   boost::optional<std::shared_ptr<TrieStorageProviderImpl::PersistentBatch>>
   TrieStorageProviderImpl::tryGetPersistentBatch() const {
     return isCurrentlyPersistent() ? boost::make_optional(persistent_batch_)
@@ -61,4 +69,9 @@ namespace sgns::runtime {
     return base::Buffer{};
   }
 
+  std::shared_ptr<TrieStorageProvider>
+  TrieStorageProviderImpl::createEphemeralProvider() const {
+    return std::make_shared<TrieStorageProviderImpl>(trie_storage_);
+  }
+
 }  // namespace sgns::runtime
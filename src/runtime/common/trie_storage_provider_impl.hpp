@@ -26,16 +26,21 @@ namespace sgns::runtime {
 
 
     std::shared_ptr<Batch> getCurrentBatch() const override;
+    uint64_t getBatchGeneration() const override;
     boost::optional<std::shared_ptr<PersistentBatch>> tryGetPersistentBatch()
         const override;
     bool isCurrentlyPersistent() const override;
 
     outcome::result<base::Buffer> forceCommit() override;
 
+    std::shared_ptr<TrieStorageProvider> createEphemeralProvider()
+        const override;
+
    private:
     std::shared_ptr <storage::trie::TrieStorage> trie_storage_;
 
     std::shared_ptr<Batch> current_batch_;
+    uint64_t batch_generation_ = 0;
 
     // need to store it because it has to be the same in different runtime calls
     // to keep accumulated changes for commit to the main storage
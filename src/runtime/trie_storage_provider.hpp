@@ -52,6 +52,13 @@ namespace sgns::runtime {
      */
     virtual std::shared_ptr<Batch> getCurrentBatch() const = 0;
 
+    /**
+     * @returns number of times the current batch was set. As it is set at the
+     * start of every runtime call, a change tells that data cached from the
+     * batch may be stale
+     */
+    virtual uint64_t getBatchGeneration() const = 0;
+
     /**
      * @returns current persistent batch, if the current batch is persistent,
      * none otherwise
@@ -69,6 +76,14 @@ namespace sgns::runtime {
      * Commits persistent changes even if the current batch is not persistent
      */
     virtual outcome::result<base::Buffer> forceCommit() = 0;
+
+    /**
+     * @returns a provider on the same storage with its own current batch, so
+     * ephemeral calls can run alongside the calls using this one, or null if
+     * not supported
+     */
+    virtual std::shared_ptr<TrieStorageProvider> createEphemeralProvider()
+        const = 0;
   };
 
 }  // namespace sgns::runtime
@@ -1,6 +1,10 @@
 #ifndef SUPERGENIUS_SRC_RUNTIME_WASM_PROVIDER_HPP
 #define SUPERGENIUS_SRC_RUNTIME_WASM_PROVIDER_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
 #include "base/buffer.hpp"
 
 namespace sgns::runtime {
@@ -9,12 +13,33 @@ namespace sgns::runtime {
    */
   class WasmProvider {
    public:
+    /**
+     * Code and its version, read at once so the version always describes the
+     * code. The code stays valid while it is held, even if the provider loads
+     * another one meanwhile
+     */
+    struct StateCode {
+      std::shared_ptr<const base::Buffer> code;
+      /// unique in the process and changed whenever the code does, 0 if not
+      /// tracked
+      uint64_t version = 0;
+    };
+
     virtual ~WasmProvider() = default;
 
     /**
      * @return wasm runtime code
      */
-    virtual const base::Buffer &getStateCode() const = 0;
+    virtual StateCode getStateCode() const = 0;
+
+   protected:
+    /**
+     * @return a version no other code loaded by the process has
+     */
+    static uint64_t nextStateCodeVersion() {
+      static std::atomic<uint64_t> last_version{0};
+      return last_version.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
   };
 }  // namespace sgns::runtime
 
@@ -3,6 +3,8 @@
 #ifndef SUPERGENIUS_IN_MEMORY_BATCH_HPP
 #define SUPERGENIUS_IN_MEMORY_BATCH_HPP
 
+#include <boost/optional.hpp>
+
 #include "base/buffer.hpp"
 #include "storage/in_memory/in_memory_storage.hpp"
 
@@ -28,14 +30,18 @@ namespace sgns::storage {
     }
 
     outcome::result<void> remove(const Buffer &key) override {
-      entries.erase(key.toHex());
+      entries[key.toHex()] = boost::none;
       return outcome::success();
     }
 
     outcome::result<void> commit() override {
       for (auto &entry : entries) {
-        BOOST_OUTCOME_TRYV2(auto &&,
-            db.put(Buffer::fromHex(entry.first).value(), entry.second));
+        auto key = Buffer::fromHex(entry.first).value();
+        if (entry.second) {
+          BOOST_OUTCOME_TRYV2(auto &&, db.put(key, *entry.second));
+        } else {
+          BOOST_OUTCOME_TRYV2(auto &&, db.remove(key));
+        }
       }
       return outcome::success();
     }
@@ -45,7 +51,7 @@ namespace sgns::storage {
     }
 
    private:
-    std::map<std::string, Buffer> entries;
+    std::map<std::string, boost::optional<Buffer>> entries;
     InMemoryStorage &db;
   };
 }  // namespace sgns::storage
@@ -1,8 +1,10 @@
+#include <algorithm>
 #include <memory>
 #include <utility>
 
 #include <boost/filesystem.hpp>
 
+#include <rocksdb/cache.h>
 #include <rocksdb/table.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/slice_transform.h>
@@ -15,10 +17,86 @@
 namespace sgns::storage
 {
     using BlockBasedTableOptions = ::ROCKSDB_NAMESPACE::BlockBasedTableOptions;
+    using ColumnFamilyOptions    = ::ROCKSDB_NAMESPACE::ColumnFamilyOptions;
+    using ColumnFamilyDescriptor = ::ROCKSDB_NAMESPACE::ColumnFamilyDescriptor;
 
-    rocksdb::~rocksdb() {}
+    namespace
+    {
+        /// Number of keys moved per write batch when migrating to column families
+        constexpr std::size_t MIGRATION_BATCH_SIZE = 1024;
+
+        bool StartsWith( std::string_view str, std::string_view prefix )
+        {
+            return str.size() >= prefix.size() && str.compare( 0, prefix.size(), prefix ) == 0;
+        }
+
+        bool MatchesSpec( std::string_view key, const rocksdb::ColumnFamilySpec &spec )
+        {
+            const auto &prefix = spec.keyPrefix;
+            const auto &suffix = spec.keySuffix;
+            return key.size() >= prefix.size() + suffix.size() && StartsWith( key, prefix ) &&
+                   key.compare( key.size() - suffix.size(), suffix.size(), suffix ) == 0;
+        }
+
+        /// Smallest key greater than every key starting with @param prefix, empty if there is none
+        std::string PrefixUpperBound( std::string_view prefix )
+        {
+            std::string bound( prefix );
+            while ( !bound.empty() )
+            {
+                auto last = static_cast<unsigned char>( bound.back() );
+                if ( last != 0xFF )
+                {
+                    bound.back() = static_cast<char>( last + 1 );
+                    return bound;
+                }
+                bound.pop_back();
+            }
+            return bound;
+        }
+
+        ColumnFamilyOptions MakeColumnFamilyOptions( const rocksdb::Options &options, const rocksdb::ColumnFamilySpec &spec )
+        {
+            ColumnFamilyOptions familyOptions( options );
+
+            BlockBasedTableOptions table_options;
+            if ( spec.bloomBitsPerKey > 0 )
+            {
+                table_options.filter_policy.reset(
+                    ::ROCKSDB_NAMESPACE::NewBloomFilterPolicy( spec.bloomBitsPerKey, false ) );
+            }
+            table_options.whole_key_filtering = spec.wholeKeyFiltering;
+            table_options.block_cache         = ::ROCKSDB_NAMESPACE::NewLRUCache( spec.blockCacheBytes );
+            familyOptions.table_factory.reset( NewBlockBasedTableFactory( table_options ) );
+
+            if ( spec.prefixLength > 0 )
+            {
+                familyOptions.prefix_extractor.reset( ::ROCKSDB_NAMESPACE::NewCappedPrefixTransform( spec.prefixLength ) );
+            }
+            else
+            {
+                familyOptions.prefix_extractor.reset();
+            }
+            return familyOptions;
+        }
+    }
+
+    rocksdb::~rocksdb()
+    {
+        for ( auto id : metricCallbacks_ )
+        {
+            base::MetricsRegistry::Instance().RemoveCallbackGauge( id );
+        }
+    }
 
     outcome::result<std::shared_ptr<rocksdb>> rocksdb::create( std::string_view path, const Options &options )
+    {
+        return create( path, options, {} );
+    }
+
+    outcome::result<std::shared_ptr<rocksdb>> rocksdb::create( std::string_view          path,
+                                                               const Options             &options,
+                                                               const ColumnFamilyLayout &layout )
     {
         // Create a shared_ptr immediately to avoid manual memory management
         auto l = std::make_shared<rocksdb>();
@@ -39,19 +117,58 @@ namespace sgns::storage
         // Configure threading environment
         l->options_->env = ::rocksdb::Env::Default();
         l->options_->env->SetBackgroundThreads( 4, ::rocksdb::Env::Priority::HIGH );
+        l->options_->create_missing_column_families = true;
+
+        std::vector<ColumnFamilyDescriptor> descriptors;
+        descriptors.emplace_back( ::ROCKSDB_NAMESPACE::kDefaultColumnFamilyName, *( l->options_ ) );
+        for ( const auto &spec : layout )
+        {
+            descriptors.emplace_back( spec.name, MakeColumnFamilyOptions( *( l->options_ ), spec ) );
+        }
+
+        // Every column family of an existing database has to be opened, even the ones not in the layout
+        std::vector<std::string> existingFamilies;
+        if ( DB::ListColumnFamilies( *( l->options_ ), std::string( path ), &existingFamilies ).ok() )
+        {
+            for ( const auto &name : existingFamilies )
+            {
+                if ( std::none_of( descriptors.begin(),
+                                   descriptors.end(),
+                                   [&name]( const auto &descriptor ) { return descriptor.name == name; } ) )
+                {
+                    descriptors.emplace_back( name, ColumnFamilyOptions( *( l->options_ ) ) );
+                }
+            }
+        }
 
         // Open the RocksDB database
-        DB  *db     = nullptr;
-        auto status = DB::Open( *( l->options_ ), std::string( path ), &db );
+        DB                               *db = nullptr;
+        std::vector<ColumnFamilyHandle *> handles;
+        auto status = DB::Open( *( l->options_ ), std::string( path ), descriptors, &handles, &db );
 
         if ( status.ok() )
         {
-            // Wrap DB* into a shared_ptr with a custom deleter to ensure cleanup
-            l->db_ = std::shared_ptr<DB>( db );
+            // Wrap DB* into a shared_ptr with a custom deleter to ensure cleanup, handles go before the DB
+            l->db_ = std::shared_ptr<DB>( db,
+                                          [handles]( DB *db )
+                                          {
+                                              for ( auto *handle : handles )
+                                              {
+                                                  db->DestroyColumnFamilyHandle( handle );
+                                              }
+                                              delete db;
+                                          } );
             // Create logger
             l->logger_ = base::createLogger( "rocksdb" );
             l->wo_.sync = true;
             l->setWriteOptions( l->wo_ );
+
+            BOOST_OUTCOME_TRYV2( auto &&,
+                                 l->SetColumnFamilies( layout,
+                                                       std::vector<ColumnFamilyHandle *>(
+                                                           handles.begin() + 1,
+                                                           handles.begin() + 1 + layout.size() ) ) );
+            l->RegisterMetrics( path );
             return l; // Return the shared_ptr
         }
 
@@ -65,23 +182,45 @@ namespace sgns::storage
         return error_as_result<std::shared_ptr<rocksdb>>( status );
     }
 
-    outcome::result<std::shared_ptr<rocksdb>> rocksdb::create( const std::shared_ptr<DB> &db )
+    outcome::result<std::shared_ptr<rocksdb>> rocksdb::create( const std::shared_ptr<DB>               &db,
+                                                               const ColumnFamilyLayout                &layout,
+                                                               const std::vector<ColumnFamilyHandle *> &handles )
     {
         if ( db == nullptr )
         {
             return error_as_result<std::shared_ptr<rocksdb>>( rocksdb::Status( rocksdb::Status::PathNotFound() ) );
         }
+        if ( handles.size() != layout.size() )
+        {
+            return error_as_result<std::shared_ptr<rocksdb>>(
+                rocksdb::Status( rocksdb::Status::InvalidArgument( "A column family handle is needed per family" ) ) );
+        }
 
-        auto l     = std::make_unique<rocksdb>();
+        auto l     = std::make_shared<rocksdb>();
         l->db_     = db;
         l->logger_ = base::createLogger( "rocksdb" );
+        BOOST_OUTCOME_TRYV2( auto &&, l->SetColumnFamilies( layout, handles ) );
         return l;
     }
 
+    rocksdb::ColumnFamilyLayout rocksdb::GetColumnFamilyLayout() const
+    {
+        ColumnFamilyLayout layout;
+        for ( const auto &family : columnFamilies_ )
+        {
+            layout.push_back( family.spec );
+        }
+        return layout;
+    }
+
     std::unique_ptr<BufferMapCursor> rocksdb::cursor()
     {
-        auto it = std::unique_ptr<Iterator>( db_->NewIterator( ro_ ) );
-        return std::make_unique<Cursor>( std::move( it ) );
+        std::vector<std::unique_ptr<Iterator>> iterators;
+        for ( auto *family : GetAllColumnFamilies() )
+        {
+            iterators.emplace_back( db_->NewIterator( ro_, family ) );
+        }
+        return std::make_unique<Cursor>( std::move( iterators ) );
     }
 
     std::unique_ptr<BufferBatch> rocksdb::batch()
@@ -89,6 +228,11 @@ namespace sgns::storage
         return std::make_unique<Batch>( *this );
     }
 
+    std::unique_ptr<rocksdb::Batch> rocksdb::CreateBatch()
+    {
+        return std::make_unique<Batch>( *this );
+    }
+
     void rocksdb::setReadOptions( ReadOptions ro )
     {
         ro_ = std::move( ro );
@@ -102,7 +246,7 @@ namespace sgns::storage
     outcome::result<Buffer> rocksdb::get( const Buffer &key ) const
     {
         std::string value;
-        auto        status = db_->Get( ro_, make_slice( key ), &value );
+        auto        status = db_->Get( ro_, GetColumnFamily( key.toString() ), make_slice( key ), &value );
         if ( status.ok() )
         {
             // FIXME: is it possible to avoid copying string -> Buffer?
@@ -118,23 +262,55 @@ namespace sgns::storage
         return error_as_result<Buffer>( status, logger_ );
     }
 
+    outcome::result<Buffer> rocksdb::get( std::string_view key ) const
+    {
+        std::string value;
+        auto        status = db_->Get( ro_, GetColumnFamily( key ), Slice( key.data(), key.size() ), &value );
+        if ( status.ok() )
+        {
+            return Buffer{}.put( value );
+        }
+
+        // not always an actual error so don't log it
+        if ( status.IsNotFound() )
+        {
+            return error_as_result<Buffer>( status );
+        }
+
+        return error_as_result<Buffer>( status, logger_ );
+    }
+
     outcome::result<rocksdb::QueryResult> rocksdb::query( const Buffer &keyPrefix ) const
+    {
+        return query( keyPrefix.toString() );
+    }
+
+    outcome::result<rocksdb::QueryResult> rocksdb::query( std::string_view keyPrefix ) const
     {
         ReadOptions read_options      = ro_;
         read_options.auto_prefix_mode = true; //Adaptive Prefix Mode
 
-        auto strKeyPrefix = std::string( keyPrefix.toString() );
+        // The upper bound lets the iterator stop at the end of the prefix and use the prefix bloom filters
+        auto upperBound      = PrefixUpperBound( keyPrefix );
+        auto upperBoundSlice = Slice( upperBound );
+        if ( !upperBound.empty() )
+        {
+            read_options.iterate_upper_bound = &upperBoundSlice;
+        }
 
         QueryResult results;
-        auto        iter        = std::unique_ptr<rocksdb::Iterator>( db_->NewIterator( read_options ) );
-        auto        slicePrefix = make_slice( keyPrefix );
-        for ( iter->Seek( slicePrefix ); iter->Valid() && iter->key().starts_with( slicePrefix ); iter->Next() )
+        auto        slicePrefix = Slice( keyPrefix.data(), keyPrefix.size() );
+        for ( auto *family : GetColumnFamilies( keyPrefix ) )
         {
-            Buffer key;
-            key.put( iter->key().ToString() );
-            Buffer value;
-            value.put( iter->value().ToString() );
-            results.emplace( std::move( key ), std::move( value ) );
+            auto iter = std::unique_ptr<rocksdb::Iterator>( db_->NewIterator( read_options, family ) );
+            for ( iter->Seek( slicePrefix ); iter->Valid() && iter->key().starts_with( slicePrefix ); iter->Next() )
+            {
+                Buffer key;
+                key.put( iter->key().ToString() );
+                Buffer value;
+                value.put( iter->value().ToString() );
+                results.emplace( std::move( key ), std::move( value ) );
+            }
         }
         return results;
     }
@@ -154,33 +330,43 @@ namespace sgns::storage
             strKeyPrefix += middle_part + remainder_prefix;
         }
 
-        QueryResult results;
-        auto        iter = std::unique_ptr<rocksdb::Iterator>( db_->NewIterator( read_options ) );
-        for ( iter->Seek( strKeyPrefix ); iter->Valid() && iter->key().starts_with( strKeyPrefix ); iter->Next() )
+        auto upperBound      = PrefixUpperBound( strKeyPrefix );
+        auto upperBoundSlice = Slice( upperBound );
+        if ( !upperBound.empty() )
         {
-            const std::string &key_string = iter->key().ToString();
+            read_options.iterate_upper_bound = &upperBoundSlice;
+        }
 
-            if ( !simplified_query )
+        QueryResult results;
+        for ( auto *family : GetColumnFamilies( strKeyPrefix ) )
+        {
+            auto iter = std::unique_ptr<rocksdb::Iterator>( db_->NewIterator( read_options, family ) );
+            for ( iter->Seek( strKeyPrefix ); iter->Valid() && iter->key().starts_with( strKeyPrefix ); iter->Next() )
             {
-                size_t pos = key_string.find( remainder_prefix, strKeyPrefix.size() );
-                if ( pos == std::string::npos )
-                {
-                    continue;
-                }
-                if ( negated_query )
+                const std::string &key_string = iter->key().ToString();
+
+                if ( !simplified_query )
                 {
-                    size_t pos2 = key_string.find( middle_part.substr( 1 ), strKeyPrefix.size() );
-                    if ( pos2 != std::string::npos )
+                    size_t pos = key_string.find( remainder_prefix, strKeyPrefix.size() );
+                    if ( pos == std::string::npos )
                     {
                         continue;
                     }
+                    if ( negated_query )
+                    {
+                        size_t pos2 = key_string.find( middle_part.substr( 1 ), strKeyPrefix.size() );
+                        if ( pos2 != std::string::npos )
+                        {
+                            continue;
+                        }
+                    }
                 }
+                Buffer key;
+                key.put( key_string );
+                Buffer value;
+                value.put( iter->value().ToString() );
+                results.emplace( std::move( key ), std::move( value ) );
             }
-            Buffer key;
-            key.put( key_string );
-            Buffer value;
-            value.put( iter->value().ToString() );
-            results.emplace( std::move( key ), std::move( value ) );
         }
         return results;
     }
@@ -192,16 +378,29 @@ namespace sgns::storage
         return get( key ).has_value();
     }
 
+    bool rocksdb::contains( std::string_view key ) const
+    {
+        std::string value;
+        return db_->Get( ro_, GetColumnFamily( key ), Slice( key.data(), key.size() ), &value ).ok();
+    }
+
     bool rocksdb::empty() const
     {
-        auto it = std::unique_ptr<Iterator>( db_->NewIterator( ro_ ) );
-        it->SeekToFirst();
-        return !it->Valid();
+        for ( auto *family : GetAllColumnFamilies() )
+        {
+            auto it = std::unique_ptr<Iterator>( db_->NewIterator( ro_, family ) );
+            it->SeekToFirst();
+            if ( it->Valid() )
+            {
+                return false;
+            }
+        }
+        return true;
     }
 
     outcome::result<void> rocksdb::put( const Buffer &key, const Buffer &value )
     {
-        auto status = db_->Put( wo_, make_slice( key ), make_slice( value ) );
+        auto status = db_->Put( wo_, GetColumnFamily( key.toString() ), make_slice( key ), make_slice( value ) );
         if ( status.ok() )
         {
             return outcome::success();
@@ -216,9 +415,23 @@ namespace sgns::storage
         return put( key, copy );
     }
 
+    outcome::result<void> rocksdb::put( std::string_view key, std::string_view value )
+    {
+        auto status = db_->Put( wo_,
+                                GetColumnFamily( key ),
+                                Slice( key.data(), key.size() ),
+                                Slice( value.data(), value.size() ) );
+        if ( status.ok() )
+        {
+            return outcome::success();
+        }
+
+        return error_as_result<void>( status, logger_ );
+    }
+
     outcome::result<void> rocksdb::remove( const Buffer &key )
     {
-        auto status = db_->Delete( wo_, make_slice( key ) );
+        auto status = db_->Delete( wo_, GetColumnFamily( key.toString() ), make_slice( key ) );
         if ( status.ok() )
         {
             return outcome::success();
@@ -230,18 +443,197 @@ namespace sgns::storage
     std::vector<rocksdb::KeyValuePair> rocksdb::GetAll() const
     {
         std::vector<KeyValuePair> ret_val;
-        auto iter = std::unique_ptr<rocksdb::Iterator>( db_->NewIterator( rocksdb::ReadOptions() ) );
-
-        for ( iter->SeekToFirst(); iter->Valid(); iter->Next() )
+        for ( auto *family : GetAllColumnFamilies() )
         {
-            Buffer key;
-            Buffer value;
-            key.put( iter->key().ToString() );
+            auto iter = std::unique_ptr<rocksdb::Iterator>( db_->NewIterator( rocksdb::ReadOptions(), family ) );
+
+            for ( iter->SeekToFirst(); iter->Valid(); iter->Next() )
+            {
+                Buffer key;
+                Buffer value;
+                key.put( iter->key().ToString() );
 
-            value.put( iter->value().ToString() );
-            ret_val.push_back( std::make_pair( key, value ) );
+                value.put( iter->value().ToString() );
+                ret_val.push_back( std::make_pair( key, value ) );
+            }
         }
         return ret_val;
     }
 
+    std::optional<uint64_t> rocksdb::GetIntProperty( std::string_view property ) const
+    {
+        uint64_t total = 0;
+        for ( auto *family : GetAllColumnFamilies() )
+        {
+            uint64_t value = 0;
+            if ( !db_->GetIntProperty( family, Slice( property.data(), property.size() ), &value ) )
+            {
+                return std::nullopt;
+            }
+            total += value;
+        }
+        return total;
+    }
+
+    void rocksdb::RegisterMetrics( std::string_view path )
+    {
+        static constexpr std::pair<std::string_view, std::string_view> PROPERTIES[] = {
+            { "rocksdb.estimate-num-keys", "Estimated number of keys" },
+            { "rocksdb.total-sst-files-size", "Size of the SST files, in bytes" },
+            { "rocksdb.cur-size-all-mem-tables", "Size of the memtables, in bytes" },
+            { "rocksdb.block-cache-usage", "Memory used by the block caches, in bytes" },
+            { "rocksdb.estimate-pending-compaction-bytes", "Bytes left to compact" },
+            { "rocksdb.num-running-compactions", "Compactions in progress" },
+        };
+
+        for ( const auto &[property, help] : PROPERTIES )
+        {
+            std::string name( property );
+            std::replace( name.begin(), name.end(), '.', '_' );
+            std::replace( name.begin(), name.end(), '-', '_' );
+            metricCallbacks_.push_back( base::MetricsRegistry::Instance().AddCallbackGauge(
+                name,
+                std::string( help ),
+                { { "path", std::string( path ) } },
+                // the registry calls the gauges under its lock, so none is running once removed
+                [this, property = property]() -> std::optional<double>
+                {
+                    auto value = GetIntProperty( property );
+                    if ( !value )
+                    {
+                        return std::nullopt;
+                    }
+                    return static_cast<double>( *value );
+                } ) );
+        }
+    }
+
+    rocksdb::ColumnFamilyHandle *rocksdb::GetColumnFamily( std::string_view key ) const
+    {
+        for ( const auto &family : columnFamilies_ )
+        {
+            if ( MatchesSpec( key, family.spec ) )
+            {
+                return family.handle;
+            }
+        }
+        return db_->DefaultColumnFamily();
+    }
+
+    std::vector<rocksdb::ColumnFamilyHandle *> rocksdb::GetColumnFamilies( std::string_view keyPrefix ) const
+    {
+        std::vector<ColumnFamilyHandle *> families;
+        bool                              inDefault = true;
+        for ( const auto &family : columnFamilies_ )
+        {
+            if ( StartsWith( keyPrefix, family.spec.keyPrefix ) )
+            {
+                families.push_back( family.handle );
+                // Without a suffix, every key with this prefix belongs to the family
+                inDefault = inDefault && !family.spec.keySuffix.empty();
+            }
+            else if ( StartsWith( family.spec.keyPrefix, keyPrefix ) )
+            {
+                families.push_back( family.handle );
+            }
+        }
+        if ( inDefault )
+        {
+            families.push_back( db_->DefaultColumnFamily() );
+        }
+        return families;
+    }
+
+    std::vector<rocksdb::ColumnFamilyHandle *> rocksdb::GetAllColumnFamilies() const
+    {
+        std::vector<ColumnFamilyHandle *> families{ db_->DefaultColumnFamily() };
+        for ( const auto &family : columnFamilies_ )
+        {
+            families.push_back( family.handle );
+        }
+        return families;
+    }
+
+    outcome::result<void> rocksdb::SetColumnFamilies( const ColumnFamilyLayout                &layout,
+                                                      const std::vector<ColumnFamilyHandle *> &handles )
+    {
+        for ( std::size_t i = 0; i < layout.size(); ++i )
+        {
+            columnFamilies_.push_back( { layout[i], handles[i] } );
+        }
+        if ( columnFamilies_.empty() )
+        {
+            return outcome::success();
+        }
+
+        BOOST_OUTCOME_TRY( auto &&moved, MigrateToColumnFamilies() );
+        if ( moved > 0 )
+        {
+            logger_->info( "Moved {} keys to their column families", moved );
+        }
+        return outcome::success();
+    }
+
+    outcome::result<std::size_t> rocksdb::MigrateToColumnFamilies()
+    {
+        auto       *defaultFamily = db_->DefaultColumnFamily();
+        std::size_t moved         = 0;
+
+        for ( const auto &family : columnFamilies_ )
+        {
+            const auto &prefix = family.spec.keyPrefix;
+
+            ReadOptions read_options    = ro_;
+            auto        upperBound      = PrefixUpperBound( prefix );
+            auto        upperBoundSlice = Slice( upperBound );
+            if ( !upperBound.empty() )
+            {
+                read_options.iterate_upper_bound = &upperBoundSlice;
+            }
+
+            ::ROCKSDB_NAMESPACE::WriteBatch batch;
+            std::size_t                     batchKeys = 0;
+
+            auto iter = std::unique_ptr<Iterator>( db_->NewIterator( read_options, defaultFamily ) );
+            for ( iter->Seek( prefix ); iter->Valid() && iter->key().starts_with( prefix ); iter->Next() )
+            {
+                auto key = iter->key();
+                if ( GetColumnFamily( std::string_view( key.data(), key.size() ) ) != family.handle )
+                {
+                    continue;
+                }
+
+                // Moved atomically, so an interrupted migration resumes on the next open
+                batch.Put( family.handle, key, iter->value() );
+                batch.Delete( defaultFamily, key );
+                if ( ++batchKeys == MIGRATION_BATCH_SIZE )
+                {
+                    auto status = db_->Write( wo_, &batch );
+                    if ( !status.ok() )
+                    {
+                        return error_as_result<std::size_t>( status, logger_ );
+                    }
+                    moved     += batchKeys;
+                    batchKeys  = 0;
+                    batch.Clear();
+                }
+            }
+            if ( !iter->status().ok() )
+            {
+                return error_as_result<std::size_t>( iter->status(), logger_ );
+            }
+
+            if ( batchKeys > 0 )
+            {
+                auto status = db_->Write( wo_, &batch );
+                if ( !status.ok() )
+                {
+                    return error_as_result<std::size_t>( status, logger_ );
+                }
+                moved += batchKeys;
+            }
+        }
+        return moved;
+    }
+
 } // namespace sgns::storage
@@ -1,6 +1,10 @@
 #ifndef SUPERGENIUS_rocksdb_HPP
 #define SUPERGENIUS_rocksdb_HPP
 
+#include <optional>
+#include <string>
+#include <vector>
+
 #include <rocksdb/rocksdb_namespace.h>
 #include <rocksdb/db.h>
 #include <rocksdb/slice.h>
@@ -8,6 +12,7 @@
 #include <rocksdb/write_batch.h>
 
 #include "base/logger.hpp"
+#include "base/metrics.hpp"
 #include "storage/buffer_map_types.hpp"
 
 namespace sgns::storage
@@ -23,7 +28,8 @@ namespace sgns::storage
         class Batch;
         class Cursor;
 
-        using Iterator     = ::ROCKSDB_NAMESPACE::Iterator;
+        using Iterator           = ::ROCKSDB_NAMESPACE::Iterator;
+        using ColumnFamilyHandle = ::ROCKSDB_NAMESPACE::ColumnFamilyHandle;
         using Options      = ::ROCKSDB_NAMESPACE::Options;
         using ReadOptions  = ::ROCKSDB_NAMESPACE::ReadOptions;
         using WriteOptions = ::ROCKSDB_NAMESPACE::WriteOptions;
@@ -33,6 +39,24 @@ namespace sgns::storage
         using QueryResult  = std::map<Buffer, Buffer>;
         using KeyValuePair = std::pair<Buffer, Buffer>;
 
+        /**
+         * @brief Column family holding the keys of one namespace, with its own filters and block cache.
+         * A key belongs to the first family of the layout whose prefix and suffix it matches, keys
+         * matching none of them stay in the default column family.
+         */
+        struct ColumnFamilySpec
+        {
+            std::string name;                                   ///< Column family name
+            std::string keyPrefix;                              ///< Keys starting with this prefix...
+            std::string keySuffix;                              ///< ...and ending with this one, if not empty
+            int         bloomBitsPerKey   = 10;                 ///< Bloom filter bits per key, 0 disables it
+            bool        wholeKeyFiltering = true;               ///< Bloom filter on whole keys, for point reads
+            std::size_t prefixLength      = 0;                  ///< Capped prefix extractor length, 0 disables it
+            std::size_t blockCacheBytes   = 8 * 1024 * 1024;    ///< Size of the block cache of this family
+        };
+
+        using ColumnFamilyLayout = std::vector<ColumnFamilySpec>;
+
         ~rocksdb() override;
 
         /**
@@ -44,11 +68,28 @@ namespace sgns::storage
         static outcome::result<std::shared_ptr<rocksdb>> create( std::string_view path,
                                                                  const Options   &options = Options() );
 
+        /**
+     * @brief Factory method to create an instance of rocksdb class split in column families.
+     * Keys of the layout found in the default column family, written by an older version,
+     * are moved to their column family when the database is opened.
+     * @param path filesystem path where database is going to be
+     * @param options rocksdb options, such as caching, logging, etc.
+     * @param layout column families and the keys they hold
+     * @return instance of rocksdb
+     */
+        static outcome::result<std::shared_ptr<rocksdb>> create( std::string_view          path,
+                                                                 const Options             &options,
+                                                                 const ColumnFamilyLayout &layout );
+
         /**
     * @brief Factory method to create an instance of rocksdb class.
     * @param db pointer to rocksdb database instance
+    * @param layout column families the database was opened with
+    * @param handles handles of the column families of the layout, in the same order, owned by the caller
     */
-        static outcome::result<std::shared_ptr<rocksdb>> create( const std::shared_ptr<DB> &db );
+        static outcome::result<std::shared_ptr<rocksdb>> create( const std::shared_ptr<DB>               &db,
+                                                                 const ColumnFamilyLayout                &layout  = {},
+                                                                 const std::vector<ColumnFamilyHandle *> &handles = {} );
 
         /**
      * @brief Set read options, which are used in @see rocksdb#get
@@ -62,14 +103,32 @@ namespace sgns::storage
      */
         void setWriteOptions( WriteOptions wo );
 
+        /**
+         * @brief       Cursor over every column family, in key order
+         */
         std::unique_ptr<BufferMapCursor> cursor() override;
 
         std::unique_ptr<BufferBatch> batch() override;
 
         outcome::result<Buffer> get( const Buffer &key ) const override;
 
+        /**
+         * @brief       Gets a value using a key that is not held in a Buffer, avoiding a key copy
+         * @param[in]   key: The key to look for
+         * @return      The value or outcome::failure if not found
+         */
+        outcome::result<Buffer> get( std::string_view key ) const;
+
+        /**
+         * @brief       Batch with key/value views, for callers that build keys in place
+         * @return      A new write batch bound to this database
+         */
+        std::unique_ptr<Batch> CreateBatch();
+
         outcome::result<QueryResult> query( const Buffer &keyPrefix ) const;
 
+        outcome::result<QueryResult> query( std::string_view keyPrefix ) const;
+
         /**
          * @brief       Queries with a middle part that can be a wildcard, negated string or normal string
          * @param[in]   prefix_base: The base prefix to query
@@ -83,6 +142,8 @@ namespace sgns::storage
 
         [[nodiscard]] bool contains( const Buffer &key ) const override;
 
+        [[nodiscard]] bool contains( std::string_view key ) const;
+
         bool empty() const override;
 
         outcome::result<void> put( const Buffer &key, const Buffer &value ) override;
@@ -90,6 +151,8 @@ namespace sgns::storage
         // value will be copied, not moved, due to internal structure of rocksdb
         outcome::result<void> put( const Buffer &key, Buffer &&value ) override;
 
+        outcome::result<void> put( std::string_view key, std::string_view value );
+
         outcome::result<void> remove( const Buffer &key ) override;
 
         std::string GetName() override
@@ -102,17 +165,73 @@ namespace sgns::storage
             return db_;
         }
 
+        /**
+         * @brief       Column families the database was opened with
+         */
+        ColumnFamilyLayout GetColumnFamilyLayout() const;
+
         /**
          * @brief      Gets all key value pairs on rocksdb
          */
         std::vector<KeyValuePair> GetAll() const;
 
+        /**
+         * @brief       Gets a rocksdb property summed over all column families, e.g. "rocksdb.estimate-num-keys"
+         * @param[in]   property: The integer property to read
+         * @return      The property value or std::nullopt if it is not supported
+         */
+        std::optional<uint64_t> GetIntProperty( std::string_view property ) const;
+
     private:
-        std::shared_ptr<DB>      db_;
-        ReadOptions              ro_;
-        WriteOptions             wo_;
-        base::Logger             logger_;
-        std::shared_ptr<Options> options_;
+        struct ColumnFamily
+        {
+            ColumnFamilySpec    spec;
+            ColumnFamilyHandle *handle = nullptr;
+        };
+
+        /**
+         * @brief       Column family a key is stored in
+         */
+        ColumnFamilyHandle *GetColumnFamily( std::string_view key ) const;
+
+        /**
+         * @brief       Column families that may hold keys starting with a prefix
+         */
+        std::vector<ColumnFamilyHandle *> GetColumnFamilies( std::string_view keyPrefix ) const;
+
+        /**
+         * @brief       The default column family followed by the ones of the layout
+         */
+        std::vector<ColumnFamilyHandle *> GetAllColumnFamilies() const;
+
+        /**
+         * @brief       Binds the layout to the handles of its column families and moves the keys of the layout
+         *              written by an older version to them
+         * @param[in]   layout: Column families of the database
+         * @param[in]   handles: Handles of the layout column families, in the same order
+         */
+        outcome::result<void> SetColumnFamilies( const ColumnFamilyLayout                &layout,
+                                                 const std::vector<ColumnFamilyHandle *> &handles );
+
+        /**
+         * @brief       Moves keys of the layout out of the default column family
+         * @return      Number of moved keys or outcome::failure on error
+         */
+        outcome::result<std::size_t> MigrateToColumnFamilies();
+
+        /**
+         * @brief       Exposes the main database properties as gauges labelled with the path
+         */
+        void RegisterMetrics( std::string_view path );
+
+        std::shared_ptr<DB>       db_;
+        ReadOptions               ro_;
+        WriteOptions              wo_;
+        base::Logger              logger_;
+        std::shared_ptr<Options>  options_;
+        std::vector<ColumnFamily> columnFamilies_;
+
+        std::vector<base::MetricsRegistry::CallbackId> metricCallbacks_;
     };
 
 } // namespace sgns::storage
@@ -10,7 +10,7 @@ namespace sgns::storage
   outcome::result<void> rocksdb::Batch::put(const Buffer &key,
                                             const Buffer &value) 
   {
-    batch_.Put(make_slice(key), make_slice(value));
+    batch_.Put(db_.GetColumnFamily(key.toString()), make_slice(key), make_slice(value));
     return outcome::success();
   }
 
@@ -22,7 +22,20 @@ namespace sgns::storage
 
   outcome::result<void> rocksdb::Batch::remove(const Buffer &key) 
   {
-    batch_.Delete(make_slice(key));
+    batch_.Delete(db_.GetColumnFamily(key.toString()), make_slice(key));
+    return outcome::success();
+  }
+
+  outcome::result<void> rocksdb::Batch::put(std::string_view key,
+                                            std::string_view value)
+  {
+    batch_.Put(db_.GetColumnFamily(key), Slice(key.data(), key.size()), Slice(value.data(), value.size()));
+    return outcome::success();
+  }
+
+  outcome::result<void> rocksdb::Batch::remove(std::string_view key)
+  {
+    batch_.Delete(db_.GetColumnFamily(key), Slice(key.data(), key.size()));
     return outcome::success();
   }
 
@@ -20,6 +20,13 @@ namespace sgns::storage
 
     outcome::result<void> remove(const Buffer &key) override;
 
+    /**
+     * @brief Writes the key/value views straight into the batch, no Buffer needed
+     */
+    outcome::result<void> put(std::string_view key, std::string_view value);
+
+    outcome::result<void> remove(std::string_view key);
+
     outcome::result<void> commit() override;
 
     void clear() override;
@@ -7,52 +7,114 @@
 namespace sgns::storage 
 {
 
-  rocksdb::Cursor::Cursor(std::shared_ptr<Iterator> it)
-      : i_(std::move(it)) {}
+  rocksdb::Cursor::Cursor(std::vector<std::unique_ptr<Iterator>> iterators)
+      : iterators_(std::move(iterators)) {}
 
   outcome::result<void> rocksdb::Cursor::seekToFirst() 
   {
-    i_->SeekToFirst();
+    for (auto &it : iterators_) {
+      it->SeekToFirst();
+    }
+    forward_ = true;
+    pickCurrent();
     return outcome::success();
   }
 
   outcome::result<void> rocksdb::Cursor::seek(const Buffer &key) 
   {
-    i_->Seek(make_slice(key));
+    for (auto &it : iterators_) {
+      it->Seek(make_slice(key));
+    }
+    forward_ = true;
+    pickCurrent();
     return outcome::success();
   }
 
   outcome::result<void> rocksdb::Cursor::seekToLast() 
   {
-    i_->SeekToLast();
+    for (auto &it : iterators_) {
+      it->SeekToLast();
+    }
+    forward_ = false;
+    pickCurrent();
     return outcome::success();
   }
 
   bool rocksdb::Cursor::isValid() const 
   {
-    return i_->Valid();
+    return current_ != nullptr;
   }
 
   outcome::result<void> rocksdb::Cursor::next() 
   {
-    i_->Next();
+    if (current_ == nullptr) {
+      return outcome::success();
+    }
+    if (!forward_) {
+      turn(true);
+    }
+    current_->Next();
+    pickCurrent();
     return outcome::success();
   }
 
   outcome::result<void> rocksdb::Cursor::prev() 
   {
-    i_->Prev();
+    if (current_ == nullptr) {
+      return outcome::success();
+    }
+    if (forward_) {
+      turn(false);
+    }
+    current_->Prev();
+    pickCurrent();
     return outcome::success();
   }
 
   outcome::result<Buffer> rocksdb::Cursor::key() const 
   {
-    return make_buffer(i_->key());
+    return make_buffer(current_->key());
   }
 
   outcome::result<Buffer> rocksdb::Cursor::value() const 
   {
-    return make_buffer(i_->value());
+    return make_buffer(current_->value());
+  }
+
+  void rocksdb::Cursor::pickCurrent()
+  {
+    current_ = nullptr;
+    for (auto &it : iterators_) {
+      if (!it->Valid()) {
+        continue;
+      }
+      if (current_ == nullptr) {
+        current_ = it.get();
+        continue;
+      }
+      auto order = it->key().compare(current_->key());
+      if (forward_ ? order < 0 : order > 0) {
+        current_ = it.get();
+      }
+    }
+  }
+
+  void rocksdb::Cursor::turn(bool forward)
+  {
+    // the other families don't hold the current key, so they land strictly
+    // after or before it
+    auto key = current_->key().ToString();
+    for (auto &it : iterators_) {
+      if (it.get() == current_) {
+        continue;
+      }
+      if (forward) {
+        it->Seek(key);
+      } else {
+        it->SeekForPrev(key);
+      }
+    }
+    forward_ = forward;
   }
 
 }  // namespace sgns::storage
@@ -11,13 +11,14 @@ namespace sgns::storage
 
   /**
    * @brief Instance of cursor can be used as bidirectional iterator over
-   * key-value bindings of the Map.
+   * key-value bindings of the Map. The iterators of the column families are
+   * merged in key order, a key being held by a single family.
    */
   class rocksdb::Cursor : public BufferMapCursor {
    public:
     ~Cursor() override = default;
 
-    explicit Cursor(std::shared_ptr<Iterator> it);
+    explicit Cursor(std::vector<std::unique_ptr<Iterator>> iterators);
 
     outcome::result<void> seekToFirst() override;
 
@@ -36,7 +37,21 @@ namespace sgns::storage
     outcome::result<Buffer> value() const override;
 
    private:
-    std::shared_ptr<Iterator> i_;
+    /**
+     * Points to the smallest key when moving forward, to the largest one
+     * when moving backward
+     */
+    void pickCurrent();
+
+    /**
+     * Positions the other iterators after the current key, or before it, to
+     * change the direction
+     */
+    void turn(bool forward);
+
+    std::vector<std::unique_ptr<Iterator>> iterators_;
+    Iterator *current_ = nullptr;
+    bool forward_ = true;
   };
 
 }  // namespace sgns::storage
@@ -9,8 +9,11 @@
 namespace sgns::storage::trie {
 
   TrieStorageBackendImpl::TrieStorageBackendImpl(std::shared_ptr<BufferStorage> storage,
-                                       base::Buffer node_prefix)
-      : storage_{std::move(storage)}, node_prefix_{std::move(node_prefix)} {
+                                       base::Buffer node_prefix,
+                                       size_t node_cache_bytes)
+      : storage_{std::move(storage)},
+        node_prefix_{std::move(node_prefix)},
+        node_cache_{std::make_shared<TrieNodeCache>(node_cache_bytes)} {
     BOOST_ASSERT(storage_ != nullptr);
   }
 
@@ -50,6 +53,10 @@ namespace sgns::storage::trie {
     return storage_->remove(prefixKey(key));
   }
 
+  std::shared_ptr<TrieNodeCache> TrieStorageBackendImpl::nodeCache() const {
+    return node_cache_;
+  }
+
   base::Buffer TrieStorageBackendImpl::prefixKey(const base::Buffer &key) const {
     return base::Buffer{node_prefix_}.put(key);
   }
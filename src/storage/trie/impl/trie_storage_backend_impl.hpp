@@ -5,14 +5,22 @@
 
 #include "base/buffer.hpp"
 #include "outcome/outcome.hpp"
+#include "storage/trie/serialization/trie_node_cache.hpp"
 #include "storage/trie/trie_storage_backend.hpp"
 
 namespace sgns::storage::trie {
 
   class TrieStorageBackendImpl : public TrieStorageBackend {
    public:
-    TrieStorageBackendImpl(std::shared_ptr<BufferStorage> storage,
-                      base::Buffer node_prefix);
+    struct Config {
+      /// memory budget of the decoded node cache, 0 disables it
+      size_t node_cache_bytes = TrieNodeCache::kDefaultCapacityBytes;
+    };
+
+    TrieStorageBackendImpl(
+        std::shared_ptr<BufferStorage> storage,
+        base::Buffer node_prefix,
+        size_t node_cache_bytes = TrieNodeCache::kDefaultCapacityBytes);
 
     ~TrieStorageBackendImpl() override = default;
 
@@ -27,6 +35,8 @@ namespace sgns::storage::trie {
     outcome::result<void> put(const Buffer &key, Buffer &&value) override;
     outcome::result<void> remove(const Buffer &key) override;
 
+    std::shared_ptr<TrieNodeCache> nodeCache() const override;
+
     std::string GetName() override
     {
       return "TrieStorageBackendImpl";
@@ -37,8 +47,7 @@ namespace sgns::storage::trie {
 
     std::shared_ptr<BufferStorage> storage_;
     base::Buffer node_prefix_;
-  
-
+    std::shared_ptr<TrieNodeCache> node_cache_;
   };
 
 }  // namespace sgns::storage::trie
@@ -0,0 +1,143 @@
+
+
+#include "storage/trie/serialization/ordered_trie_hash.hpp"
+
+#include <algorithm>
+#include <future>
+#include <utility>
+
+namespace sgns::storage::trie {
+
+  namespace {
+    struct Entry {
+      KeyNibbles key;
+      const base::Buffer *value;
+    };
+    using EntryIt = std::vector<Entry>::const_iterator;
+
+    /// Subtrees of the root with fewer entries are encoded on the calling
+    /// thread, a thread costs more than hashing them
+    constexpr size_t kParallelSubtreeSize = 1024;
+
+    /**
+     * SCALE compact encoding of an index, without the arbitrary precision
+     * arithmetic of scale::CompactInteger for the indices fitting in 30 bits
+     */
+    outcome::result<base::Buffer> encodeIndex(size_t index) {
+      if (index < (1u << 6u)) {
+        return base::Buffer{static_cast<uint8_t>(index << 2u)};
+      }
+      if (index < (1u << 14u)) {
+        const auto mode = static_cast<uint16_t>((index << 2u) | 0b01u);
+        return base::Buffer{static_cast<uint8_t>(mode & 0xffu),
+                            static_cast<uint8_t>(mode >> 8u)};
+      }
+      if (index < (1u << 30u)) {
+        const auto mode = static_cast<uint32_t>((index << 2u) | 0b10u);
+        return base::Buffer{static_cast<uint8_t>(mode & 0xffu),
+                            static_cast<uint8_t>((mode >> 8u) & 0xffu),
+                            static_cast<uint8_t>((mode >> 16u) & 0xffu),
+                            static_cast<uint8_t>(mode >> 24u)};
+      }
+      OUTCOME_TRY((auto &&, enc), scale::encode(scale::CompactInteger{index}));
+      return base::Buffer{enc};
+    }
+
+    /**
+     * Encodes the node holding the sorted entries in [begin, end), which share
+     * their first \arg depth nibbles. The children are only kept as their
+     * merkle values, which is all their parent encoding needs
+     */
+    outcome::result<base::Buffer> encodeSubtree(const SuperGeniusCodec &codec,
+                                                EntryIt begin,
+                                                EntryIt end,
+                                                size_t depth,
+                                                bool parallel) {
+      const auto &first = begin->key;
+      if (std::next(begin) == end) {
+        return codec.encodeNode(
+            LeafNode{first.subspan(depth), *begin->value});
+      }
+
+      // sorted keys share the prefix of the first and the last ones
+      const auto &last = std::prev(end)->key;
+      auto prefix = depth;
+      while (prefix < first.size() && prefix < last.size()
+             && first[prefix] == last[prefix]) {
+        ++prefix;
+      }
+
+      BranchNode branch{first.subspan(depth, prefix - depth)};
+      auto it = begin;
+      // a key ending at the branch is sorted first and is its value
+      if (first.size() == prefix) {
+        branch.value = *begin->value;
+        ++it;
+      }
+
+      // the largest subtrees of the root are encoded on their own threads
+      std::vector<std::pair<uint8_t, std::future<outcome::result<base::Buffer>>>>
+          pending;
+      while (it != end) {
+        const auto nibble = it->key[prefix];
+        auto child_end = std::find_if(it, end, [&](const Entry &entry) {
+          return entry.key[prefix] != nibble;
+        });
+        if (parallel
+            && static_cast<size_t>(std::distance(it, child_end))
+                   >= kParallelSubtreeSize) {
+          pending.emplace_back(nibble,
+                               std::async(std::launch::async,
+                                          encodeSubtree,
+                                          std::cref(codec),
+                                          it,
+                                          child_end,
+                                          prefix + 1,
+                                          false));
+        } else {
+          OUTCOME_TRY((auto &&, encoded),
+                      encodeSubtree(codec, it, child_end, prefix + 1, false));
+          branch.children.at(nibble) =
+              std::make_shared<DummyNode>(codec.merkleValue(encoded));
+        }
+        it = child_end;
+      }
+
+      for (auto &[nibble, child] : pending) {
+        OUTCOME_TRY((auto &&, encoded), child.get());
+        branch.children.at(nibble) =
+            std::make_shared<DummyNode>(codec.merkleValue(encoded));
+      }
+      return codec.encodeNode(branch);
+    }
+  }  // namespace
+
+  outcome::result<base::Buffer> calculateOrderedTrieHash(
+      const std::vector<std::reference_wrapper<const base::Buffer>> &values) {
+    SuperGeniusCodec codec;
+    // empty root
+    if (values.empty()) {
+      static const auto empty_root = base::Buffer{}.put(codec.hash256({0}));
+      return empty_root;
+    }
+
+    std::vector<Entry> entries;
+    entries.reserve(values.size());
+    for (size_t index = 0; index < values.size(); ++index) {
+      OUTCOME_TRY((auto &&, key), encodeIndex(index));
+      entries.push_back(
+          Entry{SuperGeniusCodec::keyToNibbles(key), &values[index].get()});
+    }
+    // compact encodings are little endian, the index order isn't the key order
+    std::sort(entries.begin(),
+              entries.end(),
+              [](const Entry &lhs, const Entry &rhs) {
+                return lhs.key < rhs.key;
+              });
+
+    OUTCOME_TRY((auto &&, enc),
+                encodeSubtree(codec, entries.cbegin(), entries.cend(), 0, true));
+    return base::Buffer{codec.hash256(enc)};
+  }
+
+}  // namespace sgns::storage::trie
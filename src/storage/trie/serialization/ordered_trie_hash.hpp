@@ -3,6 +3,9 @@
 #ifndef SUPERGENIUS_ORDERED_TRIE_HASH_HPP
 #define SUPERGENIUS_ORDERED_TRIE_HASH_HPP
 
+#include <functional>
+#include <vector>
+
 #include "base/buffer.hpp"
 #include "scale/scale.hpp"
 #include "storage/trie/supergenius_trie/supergenius_trie_impl.hpp"
@@ -10,6 +13,18 @@
 
 namespace sgns::storage::trie {
 
+  /**
+   * Calculates the hash of a Merkle tree containing the provided values and
+   * compact-encoded indices of those values(starting from 0) as keys
+   *
+   * The tree is built bottom-up from the sorted keys instead of inserting them
+   * one by one, only the node encodings are kept, and the largest subtrees of
+   * the root are encoded in parallel
+   * @return the Merkle tree root hash of the tree containing provided values
+   */
+  outcome::result<base::Buffer> calculateOrderedTrieHash(
+      const std::vector<std::reference_wrapper<const base::Buffer>> &values);
+
   /**
    * Calculates the hash of a Merkle tree containing the items from the provided
    * range [begin; end) as values and compact-encoded indices of those
@@ -20,26 +35,15 @@ namespace sgns::storage::trie {
   template <typename It>
   outcome::result<base::Buffer> calculateOrderedTrieHash(const It &begin,
                                                            const It &end) {
-    SuperGeniusTrieImpl trie;
-    SuperGeniusCodec codec;
-    // empty root
-    if (begin == end) {
-      static const auto empty_root = base::Buffer{}.put(codec.hash256({0}));
-      return empty_root;
-    }
     // clang-format off
     static_assert(
         std::is_same_v<std::decay_t<decltype(*begin)>, base::Buffer>);
     // clang-format on
-    It it = begin;
-    scale::CompactInteger key = 0;
-    while (it != end) {
-      OUTCOME_TRY((auto &&, enc), scale::encode(key++));
-      BOOST_OUTCOME_TRYV2(auto &&, trie.put(base::Buffer{enc}, *it));
-      it++;
+    std::vector<std::reference_wrapper<const base::Buffer>> values;
+    for (It it = begin; it != end; it++) {
+      values.emplace_back(*it);
     }
-    OUTCOME_TRY((auto &&, enc), codec.encodeNode(*trie.getRoot()));
-    return base::Buffer{codec.hash256(enc)};
+    return calculateOrderedTrieHash(values);
   }
 
 }  // namespace sgns::storage::trie
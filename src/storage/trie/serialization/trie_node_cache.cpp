@@ -0,0 +1,137 @@
+
+
+#include "storage/trie/serialization/trie_node_cache.hpp"
+
+namespace sgns::storage::trie {
+
+  TrieNodeCache::TrieNodeCache(size_t capacity_bytes)
+      : capacity_bytes_{capacity_bytes} {}
+
+  std::shared_ptr<SuperGeniusNode> TrieNodeCache::get(const base::Buffer &key) {
+    std::shared_ptr<const SuperGeniusNode> node;
+    {
+      std::lock_guard lock{mutex_};
+      auto it = entries_.find(key);
+      if (it == entries_.end()) {
+        ++stats_.misses;
+        return nullptr;
+      }
+      ++stats_.hits;
+      lru_.splice(lru_.begin(), lru_, it->second.position);
+      node = it->second.node;
+    }
+    return copyNode(*node);
+  }
+
+  void TrieNodeCache::put(const base::Buffer &key,
+                          const SuperGeniusNode &node) {
+    if (capacity_bytes_ == 0 || node.isDummy()) {
+      return;
+    }
+    if (node.getTrieType() == SuperGeniusNode::Type::BranchEmptyValue
+        || node.getTrieType() == SuperGeniusNode::Type::BranchWithValue) {
+      const auto &branch = dynamic_cast<const BranchNode &>(node);
+      for (const auto &child : branch.children) {
+        if (child && !child->isDummy()) {
+          return;
+        }
+      }
+    }
+
+    auto bytes = nodeBytes(key, node);
+    if (bytes > capacity_bytes_) {
+      return;
+    }
+    auto copy = copyNode(node);
+    if (copy == nullptr) {
+      return;
+    }
+
+    std::lock_guard lock{mutex_};
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      // same key means same content, only refresh the position
+      lru_.splice(lru_.begin(), lru_, it->second.position);
+      return;
+    }
+    lru_.push_front(key);
+    entries_.emplace(key, Entry{std::move(copy), bytes, lru_.begin()});
+    bytes_ += bytes;
+    ++stats_.insertions;
+    evict();
+  }
+
+  void TrieNodeCache::erase(const base::Buffer &key) {
+    std::lock_guard lock{mutex_};
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return;
+    }
+    bytes_ -= it->second.bytes;
+    lru_.erase(it->second.position);
+    entries_.erase(it);
+  }
+
+  void TrieNodeCache::clear() {
+    std::lock_guard lock{mutex_};
+    entries_.clear();
+    lru_.clear();
+    bytes_ = 0;
+  }
+
+  TrieNodeCache::Stats TrieNodeCache::getStats() const {
+    std::lock_guard lock{mutex_};
+    auto stats = stats_;
+    stats.entries = entries_.size();
+    stats.bytes = bytes_;
+    stats.capacity_bytes = capacity_bytes_;
+    return stats;
+  }
+
+  std::shared_ptr<SuperGeniusNode> TrieNodeCache::copyNode(
+      const SuperGeniusNode &node) {
+    using T = SuperGeniusNode::Type;
+    switch (node.getTrieType()) {
+      case T::Leaf:
+        return std::make_shared<LeafNode>(
+            dynamic_cast<const LeafNode &>(node));
+      case T::BranchEmptyValue:
+      case T::BranchWithValue:
+        return std::make_shared<BranchNode>(
+            dynamic_cast<const BranchNode &>(node));
+      default:
+        return nullptr;
+    }
+  }
+
+  size_t TrieNodeCache::nodeBytes(const base::Buffer &key,
+                                  const SuperGeniusNode &node) {
+    size_t bytes = sizeof(Entry) + key.size() + node.key_nibbles.size()
+                   + (node.value ? node.value->size() : 0);
+    if (node.getTrieType() == SuperGeniusNode::Type::BranchEmptyValue
+        || node.getTrieType() == SuperGeniusNode::Type::BranchWithValue) {
+      bytes += sizeof(BranchNode);
+      // the dummy children are shared between the copies, count them once
+      for (const auto &child : dynamic_cast<const BranchNode &>(node).children) {
+        if (child) {
+          bytes += sizeof(DummyNode)
+                   + std::static_pointer_cast<DummyNode>(child)->db_key.size();
+        }
+      }
+    } else {
+      bytes += sizeof(LeafNode);
+    }
+    return bytes;
+  }
+
+  void TrieNodeCache::evict() {
+    while (bytes_ > capacity_bytes_ && !lru_.empty()) {
+      auto it = entries_.find(lru_.back());
+      bytes_ -= it->second.bytes;
+      entries_.erase(it);
+      lru_.pop_back();
+      ++stats_.evictions;
+    }
+  }
+
+}  // namespace sgns::storage::trie
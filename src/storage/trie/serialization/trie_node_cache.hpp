@@ -0,0 +1,92 @@
+
+
+#ifndef SUPERGENIUS_STORAGE_TRIE_NODE_CACHE
+#define SUPERGENIUS_STORAGE_TRIE_NODE_CACHE
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "storage/trie/supergenius_trie/supergenius_node.hpp"
+
+namespace sgns::storage::trie {
+
+  /**
+   * Size-bounded LRU cache of decoded trie nodes, keyed by the key the node
+   * is stored under (its merkle value). Each trie storage backend owns one,
+   * so the cached nodes go away with the storage they were read from.
+   *
+   * Cached nodes are never handed out: tries modify their nodes in place, so
+   * every lookup returns a fresh copy. Children of cached branches are always
+   * dummy nodes, which are never modified, so the copy is shallow.
+   */
+  class TrieNodeCache {
+   public:
+    struct Stats {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t insertions = 0;
+      uint64_t evictions = 0;
+      size_t entries = 0;
+      size_t bytes = 0;  ///< estimated memory held by the cached nodes
+      size_t capacity_bytes = 0;
+
+      double hitRate() const {
+        auto lookups = hits + misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+      }
+    };
+
+    static constexpr size_t kDefaultCapacityBytes = 32 * 1024 * 1024;
+
+    /**
+     * @param capacity_bytes memory budget, 0 disables the cache
+     */
+    explicit TrieNodeCache(size_t capacity_bytes);
+
+    /**
+     * @return a copy of the cached node or nullptr if there is none
+     */
+    std::shared_ptr<SuperGeniusNode> get(const base::Buffer &key);
+
+    /**
+     * Caches a copy of a decoded or just stored node. Nodes with children
+     * that are not dummy nodes are not cached
+     */
+    void put(const base::Buffer &key, const SuperGeniusNode &node);
+
+    /**
+     * Drops the node stored under the key, if any
+     */
+    void erase(const base::Buffer &key);
+
+    void clear();
+
+    Stats getStats() const;
+
+   private:
+    struct Entry {
+      std::shared_ptr<const SuperGeniusNode> node;
+      size_t bytes;
+      std::list<base::Buffer>::iterator position;
+    };
+
+    static std::shared_ptr<SuperGeniusNode> copyNode(
+        const SuperGeniusNode &node);
+    static size_t nodeBytes(const base::Buffer &key,
+                            const SuperGeniusNode &node);
+
+    void evict();
+
+    const size_t capacity_bytes_;
+    mutable std::mutex mutex_;
+    std::unordered_map<base::Buffer, Entry> entries_;
+    std::list<base::Buffer> lru_;  ///< most recently used first
+    size_t bytes_ = 0;
+    Stats stats_;
+  };
+
+}  // namespace sgns::storage::trie
+
+#endif  // SUPERGENIUS_STORAGE_TRIE_NODE_CACHE
@@ -0,0 +1,403 @@
+
+
+#include "storage/trie/serialization/trie_pruner.hpp"
+
+#include <algorithm>
+
+#include "storage/trie/serialization/trie_node_cache.hpp"
+#include "storage/trie/supergenius_trie/supergenius_node.hpp"
+
+OUTCOME_CPP_DEFINE_CATEGORY_3(sgns::storage::trie, TriePruner::Error, e) {
+  using E = sgns::storage::trie::TriePruner::Error;
+  switch (e) {
+    case E::INVALID_RECORD:
+      return "Malformed trie pruning record";
+  }
+  return "Unknown error";
+}
+
+namespace {
+  constexpr uint8_t kCountTag = 'c';
+  constexpr uint8_t kJournalTag = 'j';
+  constexpr uint8_t kHeadTag = 'h';
+
+  /// delay before the collector retries after a failure
+  constexpr std::chrono::seconds kRetryInterval{10};
+
+  uint64_t readUint64(const sgns::base::Buffer &buf, size_t offset) {
+    uint64_t n = 0;
+    for (size_t i = 0; i < sizeof(n); ++i) {
+      n = (n << 8u) | buf[offset + i];
+    }
+    return n;
+  }
+}  // namespace
+
+namespace sgns::storage::trie {
+
+  outcome::result<std::shared_ptr<TriePruner>> TriePruner::create(
+      std::shared_ptr<BufferStorage> storage,
+      base::Buffer node_prefix,
+      base::Buffer record_prefix,
+      std::shared_ptr<Codec> codec,
+      Config config) {
+    std::shared_ptr<TriePruner> pruner(new TriePruner(std::move(storage),
+                                                      std::move(node_prefix),
+                                                      std::move(record_prefix),
+                                                      std::move(codec),
+                                                      config));
+    BOOST_OUTCOME_TRYV2(auto &&, pruner->loadJournal());
+    if (pruner->config_.keep_finalized > 0) {
+      pruner->collector_ = std::thread([raw = pruner.get()] {
+        raw->collectorLoop();
+      });
+    }
+    return pruner;
+  }
+
+  TriePruner::TriePruner(std::shared_ptr<BufferStorage> storage,
+                         base::Buffer node_prefix,
+                         base::Buffer record_prefix,
+                         std::shared_ptr<Codec> codec,
+                         Config config)
+      : storage_{std::move(storage)},
+        node_prefix_{std::move(node_prefix)},
+        record_prefix_{std::move(record_prefix)},
+        codec_{std::move(codec)},
+        config_{config},
+        logger_{base::createLogger("Trie Pruner: ")} {
+    BOOST_ASSERT(storage_ != nullptr);
+    BOOST_ASSERT(codec_ != nullptr);
+  }
+
+  TriePruner::~TriePruner() {
+    stop();
+  }
+
+  std::unique_ptr<TriePruner::Batch> TriePruner::batch() {
+    return std::unique_ptr<Batch>(new Batch(*this));
+  }
+
+  void TriePruner::addNodeCache(const std::shared_ptr<TrieNodeCache> &cache) {
+    std::lock_guard lock{mutex_};
+    node_caches_.erase(
+        std::remove_if(node_caches_.begin(),
+                       node_caches_.end(),
+                       [](const auto &weak_cache) { return weak_cache.expired(); }),
+        node_caches_.end());
+    node_caches_.emplace_back(cache);
+  }
+
+  void TriePruner::onFinalized(const base::Buffer &state_root) {
+    std::lock_guard lock{mutex_};
+    if (config_.keep_finalized == 0) {
+      return;
+    }
+    // the same state may be journaled several times, take the first
+    // occurrence that is not older than the last finalized one
+    auto from = finalized_.empty() ? 0 : finalized_.back();
+    auto it = std::find_if(
+        journal_.begin(), journal_.end(), [&](const JournalEntry &entry) {
+          return entry.seq >= from && entry.root == state_root;
+        });
+    if (it == journal_.end()) {
+      logger_->debug("Finalized state {} is not journaled",
+                     state_root.toHex());
+      return;
+    }
+    if (!finalized_.empty() && finalized_.back() == it->seq) {
+      return;
+    }
+    finalized_.push_back(it->seq);
+    while (finalized_.size() > config_.keep_finalized) {
+      finalized_.pop_front();
+    }
+    // states journaled before the oldest kept finalized one are either its
+    // ancestors or forks that can't be finalized anymore
+    if (finalized_.size() == config_.keep_finalized) {
+      prune_before_ = finalized_.front();
+      collector_cv_.notify_one();
+    }
+  }
+
+  outcome::result<void> TriePruner::prune() {
+    auto start = std::chrono::steady_clock::now();
+    size_t pruned = 0;
+    while (true) {
+      auto batch = this->batch();
+      if (stopped_ || !hasPrunableState()) {
+        break;
+      }
+      auto root = journal_.front().root;
+      BOOST_OUTCOME_TRYV2(auto &&, batch->release(root));
+      ++batch->released_roots_;
+      BOOST_OUTCOME_TRYV2(auto &&, batch->commit());
+      ++pruned;
+    }
+    if (pruned == 0) {
+      return outcome::success();
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::lock_guard lock{mutex_};
+    stats_.last_prune_duration = duration;
+    stats_.total_prune_duration += duration;
+    logger_->debug("Pruned {} states in {} us, {} states journaled",
+                   pruned,
+                   duration.count(),
+                   journal_.size());
+    return outcome::success();
+  }
+
+  void TriePruner::stop() {
+    {
+      std::lock_guard lock{mutex_};
+      stopped_ = true;
+    }
+    collector_cv_.notify_all();
+    if (collector_.joinable()
+        && collector_.get_id() != std::this_thread::get_id()) {
+      collector_.join();
+    }
+  }
+
+  TriePruner::Stats TriePruner::getStats() const {
+    std::lock_guard lock{mutex_};
+    return stats_;
+  }
+
+  outcome::result<void> TriePruner::loadJournal() {
+    auto head_key = headKey();
+    if (!storage_->contains(head_key)) {
+      return outcome::success();
+    }
+    OUTCOME_TRY((auto &&, head), storage_->get(head_key));
+    if (head.size() != 2 * sizeof(uint64_t)) {
+      return Error::INVALID_RECORD;
+    }
+    auto first = readUint64(head, 0);
+    next_seq_ = readUint64(head, sizeof(uint64_t));
+    for (auto seq = first; seq < next_seq_; ++seq) {
+      OUTCOME_TRY((auto &&, root), storage_->get(journalKey(seq)));
+      journal_.push_back({seq, std::move(root)});
+    }
+    stats_.journal_size = journal_.size();
+    logger_->info("Loaded {} journaled states", journal_.size());
+    return outcome::success();
+  }
+
+  void TriePruner::collectorLoop() {
+    while (true) {
+      {
+        std::unique_lock lock{mutex_};
+        collector_cv_.wait(
+            lock, [this] { return stopped_ || hasPrunableState(); });
+        if (stopped_) {
+          return;
+        }
+      }
+      auto res = prune();
+      if (!res) {
+        logger_->error("State pruning failed: {}", res.error().message());
+        std::unique_lock lock{mutex_};
+        collector_cv_.wait_for(lock, kRetryInterval, [this] { return stopped_; });
+      }
+    }
+  }
+
+  bool TriePruner::hasPrunableState() const {
+    return !journal_.empty() && journal_.front().seq < prune_before_;
+  }
+
+  base::Buffer TriePruner::nodeKey(const base::Buffer &key) const {
+    return base::Buffer{node_prefix_}.put(key);
+  }
+
+  base::Buffer TriePruner::countKey(const base::Buffer &key) const {
+    return base::Buffer{record_prefix_}.putUint8(kCountTag).put(key);
+  }
+
+  base::Buffer TriePruner::journalKey(uint64_t seq) const {
+    return base::Buffer{record_prefix_}.putUint8(kJournalTag).putUint64(seq);
+  }
+
+  base::Buffer TriePruner::headKey() const {
+    return base::Buffer{record_prefix_}.putUint8(kHeadTag);
+  }
+
+  TriePruner::Batch::Batch(TriePruner &pruner)
+      : pruner_{pruner},
+        lock_{pruner.mutex_},
+        storage_batch_{pruner.storage_->batch()} {}
+
+  outcome::result<void> TriePruner::Batch::commit() {
+    for (const auto &[key, count] : counts_) {
+      if (deleted_.count(key) != 0) {
+        BOOST_OUTCOME_TRYV2(auto &&,
+                            storage_batch_->remove(pruner_.countKey(key)));
+      } else {
+        BOOST_OUTCOME_TRYV2(
+            auto &&,
+            storage_batch_->put(pruner_.countKey(key),
+                                base::Buffer{}.putUint64(count)));
+      }
+    }
+
+    auto &journal = pruner_.journal_;
+    BOOST_ASSERT(released_roots_ <= journal.size());
+    for (size_t i = 0; i < released_roots_; ++i) {
+      BOOST_OUTCOME_TRYV2(
+          auto &&, storage_batch_->remove(pruner_.journalKey(journal[i].seq)));
+    }
+    auto next_seq = pruner_.next_seq_;
+    for (const auto &root : new_roots_) {
+      BOOST_OUTCOME_TRYV2(
+          auto &&, storage_batch_->put(pruner_.journalKey(next_seq++), root));
+    }
+    if (released_roots_ > 0 || !new_roots_.empty()) {
+      auto first_seq =
+          released_roots_ < journal.size() ? journal[released_roots_].seq
+                                           : pruner_.next_seq_;
+      BOOST_OUTCOME_TRYV2(
+          auto &&,
+          storage_batch_->put(
+              pruner_.headKey(),
+              base::Buffer{}.putUint64(first_seq).putUint64(next_seq)));
+    }
+    BOOST_OUTCOME_TRYV2(auto &&, storage_batch_->commit());
+
+    journal.erase(journal.begin(), journal.begin() + released_roots_);
+    for (auto &root : new_roots_) {
+      journal.push_back({pruner_.next_seq_++, std::move(root)});
+    }
+    auto &stats = pruner_.stats_;
+    stats.pruned_states += released_roots_;
+    stats.deleted_nodes += deleted_.size();
+    stats.reclaimed_bytes += reclaimed_bytes_;
+    stats.journal_size = journal.size();
+    for (const auto &weak_cache : pruner_.node_caches_) {
+      if (auto cache = weak_cache.lock()) {
+        for (const auto &key : deleted_) {
+          cache->erase(key);
+        }
+      }
+    }
+    clear();
+    return outcome::success();
+  }
+
+  outcome::result<void> TriePruner::Batch::put(const Buffer &key,
+                                               const Buffer &value) {
+    return storage_batch_->put(pruner_.nodeKey(key), value);
+  }
+
+  outcome::result<void> TriePruner::Batch::put(const Buffer &key,
+                                               Buffer &&value) {
+    return storage_batch_->put(pruner_.nodeKey(key), std::move(value));
+  }
+
+  outcome::result<void> TriePruner::Batch::remove(const Buffer &key) {
+    return storage_batch_->remove(pruner_.nodeKey(key));
+  }
+
+  void TriePruner::Batch::clear() {
+    storage_batch_->clear();
+    counts_.clear();
+    untracked_.clear();
+    deleted_.clear();
+    new_roots_.clear();
+    released_roots_ = 0;
+    reclaimed_bytes_ = 0;
+  }
+
+  outcome::result<bool> TriePruner::Batch::isStored(const Buffer &key) {
+    OUTCOME_TRY((auto &&, count), loadCount(key));
+    if (count) {
+      return true;
+    }
+    if (untracked_.count(key) != 0) {
+      return true;
+    }
+    if (pruner_.storage_->contains(pruner_.nodeKey(key))) {
+      untracked_.insert(key);
+      return true;
+    }
+    return false;
+  }
+
+  void TriePruner::Batch::markStored(const Buffer &key) {
+    counts_.emplace(key, 0);
+  }
+
+  outcome::result<void> TriePruner::Batch::addReference(const Buffer &key) {
+    OUTCOME_TRY((auto &&, count), loadCount(key));
+    if (count) {
+      counts_[key] = *count + 1;
+    }
+    return outcome::success();
+  }
+
+  outcome::result<void> TriePruner::Batch::addRoot(const Buffer &key) {
+    BOOST_OUTCOME_TRYV2(auto &&, addReference(key));
+    new_roots_.push_back(key);
+    return outcome::success();
+  }
+
+  outcome::result<boost::optional<uint64_t>> TriePruner::Batch::loadCount(
+      const Buffer &key) {
+    if (auto it = counts_.find(key); it != counts_.end()) {
+      return it->second;
+    }
+    if (untracked_.count(key) != 0) {
+      return boost::none;
+    }
+    auto count_key = pruner_.countKey(key);
+    if (!pruner_.storage_->contains(count_key)) {
+      return boost::none;
+    }
+    OUTCOME_TRY((auto &&, record), pruner_.storage_->get(count_key));
+    if (record.size() != sizeof(uint64_t)) {
+      return Error::INVALID_RECORD;
+    }
+    auto count = readUint64(record, 0);
+    counts_.emplace(key, count);
+    return count;
+  }
+
+  outcome::result<void> TriePruner::Batch::release(const Buffer &key) {
+    OUTCOME_TRY((auto &&, count), loadCount(key));
+    if (!count || deleted_.count(key) != 0) {
+      return outcome::success();
+    }
+    if (*count > 1) {
+      counts_[key] = *count - 1;
+      return outcome::success();
+    }
+
+    auto node_key = pruner_.nodeKey(key);
+    OUTCOME_TRY((auto &&, enc), pruner_.storage_->get(node_key));
+    OUTCOME_TRY((auto &&, decoded), pruner_.codec_->decodeNode(enc));
+    counts_[key] = 0;
+    deleted_.insert(key);
+    BOOST_OUTCOME_TRYV2(auto &&, storage_batch_->remove(node_key));
+    reclaimed_bytes_ += node_key.size() + enc.size()
+                        + pruner_.countKey(key).size() + sizeof(uint64_t);
+
+    auto node = std::dynamic_pointer_cast<SuperGeniusNode>(decoded);
+    if (node != nullptr
+        && (node->getTrieType() == SuperGeniusNode::Type::BranchEmptyValue
+            || node->getTrieType() == SuperGeniusNode::Type::BranchWithValue)) {
+      auto &branch = dynamic_cast<BranchNode &>(*node);
+      for (const auto &child : branch.children) {
+        if (child != nullptr && child->isDummy()) {
+          BOOST_OUTCOME_TRYV2(
+              auto &&,
+              release(dynamic_cast<const DummyNode &>(*child).db_key));
+        }
+      }
+    }
+    return outcome::success();
+  }
+
+}  // namespace sgns::storage::trie
@@ -0,0 +1,221 @@
+
+
+#ifndef SUPERGENIUS_STORAGE_TRIE_PRUNER
+#define SUPERGENIUS_STORAGE_TRIE_PRUNER
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "base/logger.hpp"
+#include "outcome/outcome.hpp"
+#include "singleton/IComponent.hpp"
+#include "storage/buffer_map_types.hpp"
+#include "storage/trie/codec.hpp"
+
+namespace sgns::storage::trie {
+
+  class TrieNodeCache;
+
+  /**
+   * Keeps the trie storage from growing forever by deleting the nodes that
+   * are only reachable from old states.
+   *
+   * Every stored node has a reference count record, counting the stored
+   * nodes that have it as a child plus the committed states that have it as
+   * a root. The records are written in the same batch as the nodes, and every
+   * committed state is appended to a journal. When more than the configured
+   * number of states are finalized after a state, it can't be reverted to
+   * anymore, so a background thread releases its root, deleting every node
+   * whose count drops to zero.
+   *
+   * Nodes stored before the pruning was enabled have no record and are never
+   * deleted.
+   */
+  class TriePruner : public IComponent {
+   public:
+    enum class Error { INVALID_RECORD = 1 };
+
+    struct Config {
+      /// number of finalized states kept, 0 keeps every state (archive mode)
+      uint32_t keep_finalized = 0;
+    };
+
+    struct Stats {
+      uint64_t pruned_states = 0;
+      uint64_t deleted_nodes = 0;
+      uint64_t reclaimed_bytes = 0;  ///< size of deleted nodes and records
+      std::chrono::microseconds last_prune_duration{0};
+      std::chrono::microseconds total_prune_duration{0};
+      size_t journal_size = 0;  ///< committed states that are not pruned yet
+    };
+
+    /**
+     * Batch of node writes along with their reference counts. Holds the
+     * pruner lock for its lifetime, so no node can be deleted while a trie
+     * that references it is being stored
+     */
+    class Batch : public BufferBatch {
+     public:
+      ~Batch() override = default;
+
+      outcome::result<void> commit() override;
+
+      /**
+       * Writes a node, the key is the one the trie refers to the node with
+       */
+      outcome::result<void> put(const Buffer &key,
+                                const Buffer &value) override;
+      outcome::result<void> put(const Buffer &key, Buffer &&value) override;
+      outcome::result<void> remove(const Buffer &key) override;
+      void clear() override;
+
+      /**
+       * @return true if a node is already in the storage or in this batch, in
+       * which case it doesn't have to be written again
+       */
+      outcome::result<bool> isStored(const Buffer &key);
+
+      /**
+       * Starts counting references to a node written to this batch
+       */
+      void markStored(const Buffer &key);
+
+      /**
+       * Counts one more reference to a stored node
+       */
+      outcome::result<void> addReference(const Buffer &key);
+
+      /**
+       * Journals a committed state and counts its reference to its root node
+       */
+      outcome::result<void> addRoot(const Buffer &key);
+
+     private:
+      friend class TriePruner;
+
+      explicit Batch(TriePruner &pruner);
+
+      outcome::result<boost::optional<uint64_t>> loadCount(const Buffer &key);
+      outcome::result<void> release(const Buffer &key);
+
+      TriePruner &pruner_;
+      std::unique_lock<std::mutex> lock_;
+      std::unique_ptr<BufferBatch> storage_batch_;
+      std::unordered_map<Buffer, uint64_t> counts_;
+      std::unordered_set<Buffer> untracked_;  ///< nodes without a record
+      std::unordered_set<Buffer> deleted_;
+      std::vector<Buffer> new_roots_;
+      size_t released_roots_ = 0;
+      uint64_t reclaimed_bytes_ = 0;
+    };
+
+    /**
+     * Loads the journal of the states that are not pruned yet
+     * @param storage the storage both the nodes and the pruning records are
+     * kept in
+     * @param node_prefix prefix of the trie node keys, the same as the one of
+     * the trie storage backend
+     * @param record_prefix prefix of the reference counts and of the journal
+     */
+    static outcome::result<std::shared_ptr<TriePruner>> create(
+        std::shared_ptr<BufferStorage> storage,
+        base::Buffer node_prefix,
+        base::Buffer record_prefix,
+        std::shared_ptr<Codec> codec,
+        Config config);
+
+    TriePruner(const TriePruner &) = delete;
+    TriePruner &operator=(const TriePruner &) = delete;
+
+    /**
+     * Stops the collector, see stop()
+     */
+    ~TriePruner() override;
+
+    std::unique_ptr<Batch> batch();
+
+    /**
+     * Registers the node cache of a storage the pruned nodes are read from,
+     * its entries are dropped along with the nodes. The cache is not kept
+     * alive by the pruner
+     */
+    void addNodeCache(const std::shared_ptr<TrieNodeCache> &cache);
+
+    /**
+     * Moves the pruning window forward. Ignored if the state wasn't
+     * committed while the pruner was running
+     * @param state_root state root of the finalized block
+     */
+    void onFinalized(const base::Buffer &state_root);
+
+    /**
+     * Deletes the nodes of the states that are out of the pruning window.
+     * Called by the collector thread
+     */
+    outcome::result<void> prune();
+
+    /**
+     * Stops the collector thread, states that are not pruned yet will be
+     * pruned after a restart
+     */
+    void stop();
+
+    Stats getStats() const;
+
+    std::string GetName() override {
+      return "TriePruner";
+    }
+
+   private:
+    struct JournalEntry {
+      uint64_t seq;
+      base::Buffer root;
+    };
+
+    TriePruner(std::shared_ptr<BufferStorage> storage,
+               base::Buffer node_prefix,
+               base::Buffer record_prefix,
+               std::shared_ptr<Codec> codec,
+               Config config);
+
+    outcome::result<void> loadJournal();
+    void collectorLoop();
+    bool hasPrunableState() const;
+
+    base::Buffer nodeKey(const base::Buffer &key) const;
+    base::Buffer countKey(const base::Buffer &key) const;
+    base::Buffer journalKey(uint64_t seq) const;
+    base::Buffer headKey() const;
+
+    std::shared_ptr<BufferStorage> storage_;
+    const base::Buffer node_prefix_;
+    const base::Buffer record_prefix_;
+    std::shared_ptr<Codec> codec_;
+    const Config config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable collector_cv_;
+    std::deque<JournalEntry> journal_;  ///< oldest first
+    uint64_t next_seq_ = 0;
+    std::deque<uint64_t> finalized_;  ///< journal positions of finalized states
+    uint64_t prune_before_ = 0;  ///< states journaled before it are prunable
+    bool stopped_ = false;
+    Stats stats_;
+    std::vector<std::weak_ptr<TrieNodeCache>> node_caches_;
+    std::thread collector_;
+    base::Logger logger_;
+  };
+
+}  // namespace sgns::storage::trie
+
+OUTCOME_HPP_DECLARE_ERROR_2(sgns::storage::trie, TriePruner::Error);
+
+#endif  // SUPERGENIUS_STORAGE_TRIE_PRUNER
@@ -14,6 +14,11 @@ namespace sgns::storage::trie {
     BOOST_ASSERT(trie_factory_ != nullptr);
     BOOST_ASSERT(codec_ != nullptr);
     BOOST_ASSERT(backend_ != nullptr);
+    node_cache_ = backend_->nodeCache();
+    if (node_cache_ == nullptr) {
+      // a disabled cache, so a backend without one is never cached
+      node_cache_ = std::make_shared<TrieNodeCache>(0);
+    }
   }
 
   Buffer TrieSerializerImpl::getEmptyRootHash() const {
@@ -42,7 +47,15 @@ namespace sgns::storage::trie {
 
   outcome::result<Buffer> TrieSerializerImpl::storeRootNode(
       SuperGeniusNode &node) {
-    auto batch = backend_->batch();
+    std::unique_ptr<TriePruner::Batch> counted;
+    std::unique_ptr<BufferBatch> plain;
+    if (pruner_ != nullptr) {
+      counted = pruner_->batch();
+    } else {
+      plain = backend_->batch();
+    }
+    BufferBatch &batch = counted != nullptr ? *counted : *plain;
+    StoredNodes stored;
     using T = SuperGeniusNode::Type;
 
     // if node is a branch node, its children must be stored to the storage
@@ -51,19 +64,33 @@ namespace sgns::storage::trie {
     if (node.getTrieType() == T::BranchEmptyValue
         || node.getTrieType() == T::BranchWithValue) {
       auto &branch = dynamic_cast<BranchNode &>(node);
-      BOOST_OUTCOME_TRYV2(auto &&, storeChildren(branch, *batch));
+      BOOST_OUTCOME_TRYV2(auto &&,
+                          storeChildren(branch, batch, counted.get(), stored));
     }
 
     OUTCOME_TRY((auto &&, enc), codec_->encodeNode(node));
     auto key = Buffer{codec_->hash256(enc)};
-    BOOST_OUTCOME_TRYV2(auto &&, batch->put(key, enc));
-    BOOST_OUTCOME_TRYV2(auto &&, batch->commit());
+    BOOST_OUTCOME_TRYV2(auto &&, putNode(key, enc, node, batch, counted.get()));
+    if (counted != nullptr) {
+      BOOST_OUTCOME_TRYV2(auto &&, counted->addRoot(key));
+    }
+    BOOST_OUTCOME_TRYV2(auto &&, batch.commit());
+    // the nodes are cached only once they are in the storage, so a failed
+    // commit leaves no entry for a key that cannot be read back
+    for (const auto &[stored_key, stored_node] : stored) {
+      node_cache_->put(stored_key, *stored_node);
+    }
+    // the next trie is likely to be created from this root
+    node_cache_->put(key, node);
 
     return key;
   }
 
   outcome::result<base::Buffer> TrieSerializerImpl::storeNode(
-      SuperGeniusNode &node, BufferBatch &batch) {
+      SuperGeniusNode &node,
+      BufferBatch &batch,
+      TriePruner::Batch *counted,
+      StoredNodes &stored) {
     using T = SuperGeniusNode::Type;
 
     // if node is a branch node, its children must be stored to the storage
@@ -72,19 +99,24 @@ namespace sgns::storage::trie {
     if (node.getTrieType() == T::BranchEmptyValue
         || node.getTrieType() == T::BranchWithValue) {
       auto &branch = dynamic_cast<BranchNode &>(node);
-      BOOST_OUTCOME_TRYV2(auto &&, storeChildren(branch, batch));
+      BOOST_OUTCOME_TRYV2(auto &&,
+                          storeChildren(branch, batch, counted, stored));
     }
     OUTCOME_TRY((auto &&, enc), codec_->encodeNode(node));
     auto key = Buffer{codec_->merkleValue(enc)};
-    BOOST_OUTCOME_TRYV2(auto &&, batch.put(key, enc));
+    BOOST_OUTCOME_TRYV2(auto &&, putNode(key, enc, node, batch, counted));
     return key;
   }
 
-  outcome::result<void> TrieSerializerImpl::storeChildren(BranchNode &branch,
-                                                          BufferBatch &batch) {
+  outcome::result<void> TrieSerializerImpl::storeChildren(
+      BranchNode &branch,
+      BufferBatch &batch,
+      TriePruner::Batch *counted,
+      StoredNodes &stored) {
     for (auto &child : branch.children) {
       if (child && !child->isDummy()) {
-        OUTCOME_TRY((auto &&, hash), storeNode(*child, batch));
+        OUTCOME_TRY((auto &&, hash), storeNode(*child, batch, counted, stored));
+        stored.emplace_back(hash, child);
         // when a node is written to the storage, it is replaced with a dummy
         // node to avoid memory waste
         child = std::make_shared<DummyNode>(hash);
@@ -93,6 +125,38 @@ namespace sgns::storage::trie {
     return outcome::success();
   }
 
+  outcome::result<void> TrieSerializerImpl::putNode(
+      const Buffer &key,
+      const Buffer &enc,
+      const SuperGeniusNode &node,
+      BufferBatch &batch,
+      TriePruner::Batch *counted) {
+    if (counted == nullptr) {
+      return batch.put(key, enc);
+    }
+    OUTCOME_TRY((auto &&, stored), counted->isStored(key));
+    if (stored) {
+      return outcome::success();
+    }
+    BOOST_OUTCOME_TRYV2(auto &&, batch.put(key, enc));
+    counted->markStored(key);
+    using T = SuperGeniusNode::Type;
+    if (node.getTrieType() == T::BranchEmptyValue
+        || node.getTrieType() == T::BranchWithValue) {
+      // children are stored at this point, so all of them are dummies
+      const auto &branch = dynamic_cast<const BranchNode &>(node);
+      for (const auto &child : branch.children) {
+        if (child != nullptr) {
+          BOOST_OUTCOME_TRYV2(
+              auto &&,
+              counted->addReference(
+                  dynamic_cast<const DummyNode &>(*child).db_key));
+        }
+      }
+    }
+    return outcome::success();
+  }
+
   outcome::result<SuperGeniusTrie::NodePtr> TrieSerializerImpl::retrieveChild(
       const SuperGeniusTrie::BranchPtr &parent, uint8_t idx) const {
     if (parent->children.at(idx) == nullptr) {
@@ -112,9 +176,27 @@ namespace sgns::storage::trie {
     if (db_key.empty() || db_key == getEmptyRootHash()) {
       return nullptr;
     }
+    if (auto cached = node_cache_->get(db_key)) {
+      return cached;
+    }
     OUTCOME_TRY((auto &&, enc), backend_->get(db_key));
     OUTCOME_TRY((auto &&, n), codec_->decodeNode(enc));
-    return std::dynamic_pointer_cast<SuperGeniusNode>(n);
+    auto node = std::dynamic_pointer_cast<SuperGeniusNode>(n);
+    if (node != nullptr) {
+      node_cache_->put(db_key, *node);
+    }
+    return node;
+  }
+
+  TrieNodeCache::Stats TrieSerializerImpl::getNodeCacheStats() const {
+    return node_cache_->getStats();
+  }
+
+  void TrieSerializerImpl::setPruner(std::shared_ptr<TriePruner> pruner) {
+    pruner_ = std::move(pruner);
+    if (pruner_ != nullptr) {
+      pruner_->addNodeCache(node_cache_);
+    }
   }
 
 }  // namespace sgns::storage::trie
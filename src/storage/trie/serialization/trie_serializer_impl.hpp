@@ -6,6 +6,8 @@
 #include "storage/trie/serialization/trie_serializer.hpp"
 
 #include "storage/trie/codec.hpp"
+#include "storage/trie/serialization/trie_node_cache.hpp"
+#include "storage/trie/serialization/trie_pruner.hpp"
 #include "storage/trie/supergenius_trie/supergenius_trie_factory.hpp"
 #include "storage/trie/trie_storage_backend.hpp"
 
@@ -25,12 +27,27 @@ namespace sgns::storage::trie {
     outcome::result<std::unique_ptr<SuperGeniusTrie>> retrieveTrie(
         const base::Buffer &db_key) const override;
 
+    /**
+     * @return counters of the decoded node cache of the backend
+     */
+    TrieNodeCache::Stats getNodeCacheStats() const;
+
+    /**
+     * Enables the state pruning: from now on the nodes are stored along with
+     * their reference counts and every stored trie is journaled by the pruner
+     */
+    void setPruner(std::shared_ptr<TriePruner> pruner);
+
     std::string GetName() override
     {
       return "TrieSerializerImpl";
     }
 
    private:
+    /// nodes written to a batch, cached once the batch is committed
+    using StoredNodes =
+        std::vector<std::pair<base::Buffer, SuperGeniusTrie::NodePtr>>;
+
     /**
      * Writes a node to a persistent storage, recursively storing its
      * descendants as well. Then replaces the node children to dummy nodes to
@@ -38,8 +55,22 @@ namespace sgns::storage::trie {
      */
     outcome::result<base::Buffer> storeRootNode(SuperGeniusNode &node);
     outcome::result<base::Buffer> storeNode(SuperGeniusNode &node,
-                                              BufferBatch &batch);
-    outcome::result<void> storeChildren(BranchNode &branch, BufferBatch &batch);
+                                              BufferBatch &batch,
+                                              TriePruner::Batch *counted,
+                                              StoredNodes &stored);
+    outcome::result<void> storeChildren(BranchNode &branch,
+                                        BufferBatch &batch,
+                                        TriePruner::Batch *counted,
+                                        StoredNodes &stored);
+    /**
+     * Writes an encoded node. When pruning, a node that is already stored is
+     * not written again, and a new one references its children
+     */
+    outcome::result<void> putNode(const base::Buffer &key,
+                                  const base::Buffer &enc,
+                                  const SuperGeniusNode &node,
+                                  BufferBatch &batch,
+                                  TriePruner::Batch *counted);
     /**
      * Fetches a node from the storage. A nullptr is returned in case that there
      * is no entry for provided key. Mind that a branch node will have dummy
@@ -57,6 +88,8 @@ namespace sgns::storage::trie {
     std::shared_ptr<SuperGeniusTrieFactory> trie_factory_;
     std::shared_ptr<Codec> codec_;
     std::shared_ptr<TrieStorageBackend> backend_;
+    std::shared_ptr<TrieNodeCache> node_cache_;
+    std::shared_ptr<TriePruner> pruner_;
   };
 }  // namespace sgns::storage::trie
 
@@ -0,0 +1,38 @@
+
+
+#include "storage/trie/snapshot/state_snapshot.hpp"
+
+OUTCOME_CPP_DEFINE_CATEGORY_3(sgns::storage::trie, StateSnapshotError, e) {
+  using E = sgns::storage::trie::StateSnapshotError;
+  switch (e) {
+    case E::INVALID_HEADER:
+      return "Not a state snapshot";
+    case E::UNSUPPORTED_VERSION:
+      return "Unsupported state snapshot version";
+    case E::TRUNCATED:
+      return "State snapshot is truncated";
+    case E::CORRUPTED_CHUNK:
+      return "State snapshot chunk digest mismatch";
+    case E::UNSORTED_KEYS:
+      return "State snapshot keys are not sorted";
+    case E::ENTRY_COUNT_MISMATCH:
+      return "State snapshot entry count mismatch";
+    case E::ROOT_MISMATCH:
+      return "Imported state root differs from the snapshot one";
+    case E::WRITE_FAILED:
+      return "Failed to write the state snapshot";
+  }
+  return "Unknown error";
+}
+
+namespace sgns::storage::trie::snapshot {
+
+  base::Buffer chunkDigest(const Codec &codec,
+                           const base::Buffer &previous,
+                           const base::Buffer &chunk) {
+    auto data = previous;
+    data.put(chunk);
+    return base::Buffer{codec.hash256(data)};
+  }
+
+}  // namespace sgns::storage::trie::snapshot
@@ -0,0 +1,60 @@
+
+
+#ifndef SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT
+#define SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT
+
+#include <istream>
+#include <ostream>
+
+#include "base/buffer.hpp"
+#include "outcome/outcome.hpp"
+#include "storage/trie/codec.hpp"
+
+namespace sgns::storage::trie {
+
+  /**
+   * State snapshot stream format. All the integers are big-endian.
+   *
+   *   header: magic "SGSS" | version u32 | root length u32 | state root |
+   *           chunk entries u32
+   *   chunk:  entry count u32 | body length u32 | body | digest
+   *   body:   (key length u32 | key | value length u32 | value)*
+   *
+   * Entries are sorted by key, a chunk holds at most the chunk entries given
+   * in the header. The stream ends with a chunk with no entries
+   * whose body is the total entry count as u64. The digest of a chunk is the
+   * hash of the previous digest (the state root for the first chunk) followed
+   * by the chunk count, length and body, so every chunk is verified as soon as
+   * it is read, and a reordered or truncated stream is detected
+   */
+  namespace snapshot {
+    constexpr std::string_view kMagic = "SGSS";
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kDefaultChunkEntries = 4096;
+    /// bound on a chunk body, to reject garbage before allocating
+    constexpr uint32_t kMaxChunkBytes = 256 * 1024 * 1024;
+
+    /**
+     * @return digest of a chunk chained to the previous one
+     */
+    base::Buffer chunkDigest(const Codec &codec,
+                             const base::Buffer &previous,
+                             const base::Buffer &chunk);
+  }  // namespace snapshot
+
+  enum class StateSnapshotError {
+    INVALID_HEADER = 1,
+    UNSUPPORTED_VERSION,
+    TRUNCATED,
+    CORRUPTED_CHUNK,
+    UNSORTED_KEYS,
+    ENTRY_COUNT_MISMATCH,
+    ROOT_MISMATCH,
+    WRITE_FAILED,
+  };
+
+}  // namespace sgns::storage::trie
+
+OUTCOME_HPP_DECLARE_ERROR_2(sgns::storage::trie, StateSnapshotError)
+
+#endif  // SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT
@@ -0,0 +1,138 @@
+
+
+#include "storage/trie/snapshot/state_snapshot_exporter.hpp"
+
+#include <algorithm>
+
+#include "storage/trie/serialization/supergenius_codec.hpp"
+#include "storage/trie/supergenius_trie/supergenius_node.hpp"
+
+namespace sgns::storage::trie {
+
+  namespace {
+    /// a node on the walked path along with the full key nibbles of it
+    struct Frame {
+      std::shared_ptr<BranchNode> branch;
+      KeyNibbles nibbles;
+      uint8_t next_child = 0;
+    };
+  }  // namespace
+
+  StateSnapshotExporter::StateSnapshotExporter(
+      std::shared_ptr<TrieStorageBackend> backend,
+      std::shared_ptr<Codec> codec,
+      uint32_t chunk_entries)
+      : backend_{std::move(backend)},
+        codec_{std::move(codec)},
+        chunk_entries_{std::max<uint32_t>(chunk_entries, 1)} {
+    BOOST_ASSERT(backend_ != nullptr);
+    BOOST_ASSERT(codec_ != nullptr);
+  }
+
+  outcome::result<uint64_t> StateSnapshotExporter::exportState(
+      const base::Buffer &state_root, std::ostream &out) const {
+    base::Buffer header;
+    header.put(snapshot::kMagic)
+        .putUint32(snapshot::kVersion)
+        .putUint32(state_root.size())
+        .put(state_root)
+        .putUint32(chunk_entries_);
+    out.write(reinterpret_cast<const char *>(header.data()), header.size());
+
+    auto digest = state_root;
+    base::Buffer body;
+    uint32_t entries = 0;
+    uint64_t total = 0;
+
+    auto load = [this](const base::Buffer &key)
+        -> outcome::result<std::shared_ptr<SuperGeniusNode>> {
+      OUTCOME_TRY((auto &&, enc), backend_->get(key));
+      OUTCOME_TRY((auto &&, node), codec_->decodeNode(enc));
+      return std::dynamic_pointer_cast<SuperGeniusNode>(node);
+    };
+    // values are emitted before the children, which come in the nibble
+    // order, so the keys are sorted
+    auto emit = [&](const KeyNibbles &nibbles,
+                    const SuperGeniusNode &node) -> outcome::result<void> {
+      if (!node.value) {
+        return outcome::success();
+      }
+      auto key = SuperGeniusCodec::nibblesToKey(nibbles);
+      body.putUint32(key.size())
+          .put(key)
+          .putUint32(node.value->size())
+          .put(*node.value);
+      ++total;
+      if (++entries == chunk_entries_) {
+        BOOST_OUTCOME_TRYV2(auto &&, writeChunk(out, entries, body, digest));
+        body.clear();
+        entries = 0;
+      }
+      return outcome::success();
+    };
+    // pushes the node onto the walk, the stack only holds the current path
+    std::vector<Frame> path;
+    auto visit = [&](std::shared_ptr<SuperGeniusNode> node,
+                     KeyNibbles nibbles) -> outcome::result<void> {
+      if (node == nullptr) {
+        return outcome::success();
+      }
+      nibbles.put(node->key_nibbles);
+      BOOST_OUTCOME_TRYV2(auto &&, emit(nibbles, *node));
+      if (auto branch = std::dynamic_pointer_cast<BranchNode>(node)) {
+        path.push_back(Frame{std::move(branch), std::move(nibbles)});
+      }
+      return outcome::success();
+    };
+
+    auto empty_root = base::Buffer{codec_->hash256({0})};
+    if (state_root != empty_root) {
+      OUTCOME_TRY((auto &&, root), load(state_root));
+      BOOST_OUTCOME_TRYV2(auto &&, visit(root, KeyNibbles{}));
+    }
+    while (!path.empty()) {
+      auto &frame = path.back();
+      auto &children = frame.branch->children;
+      while (frame.next_child < children.size()
+             && children.at(frame.next_child) == nullptr) {
+        ++frame.next_child;
+      }
+      if (frame.next_child == children.size()) {
+        path.pop_back();
+        continue;
+      }
+      auto idx = frame.next_child++;
+      auto nibbles = frame.nibbles;
+      nibbles.putUint8(idx);
+      OUTCOME_TRY(
+          (auto &&, child),
+          load(dynamic_cast<const DummyNode &>(*children.at(idx)).db_key));
+      BOOST_OUTCOME_TRYV2(auto &&, visit(std::move(child), std::move(nibbles)));
+    }
+
+    if (entries > 0) {
+      BOOST_OUTCOME_TRYV2(auto &&, writeChunk(out, entries, body, digest));
+    }
+    // the terminating chunk carries the entry count
+    BOOST_OUTCOME_TRYV2(
+        auto &&, writeChunk(out, 0, base::Buffer{}.putUint64(total), digest));
+    return total;
+  }
+
+  outcome::result<void> StateSnapshotExporter::writeChunk(
+      std::ostream &out,
+      uint32_t entries,
+      const base::Buffer &body,
+      base::Buffer &digest) const {
+    base::Buffer chunk;
+    chunk.putUint32(entries).putUint32(body.size()).put(body);
+    digest = snapshot::chunkDigest(*codec_, digest, chunk);
+    chunk.put(digest);
+    out.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+    if (!out) {
+      return StateSnapshotError::WRITE_FAILED;
+    }
+    return outcome::success();
+  }
+
+}  // namespace sgns::storage::trie
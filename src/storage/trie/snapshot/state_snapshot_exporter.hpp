@@ -0,0 +1,45 @@
+
+
+#ifndef SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT_EXPORTER
+#define SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT_EXPORTER
+
+#include "storage/trie/snapshot/state_snapshot.hpp"
+#include "storage/trie/trie_storage_backend.hpp"
+
+namespace sgns::storage::trie {
+
+  /**
+   * Writes the key-value pairs of a stored state as a snapshot stream, see
+   * state_snapshot.hpp for the format.
+   *
+   * The stored nodes are walked depth first, in key order, loading one path
+   * of the trie at a time, so the memory use doesn't depend on the state size
+   */
+  class StateSnapshotExporter {
+   public:
+    StateSnapshotExporter(
+        std::shared_ptr<TrieStorageBackend> backend,
+        std::shared_ptr<Codec> codec,
+        uint32_t chunk_entries = snapshot::kDefaultChunkEntries);
+
+    /**
+     * @param state_root root of a state stored in the backend
+     * @return number of exported entries
+     */
+    outcome::result<uint64_t> exportState(const base::Buffer &state_root,
+                                          std::ostream &out) const;
+
+   private:
+    outcome::result<void> writeChunk(std::ostream &out,
+                                     uint32_t entries,
+                                     const base::Buffer &body,
+                                     base::Buffer &digest) const;
+
+    std::shared_ptr<TrieStorageBackend> backend_;
+    std::shared_ptr<Codec> codec_;
+    const uint32_t chunk_entries_;
+  };
+
+}  // namespace sgns::storage::trie
+
+#endif  // SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT_EXPORTER
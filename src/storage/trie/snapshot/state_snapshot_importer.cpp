@@ -0,0 +1,186 @@
+
+
+#include "storage/trie/snapshot/state_snapshot_importer.hpp"
+
+#include "storage/trie/serialization/supergenius_codec.hpp"
+
+namespace sgns::storage::trie {
+
+  namespace {
+    constexpr size_t kDigestSize = base::Hash256::size();
+
+    outcome::result<base::Buffer> read(std::istream &in, size_t size) {
+      base::Buffer buf(size, 0);
+      in.read(reinterpret_cast<char *>(buf.data()), size);
+      if (static_cast<size_t>(in.gcount()) != size) {
+        return StateSnapshotError::TRUNCATED;
+      }
+      return buf;
+    }
+
+    uint64_t toUint(const base::Buffer &buf, size_t offset, size_t size) {
+      uint64_t n = 0;
+      for (size_t i = 0; i < size; ++i) {
+        n = (n << 8) | buf[offset + i];
+      }
+      return n;
+    }
+
+    outcome::result<uint32_t> readUint32(std::istream &in) {
+      OUTCOME_TRY((auto &&, buf), read(in, sizeof(uint32_t)));
+      return static_cast<uint32_t>(toUint(buf, 0, sizeof(uint32_t)));
+    }
+
+    /**
+     * Reads a length-prefixed field of a chunk body, the body is digest
+     * checked, so a malformed one is a corrupted chunk
+     */
+    outcome::result<base::Buffer> takeField(const base::Buffer &body,
+                                            size_t &offset) {
+      if (body.size() - offset < sizeof(uint32_t)) {
+        return StateSnapshotError::CORRUPTED_CHUNK;
+      }
+      auto size = toUint(body, offset, sizeof(uint32_t));
+      offset += sizeof(uint32_t);
+      if (body.size() - offset < size) {
+        return StateSnapshotError::CORRUPTED_CHUNK;
+      }
+      auto field = body.subbuffer(offset, size);
+      offset += size;
+      return field;
+    }
+  }  // namespace
+
+  StateSnapshotImporter::StateSnapshotImporter(
+      std::shared_ptr<TrieStorageBackend> backend, std::shared_ptr<Codec> codec)
+      : backend_{std::move(backend)}, codec_{std::move(codec)} {
+    BOOST_ASSERT(backend_ != nullptr);
+    BOOST_ASSERT(codec_ != nullptr);
+  }
+
+  outcome::result<base::Buffer> StateSnapshotImporter::importState(
+      std::istream &in) const {
+    OUTCOME_TRY((auto &&, magic), read(in, snapshot::kMagic.size()));
+    if (magic != base::Buffer{}.put(snapshot::kMagic)) {
+      return StateSnapshotError::INVALID_HEADER;
+    }
+    OUTCOME_TRY((auto &&, version), readUint32(in));
+    if (version != snapshot::kVersion) {
+      return StateSnapshotError::UNSUPPORTED_VERSION;
+    }
+    OUTCOME_TRY((auto &&, root_size), readUint32(in));
+    if (root_size != kDigestSize) {
+      return StateSnapshotError::INVALID_HEADER;
+    }
+    OUTCOME_TRY((auto &&, expected_root), read(in, root_size));
+    // the chunk size is only a hint for the readers that preallocate
+    BOOST_OUTCOME_TRYV2(auto &&, readUint32(in));
+
+    SuperGeniusTrieImpl trie;
+    auto digest = expected_root;
+    boost::optional<base::Buffer> last_key;
+    uint64_t total = 0;
+    while (true) {
+      OUTCOME_TRY((auto &&, entries), readUint32(in));
+      OUTCOME_TRY((auto &&, body_size), readUint32(in));
+      if (body_size > snapshot::kMaxChunkBytes) {
+        return StateSnapshotError::CORRUPTED_CHUNK;
+      }
+      OUTCOME_TRY((auto &&, body), read(in, body_size));
+      OUTCOME_TRY((auto &&, chunk_digest), read(in, kDigestSize));
+
+      base::Buffer chunk;
+      chunk.putUint32(entries).putUint32(body_size).put(body);
+      digest = snapshot::chunkDigest(*codec_, digest, chunk);
+      if (digest != chunk_digest) {
+        return StateSnapshotError::CORRUPTED_CHUNK;
+      }
+
+      if (entries == 0) {
+        if (body.size() != sizeof(uint64_t)) {
+          return StateSnapshotError::CORRUPTED_CHUNK;
+        }
+        if (toUint(body, 0, sizeof(uint64_t)) != total) {
+          return StateSnapshotError::ENTRY_COUNT_MISMATCH;
+        }
+        break;
+      }
+
+      size_t offset = 0;
+      for (uint32_t i = 0; i < entries; ++i) {
+        OUTCOME_TRY((auto &&, key), takeField(body, offset));
+        OUTCOME_TRY((auto &&, value), takeField(body, offset));
+        // sorted keys are what makes the left subtries complete
+        if (last_key && !(*last_key < key)) {
+          return StateSnapshotError::UNSORTED_KEYS;
+        }
+        BOOST_OUTCOME_TRYV2(auto &&, trie.put(key, std::move(value)));
+        last_key = std::move(key);
+      }
+      if (offset != body.size()) {
+        return StateSnapshotError::CORRUPTED_CHUNK;
+      }
+      total += entries;
+      BOOST_OUTCOME_TRYV2(auto &&, flushCompleted(trie, *last_key));
+    }
+
+    auto root = base::Buffer{codec_->hash256({0})};
+    if (auto node = trie.getRoot(); node != nullptr) {
+      auto batch = backend_->batch();
+      BOOST_OUTCOME_TRYV2(auto &&, storeChildren(*node, *batch));
+      // the root is stored under its hash, even when it is short
+      OUTCOME_TRY((auto &&, enc), codec_->encodeNode(*node));
+      root = base::Buffer{codec_->hash256(enc)};
+      BOOST_OUTCOME_TRYV2(auto &&, batch->put(root, enc));
+      BOOST_OUTCOME_TRYV2(auto &&, batch->commit());
+    }
+    if (root != expected_root) {
+      return StateSnapshotError::ROOT_MISMATCH;
+    }
+    return root;
+  }
+
+  outcome::result<void> StateSnapshotImporter::flushCompleted(
+      SuperGeniusTrieImpl &trie, const base::Buffer &last_key) const {
+    OUTCOME_TRY((auto &&, path),
+                trie.getPath(trie.getRoot(),
+                             SuperGeniusCodec::keyToNibbles(last_key)));
+    auto batch = backend_->batch();
+    for (auto &[branch, idx] : path) {
+      for (uint8_t i = 0; i < idx; ++i) {
+        auto &child = branch->children.at(i);
+        if (child != nullptr && !child->isDummy()) {
+          OUTCOME_TRY((auto &&, key), storeNode(*child, *batch));
+          child = std::make_shared<DummyNode>(key);
+        }
+      }
+    }
+    return batch->commit();
+  }
+
+  outcome::result<base::Buffer> StateSnapshotImporter::storeNode(
+      SuperGeniusNode &node, BufferBatch &batch) const {
+    BOOST_OUTCOME_TRYV2(auto &&, storeChildren(node, batch));
+    OUTCOME_TRY((auto &&, enc), codec_->encodeNode(node));
+    auto key = codec_->merkleValue(enc);
+    BOOST_OUTCOME_TRYV2(auto &&, batch.put(key, enc));
+    return key;
+  }
+
+  outcome::result<void> StateSnapshotImporter::storeChildren(
+      SuperGeniusNode &node, BufferBatch &batch) const {
+    auto branch = dynamic_cast<BranchNode *>(&node);
+    if (branch == nullptr) {
+      return outcome::success();
+    }
+    for (auto &child : branch->children) {
+      if (child != nullptr && !child->isDummy()) {
+        OUTCOME_TRY((auto &&, key), storeNode(*child, batch));
+        // the stored child is replaced with a dummy to free the memory
+        child = std::make_shared<DummyNode>(key);
+      }
+    }
+    return outcome::success();
+  }
+
+}  // namespace sgns::storage::trie
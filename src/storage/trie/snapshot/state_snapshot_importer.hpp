@@ -0,0 +1,57 @@
+
+
+#ifndef SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT_IMPORTER
+#define SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT_IMPORTER
+
+#include "storage/trie/snapshot/state_snapshot.hpp"
+#include "storage/trie/supergenius_trie/supergenius_trie_impl.hpp"
+#include "storage/trie/trie_storage_backend.hpp"
+
+namespace sgns::storage::trie {
+
+  /**
+   * Rebuilds a state from a snapshot stream, see state_snapshot.hpp for the
+   * format.
+   *
+   * As the entries come in key order, once a chunk is inserted every subtrie
+   * left of the path to its last key is complete. Such subtries are written
+   * to the backend in one batch per chunk and replaced with dummy nodes, so
+   * only the rightmost path of the trie is kept in memory. The root is
+   * checked against the snapshot one at the end.
+   *
+   * The imported nodes have no pruning records, so they are never pruned.
+   */
+  class StateSnapshotImporter {
+   public:
+    StateSnapshotImporter(std::shared_ptr<TrieStorageBackend> backend,
+                          std::shared_ptr<Codec> codec);
+
+    /**
+     * @return root of the imported state, the nodes of a state which root
+     * doesn't match the snapshot one are left in the backend
+     */
+    outcome::result<base::Buffer> importState(std::istream &in) const;
+
+   private:
+    /**
+     * Stores the subtries left of the path to the key
+     */
+    outcome::result<void> flushCompleted(SuperGeniusTrieImpl &trie,
+                                         const base::Buffer &last_key) const;
+
+    /**
+     * Stores a node along with its children that are not stored yet
+     * @return the merkle value the node is stored under
+     */
+    outcome::result<base::Buffer> storeNode(SuperGeniusNode &node,
+                                            BufferBatch &batch) const;
+    outcome::result<void> storeChildren(SuperGeniusNode &node,
+                                        BufferBatch &batch) const;
+
+    std::shared_ptr<TrieStorageBackend> backend_;
+    std::shared_ptr<Codec> codec_;
+  };
+
+}  // namespace sgns::storage::trie
+
+#endif  // SUPERGENIUS_STORAGE_TRIE_SNAPSHOT_STATE_SNAPSHOT_IMPORTER
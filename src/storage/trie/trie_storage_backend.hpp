@@ -9,6 +9,8 @@
 
 namespace sgns::storage::trie {
 
+  class TrieNodeCache;
+
   /**
    * Adapter for key-value storages that allows to hide keyspace separation
    * along with root hash storing logic from the trie db component
@@ -16,6 +18,14 @@ namespace sgns::storage::trie {
   class TrieStorageBackend : public BufferStorage {
    public:
     ~TrieStorageBackend() override = default;
+
+    /**
+     * @return cache of the decoded nodes of this storage, nullptr if the
+     * nodes are not cached
+     */
+    virtual std::shared_ptr<TrieNodeCache> nodeCache() const {
+      return nullptr;
+    }
   };
 
 }  // namespace sgns::storage::trie
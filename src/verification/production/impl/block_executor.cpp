@@ -2,6 +2,10 @@
 
 #include "verification/production/impl/block_executor.hpp"
 
+#include <thread>
+
+#include <boost/asio/post.hpp>
+
 #include "blockchain/block_tree_error.hpp"
 #include "verification/production/impl/production_digests_util.hpp"
 #include "verification/production/impl/threshold_util.hpp"
@@ -28,7 +32,8 @@ namespace sgns::verification {
         tx_pool_{std::move(tx_pool)},
         hasher_{std::move(hasher)},
         authority_update_observer_{std::move(authority_update_observer)},
-        logger_{base::createLogger("BlockExecutor")} {
+        logger_{base::createLogger("BlockExecutor")},
+        verify_pool_{std::max(1u, std::thread::hardware_concurrency())} {
     BOOST_ASSERT(block_tree_ != nullptr);
     BOOST_ASSERT(genesis_configuration_ != nullptr);
     BOOST_ASSERT(production_synchronizer_ != nullptr);
@@ -109,8 +114,11 @@ namespace sgns::verification {
                                 front_block_hex,
                                 back_block_hex);
           }
-          for (const auto &block : blocks) {
-            if (auto apply_res = self->applyBlock(block); ! apply_res) {
+          // seal and VRF checks of the whole batch run in parallel while the
+          // blocks are applied in order as soon as their checks are done
+          auto prepared_blocks = self->prepareBlocks(blocks);
+          for (auto &prepared : prepared_blocks) {
+            if (auto apply_res = self->applyBlock(prepared); ! apply_res) {
               if (apply_res
                   == outcome::failure(
                       blockchain::BlockTreeError::BLOCK_EXISTS)) {
@@ -126,59 +134,102 @@ namespace sgns::verification {
         });
   }
 
-  outcome::result<void> BlockExecutor::applyBlock(
-      const primitives::Block &block) {
-    auto block_hash = hasher_->blake2b_256(scale::encode(block.header).value());
+  std::vector<BlockExecutor::PreparedBlock> BlockExecutor::prepareBlocks(
+      const std::vector<primitives::Block> &blocks) {
+    std::vector<PreparedBlock> prepared_blocks;
+    prepared_blocks.reserve(blocks.size());
 
-    // check if block body already exists. If so, do not apply
-    if (block_tree_->getBlockBody(block_hash)) {
-      return blockchain::BlockTreeError::BLOCK_EXISTS;
-    }
-    logger_->info(
-        "Applying block number: {}, hash: {}",
-        block.header.number,
-        hasher_->blake2b_256(scale::encode(block.header).value()).toHex());
-
-    OUTCOME_TRY((auto &&, production_digests), getProductionDigests(block.header));
-
-    auto [seal, production_header] = production_digests;
-
-    auto epoch_index =
-        production_header.slot_number / genesis_configuration_->epoch_length;
-
-    // TODO (kamilsa): PRE-364 uncomment outcome try and remove dirty workaround
-    // below
-    //    OUTCOME_TRY((auto &&, this_block_epoch_descriptor),
-    //                epoch_storage_->getEpochDescriptor(epoch_index));
-    auto this_block_epoch_descriptor_res =
-        epoch_storage_->getEpochDescriptor(epoch_index);
-    if (! this_block_epoch_descriptor_res) {  // take authorities and
-                                                // randomness
-                                                // from config
-      this_block_epoch_descriptor_res = NextEpochDescriptor{
+    // descriptors announced by the batch, which are only stored once the
+    // announcing block is applied
+    std::map<uint64_t, NextEpochDescriptor> batch_epochs;
+
+    for (const auto &block : blocks) {
+      auto &prepared = prepared_blocks.emplace_back();
+      prepared.block = &block;
+      prepared.hash =
+          hasher_->blake2b_256(scale::encode(block.header).value());
+
+      auto fail = [&prepared](outcome::result<void> error) {
+        std::promise<outcome::result<void>> promise;
+        promise.set_value(std::move(error));
+        prepared.checks = promise.get_future();
+      };
+
+      // check if block body already exists. If so, do not apply
+      if (block_tree_->getBlockBody(prepared.hash)) {
+        fail(blockchain::BlockTreeError::BLOCK_EXISTS);
+        continue;
+      }
+
+      auto production_digests = getProductionDigests(block.header);
+      if (! production_digests) {
+        fail(production_digests.error());
+        break;
+      }
+      const auto &production_header = production_digests.value().second;
+
+      prepared.epoch_index =
+          production_header.slot_number / genesis_configuration_->epoch_length;
+
+      // TODO (kamilsa): PRE-364 fail if the descriptor is missing instead of
+      // taking authorities and randomness from config
+      NextEpochDescriptor epoch_descriptor{
           /*.authorities =*/ genesis_configuration_->genesis_authorities,
           /*.randomness =*/ genesis_configuration_->randomness};
+      if (auto batch_it = batch_epochs.find(prepared.epoch_index);
+          batch_it != batch_epochs.end()) {
+        epoch_descriptor = batch_it->second;
+      } else if (auto stored_res =
+                     epoch_storage_->getEpochDescriptor(prepared.epoch_index)) {
+        epoch_descriptor = stored_res.value();
+      }
+
+      if (auto next_epoch_digest_res = getNextEpochDigest(block.header)) {
+        prepared.next_epoch = next_epoch_digest_res.value();
+        batch_epochs[prepared.epoch_index + 2] = next_epoch_digest_res.value();
+      }
+
+      auto threshold =
+          calculateThreshold(genesis_configuration_->leadership_rate,
+                             epoch_descriptor.authorities,
+                             production_header.authority_index);
+
+      auto checks = std::make_shared<std::packaged_task<outcome::result<void>()>>(
+          [validator = block_validator_,
+           header = block.header,
+           authority_id =
+               epoch_descriptor.authorities[production_header.authority_index].id,
+           threshold,
+           randomness = epoch_descriptor.randomness] {
+            return validator->validateHeaderSeal(
+                header, authority_id, threshold, randomness);
+          });
+      prepared.checks = checks->get_future();
+      boost::asio::post(verify_pool_, [checks] { (*checks)(); });
     }
-    auto this_block_epoch_descriptor = this_block_epoch_descriptor_res.value();
+    return prepared_blocks;
+  }
+
+  outcome::result<void> BlockExecutor::applyBlock(PreparedBlock &prepared) {
+    BOOST_OUTCOME_TRYV2(auto &&, prepared.checks.get());
 
-    auto threshold = calculateThreshold(genesis_configuration_->leadership_rate,
-                                        this_block_epoch_descriptor.authorities,
-                                        production_header.authority_index);
+    const auto &block = *prepared.block;
+    const auto &block_hash = prepared.hash;
+    logger_->info("Applying block number: {}, hash: {}",
+                  block.header.number,
+                  block_hash.toHex());
 
     // update authorities and randomnesss
-    auto next_epoch_digest_res = getNextEpochDigest(block.header);
-    if (next_epoch_digest_res) {
-      logger_->info("Got next epoch digest for epoch: {}", epoch_index);
+    if (prepared.next_epoch) {
+      logger_->info("Got next epoch digest for epoch: {}",
+                    prepared.epoch_index);
       epoch_storage_
-          ->addEpochDescriptor(epoch_index + 2, next_epoch_digest_res.value())
+          ->addEpochDescriptor(prepared.epoch_index + 2, *prepared.next_epoch)
           .value();
     }
 
-    BOOST_OUTCOME_TRYV2(auto &&, block_validator_->validateHeader(
-        block.header,
-        this_block_epoch_descriptor.authorities[production_header.authority_index].id,
-        threshold,
-        this_block_epoch_descriptor.randomness));
+    BOOST_OUTCOME_TRYV2(auto &&,
+                        block_validator_->validateHeaderProducer(block.header));
 
     auto block_without_seal_digest = block;
 
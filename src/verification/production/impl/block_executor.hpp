@@ -3,6 +3,10 @@
 #ifndef SUPERGENIUS_SRC_VERIFICATION_PRODUCTION_IMPL_BLOCK_EXECUTOR_HPP
 #define SUPERGENIUS_SRC_VERIFICATION_PRODUCTION_IMPL_BLOCK_EXECUTOR_HPP
 
+#include <future>
+
+#include <boost/asio/thread_pool.hpp>
+
 #include "blockchain/block_tree.hpp"
 #include "base/logger.hpp"
 #include "verification/authority/authority_update_observer.hpp"
@@ -67,8 +71,33 @@ namespace sgns::verification {
     }
 
    private:
-    // should only be invoked when parent of block exists
-    outcome::result<void> applyBlock(const primitives::Block &block);
+    /**
+     * Block of a synced batch with its stateless checks running on the
+     * verification pool
+     */
+    struct PreparedBlock {
+      const primitives::Block *block = nullptr;
+      primitives::BlockHash hash;
+      uint64_t epoch_index = 0;
+      boost::optional<NextEpochDescriptor> next_epoch;
+      /// result of the seal and VRF checks, or of the preparation itself
+      std::future<outcome::result<void>> checks;
+    };
+
+    /**
+     * Decodes the digests of the blocks in order, resolving the epoch of each
+     * one with the descriptors announced earlier in the batch, and schedules
+     * their seal and VRF checks in parallel. Stops after the first block that
+     * can't be prepared
+     * @param blocks batch in import order
+     * @return prepared blocks, the last one possibly holding an error
+     */
+    std::vector<PreparedBlock> prepareBlocks(
+        const std::vector<primitives::Block> &blocks);
+
+    // should only be invoked when parent of block exists and blocks are
+    // applied in the order they were prepared
+    outcome::result<void> applyBlock(PreparedBlock &prepared);
 
     std::shared_ptr<blockchain::BlockTree> block_tree_;
     //std::shared_ptr<runtime::Core> core_;
@@ -81,6 +110,7 @@ namespace sgns::verification {
     std::shared_ptr<authority::AuthorityUpdateObserver>
         authority_update_observer_;
     base::Logger logger_;
+    boost::asio::thread_pool verify_pool_;  ///< runs the stateless checks
   };
 
 }  // namespace sgns::verification
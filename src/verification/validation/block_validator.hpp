@@ -42,6 +42,31 @@ namespace sgns::verification {
                                                      const primitives::AuthorityId &authority_id,
         const Threshold &threshold,
         const Randomness &randomness) const = 0;
+
+       /**
+     * Validate the stateless part of the block header: the seal signature and
+     * the VRF output. Safe to call concurrently for different headers
+     * @param block_header to be validated
+     * @param authority_id authority that sent this block
+     * @param threshold is vrf threshold for this epoch
+     * @param randomness is randomness used in this epoch
+     * @return nothing or validation error
+     */
+    virtual outcome::result<void> validateHeaderSeal(
+        const primitives::BlockHeader &block_header,
+        const primitives::AuthorityId &authority_id,
+        const Threshold &threshold,
+        const Randomness &randomness) const = 0;
+
+       /**
+     * Validate the stateful part of the block header, that is the producer
+     * did not produce another block in the same slot. Headers must be passed
+     * in import order
+     * @param block_header to be validated
+     * @return nothing or validation error
+     */
+    virtual outcome::result<void> validateHeaderProducer(
+        const primitives::BlockHeader &block_header) const = 0;
   };
 }  // namespace sgns::verification
 
@@ -75,6 +75,16 @@ namespace sgns::verification {
       const primitives::AuthorityId &authority_id,
       const Threshold &threshold,
       const Randomness &randomness) const {
+    BOOST_OUTCOME_TRYV2(auto &&,
+        validateHeaderSeal(header, authority_id, threshold, randomness));
+    return validateHeaderProducer(header);
+  }
+
+  outcome::result<void> ProductionBlockValidator::validateHeaderSeal(
+      const primitives::BlockHeader &header,
+      const primitives::AuthorityId &authority_id,
+      const Threshold &threshold,
+      const Randomness &randomness) const {
     log_->debug("Validates block signed by authority: {}",
                 authority_id.id.toHex());
 
@@ -91,9 +101,15 @@ namespace sgns::verification {
     if (!verifyVRF(production_header, authority_id.id, threshold, randomness)) {
       return ValidationError::INVALID_VRF;
     }
+    return outcome::success();
+  }
+
+  outcome::result<void> ProductionBlockValidator::validateHeaderProducer(
+      const primitives::BlockHeader &header) const {
+    OUTCOME_TRY((auto &&, production_digests), getProductionDigests(header));
 
     // peer must not send two blocks in one slot
-    if (!verifyProducer(production_header)) {
+    if (!verifyProducer(production_digests.second)) {
       return ValidationError::TWO_BLOCKS_IN_SLOT;
     }
     return outcome::success();
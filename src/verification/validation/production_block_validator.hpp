@@ -60,6 +60,15 @@ namespace sgns::verification {
         const primitives::AuthorityId &authority_id,
         const Threshold &threshold,
         const Randomness &randomness) const override;
+
+    outcome::result<void> validateHeaderSeal(
+        const primitives::BlockHeader &header,
+        const primitives::AuthorityId &authority_id,
+        const Threshold &threshold,
+        const Randomness &randomness) const override;
+
+    outcome::result<void> validateHeaderProducer(
+        const primitives::BlockHeader &header) const override;
     
     std::string GetName() override
     {
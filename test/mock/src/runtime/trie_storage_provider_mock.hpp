@@ -15,9 +15,11 @@ namespace sgns::runtime {
     MOCK_METHOD0(setToPersistent, outcome::result<void>());
     MOCK_METHOD1(setToPersistentAt, outcome::result<void>(const base::Hash256 &));
     MOCK_CONST_METHOD0(getCurrentBatch, std::shared_ptr<Batch>());
+    MOCK_CONST_METHOD0(getBatchGeneration, uint64_t());
     MOCK_CONST_METHOD0(tryGetPersistentBatch, boost::optional<std::shared_ptr<PersistentBatch>>());
     MOCK_CONST_METHOD0(isCurrentlyPersistent, bool());
     MOCK_METHOD0(forceCommit, outcome::result<base::Buffer>());
+    MOCK_CONST_METHOD0(createEphemeralProvider, std::shared_ptr<TrieStorageProvider>());
   };
 
 }
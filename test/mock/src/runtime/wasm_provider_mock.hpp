@@ -10,7 +10,7 @@ namespace sgns::runtime {
 
   class WasmProviderMock: public WasmProvider {
    public:
-    MOCK_CONST_METHOD0(getStateCode, const base::Buffer &());
+    MOCK_CONST_METHOD0(getStateCode, StateCode());
   };
 
 }
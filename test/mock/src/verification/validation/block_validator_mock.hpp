@@ -23,6 +23,17 @@ namespace sgns::verification {
                               const primitives::AuthorityId &authority_id,
                               const Threshold &threshold,
                               const Randomness &randomness));
+
+    MOCK_CONST_METHOD4(
+        validateHeaderSeal,
+        outcome::result<void>(const primitives::BlockHeader &header,
+                              const primitives::AuthorityId &authority_id,
+                              const Threshold &threshold,
+                              const Randomness &randomness));
+
+    MOCK_CONST_METHOD1(
+        validateHeaderProducer,
+        outcome::result<void>(const primitives::BlockHeader &header));
     
     MOCK_METHOD0(GetName, std::string());
   };
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "account/GeniusAccount.hpp"
+#include "account/MintTransaction.hpp"
+#include "account/TransactionSignatureVerifier.hpp"
+
+using namespace sgns;
+
+static const sgns::TokenID   TOKEN_NAME = sgns::TokenID::FromBytes( { 0x01, 0x02 } );
+static const std::string     DATA_DIR   = ".";
+static constexpr const char *PRIV_KEY   = "deadbeefdeadbeefdeadbeefdeadbeefdeadbeefdeadbeefdeadbeefdeadbeef";
+
+static SGTransaction::DAGStruct SignedDag( const GeniusAccount &account, uint64_t nonce )
+{
+    SGTransaction::DAGStruct dag;
+    dag.set_nonce( nonce );
+    dag.set_source_addr( account.GetAddress() );
+    dag.set_timestamp( 1000 + nonce );
+    auto tx = MintTransaction::New( 100 + nonce, "chain", TOKEN_NAME, dag, account.eth_address );
+    return tx.dag_st;
+}
+
+TEST( TransactionSignatureVerifier, VerifiesAndCachesKeys )
+{
+    auto                         account = std::make_unique<GeniusAccount>( TOKEN_NAME, DATA_DIR, PRIV_KEY );
+    TransactionSignatureVerifier verifier;
+
+    auto dag = SignedDag( *account, 1 );
+    EXPECT_TRUE( verifier.Verify( dag ) );
+    EXPECT_TRUE( verifier.Verify( SignedDag( *account, 2 ) ) );
+
+    auto stats = verifier.GetStats();
+    EXPECT_EQ( stats.key_cache_misses, 1 );
+    EXPECT_EQ( stats.key_cache_hits, 1 );
+
+    auto tampered = dag;
+    tampered.set_nonce( dag.nonce() + 1 );
+    EXPECT_FALSE( verifier.Verify( tampered ) );
+
+    auto truncated = dag;
+    truncated.set_signature( dag.signature().substr( 0, 32 ) );
+    EXPECT_FALSE( verifier.Verify( truncated ) );
+}
+
+TEST( TransactionSignatureVerifier, VerifiesBatch )
+{
+    auto                         account = std::make_unique<GeniusAccount>( TOKEN_NAME, DATA_DIR, PRIV_KEY );
+    TransactionSignatureVerifier verifier;
+
+    std::vector<SGTransaction::DAGStruct> dags;
+    for ( uint64_t nonce = 0; nonce < 40; ++nonce )
+    {
+        dags.push_back( SignedDag( *account, nonce ) );
+    }
+    dags[7].set_timestamp( 0 );
+    dags[31].set_timestamp( 0 );
+
+    auto results = verifier.VerifyBatch( dags );
+    ASSERT_EQ( results.size(), dags.size() );
+    for ( size_t i = 0; i < results.size(); ++i )
+    {
+        EXPECT_EQ( results[i], i != 7 && i != 31 ) << i;
+    }
+}
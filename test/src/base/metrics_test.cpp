@@ -0,0 +1,144 @@
+
+
+#include "base/metrics.hpp"
+#include "base/metrics_exporter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
+using namespace sgns::base;
+
+/**
+ * @given values spanning the whole range
+ * @when they are bucketed
+ * @then every value is within its bucket and the buckets are ordered
+ */
+TEST(Metrics, HistogramBuckets) {
+  for (uint64_t value : {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 1000ull,
+                         123456789ull, ~0ull}) {
+    auto index = Histogram::BucketIndex(value);
+    ASSERT_LT(index, Histogram::BUCKET_COUNT);
+    EXPECT_GE(Histogram::BucketUpperBound(index), value);
+    if (index > 0) {
+      EXPECT_LT(Histogram::BucketUpperBound(index - 1), value);
+    }
+  }
+  EXPECT_EQ(Histogram::BucketIndex(~0ull), Histogram::BUCKET_COUNT - 1);
+}
+
+/**
+ * @given a histogram of the values 1 to 1000
+ * @when its quantiles are estimated
+ * @then they are within the bucket precision
+ */
+TEST(Metrics, HistogramQuantiles) {
+  Histogram histogram;
+  EXPECT_EQ(histogram.Quantile(0.5), 0);
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram.Observe(value);
+  }
+  EXPECT_EQ(histogram.Count(), 1000);
+  EXPECT_EQ(histogram.Sum(), 500500);
+  EXPECT_NEAR(histogram.Quantile(0.5), 500, 500 / 8);
+  EXPECT_NEAR(histogram.Quantile(0.99), 990, 990 / 8);
+  EXPECT_GE(histogram.Quantile(1), 1000);
+}
+
+/**
+ * @given a counter updated from several threads
+ * @when the threads are done
+ * @then no update is lost
+ */
+TEST(Metrics, ConcurrentCounter) {
+  Counter counter;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&counter] {
+      for (int j = 0; j < 100000; ++j) {
+        counter.Increment();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter.Value(), 400000);
+}
+
+/**
+ * @given a registry with a metric of each kind
+ * @when it is serialized
+ * @then the Prometheus text format is produced, removed gauges are left out
+ */
+TEST(Metrics, RegistrySerialize) {
+  MetricsRegistry registry;
+  registry.GetCounter("requests_total", "Requests", {{"kind", "a\"b"}})
+      .Increment(3);
+  registry.GetGauge("queue_depth", "Queued").Set(-2);
+  registry.GetHistogram("latency_us", "Latency").Observe(5);
+  auto id = registry.AddCallbackGauge(
+      "db_keys", "Keys", {}, []() -> std::optional<double> { return 42; });
+  registry.AddCallbackGauge(
+      "db_size", "Size", {}, []() -> std::optional<double> { return {}; });
+
+  EXPECT_EQ(&registry.GetGauge("queue_depth", "Queued"),
+            &registry.GetGauge("queue_depth", "Queued"));
+
+  auto text = registry.Serialize();
+  EXPECT_NE(text.find("# TYPE requests_total counter\n"
+                      "requests_total{kind=\"a\\\"b\"} 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("queue_depth -2\n"), std::string::npos);
+  EXPECT_NE(text.find("# TYPE latency_us summary\n"
+                      "latency_us{quantile=\"0.5\"} 5\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("latency_us_count 1\n"), std::string::npos);
+  EXPECT_NE(text.find("db_keys 42\n"), std::string::npos);
+  EXPECT_EQ(text.find("\ndb_size "), std::string::npos);
+
+  registry.RemoveCallbackGauge(id);
+  EXPECT_EQ(registry.Serialize().find("db_keys 42"), std::string::npos);
+}
+
+/**
+ * @given an exporter serving a registry
+ * @when the metrics are scraped and dumped
+ * @then both hold the registry content
+ */
+TEST(Metrics, Exporter) {
+  MetricsRegistry registry;
+  registry.GetCounter("scrapes_total", "Scrapes").Increment();
+  MetricsExporter exporter(registry);
+  ASSERT_TRUE(exporter.StartHttp(0));
+  ASSERT_NE(exporter.GetPort(), 0);
+  auto restarted = exporter.StartHttp(0);
+  ASSERT_FALSE(restarted);
+  EXPECT_EQ(restarted.error().value(), boost::asio::error::already_started);
+
+  boost::asio::io_context io;
+  boost::asio::ip::tcp::socket socket(io);
+  socket.connect({boost::asio::ip::make_address("127.0.0.1"),
+                  exporter.GetPort()});
+  std::string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  boost::asio::write(socket, boost::asio::buffer(request));
+  std::string response;
+  boost::system::error_code ec;
+  boost::asio::read(socket, boost::asio::dynamic_buffer(response), ec);
+  EXPECT_EQ(response.rfind("HTTP/1.1 200 OK", 0), 0);
+  EXPECT_NE(response.find("scrapes_total 1\n"), std::string::npos);
+  exporter.Stop();
+
+  auto path = testing::TempDir() + "metrics_test.prom";
+  ASSERT_TRUE(exporter.WriteFile(path));
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  EXPECT_EQ(content.str(), registry.Serialize());
+}
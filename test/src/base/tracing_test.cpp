@@ -0,0 +1,100 @@
+
+
+#include "base/tracing.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace sgns::base;
+
+class TracingTest : public testing::Test {
+ public:
+  void SetUp() override {
+    tracer_.Clear();
+    tracer_.SetEnabled(true);
+  }
+
+  void TearDown() override {
+    tracer_.SetEnabled(false);
+    tracer_.Clear();
+    tracer_.SetMaxEvents(Tracer::DEFAULT_MAX_EVENTS);
+  }
+
+  Tracer &tracer_ = Tracer::Instance();
+};
+
+/**
+ * @given tracing switched off
+ * @when spans are opened and closed
+ * @then nothing is recorded and the spans have no id
+ */
+TEST_F(TracingTest, DisabledRecordsNothing) {
+  tracer_.SetEnabled(false);
+  {
+    TraceSpan span("inference", "task", "subtask");
+    EXPECT_EQ(span.Id(), 0);
+    EXPECT_EQ(span.FlowOut(), 0);
+  }
+  EXPECT_TRUE(tracer_.GetEvents().empty());
+}
+
+/**
+ * @given nested spans
+ * @when they end
+ * @then both are recorded with their ids, the inner one within the outer one
+ */
+TEST_F(TracingTest, RecordsNestedSpans) {
+  {
+    TraceSpan outer("process_subtask", "task", "subtask");
+    TraceSpan inner("inference", "task", "subtask");
+    EXPECT_NE(inner.Id(), outer.Id());
+  }
+  auto events = tracer_.GetEvents();
+  ASSERT_EQ(events.size(), 2);
+  EXPECT_EQ(events[0].name, "inference");
+  EXPECT_EQ(events[1].name, "process_subtask");
+  EXPECT_EQ(events[0].task_id, "task");
+  EXPECT_EQ(events[0].subtask_id, "subtask");
+  EXPECT_GE(events[0].start_us, events[1].start_us);
+  EXPECT_LE(events[0].start_us + events[0].duration_us,
+            events[1].start_us + events[1].duration_us);
+}
+
+/**
+ * @given a span followed by a span that received its id
+ * @when the trace is exported
+ * @then both spans and the flow linking them are in the Chrome trace
+ */
+TEST_F(TracingTest, ExportsFlows) {
+  tracer_.SetProcessName("node \"1\"");
+  uint64_t sent = 0;
+  {
+    TraceSpan publish("publish_result", "task", "subtask");
+    sent = publish.FlowOut();
+  }
+  {
+    TraceSpan receive("receive_result", "task", "subtask");
+    receive.FlowIn(sent);
+  }
+  auto trace = tracer_.ExportChromeTrace();
+  EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+  EXPECT_NE(trace.find("\"name\":\"node \\\"1\\\"\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"publish_result\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"receive_result\""), std::string::npos);
+  EXPECT_NE(trace.find("\"subtask_id\":\"subtask\""), std::string::npos);
+  EXPECT_NE(trace.find("\"ph\":\"s\""), std::string::npos);
+  EXPECT_NE(trace.find("\"ph\":\"f\",\"bp\":\"e\""), std::string::npos);
+}
+
+/**
+ * @given a bounded buffer
+ * @when more spans than it holds are recorded
+ * @then the extra ones are dropped and counted
+ */
+TEST_F(TracingTest, DropsWhenFull) {
+  tracer_.SetMaxEvents(2);
+  for (int i = 0; i < 5; ++i) {
+    TraceSpan span("inference", "task");
+  }
+  EXPECT_EQ(tracer_.GetEvents().size(), 2);
+  EXPECT_EQ(tracer_.GetDroppedCount(), 3);
+}
@@ -0,0 +1,90 @@
+#include "crdt/crdt_data_filter.hpp"
+#include <gtest/gtest.h>
+
+namespace sgns::crdt
+{
+  namespace
+  {
+    std::shared_ptr<pb::Delta> MakeDelta( const std::vector<std::string> &keys )
+    {
+      auto delta = std::make_shared<pb::Delta>();
+      for ( const auto &key : keys )
+      {
+        auto *element = delta->add_elements();
+        element->set_key( key );
+        element->set_value( "value" );
+      }
+      return delta;
+    }
+
+    CRDTDataFilter::ElementFilterCallback Rejecting( std::vector<std::string> &seen )
+    {
+      return [&seen]( const pb::Element &element ) -> std::optional<std::vector<pb::Element>>
+      {
+        seen.push_back( element.key() );
+        return std::vector<pb::Element>{ element };
+      };
+    }
+
+    CRDTDataFilter::ElementFilterCallback Accepting( std::vector<std::string> &seen )
+    {
+      return [&seen]( const pb::Element &element ) -> std::optional<std::vector<pb::Element>>
+      {
+        seen.push_back( element.key() );
+        return std::nullopt;
+      };
+    }
+  }
+
+  TEST(CRDTDataFilterTest, DispatchesToMatchingPattern)
+  {
+    CRDTDataFilter           filter;
+    std::vector<std::string> txs;
+    std::vector<std::string> proofs;
+    ASSERT_TRUE( filter.RegisterElementFilter( "^/?bc-1[^/]*/tx/[^/]*/[0-9]+", Rejecting( txs ) ) );
+    ASSERT_TRUE( filter.RegisterElementFilter( "^/?bc-1[^/]*/(proof)/[^/]*/[0-9]+", Accepting( proofs ) ) );
+
+    auto delta = MakeDelta( { "/bc-1/tx/transfer/1", "bc-1/proof/transfer/1", "bc-1/other/1", "/bc-1/tx/x" } );
+    filter.FilterElementsOnDelta( delta );
+
+    EXPECT_EQ( txs, std::vector<std::string>{ "/bc-1/tx/transfer/1" } );
+    EXPECT_EQ( proofs, std::vector<std::string>{ "bc-1/proof/transfer/1" } );
+    ASSERT_EQ( delta->tombstones_size(), 1 );
+    EXPECT_EQ( delta->tombstones( 0 ).key(), "/bc-1/tx/transfer/1" );
+  }
+
+  TEST(CRDTDataFilterTest, RejectsUnmatchedByDefault)
+  {
+    CRDTDataFilter           filter( false );
+    std::vector<std::string> seen;
+    ASSERT_TRUE( filter.RegisterElementFilter( "^a/[0-9]+", Accepting( seen ) ) );
+
+    auto delta = MakeDelta( { "a/1", "b/1" } );
+    filter.FilterElementsOnDelta( delta );
+
+    EXPECT_EQ( seen, std::vector<std::string>{ "a/1" } );
+    ASSERT_EQ( delta->tombstones_size(), 1 );
+    EXPECT_EQ( delta->tombstones( 0 ).key(), "b/1" );
+  }
+
+  TEST(CRDTDataFilterTest, UnregisterAndInvalidPatterns)
+  {
+    CRDTDataFilter           filter;
+    std::vector<std::string> seen;
+    EXPECT_FALSE( filter.RegisterElementFilter( "a/(", Accepting( seen ) ) );
+    ASSERT_TRUE( filter.RegisterElementFilter( "a/([0-9])\\1", Rejecting( seen ) ) );
+    ASSERT_TRUE( filter.RegisterElementFilter( "b/.*", Rejecting( seen ) ) );
+
+    auto delta = MakeDelta( { "a/11", "a/12", "b/1" } );
+    filter.FilterElementsOnDelta( delta );
+    EXPECT_EQ( delta->tombstones_size(), 2 );
+
+    filter.UnregisterElementFilter( "a/([0-9])\\1" );
+    filter.UnregisterElementFilter( "b/.*" );
+    seen.clear();
+    delta = MakeDelta( { "a/11", "b/1" } );
+    filter.FilterElementsOnDelta( delta );
+    EXPECT_TRUE( seen.empty() );
+    EXPECT_EQ( delta->tombstones_size(), 0 );
+  }
+}
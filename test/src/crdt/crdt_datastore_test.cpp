@@ -244,6 +244,29 @@ namespace sgns::crdt
         EXPECT_OUTCOME_EQ( crdtDatastore_->HasKey( newKey5 ), false );
     }
 
+    TEST_F( CrdtDatastoreTest, RebroadcastSendsOnlyNewHeads )
+    {
+        std::chrono::milliseconds resultTime;
+
+        EXPECT_OUTCOME_TRUE_1( crdtDatastore_->Publish( CreateTestDelta( "Key1", "Value1" ), { "topic" } ) );
+        test::assertWaitForCondition( [&]() { return crdtDatastore_->GetRebroadcastStats().diffBroadcasts == 1; },
+                                      std::chrono::milliseconds( 5000 ),
+                                      "First head not broadcast",
+                                      &resultTime );
+
+        EXPECT_OUTCOME_TRUE_1( crdtDatastore_->Publish( CreateTestDelta( "Key2", "Value2", 2 ), { "topic" } ) );
+        test::assertWaitForCondition( [&]() { return crdtDatastore_->GetRebroadcastStats().diffBroadcasts == 2; },
+                                      std::chrono::milliseconds( 5000 ),
+                                      "Second head not broadcast",
+                                      &resultTime );
+
+        // Each change encodes only the new head, and the full head set isn't due before the interval
+        auto stats = crdtDatastore_->GetRebroadcastStats();
+        EXPECT_EQ( stats.encodings, 2 );
+        EXPECT_EQ( stats.fullBroadcasts, 0 );
+        EXPECT_GT( stats.bytes, 0 );
+    }
+
     TEST_F( CrdtDatastoreTest, FilterCallbackOneInvalid )
     {
         // Create a filter that rejects Deltas containing a specific key
@@ -23,4 +23,34 @@ namespace sgns::crdt
     EXPECT_TRUE(hKey != childKey);
     EXPECT_STRCASEEQ((strNamespace + "/" + childString).c_str(), childKey.GetKey().c_str());
   }
-}
\ No newline at end of file
+
+  TEST(CrdtHierarchicalKeyTest, TestHierarchicalKeyBuilder)
+  {
+    HierarchicalKey hKey("/namespace");
+
+    HierarchicalKeyBuilder builder(hKey);
+    builder.Child("s").Child("key/").Child("/id");
+    EXPECT_EQ(builder.GetView(), "/namespace/s/key/id");
+    EXPECT_TRUE(builder.Build() == hKey.ChildString("s").ChildString("key/").ChildString("/id"));
+
+    // Reuse the common prefix for a sibling key
+    builder.Truncate(hKey.GetView().size()).Child("t");
+    EXPECT_EQ(builder.GetView(), "/namespace/t");
+
+    // Typical CRDT keys are assembled in the inline buffer, without heap allocations
+    auto view = builder.GetView();
+    auto begin = reinterpret_cast<const char *>(&builder);
+    EXPECT_TRUE(view.data() >= begin && view.data() + view.size() <= begin + sizeof(builder));
+  }
+
+  TEST(CrdtHierarchicalKeyTest, TestHierarchicalKeyTopLevel)
+  {
+    EXPECT_TRUE(HierarchicalKey("/id").IsTopLevel());
+    EXPECT_FALSE(HierarchicalKey("/key/id").IsTopLevel());
+
+    EXPECT_TRUE(HierarchicalKey::IsTopLevel("id"));
+    EXPECT_TRUE(HierarchicalKey::IsTopLevel("/id/"));
+    EXPECT_FALSE(HierarchicalKey::IsTopLevel("key/id"));
+    EXPECT_EQ(HierarchicalKey::IsTopLevel("/key/id"), HierarchicalKey("/key/id").IsTopLevel());
+  }
+}
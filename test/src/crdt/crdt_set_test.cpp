@@ -212,6 +212,67 @@ namespace sgns::crdt
 
   }
 
+  TEST(CrdtSetTest, TestValueCacheCoherence)
+  {
+    const std::string strNamespace = "/namespace";
+    const std::string key = "cached";
+    const uint64_t lowerPriority = 11;
+    const uint64_t higherPriority = 12;
+
+    // Remove leftover database
+    std::string databasePath = "supergenius_crdt_set_test_value_cache";
+    fs::remove_all(databasePath);
+
+    // Create new database
+    rocksdb::Options options;
+    options.create_if_missing = true;  // intentionally
+
+    auto dataStoreResult = rocksdb::create(databasePath, options);
+    auto dataStore = dataStoreResult.value();
+
+    auto crdtSet = CrdtSet(dataStore, HierarchicalKey(strNamespace));
+
+    // A missing key is cached as never added
+    EXPECT_OUTCOME_EQ(crdtSet.IsValueInSet(key), false);
+    EXPECT_OUTCOME_EQ(crdtSet.IsValueInSet(key), false);
+    EXPECT_EQ(crdtSet.GetValueCacheStats().hits, 1);
+
+    // Written through by PutElems
+    std::vector<CrdtSet::Element> elements(1);
+    elements[0].set_key(key);
+    elements[0].set_value("first");
+    EXPECT_OUTCOME_TRUE_1(crdtSet.PutElems(elements, "ID1", lowerPriority));
+    EXPECT_OUTCOME_TRUE(firstValue, crdtSet.GetElement(key));
+    EXPECT_EQ(firstValue.toString(), "first");
+    EXPECT_OUTCOME_EQ(crdtSet.GetPriority(key), lowerPriority);
+
+    elements[0].set_value("second");
+    EXPECT_OUTCOME_TRUE_1(crdtSet.PutElems(elements, "ID2", higherPriority));
+    EXPECT_OUTCOME_TRUE(secondValue, crdtSet.GetElement(key));
+    EXPECT_EQ(secondValue.toString(), "second");
+
+    // Tombstoning one of the two versions keeps the key alive
+    std::vector<CrdtSet::Element> tombs(1);
+    tombs[0].set_key(key);
+    EXPECT_OUTCOME_TRUE_1(crdtSet.PutTombs(tombs, "ID2"));
+    EXPECT_OUTCOME_EQ(crdtSet.IsValueInSet(key), true);
+
+    // Tombstoning the other one removes it
+    EXPECT_OUTCOME_TRUE_1(crdtSet.PutTombs(tombs, "ID1"));
+    EXPECT_OUTCOME_EQ(crdtSet.IsValueInSet(key), false);
+    EXPECT_OUTCOME_FALSE_1(crdtSet.GetElement(key));
+
+    // A copy shares the cache, so it sees the same state
+    CrdtSet crdtSetCopy(crdtSet);
+    EXPECT_OUTCOME_EQ(crdtSetCopy.IsValueInSet(key), false);
+
+    auto stats = crdtSet.GetValueCacheStats();
+    EXPECT_GT(stats.hits, 1);
+    EXPECT_GT(stats.HitRate(), 0.0);
+    EXPECT_EQ(stats.entries, 1);
+    EXPECT_GT(stats.bytes, key.size());
+  }
+
   TEST(CrdtSetTest, TestMerge)
   {
     const std::string strNamespace = "/namespace";
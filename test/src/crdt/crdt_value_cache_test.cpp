@@ -0,0 +1,86 @@
+#include "crdt/crdt_value_cache.hpp"
+#include <gtest/gtest.h>
+
+namespace sgns::crdt
+{
+  TEST(CrdtValueCacheTest, TestPutGetInvalidate)
+  {
+    CrdtValueCache cache;
+
+    EXPECT_FALSE(cache.Get("key").has_value());
+
+    cache.Put("key", { std::string("value"), 7, false });
+    auto entry = cache.Get("key");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->value, std::string("value"));
+    EXPECT_EQ(entry->priority, 7);
+    EXPECT_FALSE(entry->tombstoned);
+
+    cache.Invalidate("key");
+    EXPECT_FALSE(cache.Get("key").has_value());
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_EQ(stats.invalidations, 1);
+    EXPECT_EQ(stats.entries, 0);
+    EXPECT_EQ(stats.bytes, 0);
+  }
+
+  TEST(CrdtValueCacheTest, TestStaleFillIsDropped)
+  {
+    CrdtValueCache cache;
+
+    // A write between the ticket and the fill makes the loaded state stale
+    auto staleTicket = cache.BeginLoad("key");
+    cache.Put("key", { std::string("new"), 2, false });
+    EXPECT_FALSE(cache.Fill("key", { std::string("old"), std::nullopt, false }, staleTicket));
+    EXPECT_EQ(cache.Get("key")->value, std::string("new"));
+
+    staleTicket = cache.BeginLoad("key");
+    cache.Invalidate("key");
+    EXPECT_FALSE(cache.Fill("key", { std::string("new"), std::nullopt, false }, staleTicket));
+    EXPECT_FALSE(cache.Get("key").has_value());
+
+    auto ticket = cache.BeginLoad("key");
+    EXPECT_TRUE(cache.Fill("key", { std::nullopt, std::nullopt, false }, ticket));
+    auto entry = cache.Get("key");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_FALSE(entry->value.has_value());
+  }
+
+  TEST(CrdtValueCacheTest, TestEvictionKeepsBudget)
+  {
+    const std::size_t capacity = 4 * 1024;
+    CrdtValueCache cache(capacity, 1);
+
+    const std::string value(100, 'v');
+    for (int i = 0; i < 200; ++i)
+    {
+      cache.Put("key" + std::to_string(i), { value, std::nullopt, false });
+    }
+
+    auto stats = cache.GetStats();
+    EXPECT_LE(stats.bytes, capacity);
+    EXPECT_GT(stats.evictions, 0);
+    EXPECT_EQ(stats.insertions, 200);
+
+    // The most recent entries survive, the oldest ones are gone
+    EXPECT_TRUE(cache.Get("key199").has_value());
+    EXPECT_FALSE(cache.Get("key0").has_value());
+
+    // Entries larger than a shard are not cached at all
+    cache.Put("huge", { std::string(capacity, 'h'), std::nullopt, false });
+    EXPECT_FALSE(cache.Get("huge").has_value());
+  }
+
+  TEST(CrdtValueCacheTest, TestDisabled)
+  {
+    CrdtValueCache cache(0);
+
+    EXPECT_FALSE(cache.IsEnabled());
+    cache.Put("key", { std::string("value"), 1, false });
+    EXPECT_FALSE(cache.Get("key").has_value());
+    EXPECT_FALSE(cache.Fill("key", {}, cache.BeginLoad("key")));
+  }
+}
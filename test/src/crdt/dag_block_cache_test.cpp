@@ -0,0 +1,116 @@
+#include "crdt/dag_block_cache.hpp"
+#include <ipfs_lite/ipld/impl/ipld_node_impl.hpp>
+#include <gtest/gtest.h>
+
+namespace sgns::crdt
+{
+  namespace
+  {
+    std::shared_ptr<ipfs_lite::ipld::IPLDNode> MakeNode(const std::string &content)
+    {
+      return ipfs_lite::ipld::IPLDNodeImpl::createFromString(content);
+    }
+  }
+
+  TEST(DAGBlockCacheTest, TestCleanTierHitsAndErase)
+  {
+    DAGBlockCache cache;
+    auto node = MakeNode("block content");
+    auto cid = node->getCID();
+
+    EXPECT_EQ(cache.Get(cid), nullptr);
+    EXPECT_TRUE(cache.Insert(cid, node));
+    EXPECT_EQ(cache.Get(cid), node);
+
+    cache.Erase(cid);
+    EXPECT_EQ(cache.Get(cid), nullptr);
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_EQ(stats.admissions, 1);
+    EXPECT_EQ(stats.entries, 0);
+    EXPECT_EQ(stats.bytes, 0);
+  }
+
+  TEST(DAGBlockCacheTest, TestBudgetIsEnforced)
+  {
+    auto sample = MakeNode(std::string(1000, 'x'));
+    const auto nodeBytes = DAGBlockCache::NodeBytes(*sample);
+    DAGBlockCache cache(nodeBytes * 8, DAGBlockCache::DEFAULT_PENDING_CAPACITY_BYTES,
+                        DAGBlockCache::DEFAULT_PENDING_MAX_ENTRIES, 1);
+
+    for (int i = 0; i < 100; ++i)
+    {
+      auto node = MakeNode(std::string(1000 - 3, 'x') + std::to_string(100 + i));
+      // Each node is requested before being read from the store, as the DAG syncer does
+      cache.Get(node->getCID());
+      cache.Insert(node->getCID(), node);
+      EXPECT_LE(cache.GetStats().bytes, nodeBytes * 8);
+    }
+    EXPECT_GT(cache.GetStats().evictions + cache.GetStats().rejections, 0);
+  }
+
+  TEST(DAGBlockCacheTest, TestFrequentBlocksSurviveScan)
+  {
+    auto sample = MakeNode(std::string(1000, 'h'));
+    const auto nodeBytes = DAGBlockCache::NodeBytes(*sample);
+    DAGBlockCache cache(nodeBytes * 8, DAGBlockCache::DEFAULT_PENDING_CAPACITY_BYTES,
+                        DAGBlockCache::DEFAULT_PENDING_MAX_ENTRIES, 1);
+
+    std::vector<std::shared_ptr<ipfs_lite::ipld::IPLDNode>> hot;
+    for (int i = 0; i < 4; ++i)
+    {
+      auto node = MakeNode(std::string(1000 - 1, 'h') + std::to_string(i));
+      cache.Get(node->getCID());
+      ASSERT_TRUE(cache.Insert(node->getCID(), node));
+      hot.push_back(node);
+    }
+    for (int round = 0; round < 3; ++round)
+    {
+      for (auto &node : hot)
+      {
+        EXPECT_EQ(cache.Get(node->getCID()), node);
+      }
+    }
+
+    // A one-off traversal over many cold blocks must not flush the hot ones
+    for (int i = 0; i < 200; ++i)
+    {
+      auto node = MakeNode(std::string(1000 - 3, 'c') + std::to_string(100 + i));
+      cache.Get(node->getCID());
+      cache.Insert(node->getCID(), node);
+    }
+    for (auto &node : hot)
+    {
+      EXPECT_EQ(cache.Get(node->getCID()), node);
+    }
+    EXPECT_GT(cache.GetStats().rejections, 0);
+  }
+
+  TEST(DAGBlockCacheTest, TestPendingTier)
+  {
+    DAGBlockCache cache(DAGBlockCache::DEFAULT_CAPACITY_BYTES, DAGBlockCache::DEFAULT_PENDING_CAPACITY_BYTES, 2);
+    auto first = MakeNode("first");
+    auto second = MakeNode("second");
+    auto third = MakeNode("third");
+
+    cache.MarkPending(first->getCID());
+    EXPECT_TRUE(cache.IsPending(first->getCID()));
+    EXPECT_EQ(cache.GetPending(first->getCID()), nullptr);
+
+    EXPECT_FALSE(cache.AddPending(first->getCID(), first));
+    EXPECT_EQ(cache.GetPending(first->getCID()), first);
+    // Pending blocks aren't persisted, so the clean tier must not report them
+    EXPECT_EQ(cache.Get(first->getCID()), nullptr);
+
+    EXPECT_TRUE(cache.AddPending(second->getCID(), second));
+    EXPECT_TRUE(cache.AddPending(third->getCID(), third));
+    EXPECT_FALSE(cache.IsPending(first->getCID()));
+    EXPECT_EQ(cache.GetStats().pendingEvictions, 1);
+
+    EXPECT_TRUE(cache.RemovePending(second->getCID()));
+    EXPECT_FALSE(cache.RemovePending(second->getCID()));
+    EXPECT_EQ(cache.GetStats().pendingEntries, 1);
+  }
+}
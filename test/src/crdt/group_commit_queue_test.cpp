@@ -0,0 +1,125 @@
+#include "crdt/group_commit_queue.hpp"
+#include <gtest/gtest.h>
+
+namespace sgns::crdt
+{
+    namespace
+    {
+        struct CommittedGroup
+        {
+            std::vector<std::string> keys;
+            std::set<std::string>    topics;
+        };
+
+        GroupCommitQueue::Operation MakePut( const std::string &key )
+        {
+            base::Buffer value;
+            value.put( "value" );
+            return { GroupCommitQueue::Operation::Type::PUT, HierarchicalKey( key ), value };
+        }
+
+        GroupCommitQueue::CommitFunction Recording( std::mutex &mutex, std::vector<CommittedGroup> &groups )
+        {
+            return [&mutex, &groups]( const std::vector<GroupCommitQueue::Operation> &operations,
+                                      const std::set<std::string> &topics ) -> outcome::result<void>
+            {
+                CommittedGroup group{ {}, topics };
+                for ( const auto &operation : operations )
+                {
+                    group.keys.push_back( operation.key.GetKey() );
+                }
+                std::lock_guard lock( mutex );
+                groups.push_back( std::move( group ) );
+                return outcome::success();
+            };
+        }
+    }
+
+    TEST( GroupCommitQueueTest, GroupsWritesPerTopics )
+    {
+        std::mutex                  mutex;
+        std::vector<CommittedGroup> groups;
+        GroupCommitQueue            queue( Recording( mutex, groups ), std::chrono::seconds( 10 ) );
+
+        auto first  = queue.Enqueue( MakePut( "/a" ), { "topic" } );
+        auto second = queue.Enqueue( MakePut( "/b" ), { "other" } );
+        auto third  = queue.Enqueue( MakePut( "/c" ), { "topic" } );
+        EXPECT_EQ( first.wait_for( std::chrono::milliseconds( 50 ) ), std::future_status::timeout );
+
+        queue.Flush();
+        EXPECT_FALSE( first.get().has_failure() );
+        EXPECT_FALSE( second.get().has_failure() );
+        EXPECT_FALSE( third.get().has_failure() );
+
+        ASSERT_EQ( groups.size(), 2 );
+        EXPECT_EQ( groups[0].keys, ( std::vector<std::string>{ "/a", "/c" } ) );
+        EXPECT_EQ( groups[0].topics, std::set<std::string>{ "topic" } );
+        EXPECT_EQ( groups[1].keys, std::vector<std::string>{ "/b" } );
+
+        auto stats = queue.GetStats();
+        EXPECT_EQ( stats.operations, 3 );
+        EXPECT_EQ( stats.deltas, 2 );
+        EXPECT_DOUBLE_EQ( stats.OperationsPerDelta(), 1.5 );
+    }
+
+    TEST( GroupCommitQueueTest, CommitsFullGroupsAndWindows )
+    {
+        std::mutex                  mutex;
+        std::vector<CommittedGroup> groups;
+        {
+            GroupCommitQueue queue( Recording( mutex, groups ), std::chrono::seconds( 10 ), 2 );
+
+            queue.Enqueue( MakePut( "/a" ), { "topic" } );
+            auto full = queue.Enqueue( MakePut( "/b" ), { "topic" } );
+            EXPECT_EQ( full.wait_for( std::chrono::seconds( 5 ) ), std::future_status::ready );
+
+            // Pending writes are committed on destruction
+            queue.Enqueue( MakePut( "/c" ), { "topic" } );
+        }
+        ASSERT_EQ( groups.size(), 2 );
+        EXPECT_EQ( groups[0].keys, ( std::vector<std::string>{ "/a", "/b" } ) );
+        EXPECT_EQ( groups[1].keys, std::vector<std::string>{ "/c" } );
+
+        groups.clear();
+        GroupCommitQueue queue( Recording( mutex, groups ), std::chrono::milliseconds( 10 ) );
+        auto             windowed = queue.Enqueue( MakePut( "/d" ), { "topic" } );
+        EXPECT_EQ( windowed.wait_for( std::chrono::seconds( 5 ) ), std::future_status::ready );
+    }
+
+    TEST( GroupCommitQueueTest, KeepsTheOrderOfRepeatedKeys )
+    {
+        std::mutex                  mutex;
+        std::vector<CommittedGroup> groups;
+        GroupCommitQueue            queue( Recording( mutex, groups ), std::chrono::seconds( 10 ) );
+
+        queue.Enqueue( MakePut( "/a" ), { "topic" } );
+        queue.Enqueue( MakePut( "/b" ), { "other" } );
+        queue.Enqueue( { GroupCommitQueue::Operation::Type::REMOVE, HierarchicalKey( "/a" ), {} }, { "topic" } );
+        // Goes after the write of /b on the other topics, not in the first group
+        queue.Enqueue( MakePut( "/b" ), { "topic" } );
+        queue.Flush();
+
+        ASSERT_EQ( groups.size(), 3 );
+        EXPECT_EQ( groups[0].keys, std::vector<std::string>{ "/a" } );
+        EXPECT_EQ( groups[1].keys, std::vector<std::string>{ "/b" } );
+        EXPECT_EQ( groups[2].keys, ( std::vector<std::string>{ "/a", "/b" } ) );
+        EXPECT_EQ( groups[2].topics, std::set<std::string>{ "topic" } );
+    }
+
+    TEST( GroupCommitQueueTest, FailuresReachEveryWriteOfTheGroup )
+    {
+        GroupCommitQueue queue(
+            []( const std::vector<GroupCommitQueue::Operation> &, const std::set<std::string> & ) -> outcome::result<void>
+            { return outcome::failure( boost::system::error_code{} ); } );
+
+        auto first  = queue.Enqueue( MakePut( "/a" ), { "topic" } );
+        auto second = queue.Enqueue( MakePut( "/b" ), { "topic" } );
+        queue.Flush();
+        EXPECT_TRUE( first.get().has_failure() );
+        EXPECT_TRUE( second.get().has_failure() );
+
+        auto stats = queue.GetStats();
+        EXPECT_EQ( stats.failures, 1 );
+        EXPECT_EQ( stats.deltas, 0 );
+    }
+}
@@ -0,0 +1,111 @@
+#include "crdt/processed_block_index.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <storage/rocksdb/rocksdb.hpp>
+#include <testutil/outcome.hpp>
+#include <base/hexutil.hpp>
+#include <boost/filesystem.hpp>
+#include <libp2p/multi/multihash.hpp>
+
+namespace sgns::crdt
+{
+    using libp2p::multi::HashType;
+    using libp2p::multi::Multihash;
+    using sgns::storage::rocksdb;
+    namespace fs = boost::filesystem;
+
+    namespace
+    {
+        CID MakeCID( const std::string &aHexDigest )
+        {
+            return CID( CID::Version::V1,
+                        CID::Multicodec::SHA2_256,
+                        Multihash::create( HashType::sha256, base::unhex( aHexDigest ).value() ).value() );
+        }
+    }
+
+    TEST( ProcessedBlockIndexTest, StatesSurviveReopening )
+    {
+        const auto hKey = HierarchicalKey( "/namespace/p" );
+        const CID  cid1 = MakeCID( "0123456789ABCDEF0123456789ABCDEF" );
+        const CID  cid2 = MakeCID( "1123456789ABCDEF0123456789ABCDEF" );
+        const CID  cid3 = MakeCID( "2123456789ABCDEF0123456789ABCDEF" );
+
+        std::string databasePath = "supergenius_processed_block_index_test";
+        fs::remove_all( databasePath );
+
+        rocksdb::Options options;
+        options.create_if_missing = true;
+        {
+            auto dataStore = rocksdb::create( databasePath, options ).value();
+
+            ProcessedBlockIndex index( dataStore, hKey );
+            EXPECT_EQ( index.GetSize(), 0 );
+            EXPECT_EQ( index.GetState( cid1 ), ProcessedBlockIndex::State::UNKNOWN );
+
+            EXPECT_OUTCOME_TRUE_1( index.SetState( cid1, ProcessedBlockIndex::State::MERGED ) );
+            EXPECT_OUTCOME_TRUE_1( index.SetState( cid2, ProcessedBlockIndex::State::COMPLETE ) );
+            EXPECT_EQ( index.GetState( cid1 ), ProcessedBlockIndex::State::MERGED );
+            EXPECT_EQ( index.GetState( cid2 ), ProcessedBlockIndex::State::COMPLETE );
+
+            // A block never goes back to an earlier state
+            EXPECT_OUTCOME_TRUE_1( index.SetState( cid2, ProcessedBlockIndex::State::MERGED ) );
+            EXPECT_EQ( index.GetState( cid2 ), ProcessedBlockIndex::State::COMPLETE );
+            EXPECT_EQ( index.GetSize(), 2 );
+
+            EXPECT_TRUE( index.SetState( cid3, ProcessedBlockIndex::State::UNKNOWN ).has_failure() );
+        }
+
+        auto dataStore = rocksdb::create( databasePath, options ).value();
+
+        ProcessedBlockIndex index( dataStore, hKey );
+        EXPECT_EQ( index.GetSize(), 2 );
+        EXPECT_EQ( index.GetState( cid1 ), ProcessedBlockIndex::State::MERGED );
+        EXPECT_EQ( index.GetState( cid2 ), ProcessedBlockIndex::State::COMPLETE );
+        EXPECT_EQ( index.GetState( cid3 ), ProcessedBlockIndex::State::UNKNOWN );
+
+        EXPECT_OUTCOME_TRUE_1( index.SetState( cid1, ProcessedBlockIndex::State::COMPLETE ) );
+        EXPECT_EQ( index.GetState( cid1 ), ProcessedBlockIndex::State::COMPLETE );
+        EXPECT_EQ( index.GetSize(), 2 );
+
+        // Other namespaces don't see the blocks
+        ProcessedBlockIndex otherIndex( dataStore, HierarchicalKey( "/other/p" ) );
+        EXPECT_EQ( otherIndex.GetSize(), 0 );
+        EXPECT_EQ( otherIndex.GetState( cid1 ), ProcessedBlockIndex::State::UNKNOWN );
+
+        dataStore.reset();
+        fs::remove_all( databasePath );
+    }
+
+    TEST( ProcessedBlockIndexTest, SmallBloomFilterStaysCorrect )
+    {
+        std::string databasePath = "supergenius_processed_block_index_bloom_test";
+        fs::remove_all( databasePath );
+
+        rocksdb::Options options;
+        options.create_if_missing = true;
+        auto dataStore            = rocksdb::create( databasePath, options ).value();
+
+        // A single word of bloom filter is saturated quickly, lookups then fall back to the datastore
+        ProcessedBlockIndex index( dataStore, HierarchicalKey( "/namespace/p" ), 64 );
+        std::vector<CID>    cids;
+        for ( int i = 0; i < 64; ++i )
+        {
+            char digest[33];
+            std::snprintf( digest, sizeof( digest ), "%032X", i );
+            cids.push_back( MakeCID( digest ) );
+        }
+        for ( size_t i = 0; i < cids.size(); i += 2 )
+        {
+            EXPECT_OUTCOME_TRUE_1( index.SetState( cids[i], ProcessedBlockIndex::State::MERGED ) );
+        }
+        for ( size_t i = 0; i < cids.size(); ++i )
+        {
+            EXPECT_EQ( index.GetState( cids[i] ),
+                       i % 2 == 0 ? ProcessedBlockIndex::State::MERGED : ProcessedBlockIndex::State::UNKNOWN );
+        }
+
+        dataStore.reset();
+        fs::remove_all( databasePath );
+    }
+}
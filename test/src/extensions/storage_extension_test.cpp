@@ -0,0 +1,248 @@
+#include "extensions/impl/storage_extension.hpp"
+
+#include <gtest/gtest.h>
+
+#include "mock/src/runtime/trie_storage_provider_mock.hpp"
+#include "mock/src/storage/changes_trie/changes_tracker_mock.hpp"
+#include "mock/src/storage/map_cursor_mock.hpp"
+#include "mock/src/storage/trie/trie_batches_mock.hpp"
+#include "runtime/wasm_result.hpp"
+#include "scale/scale.hpp"
+#include "src/runtime/mock_memory.hpp"
+#include "storage/trie/supergenius_trie/trie_error.hpp"
+#include "testutil/literals.hpp"
+
+using sgns::base::Buffer;
+using sgns::extensions::StorageExtension;
+using sgns::runtime::MockMemory;
+using sgns::runtime::TrieStorageProviderMock;
+using sgns::runtime::WasmMemory;
+using sgns::runtime::WasmPointer;
+using sgns::runtime::WasmResult;
+using sgns::runtime::WasmSpan;
+using sgns::storage::changes_trie::ChangesTrackerMock;
+using sgns::storage::trie::PersistentTrieBatchMock;
+using sgns::storage::trie::TrieError;
+using testing::_;
+using testing::An;
+using testing::ByMove;
+using testing::Invoke;
+using testing::Return;
+
+using CursorMock = sgns::storage::face::MapCursorMock<Buffer, Buffer>;
+
+class StorageExtensionTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    storage_provider_ = std::make_shared<TrieStorageProviderMock>();
+    trie_batch_ = std::make_shared<PersistentTrieBatchMock>();
+    memory_ = std::make_shared<MockMemory>();
+    ON_CALL(*storage_provider_, getCurrentBatch())
+        .WillByDefault(Return(trie_batch_));
+    ON_CALL(*storage_provider_, getBatchGeneration())
+        .WillByDefault(Invoke([this] { return generation_; }));
+    EXPECT_CALL(*storage_provider_, getCurrentBatch()).Times(testing::AnyNumber());
+    EXPECT_CALL(*storage_provider_, getBatchGeneration())
+        .Times(testing::AnyNumber());
+    extension_ = std::make_shared<StorageExtension>(
+        storage_provider_, memory_, std::make_shared<ChangesTrackerMock>());
+  }
+
+ protected:
+  /**
+   * Places \arg buffer in the memory mock
+   * @return span of the buffer, for the version 1 functions
+   */
+  WasmSpan place(const Buffer &buffer) {
+    WasmPointer ptr = next_ptr_;
+    next_ptr_ += 0x100;
+    EXPECT_CALL(*memory_, loadN(ptr, buffer.size()))
+        .WillRepeatedly(Return(buffer));
+    return WasmResult(ptr, buffer.size()).combine();
+  }
+
+  /**
+   * Writes \arg value under \arg key, which caches it
+   */
+  void set(const Buffer &key, const Buffer &value) {
+    EXPECT_CALL(*trie_batch_, put(key, value))
+        .WillOnce(Return(outcome::success()));
+    extension_->ext_storage_set_version_1(place(key), place(value));
+  }
+
+  /**
+   * Reads \arg key, expecting \arg value to be handed to the runtime
+   */
+  void expectGet(const Buffer &key, const Buffer &value) {
+    EXPECT_CALL(*memory_, storeBuffer(An<gsl::span<const uint8_t>>()))
+        .WillOnce(Invoke([&value](gsl::span<const uint8_t> stored) {
+          EXPECT_EQ(Buffer(stored), value);
+          return kResultSpan;
+        }));
+    EXPECT_EQ(extension_->ext_storage_get_version_1(place(key)), kResultSpan);
+  }
+
+  /**
+   * Expects ext_storage_next_key to return \arg next_key
+   */
+  void expectNextKey(const Buffer &key, const Buffer &next_key) {
+    auto encoded = scale::encode(boost::make_optional(next_key)).value();
+    EXPECT_CALL(*memory_, storeBuffer(An<gsl::span<const uint8_t>>()))
+        .WillOnce(Invoke([encoded](gsl::span<const uint8_t> stored) {
+          EXPECT_EQ(Buffer(stored), Buffer(encoded));
+          return kResultSpan;
+        }));
+    EXPECT_EQ(extension_->ext_storage_next_key_version_1(place(key)),
+              kResultSpan);
+  }
+
+  /**
+   * @return cursor expected to be positioned on \arg key once and to go
+   * through \arg keys and their \arg values afterwards
+   */
+  std::unique_ptr<sgns::storage::BufferMapCursor> makeCursor(
+      const Buffer &key,
+      const std::vector<Buffer> &keys,
+      const std::vector<Buffer> &values) {
+    auto cursor = std::make_unique<CursorMock>();
+    EXPECT_CALL(*cursor, seek(key)).WillOnce(Return(outcome::success()));
+    EXPECT_CALL(*cursor, next())
+        .Times(keys.size())
+        .WillRepeatedly(Return(outcome::success()));
+    EXPECT_CALL(*cursor, isValid()).WillRepeatedly(Return(true));
+    auto &key_call = EXPECT_CALL(*cursor, key());
+    auto &value_call = EXPECT_CALL(*cursor, value());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      key_call.WillOnce(Return(keys[i]));
+      value_call.WillOnce(Return(values[i]));
+    }
+    return cursor;
+  }
+
+  static constexpr WasmSpan kResultSpan = 0x4200000042;
+
+  std::shared_ptr<TrieStorageProviderMock> storage_provider_;
+  std::shared_ptr<PersistentTrieBatchMock> trie_batch_;
+  std::shared_ptr<MockMemory> memory_;
+  std::shared_ptr<StorageExtension> extension_;
+  uint64_t generation_ = 1;
+  WasmPointer next_ptr_ = 0x1000;
+};
+
+/**
+ * @given a key written during the call
+ * @when it is read and checked
+ * @then the written value is served without reaching the trie
+ */
+TEST_F(StorageExtensionTest, GetAfterSetIsCached) {
+  auto key = "key"_buf;
+  auto value = "value"_buf;
+  set(key, value);
+
+  EXPECT_CALL(*trie_batch_, get(_)).Times(0);
+  EXPECT_CALL(*trie_batch_, contains(_)).Times(0);
+  expectGet(key, value);
+  EXPECT_EQ(extension_->ext_storage_exists_version_1(place(key)), 1);
+}
+
+/**
+ * @given a key cleared during the call
+ * @when it is read and checked
+ * @then it is absent without reaching the trie
+ */
+TEST_F(StorageExtensionTest, GetAfterClearIsCached) {
+  auto key = "key"_buf;
+  set(key, "value"_buf);
+  EXPECT_CALL(*trie_batch_, remove(key)).WillOnce(Return(outcome::success()));
+  extension_->ext_storage_clear_version_1(place(key));
+
+  EXPECT_CALL(*trie_batch_, get(_)).Times(0);
+  EXPECT_CALL(*trie_batch_, contains(_)).Times(0);
+  EXPECT_EQ(extension_->ext_storage_get_version_1(place(key)),
+            WasmMemory::kMaxMemorySize);
+  EXPECT_EQ(extension_->ext_storage_exists_version_1(place(key)), 0);
+}
+
+/**
+ * @given keys written during the call, some of them under a prefix
+ * @when the prefix is cleared
+ * @then the keys under it are read from the trie again, the others are still
+ * served from the cache
+ */
+TEST_F(StorageExtensionTest, ClearPrefixForgetsItsKeys) {
+  auto prefixed_key = "aa01"_buf;
+  auto other_key = "bb01"_buf;
+  auto other_value = "other"_buf;
+  set(prefixed_key, "value"_buf);
+  set(other_key, other_value);
+
+  EXPECT_CALL(*trie_batch_, clearPrefix("aa"_buf))
+      .WillOnce(Return(outcome::success()));
+  extension_->ext_storage_clear_prefix_version_1(place("aa"_buf));
+
+  EXPECT_CALL(*trie_batch_, get(prefixed_key))
+      .WillOnce(Return(TrieError::NO_VALUE));
+  EXPECT_CALL(*trie_batch_, get(other_key)).Times(0);
+  EXPECT_EQ(extension_->ext_storage_get_version_1(place(prefixed_key)),
+            WasmMemory::kMaxMemorySize);
+  expectGet(other_key, other_value);
+}
+
+/**
+ * @given a value cached during a call
+ * @when the storage provider sets a new batch
+ * @then the value is read from the new batch, once
+ */
+TEST_F(StorageExtensionTest, NewBatchGenerationDropsTheCache) {
+  auto key = "key"_buf;
+  set(key, "old"_buf);
+
+  ++generation_;
+  auto value = "new"_buf;
+  EXPECT_CALL(*trie_batch_, get(key)).WillOnce(Return(value));
+  expectGet(key, value);
+  expectGet(key, value);
+}
+
+/**
+ * @given a map iterated with ext_storage_next_key
+ * @when each call asks for the key after the one returned last
+ * @then a single cursor is positioned once, and the values of the keys it
+ * went through are served without reaching the trie
+ */
+TEST_F(StorageExtensionTest, NextKeyContinuesFromTheCursor) {
+  auto start = "map"_buf;
+  std::vector<Buffer> keys{"map01"_buf, "map02"_buf};
+  std::vector<Buffer> values{"v1"_buf, "v2"_buf};
+  EXPECT_CALL(*trie_batch_, cursor())
+      .WillOnce(Return(ByMove(makeCursor(start, keys, values))));
+
+  expectNextKey(start, keys[0]);
+  expectNextKey(keys[0], keys[1]);
+
+  EXPECT_CALL(*trie_batch_, get(_)).Times(0);
+  expectGet(keys[1], values[1]);
+}
+
+/**
+ * @given a cursor left on the key returned last
+ * @when the next key of an unrelated key is asked, then the next key of the
+ * key returned last after a write
+ * @then a new cursor is positioned each time
+ */
+TEST_F(StorageExtensionTest, NextKeyReseeksAfterUnrelatedKeyOrWrite) {
+  auto start = "map"_buf;
+  auto other = "other"_buf;
+  EXPECT_CALL(*trie_batch_, cursor())
+      .WillOnce(Return(ByMove(makeCursor(start, {"map01"_buf}, {"v1"_buf}))))
+      .WillOnce(
+          Return(ByMove(makeCursor(other, {"other01"_buf}, {"v2"_buf}))))
+      .WillOnce(Return(
+          ByMove(makeCursor("other01"_buf, {"other02"_buf}, {"v3"_buf}))));
+
+  expectNextKey(start, "map01"_buf);
+  expectNextKey(other, "other01"_buf);
+
+  set("other015"_buf, "written"_buf);
+  expectNextKey("other01"_buf, "other02"_buf);
+}
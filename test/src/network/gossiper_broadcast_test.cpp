@@ -0,0 +1,188 @@
+#include "network/impl/gossiper_broadcast.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <libp2p/injector/host_injector.hpp>
+
+#include "network/helpers/scale_message_read_writer.hpp"
+#include "network/impl/loopback_stream.hpp"
+#include "network/types/block_announce.hpp"
+
+using sgns::network::BlockAnnounce;
+using sgns::network::GossiperBroadcast;
+using sgns::network::GossipMessage;
+using sgns::network::LoopbackStream;
+using sgns::network::ScaleMessageReadWriter;
+
+namespace {
+  using Frame = std::vector<uint8_t>;
+
+  /**
+   * Stream recording the bytes of each write, which may be left in flight
+   * until the test completes it
+   */
+  class RecordingStream : public LoopbackStream {
+   public:
+    using LoopbackStream::LoopbackStream;
+
+    void write(gsl::span<const uint8_t> in,
+               size_t bytes,
+               WriteCallbackFunc cb) override {
+      frames.emplace_back(in.begin(), in.begin() + bytes);
+      if (stalled) {
+        in_flight.emplace_back(std::move(cb), bytes);
+        return;
+      }
+      cb(bytes);
+    }
+
+    /**
+     * Completes the writes in flight, and those they start, one by one
+     */
+    void drain() {
+      while (!in_flight.empty()) {
+        auto [cb, bytes] = std::move(in_flight.front());
+        in_flight.erase(in_flight.begin());
+        cb(bytes);
+      }
+    }
+
+    std::vector<Frame> frames;
+    std::vector<std::pair<WriteCallbackFunc, size_t>> in_flight;
+    bool stalled = false;
+  };
+}  // namespace
+
+class GossiperBroadcastTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    auto injector = libp2p::injector::makeHostInjector();
+    host_ = injector.create<std::shared_ptr<libp2p::Host>>();
+    gossiper_ = std::make_shared<GossiperBroadcast>(*host_);
+  }
+
+ protected:
+  std::shared_ptr<RecordingStream> makeStream() const {
+    return std::make_shared<RecordingStream>(
+        libp2p::peer::PeerInfo{host_->getId(), {}});
+  }
+
+  static BlockAnnounce makeAnnounce(size_t number) {
+    BlockAnnounce announce;
+    announce.header.number = number;
+    return announce;
+  }
+
+  std::shared_ptr<libp2p::Host> host_;
+  std::shared_ptr<GossiperBroadcast> gossiper_;
+};
+
+/**
+ * @given a block announce
+ * @when it is broadcast, and written by a ScaleMessageReadWriter as the same
+ * gossip message
+ * @then both streams receive the same bytes
+ */
+TEST_F(GossiperBroadcastTest, FrameMatchesScaleMessageReadWriter) {
+  auto announce = makeAnnounce(42);
+  auto gossiped = makeStream();
+  gossiper_->addStream(gossiped);
+  gossiper_->blockAnnounce(announce);
+
+  GossipMessage message;
+  message.type = GossipMessage::Type::BLOCK_ANNOUNCE;
+  message.data.put(scale::encode(announce).value());
+  auto written = makeStream();
+  auto read_writer = std::make_shared<ScaleMessageReadWriter>(written);
+  read_writer->write(message, [](auto &&res) { EXPECT_TRUE(res); });
+
+  auto join = [](const std::vector<Frame> &frames) {
+    Frame joined;
+    for (const auto &frame : frames) {
+      joined.insert(joined.end(), frame.begin(), frame.end());
+    }
+    return joined;
+  };
+  ASSERT_EQ(gossiped->frames.size(), 1);
+  EXPECT_EQ(join(gossiped->frames), join(written->frames));
+}
+
+/**
+ * @given a stream whose writes don't complete, next to one which keeps up
+ * @when more messages than a queue holds are broadcast, and the writes
+ * complete afterwards
+ * @then the slow stream gets the message in flight and the newest queued
+ * ones, the other stream gets them all
+ */
+TEST_F(GossiperBroadcastTest, SlowStreamQueueIsBounded) {
+  auto slow = makeStream();
+  slow->stalled = true;
+  auto fast = makeStream();
+  gossiper_->addStream(slow);
+  gossiper_->addStream(fast);
+
+  constexpr size_t kMessages = GossiperBroadcast::kMaxQueuedMessages + 10;
+  for (size_t number = 0; number < kMessages; ++number) {
+    gossiper_->blockAnnounce(makeAnnounce(number));
+  }
+  ASSERT_EQ(fast->frames.size(), kMessages);
+  EXPECT_EQ(slow->frames.size(), 1);
+
+  slow->drain();
+  std::vector<Frame> expected{fast->frames.front()};
+  expected.insert(
+      expected.end(),
+      fast->frames.end() - GossiperBroadcast::kMaxQueuedMessages,
+      fast->frames.end());
+  EXPECT_EQ(slow->frames, expected);
+}
+
+/**
+ * @given a message broadcast to a stream
+ * @when the same message is broadcast again right away, then another one
+ * @then only the other one is written again
+ */
+TEST_F(GossiperBroadcastTest, SeenMessageIsNotBroadcastAgain) {
+  auto stream = makeStream();
+  gossiper_->addStream(stream);
+
+  gossiper_->blockAnnounce(makeAnnounce(1));
+  gossiper_->blockAnnounce(makeAnnounce(1));
+  EXPECT_EQ(stream->frames.size(), 1);
+
+  gossiper_->blockAnnounce(makeAnnounce(2));
+  EXPECT_EQ(stream->frames.size(), 2);
+}
+
+/**
+ * @given a message broadcast to a stream
+ * @when the same message is broadcast again once it expired from the filter
+ * @then it is written again, as a node retransmitting its vote does
+ */
+TEST_F(GossiperBroadcastTest, SeenMessageExpires) {
+  auto stream = makeStream();
+  gossiper_->addStream(stream);
+
+  gossiper_->blockAnnounce(makeAnnounce(1));
+  std::this_thread::sleep_for(GossiperBroadcast::kSeenMessagesTtl
+                              + std::chrono::milliseconds(100));
+  gossiper_->blockAnnounce(makeAnnounce(1));
+  ASSERT_EQ(stream->frames.size(), 2);
+  EXPECT_EQ(stream->frames[0], stream->frames[1]);
+}
+
+/**
+ * @given a message broadcast while no stream is open
+ * @when a stream is added and the message is broadcast again
+ * @then it is written to the stream
+ */
+TEST_F(GossiperBroadcastTest, MessageWithoutPeersIsNotSeen) {
+  gossiper_->blockAnnounce(makeAnnounce(1));
+
+  auto stream = makeStream();
+  gossiper_->addStream(stream);
+  gossiper_->blockAnnounce(makeAnnounce(1));
+  EXPECT_EQ(stream->frames.size(), 1);
+}
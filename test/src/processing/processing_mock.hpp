@@ -30,7 +30,7 @@ namespace sgns::test
     class SubTaskResultStorageMock : public SubTaskResultStorage
     {
     public:
-        void AddSubTaskResult(const SGProcessing::SubTaskResult& subTaskResult) override {
+        bool AddSubTaskResult(const SGProcessing::SubTaskResult& subTaskResult) override {
             auto [_, success] = results.insert({subTaskResult.subtaskid(), subTaskResult});
             if (!success)
             {
@@ -40,6 +40,7 @@ namespace sgns::test
             {
                 Color::PrintInfo("AddSubTaskResult ", subTaskResult.subtaskid(), " ", subTaskResult.node_address());
             }
+            return true;
         }
 
         void RemoveSubTaskResult(const std::string& subTaskId) override {
@@ -315,4 +315,81 @@ TEST_F(ProcessingSubTaskChannelPubSubTest, QueueTransmittingOnSinglePubSubHost)
     ASSERT_EQ(2, queueCount2.load());
     EXPECT_EQ(nodeId1, queueSnapshotSet2[0]->processing_queue().owner_node_id());
     EXPECT_EQ(nodeId2, queueSnapshotSet2[1]->processing_queue().owner_node_id());
-}
\ No newline at end of file
+}
+/**
+ * @given 2 channels connected to different pubsub hosts and a queue with many subtasks
+ * @when The queue is published and then only the processing state of some items changes
+ * @then The receiver rebuilds the whole queue while the changes are sent as small deltas
+ */
+TEST_F(ProcessingSubTaskChannelPubSubTest, QueueDeltasOnDifferentPubSubHosts)
+{
+    auto pubs1 = m_pubsub_nodes[0];
+    auto pubs2 = m_pubsub_nodes[1];
+
+    auto queueChannel1 = std::make_shared<ProcessingSubTaskQueueChannelPubSub>(pubs1, "PROCESSING_CHANNEL_ID");
+    auto queueChannel2 = std::make_shared<ProcessingSubTaskQueueChannelPubSub>(pubs2, "PROCESSING_CHANNEL_ID");
+
+    std::atomic<size_t> queueCount2{0};
+    std::mutex mutex2;
+    SGProcessing::SubTaskQueue lastQueue2;
+    queueChannel2->SetQueueUpdateSink([&lastQueue2, &queueCount2, &mutex2](SGProcessing::SubTaskQueue* queue) {
+        std::lock_guard<std::mutex> lock(mutex2);
+        lastQueue2.CopyFrom(*queue);
+        delete queue;
+        queueCount2++;
+        return true;
+    });
+
+    ASSERT_TRUE(queueChannel1->Listen()) << "Channel subscription failed to establish within 2000ms";
+    ASSERT_TRUE(queueChannel2->Listen()) << "Channel subscription failed to establish within 2000ms";
+
+    const int subTaskCount = 500;
+    auto queue = std::make_shared<SGProcessing::SubTaskQueue>();
+    queue->mutable_processing_queue()->set_owner_node_id(nodeId1);
+    for (int i = 0; i < subTaskCount; ++i)
+    {
+        auto subtask = queue->mutable_subtasks()->add_items();
+        subtask->set_subtaskid("SUBTASK_" + std::to_string(i));
+        subtask->set_json_data(R"({"input": "data"})");
+        subtask->add_chunkstoprocess()->set_chunkid("CHUNK_" + std::to_string(i));
+        queue->mutable_processing_queue()->add_items();
+    }
+
+    queueChannel1->PublishQueue(queue);
+    ASSERT_WAIT_FOR_CONDITION(
+        ([&queueCount2]() { return queueCount2 >= 1; }),
+        std::chrono::milliseconds(2000),
+        "Queue snapshot not received",
+        nullptr);
+
+    const size_t updateCount = 10;
+    for (size_t i = 0; i < updateCount; ++i)
+    {
+        auto item = queue->mutable_processing_queue()->mutable_items(static_cast<int>(i));
+        item->set_lock_node_id(nodeId1);
+        item->set_lock_timestamp(i + 1);
+        queue->mutable_processing_queue()->add_processed_subtask_ids("SUBTASK_" + std::to_string(i));
+        queueChannel1->PublishQueue(queue);
+
+        ASSERT_WAIT_FOR_CONDITION(
+            ([&queueCount2, i]() { return queueCount2 >= i + 2; }),
+            std::chrono::milliseconds(2000),
+            "Queue update not received",
+            nullptr);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex2);
+        ASSERT_EQ(subTaskCount, lastQueue2.subtasks().items_size());
+        EXPECT_EQ(static_cast<int>(updateCount), lastQueue2.processing_queue().processed_subtask_ids_size());
+        EXPECT_EQ(nodeId1, lastQueue2.processing_queue().items(updateCount - 1).lock_node_id());
+        EXPECT_EQ(updateCount, lastQueue2.processing_queue().items(updateCount - 1).lock_timestamp());
+    }
+
+    auto stats = queueChannel1->GetPublishStats();
+    EXPECT_EQ(1u, stats.snapshots);
+    EXPECT_EQ(updateCount, stats.deltas);
+    Color::PrintInfo("Snapshot bytes per subtask ", stats.snapshotBytes / subTaskCount,
+                     ", delta bytes per update ", stats.deltaBytes / stats.deltas);
+    EXPECT_LT(stats.deltaBytes, stats.snapshotBytes);
+}
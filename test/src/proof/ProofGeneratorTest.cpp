@@ -0,0 +1,71 @@
+/**
+ * @file       ProofGeneratorTest.cpp
+ * @brief      Source file with the proof generation pool tests
+ * @date       2026-10-18
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include "proof/ProofGenerator.hpp"
+#include "proof/TransferProof.hpp"
+
+TEST( ProofGeneratorTest, GeneratesSubmittedProofs )
+{
+    sgns::ProofGenerator generator( 2 );
+    std::atomic<int>     completed{ 0 };
+
+    std::vector<sgns::ProofGenerator::ProofFuture> futures;
+    for ( uint64_t amount = 1; amount <= 4; ++amount )
+    {
+        futures.push_back( generator.Submit( std::make_unique<sgns::TransferProof>( 1000, amount, "Bypass" ),
+                                             [&completed]() { ++completed; } ) );
+    }
+
+    for ( auto &future : futures )
+    {
+        const auto &proof_result = future.get();
+        ASSERT_FALSE( proof_result.has_error() ) << proof_result.error().message();
+        EXPECT_FALSE( proof_result.value().empty() );
+    }
+    generator.Stop();
+    EXPECT_EQ( completed, 4 );
+    EXPECT_EQ( generator.GetPendingCount(), 0 );
+}
+
+TEST( ProofGeneratorTest, FailsProofsAfterStop )
+{
+    sgns::ProofGenerator generator( 1 );
+    generator.Stop();
+
+    bool completed = false;
+    auto future    = generator.Submit( std::make_unique<sgns::TransferProof>( 1000, 1, "Bypass" ),
+                                    [&completed]() { completed = true; } );
+    EXPECT_TRUE( future.get().has_error() );
+    EXPECT_TRUE( completed );
+}
+
+TEST( ProofGeneratorTest, TrySubmitFailsWhenQueueIsFull )
+{
+    // A proof takes far longer than queueing one, so the single slot is taken while the worker is busy
+    sgns::ProofGenerator generator( 1, 1 );
+
+    std::vector<sgns::ProofGenerator::ProofFuture> futures;
+    bool                                           rejected = false;
+    for ( uint64_t amount = 1; amount <= 16; ++amount )
+    {
+        auto submit_result = generator.TrySubmit( std::make_unique<sgns::TransferProof>( 1000, amount, "Bypass" ) );
+        if ( submit_result.has_error() )
+        {
+            EXPECT_EQ( submit_result.error(), std::make_error_code( std::errc::resource_unavailable_try_again ) );
+            rejected = true;
+            continue;
+        }
+        futures.push_back( submit_result.value() );
+    }
+    EXPECT_TRUE( rejected );
+
+    for ( auto &future : futures )
+    {
+        EXPECT_FALSE( future.get().has_error() );
+    }
+}
@@ -185,3 +185,28 @@ TEST_F(MemoryHeapTest, ResetTest) {
   memory_.reset();
   ASSERT_EQ(memory_.allocate(N), 1);
 }
+
+/**
+ * @given memory with an image taken after some stores
+ * @when memory is written over, grown and then restored
+ * @then contents and size are the ones of the image and allocations are reset
+ */
+TEST_F(MemoryHeapTest, RestoreImageTest) {
+  memory_.store32(0, 42);
+  memory_.store64(memory_size_ - 8, 43);
+  memory_.takeImage();
+
+  memory_.store32(0, 1);
+  memory_.store64(memory_size_ - 8, 2);
+  memory_.store8(16, 3);
+  auto ptr = memory_.allocate(memory_size_ * 2);
+  ASSERT_NE(ptr, 0);
+  memory_.storeBuffer(ptr, sgns::base::Buffer(memory_size_, 'c'));
+
+  memory_.restoreImage();
+  ASSERT_EQ(memory_.size(), memory_size_);
+  ASSERT_EQ(memory_.load32u(0), 42);
+  ASSERT_EQ(memory_.load64u(memory_size_ - 8), 43);
+  ASSERT_EQ(memory_.load8u(16), 0);
+  ASSERT_EQ(memory_.allocate(1), 1);
+}
@@ -0,0 +1,204 @@
+
+
+#include "testutil/storage/base_fs_test.hpp"
+
+#include <gtest/gtest.h>
+#include "storage/rocksdb/rocksdb.hpp"
+#include "storage/rocksdb/rocksdb_batch.hpp"
+#include "storage/database_error.hpp"
+#include "testutil/outcome.hpp"
+
+using namespace sgns::storage;
+using sgns::base::Buffer;
+using RocksDB = sgns::storage::rocksdb;
+
+struct RocksDBColumnFamilyFixture : public test::FSFixture
+{
+    RocksDBColumnFamilyFixture() : test::FSFixture( "supergenius_rocksdb_column_family_test" )
+    {
+        layout_.push_back( { "values", "/ns/k/", "/v", 10, true, 10, 1024 * 1024 } );
+        layout_.push_back( { "priorities", "/ns/k/", "/p", 10, true, 0, 1024 * 1024 } );
+        layout_.push_back( { "tombstones", "/ns/t/", "", 10, true, 0, 1024 * 1024 } );
+    }
+
+    std::shared_ptr<RocksDB> open( const RocksDB::ColumnFamilyLayout &layout )
+    {
+        RocksDB::Options options;
+        options.create_if_missing = true;
+
+        auto r = RocksDB::create( getPathString(), options, layout );
+        if ( !r )
+        {
+            throw std::invalid_argument( r.error().message() );
+        }
+        return r.value();
+    }
+
+    static Buffer toBuffer( std::string_view str )
+    {
+        return Buffer{}.put( str );
+    }
+
+    RocksDB::ColumnFamilyLayout layout_;
+};
+
+/**
+ * @given database split in column families
+ * @when keys of every family are written, directly and in a batch
+ * @then point reads and prefix queries see all of them
+ */
+TEST_F( RocksDBColumnFamilyFixture, RoutesKeys )
+{
+    auto db = open( layout_ );
+
+    EXPECT_OUTCOME_TRUE_1( db->put( "/ns/k/a/v", "value" ) );
+    EXPECT_OUTCOME_TRUE_1( db->put( toBuffer( "/ns/k/a/p" ), toBuffer( "2" ) ) );
+    EXPECT_OUTCOME_TRUE_1( db->put( "/ns/k/a/other", "default" ) );
+
+    auto batch = db->CreateBatch();
+    EXPECT_OUTCOME_TRUE_1( batch->put( "/ns/t/a/id", "" ) );
+    EXPECT_OUTCOME_TRUE_1( batch->put( "/ns/k/b/v", "value b" ) );
+    EXPECT_OUTCOME_TRUE_1( batch->commit() );
+
+    EXPECT_OUTCOME_TRUE( value, db->get( "/ns/k/a/v" ) );
+    EXPECT_EQ( value.toString(), "value" );
+    EXPECT_TRUE( db->contains( "/ns/k/a/p" ) );
+    EXPECT_TRUE( db->contains( toBuffer( "/ns/t/a/id" ) ) );
+    EXPECT_TRUE( db->contains( "/ns/k/a/other" ) );
+
+    // Values, priorities and unrouted keys under the same prefix are merged
+    EXPECT_OUTCOME_TRUE( keysA, db->query( std::string_view( "/ns/k/a/" ) ) );
+    EXPECT_EQ( keysA.size(), 3 );
+    EXPECT_OUTCOME_TRUE( keys, db->query( std::string_view( "/ns/k/" ) ) );
+    EXPECT_EQ( keys.size(), 4 );
+    EXPECT_OUTCOME_TRUE( tombs, db->query( std::string_view( "/ns/t/" ) ) );
+    EXPECT_EQ( tombs.size(), 1 );
+
+    EXPECT_EQ( db->GetAll().size(), 5 );
+
+    EXPECT_OUTCOME_TRUE_1( db->remove( toBuffer( "/ns/k/a/v" ) ) );
+    auto r = db->get( "/ns/k/a/v" );
+    ASSERT_FALSE( r );
+    EXPECT_EQ( r.error().value(), (int)DatabaseError::NOT_FOUND );
+}
+
+/**
+ * @given database written without column families
+ * @when it is opened with a layout
+ * @then keys are moved to their column families and can still be read
+ */
+TEST_F( RocksDBColumnFamilyFixture, MigratesExistingKeys )
+{
+    {
+        auto db = open( {} );
+        for ( int i = 0; i < 3000; ++i )
+        {
+            EXPECT_OUTCOME_TRUE_1( db->put( "/ns/k/" + std::to_string( i ) + "/v", std::to_string( i ) ) );
+        }
+        EXPECT_OUTCOME_TRUE_1( db->put( "/ns/k/0/p", "1" ) );
+        EXPECT_OUTCOME_TRUE_1( db->put( "/ns/t/0/id", "" ) );
+        EXPECT_OUTCOME_TRUE_1( db->put( "/blocks/cid", "block" ) );
+    }
+
+    {
+        auto db = open( layout_ );
+        EXPECT_OUTCOME_TRUE( value, db->get( "/ns/k/2999/v" ) );
+        EXPECT_EQ( value.toString(), "2999" );
+        EXPECT_TRUE( db->contains( "/ns/k/0/p" ) );
+        EXPECT_TRUE( db->contains( "/ns/t/0/id" ) );
+        EXPECT_TRUE( db->contains( "/blocks/cid" ) );
+        EXPECT_EQ( db->GetAll().size(), 3003 );
+    }
+
+    // Without the layout only the keys left in the default column family are visible
+    auto db = open( {} );
+    EXPECT_FALSE( db->contains( "/ns/k/0/v" ) );
+    EXPECT_FALSE( db->contains( "/ns/t/0/id" ) );
+    EXPECT_TRUE( db->contains( "/blocks/cid" ) );
+}
+
+/**
+ * @given keys spread over the default and the layout column families
+ * @when a cursor walks the database forward, backward and changing direction
+ * @then it goes through every key in key order
+ */
+TEST_F( RocksDBColumnFamilyFixture, CursorMergesFamilies )
+{
+    auto db = open( layout_ );
+
+    std::vector<std::string> keys{ "/a", "/ns/k/a/other", "/ns/k/a/p", "/ns/k/a/v", "/ns/t/a/id", "/z" };
+    for ( const auto &key : keys )
+    {
+        EXPECT_OUTCOME_TRUE_1( db->put( key, "value" ) );
+    }
+
+    auto                     cursor = db->cursor();
+    std::vector<std::string> walked;
+    for ( cursor->seekToFirst(); cursor->isValid(); cursor->next() )
+    {
+        walked.push_back( cursor->key().value().toString() );
+    }
+    EXPECT_EQ( walked, keys );
+
+    walked.clear();
+    for ( cursor->seekToLast(); cursor->isValid(); cursor->prev() )
+    {
+        walked.push_back( cursor->key().value().toString() );
+    }
+    EXPECT_EQ( walked, std::vector<std::string>( keys.rbegin(), keys.rend() ) );
+
+    EXPECT_OUTCOME_TRUE_1( cursor->seek( toBuffer( "/ns/k/a/v" ) ) );
+    EXPECT_OUTCOME_TRUE_1( cursor->prev() );
+    ASSERT_TRUE( cursor->isValid() );
+    EXPECT_EQ( cursor->key().value().toString(), "/ns/k/a/p" );
+    EXPECT_OUTCOME_TRUE_1( cursor->next() );
+    ASSERT_TRUE( cursor->isValid() );
+    EXPECT_EQ( cursor->key().value().toString(), "/ns/k/a/v" );
+    EXPECT_OUTCOME_TRUE_1( cursor->next() );
+    ASSERT_TRUE( cursor->isValid() );
+    EXPECT_EQ( cursor->key().value().toString(), "/ns/t/a/id" );
+}
+
+/**
+ * @given database written with a layout, then opened by the caller with its column families
+ * @when it is wrapped with the layout and the handles
+ * @then the keys of the layout are read from their families
+ */
+TEST_F( RocksDBColumnFamilyFixture, WrapsOpenedDatabase )
+{
+    {
+        auto db = open( layout_ );
+        EXPECT_OUTCOME_TRUE_1( db->put( "/ns/k/a/v", "value" ) );
+        EXPECT_OUTCOME_TRUE_1( db->put( "/blocks/cid", "block" ) );
+    }
+
+    RocksDB::Options                                         options;
+    std::vector<::ROCKSDB_NAMESPACE::ColumnFamilyDescriptor> descriptors{
+        { ::ROCKSDB_NAMESPACE::kDefaultColumnFamilyName, options } };
+    for ( const auto &spec : layout_ )
+    {
+        descriptors.emplace_back( spec.name, options );
+    }
+    std::vector<RocksDB::ColumnFamilyHandle *> handles;
+    RocksDB::DB                               *raw = nullptr;
+    ASSERT_TRUE( RocksDB::DB::Open( options, getPathString(), descriptors, &handles, &raw ).ok() );
+    auto shared = std::shared_ptr<RocksDB::DB>( raw,
+                                                [handles]( RocksDB::DB *db )
+                                                {
+                                                    for ( auto *handle : handles )
+                                                    {
+                                                        db->DestroyColumnFamilyHandle( handle );
+                                                    }
+                                                    delete db;
+                                                } );
+
+    EXPECT_FALSE( RocksDB::create( shared, layout_, {} ) );
+
+    // The handles of the layout come after the default one
+    std::vector<RocksDB::ColumnFamilyHandle *> layoutHandles( handles.begin() + 1, handles.end() );
+    EXPECT_OUTCOME_TRUE( db, RocksDB::create( shared, layout_, layoutHandles ) );
+    EXPECT_EQ( db->GetColumnFamilyLayout().size(), layout_.size() );
+    EXPECT_OUTCOME_TRUE( value, db->get( "/ns/k/a/v" ) );
+    EXPECT_EQ( value.toString(), "value" );
+    EXPECT_TRUE( db->contains( "/blocks/cid" ) );
+}
@@ -61,3 +61,31 @@ TEST(OrderedTrieHash, TwoValueVectorErr2) {
   ASSERT_EQ(sgns::base::hex_lower(val),
             "5147323d593b7bb01fe8ea3e9d5a4bba0497c7f47b5daa121f4a6d791164d60b");
 }
+
+/**
+ * @given values enough for every compact index encoding length up to 4 bytes
+ * and for the subtrees encoded in parallel
+ * @when calculating their ordered trie hash
+ * @then it is the hash of the root of a trie with every value put at its
+ * encoded index
+ */
+TEST(OrderedTrieHash, MatchesGenericTrie) {
+  std::vector<sgns::base::Buffer> vals;
+  for (uint32_t i = 0; i < 20000; ++i) {
+    vals.push_back(sgns::base::Buffer{}.putUint32(i * 2654435761u));
+  }
+
+  sgns::storage::trie::SuperGeniusTrieImpl trie;
+  sgns::storage::trie::SuperGeniusCodec codec;
+  sgns::scale::CompactInteger key = 0;
+  for (const auto &val : vals) {
+    EXPECT_OUTCOME_TRUE(enc, sgns::scale::encode(key++));
+    EXPECT_OUTCOME_TRUE_1(trie.put(sgns::base::Buffer{enc}, val));
+  }
+  EXPECT_OUTCOME_TRUE(root, codec.encodeNode(*trie.getRoot()));
+
+  EXPECT_OUTCOME_TRUE(val,
+                      sgns::storage::trie::calculateOrderedTrieHash(
+                          vals.begin(), vals.end()));
+  ASSERT_EQ(val, sgns::base::Buffer{codec.hash256(root)});
+}
@@ -0,0 +1,119 @@
+
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/trie/impl/trie_storage_backend_impl.hpp"
+#include "storage/trie/impl/trie_storage_impl.hpp"
+#include "storage/trie/serialization/supergenius_codec.hpp"
+#include "storage/trie/serialization/trie_serializer_impl.hpp"
+#include "storage/trie/snapshot/state_snapshot_exporter.hpp"
+#include "storage/trie/snapshot/state_snapshot_importer.hpp"
+#include "storage/trie/supergenius_trie/supergenius_trie_factory_impl.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using namespace sgns;
+using namespace base;
+using namespace storage;
+using namespace trie;
+
+class StateSnapshotTest : public testing::Test {
+ public:
+  void SetUp() override {
+    source_ = createBackend();
+    auto serializer =
+        std::make_shared<TrieSerializerImpl>(factory_, codec_, source_);
+    auto trie =
+        TrieStorageImpl::createEmpty(factory_, codec_, serializer, boost::none)
+            .value();
+    auto batch = trie->getPersistentBatch().value();
+    for (uint16_t i = 0; i < kKeys; ++i) {
+      EXPECT_OUTCOME_TRUE_1(batch->put(key(i), value(i)));
+    }
+    root_ = batch->commit().value();
+  }
+
+  std::shared_ptr<TrieStorageBackendImpl> createBackend() const {
+    return std::make_shared<TrieStorageBackendImpl>(
+        std::make_shared<InMemoryStorage>(), "\1"_buf);
+  }
+
+  /**
+   * Keys of different lengths sharing prefixes, so the trie has both
+   * branches with values and inlined nodes
+   */
+  static Buffer key(uint16_t i) {
+    return Buffer(1 + i % 3, static_cast<uint8_t>(i / 3));
+  }
+
+  static Buffer value(uint16_t i) {
+    return Buffer(i % 40 + 1, static_cast<uint8_t>(i));
+  }
+
+  std::string exportState(uint32_t chunk_entries) const {
+    std::stringstream out;
+    StateSnapshotExporter exporter{source_, codec_, chunk_entries};
+    EXPECT_OUTCOME_TRUE(entries, exporter.exportState(root_, out));
+    EXPECT_EQ(entries, kKeys);
+    return out.str();
+  }
+
+  static constexpr uint16_t kKeys = 600;
+
+  std::shared_ptr<SuperGeniusTrieFactoryImpl> factory_ =
+      std::make_shared<SuperGeniusTrieFactoryImpl>();
+  std::shared_ptr<SuperGeniusCodec> codec_ =
+      std::make_shared<SuperGeniusCodec>();
+  std::shared_ptr<TrieStorageBackendImpl> source_;
+  Buffer root_;
+};
+
+/**
+ * @given a stored state
+ * @when it is exported in small chunks and imported into an empty storage
+ * @then the imported state has the same root and values
+ */
+TEST_F(StateSnapshotTest, RoundTrip) {
+  std::stringstream in{exportState(7)};
+  auto target = createBackend();
+  StateSnapshotImporter importer{target, codec_};
+  EXPECT_OUTCOME_TRUE(root, importer.importState(in));
+  EXPECT_EQ(root, root_);
+
+  TrieSerializerImpl serializer{factory_, codec_, target};
+  EXPECT_OUTCOME_TRUE(trie, serializer.retrieveTrie(root));
+  for (uint16_t i = 0; i < kKeys; ++i) {
+    EXPECT_OUTCOME_TRUE(val, trie->get(key(i)));
+    EXPECT_EQ(val, value(i));
+  }
+}
+
+/**
+ * @given an exported state
+ * @when a byte of an entry is changed
+ * @then the import fails on the digest of the chunk
+ */
+TEST_F(StateSnapshotTest, DetectsCorruptedChunk) {
+  auto snapshot = exportState(50);
+  snapshot[snapshot.size() / 2] ^= 0x01;
+  std::stringstream in{snapshot};
+  StateSnapshotImporter importer{createBackend(), codec_};
+  EXPECT_OUTCOME_FALSE(error, importer.importState(in));
+  EXPECT_EQ(error, StateSnapshotError::CORRUPTED_CHUNK);
+}
+
+/**
+ * @given an exported state
+ * @when the stream is cut
+ * @then the import fails
+ */
+TEST_F(StateSnapshotTest, DetectsTruncatedStream) {
+  auto snapshot = exportState(50);
+  std::stringstream in{snapshot.substr(0, snapshot.size() - 10)};
+  StateSnapshotImporter importer{createBackend(), codec_};
+  EXPECT_OUTCOME_FALSE(error, importer.importState(in));
+  EXPECT_EQ(error, StateSnapshotError::TRUNCATED);
+}
@@ -0,0 +1,106 @@
+
+
+#include "storage/trie/serialization/trie_node_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/trie/impl/trie_storage_backend_impl.hpp"
+#include "testutil/literals.hpp"
+
+using namespace sgns;
+using namespace base;
+using namespace storage;
+using namespace trie;
+
+/**
+ * @given a branch node with dummy children cached under its key
+ * @when it is retrieved and the retrieved copy is modified
+ * @then the cached node is not affected and the hit is counted
+ */
+TEST(TrieNodeCacheTest, ReturnsIndependentCopies) {
+  TrieNodeCache cache{TrieNodeCache::kDefaultCapacityBytes};
+  BranchNode branch{KeyNibbles{"0102"_hex2buf}, "0a"_hex2buf};
+  branch.children.at(3) = std::make_shared<DummyNode>("abcd"_hex2buf);
+  cache.put("01"_hex2buf, branch);
+
+  auto first = std::dynamic_pointer_cast<BranchNode>(cache.get("01"_hex2buf));
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->key_nibbles, branch.key_nibbles);
+  ASSERT_TRUE(first->children.at(3)->isDummy());
+  first->value = "0b"_hex2buf;
+  first->children.at(3) = std::make_shared<LeafNode>(KeyNibbles{}, "0c"_hex2buf);
+
+  auto second = std::dynamic_pointer_cast<BranchNode>(cache.get("01"_hex2buf));
+  ASSERT_NE(second, nullptr);
+  ASSERT_TRUE(second->value);
+  EXPECT_EQ(*second->value, "0a"_hex2buf);
+  EXPECT_TRUE(second->children.at(3)->isDummy());
+
+  EXPECT_EQ(cache.get("02"_hex2buf), nullptr);
+  auto stats = cache.getStats();
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.entries, 1);
+}
+
+/**
+ * @given a branch with a child that is not stored yet
+ * @when it is offered to the cache
+ * @then it is not cached, since its children could not be shared
+ */
+TEST(TrieNodeCacheTest, SkipsBranchesWithLoadedChildren) {
+  TrieNodeCache cache{TrieNodeCache::kDefaultCapacityBytes};
+  BranchNode branch{KeyNibbles{"01"_hex2buf}};
+  branch.children.at(0) = std::make_shared<LeafNode>(KeyNibbles{}, "0c"_hex2buf);
+  cache.put("01"_hex2buf, branch);
+  EXPECT_EQ(cache.get("01"_hex2buf), nullptr);
+  EXPECT_EQ(cache.getStats().insertions, 0);
+}
+
+/**
+ * @given a cache that fits a few leaves
+ * @when more leaves are cached
+ * @then the least recently used ones are evicted and the budget is kept
+ */
+TEST(TrieNodeCacheTest, EvictsLeastRecentlyUsed) {
+  LeafNode leaf{KeyNibbles{"0102"_hex2buf}, Buffer(64, 1)};
+  TrieNodeCache probe{TrieNodeCache::kDefaultCapacityBytes};
+  probe.put("00"_hex2buf, leaf);
+  auto entry_bytes = probe.getStats().bytes;
+
+  TrieNodeCache cache{entry_bytes * 3};
+  cache.put("00"_hex2buf, leaf);
+  cache.put("01"_hex2buf, leaf);
+  cache.put("02"_hex2buf, leaf);
+  // refresh the first one, so the second is the oldest
+  EXPECT_NE(cache.get("00"_hex2buf), nullptr);
+  cache.put("03"_hex2buf, leaf);
+
+  EXPECT_NE(cache.get("00"_hex2buf), nullptr);
+  EXPECT_EQ(cache.get("01"_hex2buf), nullptr);
+  EXPECT_NE(cache.get("03"_hex2buf), nullptr);
+  auto stats = cache.getStats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_LE(stats.bytes, stats.capacity_bytes);
+}
+
+/**
+ * @given two trie storage backends, one with a configured cache budget
+ * @when a node is cached in the cache of the first one
+ * @then the other backend doesn't see it and each cache has its own budget
+ */
+TEST(TrieNodeCacheTest, EachBackendHasItsOwnCache) {
+  auto storage = std::make_shared<InMemoryStorage>();
+  TrieStorageBackendImpl first{storage, "00"_hex2buf};
+  TrieStorageBackendImpl second{storage, "00"_hex2buf, 1024};
+  ASSERT_NE(first.nodeCache(), second.nodeCache());
+
+  first.nodeCache()->put("01"_hex2buf,
+                         LeafNode{KeyNibbles{"0102"_hex2buf}, Buffer(8, 1)});
+  EXPECT_NE(first.nodeCache()->get("01"_hex2buf), nullptr);
+  EXPECT_EQ(second.nodeCache()->get("01"_hex2buf), nullptr);
+  EXPECT_EQ(first.nodeCache()->getStats().capacity_bytes,
+            TrieNodeCache::kDefaultCapacityBytes);
+  EXPECT_EQ(second.nodeCache()->getStats().capacity_bytes, 1024);
+}
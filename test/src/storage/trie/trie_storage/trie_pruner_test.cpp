@@ -0,0 +1,149 @@
+
+
+#include "storage/trie/serialization/trie_pruner.hpp"
+
+#include <gtest/gtest.h>
+
+#include "storage/in_memory/in_memory_storage.hpp"
+#include "storage/trie/impl/trie_storage_backend_impl.hpp"
+#include "storage/trie/impl/trie_storage_impl.hpp"
+#include "storage/trie/serialization/supergenius_codec.hpp"
+#include "storage/trie/serialization/trie_serializer_impl.hpp"
+#include "storage/trie/supergenius_trie/supergenius_trie_factory_impl.hpp"
+#include "testutil/literals.hpp"
+#include "testutil/outcome.hpp"
+
+using namespace sgns;
+using namespace base;
+using namespace storage;
+using namespace trie;
+
+class TriePrunerTest : public testing::Test {
+ public:
+  void SetUp() override {
+    storage_ = std::make_shared<InMemoryStorage>();
+    pruner_ = createPruner();
+    serializer_ = std::make_shared<TrieSerializerImpl>(
+        factory_,
+        codec_,
+        std::make_shared<TrieStorageBackendImpl>(storage_, kNodePrefix));
+    serializer_->setPruner(pruner_);
+    trie_ = TrieStorageImpl::createEmpty(
+                factory_, codec_, serializer_, boost::none)
+                .value();
+  }
+
+  std::shared_ptr<TriePruner> createPruner() {
+    return TriePruner::create(
+               storage_, kNodePrefix, kRecordPrefix, codec_, {kKeepFinalized})
+        .value();
+  }
+
+  /**
+   * Commits a state where every key holds a value derived from the version
+   */
+  Buffer commitState(uint8_t version) {
+    auto batch = trie_->getPersistentBatch().value();
+    for (uint8_t i = 0; i < kKeys; ++i) {
+      EXPECT_OUTCOME_TRUE_1(batch->put(Buffer{i, 0xAB}, value(i, version)));
+    }
+    return batch->commit().value();
+  }
+
+  /**
+   * Only the first key changes between the versions, so the states share
+   * most of their nodes
+   */
+  static Buffer value(uint8_t key, uint8_t version) {
+    return Buffer(40, key == 0 ? version : 0xFF);
+  }
+
+  void expectState(const Buffer &root, uint8_t version) {
+    EXPECT_OUTCOME_TRUE(trie, serializer_->retrieveTrie(root));
+    for (uint8_t i = 0; i < kKeys; ++i) {
+      EXPECT_OUTCOME_TRUE(val, trie->get(Buffer{i, 0xAB}));
+      EXPECT_EQ(val, value(i, version));
+    }
+  }
+
+  static constexpr uint8_t kKeys = 32;
+  static constexpr uint32_t kKeepFinalized = 2;
+  const Buffer kNodePrefix = "\1"_buf;
+  const Buffer kRecordPrefix = "\2"_buf;
+
+  std::shared_ptr<InMemoryStorage> storage_;
+  std::shared_ptr<SuperGeniusTrieFactoryImpl> factory_ =
+      std::make_shared<SuperGeniusTrieFactoryImpl>();
+  std::shared_ptr<SuperGeniusCodec> codec_ =
+      std::make_shared<SuperGeniusCodec>();
+  std::shared_ptr<TriePruner> pruner_;
+  std::shared_ptr<TrieSerializerImpl> serializer_;
+  std::unique_ptr<TrieStorageImpl> trie_;
+};
+
+/**
+ * @given four committed states, each one changing a single value
+ * @when the last one is finalized and two finalized states are kept
+ * @then the two oldest states are deleted, the kept ones are intact
+ */
+TEST_F(TriePrunerTest, PrunesStatesOutOfWindow) {
+  std::vector<Buffer> roots;
+  for (uint8_t version = 0; version < 4; ++version) {
+    roots.push_back(commitState(version));
+  }
+  EXPECT_EQ(pruner_->getStats().journal_size, 4);
+
+  pruner_->onFinalized(roots[1]);
+  pruner_->onFinalized(roots[2]);
+  pruner_->onFinalized(roots[3]);
+  EXPECT_OUTCOME_TRUE_1(pruner_->prune());
+
+  auto stats = pruner_->getStats();
+  EXPECT_EQ(stats.pruned_states, 2);
+  EXPECT_EQ(stats.journal_size, 2);
+  EXPECT_GT(stats.deleted_nodes, 0);
+  EXPECT_GT(stats.reclaimed_bytes, 0);
+
+  expectState(roots[2], 2);
+  expectState(roots[3], 3);
+  EXPECT_FALSE(serializer_->retrieveTrie(roots[0]));
+  EXPECT_FALSE(serializer_->retrieveTrie(roots[1]));
+}
+
+/**
+ * @given committed states of which only one is finalized
+ * @when fewer states than the window are finalized
+ * @then nothing is pruned
+ */
+TEST_F(TriePrunerTest, KeepsStatesInsideWindow) {
+  auto first = commitState(0);
+  auto second = commitState(1);
+  pruner_->onFinalized(second);
+  EXPECT_OUTCOME_TRUE_1(pruner_->prune());
+
+  EXPECT_EQ(pruner_->getStats().pruned_states, 0);
+  expectState(first, 0);
+  expectState(second, 1);
+}
+
+/**
+ * @given committed states
+ * @when the pruner is created again on the same storage
+ * @then the journal is restored and pruning goes on from it
+ */
+TEST_F(TriePrunerTest, RestoresJournal) {
+  std::vector<Buffer> roots;
+  for (uint8_t version = 0; version < 3; ++version) {
+    roots.push_back(commitState(version));
+  }
+  pruner_->stop();
+
+  auto restarted = createPruner();
+  EXPECT_EQ(restarted->getStats().journal_size, 3);
+  restarted->onFinalized(roots[1]);
+  restarted->onFinalized(roots[2]);
+  EXPECT_OUTCOME_TRUE_1(restarted->prune());
+  EXPECT_EQ(restarted->getStats().pruned_states, 1);
+  EXPECT_FALSE(serializer_->retrieveTrie(roots[0]));
+  expectState(roots[2], 2);
+}
@@ -26,6 +26,8 @@
 #include <boost/dll.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include "account/TransferTransaction.hpp"
+#include "account/MintTransaction.hpp"
+#include "account/ProcessingTransaction.hpp"
 #include "testutil/outcome.hpp"
 #include "proof/TransferProof.hpp"
 
@@ -143,6 +145,124 @@ namespace sgns
         {
             node.SendTransactionAndProof( tx, proof );
         }
+
+        std::shared_ptr<sgns::TransactionManager> GetTransactionManager( sgns::GeniusNode &node )
+        {
+            return node.transaction_manager_;
+        }
+
+        /**
+         * Queues a mint, a transaction that has no parser and another mint while the sends are held back,
+         * so the three batches are merged into a single commit
+         */
+        std::vector<std::string> EnqueueAroundUnparsable( sgns::TransactionManager &manager, uint64_t amount )
+        {
+            std::lock_guard send_lock( manager.send_mutex_m );
+            std::lock_guard account_lock( manager.account_mutex_m );
+
+            std::vector<std::shared_ptr<IGeniusTransactions>> transactions{
+                std::make_shared<sgns::MintTransaction>( sgns::MintTransaction::New( amount,
+                                                                                     "",
+                                                                                     sgns::TokenID::FromBytes( { 0x00 } ),
+                                                                                     manager.FillDAGStruct(),
+                                                                                     manager.account_m->eth_address ) ),
+                std::make_shared<sgns::ProcessingTransaction>(
+                    sgns::ProcessingTransaction::New( "unparsable",
+                                                      {},
+                                                      {},
+                                                      manager.FillDAGStruct(),
+                                                      manager.account_m->eth_address ) ),
+                std::make_shared<sgns::MintTransaction>( sgns::MintTransaction::New( amount,
+                                                                                     "",
+                                                                                     sgns::TokenID::FromBytes( { 0x00 } ),
+                                                                                     manager.FillDAGStruct(),
+                                                                                     manager.account_m->eth_address ) ) };
+
+            std::vector<std::string> tx_ids;
+            for ( auto &transaction : transactions )
+            {
+                tx_ids.push_back( transaction->dag_st.data_hash() );
+                manager.EnqueueTransaction( sgns::TransactionManager::TransactionPair{ transaction, std::nullopt } );
+            }
+            return tx_ids;
+        }
+
+        /**
+         * Saves the account snapshot, retrying while outgoing transactions are in flight
+         */
+        bool SaveSnapshotWhenIdle( sgns::TransactionManager &manager )
+        {
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds( OUTGOING_TIMEOUT_MILLISECONDS );
+            while ( std::chrono::steady_clock::now() < deadline )
+            {
+                auto save_result = manager.SaveSnapshot();
+                if ( save_result.has_error() )
+                {
+                    return false;
+                }
+                if ( save_result.value() )
+                {
+                    return true;
+                }
+                std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+            }
+            return false;
+        }
+
+        outcome::result<void> LoadSnapshot( sgns::TransactionManager &manager )
+        {
+            return manager.LoadSnapshot();
+        }
+
+        void ClearUTXOs( sgns::TransactionManager &manager )
+        {
+            std::lock_guard account_lock( manager.account_mutex_m );
+            manager.account_m->utxos.clear();
+        }
+
+        void ClearCursors( sgns::TransactionManager &manager )
+        {
+            std::lock_guard account_lock( manager.account_mutex_m );
+            manager.tx_cursors_m.clear();
+        }
+
+        bool IsOutgoingProcessed( sgns::TransactionManager &manager, uint64_t nonce )
+        {
+            std::lock_guard account_lock( manager.account_mutex_m );
+            return manager.IsTransactionProcessed( manager.account_m->GetAddress(), nonce );
+        }
+
+        uint64_t GetNonce( sgns::TransactionManager &manager )
+        {
+            std::lock_guard account_lock( manager.account_mutex_m );
+            return manager.account_m->nonce;
+        }
+
+        /**
+         * Replaces the nonce of the stored snapshot, keeping the checksum of the original one
+         */
+        void TamperSnapshot( sgns::TransactionManager &manager, uint64_t nonce )
+        {
+            crdt::GlobalDB::Buffer snapshot_key;
+            snapshot_key.put( manager.GetSnapshotKey() );
+            auto data_store = manager.globaldb_m->GetDataStore();
+
+            auto snapshot_buffer = data_store->get( snapshot_key );
+            ASSERT_TRUE( snapshot_buffer.has_value() );
+
+            SGTransaction::AccountSnapshotEnvelope envelope;
+            ASSERT_TRUE( envelope.ParseFromArray( snapshot_buffer.value().data(),
+                                                  static_cast<int>( snapshot_buffer.value().size() ) ) );
+            SGTransaction::AccountSnapshot snapshot;
+            ASSERT_TRUE( snapshot.ParseFromString( envelope.snapshot() ) );
+            snapshot.set_nonce( nonce );
+            envelope.set_snapshot( snapshot.SerializeAsString() );
+
+            crdt::GlobalDB::Buffer tampered_buffer;
+            tampered_buffer.put( envelope.SerializeAsString() );
+            ASSERT_TRUE( data_store->put( snapshot_key, std::move( tampered_buffer ) ).has_value() );
+        }
     };
 
     TEST_F( TransactionSyncTest, TransactionSimpleTransfer )
@@ -462,4 +582,67 @@ namespace sgns
         EXPECT_EQ( node_proc2->GetBalance(), balance_2_before + 10000000000 )
             << "Transfer should increase node_proc2's balance";
     }
+
+    TEST_F( TransactionSyncTest, FailedBatchDoesNotDropMergedBatches )
+    {
+        auto balance_before = node_proc1->GetBalance();
+
+        auto tx_ids = EnqueueAroundUnparsable( *GetTransactionManager( *node_proc1 ), 1000 );
+        ASSERT_EQ( tx_ids.size(), 3 );
+
+        // The merged commit fails on the unparsable transaction, the batches around it are still published
+        EXPECT_TRUE( node_proc1->WaitForTransactionOutgoing( tx_ids[0],
+                                                             std::chrono::milliseconds( OUTGOING_TIMEOUT_MILLISECONDS ) ) );
+        EXPECT_TRUE( node_proc1->WaitForTransactionOutgoing( tx_ids[2],
+                                                             std::chrono::milliseconds( OUTGOING_TIMEOUT_MILLISECONDS ) ) );
+        EXPECT_FALSE( node_proc1->WaitForTransactionOutgoing( tx_ids[1], std::chrono::milliseconds( 2500 ) ) );
+
+        EXPECT_EQ( node_proc1->GetBalance(), balance_before + 2000 );
+    }
+
+    TEST_F( TransactionSyncTest, SnapshotRoundTrip )
+    {
+        auto manager = GetTransactionManager( *node_proc1 );
+
+        auto mint_result = node_proc1->MintTokens( 1000,
+                                                   "",
+                                                   "",
+                                                   sgns::TokenID::FromBytes( { 0x00 } ),
+                                                   std::chrono::milliseconds( OUTGOING_TIMEOUT_MILLISECONDS ) );
+        ASSERT_TRUE( mint_result.has_value() ) << "Mint transaction failed or timed out";
+        ASSERT_TRUE( SaveSnapshotWhenIdle( *manager ) );
+
+        auto balance_before = node_proc1->GetBalance();
+        auto nonce_before   = GetNonce( *manager );
+        ASSERT_GT( balance_before, 0 );
+
+        ClearUTXOs( *manager );
+        ClearCursors( *manager );
+        EXPECT_EQ( node_proc1->GetBalance(), 0 );
+        EXPECT_FALSE( IsOutgoingProcessed( *manager, nonce_before ) );
+
+        ASSERT_TRUE( LoadSnapshot( *manager ).has_value() );
+        EXPECT_EQ( node_proc1->GetBalance(), balance_before );
+        EXPECT_EQ( GetNonce( *manager ), nonce_before );
+        EXPECT_TRUE( IsOutgoingProcessed( *manager, nonce_before ) );
+    }
+
+    TEST_F( TransactionSyncTest, SnapshotChecksumMismatchIsRejected )
+    {
+        auto manager = GetTransactionManager( *node_proc1 );
+        ASSERT_TRUE( SaveSnapshotWhenIdle( *manager ) );
+
+        auto balance_before = node_proc1->GetBalance();
+        auto nonce_before   = GetNonce( *manager );
+
+        TamperSnapshot( *manager, nonce_before + 100 );
+        EXPECT_TRUE( LoadSnapshot( *manager ).has_error() );
+        EXPECT_EQ( node_proc1->GetBalance(), balance_before );
+        EXPECT_EQ( GetNonce( *manager ), nonce_before );
+
+        // A fresh snapshot replaces the corrupted one
+        ASSERT_TRUE( SaveSnapshotWhenIdle( *manager ) );
+        EXPECT_TRUE( LoadSnapshot( *manager ).has_value() );
+        EXPECT_EQ( GetNonce( *manager ), nonce_before );
+    }
 }
@@ -10,8 +10,8 @@ namespace sgns::runtime {
     initialize(path);
   }
 
-  const Buffer &BasicWasmProvider::getStateCode() const {
-    return buffer_;
+  WasmProvider::StateCode BasicWasmProvider::getStateCode() const {
+    return {buffer_, 0};
   }
 
   void BasicWasmProvider::initialize(std::string_view path) {
@@ -24,6 +24,6 @@ namespace sgns::runtime {
     sgns::base::Buffer buffer(size, 0);
     // read whole file to the buffer
     ifd.read((char *)buffer.data(), size);  // NOLINT
-    buffer_ = std::move(buffer);
+    buffer_ = std::make_shared<const Buffer>(std::move(buffer));
   }
 }  // namespace sgns::runtime
@@ -12,12 +12,12 @@ namespace sgns::runtime {
 
     ~BasicWasmProvider() override = default;
 
-    const sgns::base::Buffer &getStateCode() const override;
+    StateCode getStateCode() const override;
 
    private:
     void initialize(std::string_view path);
 
-    sgns::base::Buffer buffer_;
+    std::shared_ptr<const sgns::base::Buffer> buffer_;
   };
 
 }  // namespace sgns::runtime